@@ -49,12 +49,16 @@ fn main() {
     {
         if target_os == "macos" {
             println!("cargo:rustc-link-lib=c++");
+            // Audio workgroups (vst3_prepare_realtime_thread)
+            println!("cargo:rustc-link-lib=framework=CoreAudio");
         } else if target_os == "linux" {
             println!("cargo:rustc-link-lib=stdc++");
         } else if target_os == "windows" {
             // Windows: Link COM libraries needed for VST3
             println!("cargo:rustc-link-lib=ole32");
             println!("cargo:rustc-link-lib=uuid");
+            // MMCSS (vst3_prepare_realtime_thread)
+            println!("cargo:rustc-link-lib=avrt");
             // MSVC automatically links the C++ runtime
         }
     }
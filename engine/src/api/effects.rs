@@ -40,6 +40,10 @@ pub fn add_effect_to_track(track_id: TrackId, effect_type_str: &str) -> Result<u
             "🎛️ [API] Added {} effect (ID: {}) to track {}",
             effect_type_str, effect_id, track_id
         );
+        drop(track);
+        drop(effect_manager);
+        drop(track_manager);
+        graph.fx_chains_changed();
         Ok(effect_id)
     } else {
         Err(format!("Track {} not found", track_id))
@@ -64,6 +68,12 @@ pub fn remove_effect_from_track(track_id: TrackId, effect_id: u64) -> Result<Str
                 "🗑️ [API] Removed effect {} from track {}",
                 effect_id, track_id
             );
+            // The callback may still be processing it; it's unloaded on the
+            // reclaim thread once the callback has moved to the new chain
+            drop(track);
+            drop(effect_manager);
+            drop(track_manager);
+            graph.fx_chains_changed();
             Ok(format!("Effect {} removed from track {}", effect_id, track_id))
         } else {
             Err(format!(
@@ -151,6 +161,9 @@ pub fn set_effect_bypass(effect_id: u64, bypassed: bool) -> Result<String, Strin
     let mut effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
 
     if effect_manager.set_bypass(effect_id, bypassed) {
+        // A bypassed plugin passes audio straight through, without its latency
+        drop(effect_manager);
+        graph.fx_chains_changed();
         Ok(format!(
             "Effect {} bypass set to {}",
             effect_id,
@@ -213,6 +226,9 @@ pub fn reorder_track_effects(track_id: u64, effect_ids_csv: &str) -> Result<Stri
             track_id, track.fx_chain
         );
 
+        drop(track);
+        drop(track_manager);
+        graph.publish_fx_chains();
         Ok(format!("Effects reordered on track {}", track_id))
     } else {
         Err(format!("Track {} not found", track_id))
@@ -114,6 +114,26 @@ pub fn init_audio_graph() -> Result<String, String> {
     {
         use crate::vst3_host::VST3Host;
         VST3Host::init().map_err(|e| format!("VST3 host init failed: {}", e))?;
+
+        // Probe plugins out-of-process when the scan helper ships next to the app
+        let helper_name = if cfg!(windows) { "vst3_scan_helper.exe" } else { "vst3_scan_helper" };
+        if let Some(helper) = std::env::current_exe()
+            .ok()
+            .map(|exe| exe.with_file_name(helper_name))
+            .filter(|helper| helper.is_file())
+        {
+            VST3Host::set_scan_helper_path(Some(&helper.to_string_lossy()))?;
+        }
+
+        // Bridged plugins need their helper next to the app too
+        let bridge_name = if cfg!(windows) { "vst3_bridge_helper.exe" } else { "vst3_bridge_helper" };
+        if let Some(helper) = std::env::current_exe()
+            .ok()
+            .map(|exe| exe.with_file_name(bridge_name))
+            .filter(|helper| helper.is_file())
+        {
+            VST3Host::set_bridge_helper_path(Some(&helper.to_string_lossy()))?;
+        }
     }
 
     let graph = AudioGraph::new().map_err(|e| e.to_string())?;
@@ -1,7 +1,9 @@
 //! Latency and buffer control API functions
 //!
-//! Functions for audio latency configuration and waveform visualization.
+//! Functions for audio latency configuration, callback timing telemetry and
+//! waveform visualization.
 
+use crate::audio_file::TARGET_SAMPLE_RATE;
 use crate::audio_graph::BufferSizePreset;
 use super::helpers::{get_audio_clips, get_audio_graph, with_graph, with_graph_mut};
 
@@ -63,6 +65,136 @@ pub fn get_latency_info() -> Option<(u32, f32, f32, f32)> {
     Some(graph.get_latency_info())
 }
 
+// ============================================================================
+// PLUGIN DELAY COMPENSATION
+// ============================================================================
+
+/// Turn plugin delay compensation on or off
+pub fn set_delay_compensation_enabled(enabled: bool) -> Result<String, String> {
+    with_graph(|graph| {
+        graph.set_delay_compensation_enabled(enabled);
+        Ok(format!(
+            "Delay compensation {}",
+            if enabled { "enabled" } else { "disabled" }
+        ))
+    })
+}
+
+/// Get a track's delay compensation
+/// Returns: (fx_chain_latency_samples, compensation_samples)
+pub fn get_track_delay_compensation(track_id: u64) -> Result<(u32, u32), String> {
+    with_graph(|graph| {
+        graph.refresh_delay_compensation();
+        graph
+            .get_track_delay_compensation(track_id)
+            .ok_or_else(|| format!("Track {} not found", track_id))
+    })
+}
+
+/// Get the delay every track is aligned to (the slowest FX chain), in samples
+pub fn get_delay_compensation_latency() -> Result<u32, String> {
+    with_graph(|graph| {
+        graph.refresh_delay_compensation();
+        Ok(graph.delay_compensation.lock().map_err(|e| e.to_string())?.max_latency())
+    })
+}
+
+// ============================================================================
+// RENDER-AHEAD
+// ============================================================================
+
+/// Enable or disable rendering non-live tracks ahead of the playhead
+/// `lead_ms` is how far ahead (clamped to 50-2000ms)
+pub fn set_render_ahead(enabled: bool, lead_ms: u32) -> Result<String, String> {
+    with_graph_mut(|graph| {
+        graph.set_render_ahead(enabled, lead_ms);
+        let (_, lead_ms, _, _) = graph.get_render_ahead_info();
+        Ok(format!(
+            "Render-ahead {} ({}ms)",
+            if enabled { "enabled" } else { "disabled" },
+            lead_ms
+        ))
+    })
+}
+
+/// Get render-ahead status
+/// Returns: "enabled,lead_ms,tracks,underruns"
+pub fn get_render_ahead_info() -> Result<String, String> {
+    with_graph(|graph| {
+        let (enabled, lead_ms, tracks, underruns) = graph.get_render_ahead_info();
+        Ok(format!("{},{},{},{}", enabled, lead_ms, tracks, underruns))
+    })
+}
+
+// ============================================================================
+// CALLBACK TELEMETRY
+// ============================================================================
+
+/// Get output callback timing since the last reset, one line per measure:
+/// "callback,count,mean_us,p99_us,max_us,deadline_us,xruns", then
+/// "<lock>,count,mean_us,p99_us,max_us" for each lock the callback waits on
+/// (track_manager, effects, synth_manager, delay_compensation, master_limiter,
+/// recorder)
+pub fn get_audio_callback_telemetry() -> Result<String, String> {
+    with_graph(|graph| {
+        let telemetry = graph.callback_telemetry();
+        let (duration, waits) = telemetry.summary();
+        let mut lines = vec![format!(
+            "callback,{},{:.1},{:.1},{:.1},{:.1},{}",
+            duration.count,
+            duration.mean_us,
+            duration.p99_us,
+            duration.max_us,
+            telemetry.deadline_us(),
+            telemetry.xrun_count()
+        )];
+        for (stage, wait) in waits {
+            lines.push(format!(
+                "{},{},{:.1},{:.1},{:.1}",
+                stage.name(),
+                wait.count,
+                wait.mean_us,
+                wait.p99_us,
+                wait.max_us
+            ));
+        }
+        Ok(lines.join("\n"))
+    })
+}
+
+/// Get the callbacks that missed their deadline since the last poll, one
+/// per line: "timestamp_ms,playhead_seconds,duration_us,deadline_us,stage,stage_us"
+/// where stage is the lock wait (or "processing") that took longest
+pub fn poll_audio_xruns() -> Result<String, String> {
+    with_graph(|graph| {
+        let lines: Vec<String> = graph
+            .callback_telemetry()
+            .poll_xruns()
+            .iter()
+            .map(|xrun| {
+                format!(
+                    "{},{:.3},{:.1},{:.1},{},{:.1}",
+                    xrun.timestamp_ms,
+                    xrun.playhead as f64 / TARGET_SAMPLE_RATE as f64,
+                    xrun.duration_us,
+                    xrun.deadline_us,
+                    xrun.stage.name(),
+                    xrun.stage_us
+                )
+            })
+            .collect();
+        Ok(lines.join("\n"))
+    })
+}
+
+/// Start the callback histograms and xrun count over
+pub fn reset_audio_callback_telemetry() -> Result<String, String> {
+    with_graph(|graph| {
+        graph.callback_telemetry().reset();
+        Ok("Audio callback telemetry reset".to_string())
+    })
+}
+
 // ============================================================================
 // WAVEFORM VISUALIZATION
 // ============================================================================
@@ -40,8 +40,11 @@ pub use effects::{
 pub use helpers::{get_audio_clips, get_audio_graph, AUDIO_CLIPS, AUDIO_GRAPH};
 pub use init::{init_audio_engine, init_audio_graph, play_sine_wave};
 pub use latency::{
-    get_actual_buffer_size, get_buffer_size_preset, get_clip_duration, get_latency_info,
-    get_waveform_peaks, set_buffer_size,
+    get_actual_buffer_size, get_audio_callback_telemetry, get_buffer_size_preset,
+    get_clip_duration, get_delay_compensation_latency, get_latency_info, get_render_ahead_info,
+    get_track_delay_compensation, get_waveform_peaks, poll_audio_xruns,
+    reset_audio_callback_telemetry, set_buffer_size, set_delay_compensation_enabled,
+    set_render_ahead,
 };
 pub use midi_clips::{
     add_midi_clip_to_track_api, add_midi_clip_to_track_api as add_midi_clip_to_track,
@@ -55,8 +58,9 @@ pub use midi_input::{
     start_midi_recording, stop_midi_input, stop_midi_recording,
 };
 pub use project::{
-    export_audio, export_mp3_with_options, export_stems, export_to_wav, export_wav_with_options,
-    get_tracks_for_stems, is_ffmpeg_available, load_project, save_project, write_mp3_metadata,
+    autosave_project, export_audio, export_mp3_with_options, export_stems, export_to_wav,
+    export_wav_with_options, get_autosave_status, get_tracks_for_stems, is_ffmpeg_available,
+    load_project, save_project, write_mp3_metadata,
 };
 pub use recording::{
     get_audio_input_devices, get_audio_output_devices, get_count_in_bars, get_recorded_duration,
@@ -69,9 +73,9 @@ pub use synthesizer::{
 };
 pub use timing::{get_tempo, is_metronome_enabled, set_metronome_enabled, set_tempo};
 pub use tracks::{
-    create_track, get_all_track_ids, get_track_count, get_track_info, get_track_peak_levels,
-    move_clip_to_track, set_track_armed, set_track_mute, set_track_name, set_track_pan,
-    set_track_solo, set_track_volume,
+    create_track, freeze_track, get_all_track_ids, get_track_count, get_track_info,
+    get_track_peak_levels, is_track_frozen, move_clip_to_track, set_track_armed, set_track_mute,
+    set_track_name, set_track_pan, set_track_solo, set_track_volume, unfreeze_track,
 };
 pub use transport::{
     get_playhead_position, get_transport_state, transport_pause, transport_play, transport_seek,
@@ -80,10 +84,14 @@ pub use transport::{
 
 #[cfg(all(feature = "vst3", not(target_os = "ios")))]
 pub use vst3::{
-    add_vst3_effect_to_track, get_vst3_parameter_count, get_vst3_parameter_info,
-    get_vst3_parameter_value, get_vst3_state, scan_vst3_plugins, scan_vst3_plugins_standard,
-    set_vst3_parameter_value, set_vst3_state, vst3_attach_editor, vst3_close_editor,
-    vst3_get_editor_size, vst3_has_editor, vst3_open_editor, vst3_send_midi_note,
+    add_vst3_effect_to_track, configure_vst3_instance_pool, get_vst3_dsp_load_report, get_vst3_parameter_catalog,
+    get_vst3_parameter_count, get_vst3_parameter_info, get_vst3_parameter_value,
+    get_vst3_parameter_values, get_vst3_plugin_filters, get_vst3_plugin_stats, get_vst3_state,
+    is_vst3_effect_bridged, pin_vst3_plugin, poll_vst3_editor_changes, poll_vst3_parameter_changes,
+    query_vst3_plugins, reset_vst3_plugin_stats,
+    scan_vst3_plugins, scan_vst3_plugins_standard, set_vst3_parameter_value,
+    set_vst3_parameter_values, set_vst3_plugin_bridged, set_vst3_state, vst3_attach_editor,
+    vst3_close_editor, vst3_get_editor_size, vst3_has_editor, vst3_open_editor, vst3_send_midi_note,
 };
 
 // ============================================================================
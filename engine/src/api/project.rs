@@ -3,8 +3,8 @@
 //! Functions for saving, loading, and exporting projects.
 
 use super::helpers::{get_audio_clips, get_audio_graph};
-use std::path::Path;
-use std::sync::Arc;
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex, OnceLock};
 
 // ============================================================================
 // PROJECT SAVE/LOAD API
@@ -76,8 +76,16 @@ pub fn load_project(project_path_str: String) -> Result<String, String> {
 
     eprintln!("📂 [API] Loading project from {:?}", project_path);
 
-    // Load project data from JSON
-    let project_data = project::load_project(project_path).map_err(|e| e.to_string())?;
+    // Load project data from JSON, plus any plugin states stored beside it
+    let mut project_data = project::load_project(project_path).map_err(|e| e.to_string())?;
+    project::load_plugin_state_files(&mut project_data, project_path);
+    let project_name = project_data.name.clone();
+
+    // Effect IDs are reassigned below, so no saved plugin blob applies any more
+    if let Ok(mut autosave) = autosave_state().lock() {
+        autosave.plugin_states.clear();
+        autosave.epoch += 1;
+    }
 
     // Get audio graph
     let graph_mutex = get_audio_graph()?;
@@ -112,11 +120,268 @@ pub fn load_project(project_path_str: String) -> Result<String, String> {
 
     // Restore audio graph state from project data
     graph
-        .restore_from_project_data(project_data.clone())
+        .restore_from_project_data(project_data)
         .map_err(|e| e.to_string())?;
 
     eprintln!("✅ [API] Project loaded successfully");
-    Ok(format!("Loaded project: {}", project_data.name))
+    Ok(format!("Loaded project: {}", project_name))
+}
+
+// ============================================================================
+// INCREMENTAL AUTOSAVE
+// ============================================================================
+
+/// Autosave bookkeeping: which plugin blobs are already on disk, and the
+/// outcome of the last save
+#[derive(Default)]
+struct AutosaveState {
+    plugin_states: crate::project::PluginStateCache,
+    /// Bumped when `plugin_states` is invalidated, so a save that was
+    /// still writing doesn't record blobs for the old effect IDs
+    epoch: u64,
+    running: bool,
+    last_result: String,
+}
+
+static AUTOSAVE: OnceLock<Mutex<AutosaveState>> = OnceLock::new();
+
+fn autosave_state() -> &'static Mutex<AutosaveState> {
+    AUTOSAVE.get_or_init(|| Mutex::new(AutosaveState::default()))
+}
+
+/// A plugin state captured for the writer thread
+struct PendingPluginState {
+    effect_id: u64,
+    generation: u64,
+    state: Box<dyn std::ops::Deref<Target = [u8]> + Send>,
+    /// What was written for this plugin last time, if anything
+    previous: Option<crate::project::SavedPluginState>,
+}
+
+/// Autosave the project into `project_path` in the background.
+///
+/// Unlike `save_project`, VST3 states are stored as separate files under
+/// plugins/ and only rewritten when they changed: plugins whose state
+/// generation hasn't moved since the last autosave to the same folder are
+/// not serialized at all, and re-serialized states that hash the same as
+/// the blob on disk are not rewritten. Audio files already in the folder
+/// are not copied again.
+///
+/// Plugin states are captured on the calling thread; hashing, compression
+/// and all file I/O happen on a background thread. Poll
+/// `get_autosave_status` for the result.
+///
+/// # Arguments
+/// * `compress` - gzip plugin state blobs
+pub fn autosave_project(project_name: String, project_path_str: String, compress: bool) -> Result<String, String> {
+    let project_path = PathBuf::from(&project_path_str);
+
+    let mut autosave = autosave_state().lock().map_err(|e| e.to_string())?;
+    if autosave.running {
+        return Ok("Autosave already in progress".to_string());
+    }
+    autosave.plugin_states.target(&project_path, compress);
+
+    let (mut project_data, pending) = {
+        let graph_mutex = get_audio_graph()?;
+        let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+
+        let mut project_data = graph.export_to_project_data_without_plugin_states(project_name);
+        let pending = capture_changed_plugin_states(&graph, &mut project_data, &autosave.plugin_states)?;
+        (project_data, pending)
+    };
+
+    // Audio files this folder doesn't have yet
+    let mut audio_copies = Vec::new();
+    {
+        let clips_mutex = get_audio_clips()?;
+        let clips_map = clips_mutex.lock().map_err(|e| e.to_string())?;
+
+        for audio_file in &mut project_data.audio_files {
+            if let Some(clip_arc) = clips_map.get(&audio_file.id) {
+                let source_path = PathBuf::from(&clip_arc.file_path);
+                audio_file.relative_path = crate::project::audio_file_relative_path(&source_path, audio_file.id);
+                if !project_path.join(&audio_file.relative_path).exists() {
+                    audio_copies.push((source_path, audio_file.id));
+                }
+            }
+        }
+    }
+
+    let epoch = autosave.epoch;
+    autosave.running = true;
+    drop(autosave);
+
+    let spawned = std::thread::Builder::new()
+        .name("autosave".to_string())
+        .spawn(move || {
+            let started = std::time::Instant::now();
+            let plugin_count = pending.len();
+            let result = write_autosave(&mut project_data, &project_path, compress, audio_copies, pending);
+
+            let mut autosave = autosave_state().lock().expect("mutex poisoned");
+            autosave.running = false;
+            autosave.last_result = match result {
+                Ok((saved, written)) => {
+                    if autosave.epoch == epoch {
+                        let effect_ids = project_data
+                            .tracks
+                            .iter()
+                            .flat_map(|track| track.vst3_plugins.iter().map(|plugin| plugin.effect_id))
+                            .collect();
+                        autosave.plugin_states.retain(&effect_ids);
+                        for (effect_id, saved_state) in saved {
+                            autosave.plugin_states.insert(effect_id, saved_state);
+                        }
+                    }
+                    format!(
+                        "Autosaved in {} ms ({} of {} changed plugin states written)",
+                        started.elapsed().as_millis(),
+                        written,
+                        plugin_count
+                    )
+                }
+                Err(e) => format!("Error: {}", e),
+            };
+            eprintln!("💾 [API] {}", autosave.last_result);
+        });
+
+    if let Err(e) = spawned {
+        autosave_state().lock().map_err(|e| e.to_string())?.running = false;
+        return Err(format!("Failed to start autosave thread: {}", e));
+    }
+
+    Ok("Autosave started".to_string())
+}
+
+/// Outcome of the last `autosave_project` ("running" while one is writing)
+pub fn get_autosave_status() -> Result<String, String> {
+    let autosave = autosave_state().lock().map_err(|e| e.to_string())?;
+    if autosave.running {
+        Ok("running".to_string())
+    } else {
+        Ok(autosave.last_result.clone())
+    }
+}
+
+/// Snapshot the plugins whose state may have changed since their blob was
+/// written; point the others at their existing blob
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+fn capture_changed_plugin_states(
+    graph: &crate::audio_graph::AudioGraph,
+    project_data: &mut crate::project::ProjectData,
+    saved_states: &crate::project::PluginStateCache,
+) -> Result<Vec<PendingPluginState>, String> {
+    use crate::effects::EffectType;
+
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    let mut pending = Vec::new();
+    for plugin in project_data.tracks.iter_mut().flat_map(|track| track.vst3_plugins.iter_mut()) {
+        let Some(effect_arc) = effect_manager.get_effect(plugin.effect_id) else {
+            continue;
+        };
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+        let EffectType::VST3(vst3) = &*effect else {
+            continue;
+        };
+
+        // Read before the snapshot: an edit made while it's taken moves the
+        // generation again, so the next autosave picks it up
+        let generation = vst3.state_generation();
+        let previous = saved_states.get(plugin.effect_id).cloned();
+
+        match &previous {
+            Some(saved) if saved.generation == generation => {
+                plugin.state_file = Some(saved.state_file.clone());
+            }
+            _ => match vst3.snapshot_state() {
+                Ok(state) => pending.push(PendingPluginState {
+                    effect_id: plugin.effect_id,
+                    generation,
+                    state: Box::new(state),
+                    previous,
+                }),
+                Err(e) => {
+                    // Keep whatever was saved before rather than nothing
+                    eprintln!("⚠️  [API] Failed to capture state of {}: {}", plugin.plugin_name, e);
+                    plugin.state_file = previous.map(|saved| saved.state_file);
+                }
+            },
+        }
+    }
+    Ok(pending)
+}
+
+#[cfg(not(all(feature = "vst3", not(target_os = "ios"))))]
+fn capture_changed_plugin_states(
+    _graph: &crate::audio_graph::AudioGraph,
+    _project_data: &mut crate::project::ProjectData,
+    _saved_states: &crate::project::PluginStateCache,
+) -> Result<Vec<PendingPluginState>, String> {
+    Ok(Vec::new())
+}
+
+/// Writer thread half of `autosave_project`. Returns the blobs now on disk
+/// for the captured plugins and how many of them had to be rewritten.
+fn write_autosave(
+    project_data: &mut crate::project::ProjectData,
+    project_path: &Path,
+    compress: bool,
+    audio_copies: Vec<(PathBuf, u64)>,
+    pending: Vec<PendingPluginState>,
+) -> Result<(Vec<(u64, crate::project::SavedPluginState)>, usize), String> {
+    use crate::project;
+    use std::collections::{HashMap, HashSet};
+
+    for (source_path, file_id) in &audio_copies {
+        project::copy_audio_file_to_project(source_path, project_path, *file_id).map_err(|e| e.to_string())?;
+    }
+
+    let mut saved = Vec::with_capacity(pending.len());
+    let mut written = 0;
+    for plugin in pending {
+        let hash = project::plugin_state_hash(&plugin.state);
+        let state_file = match plugin.previous {
+            Some(previous) if previous.hash == hash && project_path.join(&previous.state_file).exists() => {
+                previous.state_file
+            }
+            _ => {
+                written += 1;
+                project::write_plugin_state(project_path, plugin.effect_id, &plugin.state, compress)
+                    .map_err(|e| format!("{:#}", e))?
+            }
+        };
+        saved.push((
+            plugin.effect_id,
+            project::SavedPluginState {
+                generation: plugin.generation,
+                hash,
+                state_file,
+            },
+        ));
+    }
+
+    let state_files: HashMap<u64, &str> = saved
+        .iter()
+        .map(|(effect_id, saved_state)| (*effect_id, saved_state.state_file.as_str()))
+        .collect();
+    for plugin in project_data.tracks.iter_mut().flat_map(|track| track.vst3_plugins.iter_mut()) {
+        if let Some(state_file) = state_files.get(&plugin.effect_id) {
+            plugin.state_file = Some(state_file.to_string());
+        }
+    }
+
+    project::save_project(project_data, project_path).map_err(|e| e.to_string())?;
+
+    let used: HashSet<String> = project_data
+        .tracks
+        .iter()
+        .flat_map(|track| track.vst3_plugins.iter().filter_map(|plugin| plugin.state_file.clone()))
+        .collect();
+    project::remove_unused_plugin_states(project_path, &used);
+
+    Ok((saved, written))
 }
 
 /// Export project to WAV file
@@ -608,30 +873,31 @@ pub fn export_stems(
         return Err("No tracks selected for export".to_string());
     }
 
-    // Render each track
-    let mut tracks_with_samples: Vec<(StemTrackInfo, Vec<f32>)> = Vec::new();
-
-    for (i, (track_id, track_name, _track_type)) in tracks_to_export.iter().enumerate() {
-        // Check for cancellation
-        if progress.is_cancelled() {
-            progress.fail("Export cancelled");
-            return Err("Export cancelled".to_string());
-        }
-
-        // Progress: 10% to 70% is rendering tracks
-        let track_progress = 10 + (i as u32 * 60 / total_tracks as u32);
-        progress.update(
-            track_progress,
-            &format!("Rendering track {} of {}: {}", i + 1, total_tracks, track_name),
-        );
+    // Render all tracks in parallel, each through its own copy of its FX chain
+    // Progress: 10% to 70% is rendering tracks
+    progress.update(10, &format!("Rendering {} tracks...", total_tracks));
+    let track_ids: Vec<u64> = tracks_to_export.iter().map(|(track_id, _, _)| *track_id).collect();
+    let rendered = graph.render_tracks_offline_parallel(
+        &track_ids,
+        duration,
+        &|done, total| {
+            progress.update(
+                10 + (done as u32 * 60 / total as u32),
+                &format!("Rendered {} of {} tracks", done, total),
+            );
+        },
+        &|| progress.is_cancelled(),
+    );
 
-        eprintln!(
-            "🎚️ [API] Rendering track '{}' (ID: {})",
-            track_name, track_id
-        );
+    // Check for cancellation
+    if progress.is_cancelled() {
+        progress.fail("Export cancelled");
+        return Err("Export cancelled".to_string());
+    }
 
-        let samples = graph.render_track_offline(*track_id, duration);
+    let mut tracks_with_samples: Vec<(StemTrackInfo, Vec<f32>)> = Vec::new();
 
+    for ((track_id, track_name, _track_type), (_, samples)) in tracks_to_export.iter().zip(rendered) {
         // Skip empty tracks
         if samples.iter().all(|&s| s.abs() < 0.0001) {
             eprintln!("   ⏭️ Track '{}' is silent, skipping", track_name);
@@ -52,9 +52,14 @@ pub fn delete_track(track_id: TrackId) -> Result<String, String> {
     // Remove all MIDI clips belonging to this track from the global collection
     graph.remove_midi_clips_for_track(track_id);
 
-    let mut track_manager = graph.track_manager.lock().map_err(|e| e.to_string())?;
-
-    if track_manager.remove_track(track_id) {
+    let removed = graph
+        .track_manager
+        .lock()
+        .map_err(|e| e.to_string())?
+        .remove_track(track_id);
+
+    if removed {
+        graph.fx_chains_changed();
         Ok(format!("Track {} deleted", track_id))
     } else {
         Err(format!(
@@ -128,6 +133,8 @@ pub fn clear_all_tracks() -> Result<String, String> {
         }
     }
 
+    graph.fx_chains_changed();
+
     eprintln!(
         "🧹 [API] Cleared {} tracks (master track preserved)",
         track_ids_to_remove.len()
@@ -162,6 +169,10 @@ pub fn duplicate_track(track_id: TrackId) -> Result<TrackId, String> {
             .ok_or(format!("Track {} not found", track_id))?;
 
         let source_track = source_track_arc.lock().map_err(|e| e.to_string())?;
+        // Its plugins are unloaded; a copy would come out without them
+        if source_track.frozen.is_some() {
+            return Err(format!("Unfreeze track {} before duplicating it", track_id));
+        }
 
         // Collect all data we need to copy
         (
@@ -230,6 +241,8 @@ pub fn duplicate_track(track_id: TrackId) -> Result<TrackId, String> {
         // track_manager lock is released here
     };
 
+    graph.fx_chains_changed();
+
     // Copy instrument assignment if exists (for MIDI tracks)
     {
         let mut synth_manager = graph.track_synth_manager.lock().map_err(|e| e.to_string())?;
@@ -43,6 +43,9 @@ pub fn create_track(track_type_str: &str, name: String) -> Result<TrackId, Strin
         println!("✅ Auto-created synth for MIDI track {}", track_id);
     }
 
+    // New tracks have no latency of their own and need to wait for the slowest chain
+    graph.update_delay_compensation();
+
     Ok(track_id)
 }
 
@@ -150,6 +153,43 @@ pub fn set_track_name(track_id: TrackId, name: String) -> Result<String, String>
     }
 }
 
+// ============================================================================
+// TRACK FREEZE
+// ============================================================================
+
+/// Freeze a track: render it to an audio file and unload its plugins
+///
+/// # Arguments
+/// * `track_id` - Audio or MIDI track to freeze
+/// * `cache_dir` - Folder for the render (empty = system temp folder)
+pub fn freeze_track(track_id: TrackId, cache_dir: String) -> Result<String, String> {
+    let cache_dir = if cache_dir.is_empty() {
+        std::env::temp_dir().join("boojy_freeze")
+    } else {
+        std::path::PathBuf::from(cache_dir)
+    };
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let seconds = graph.freeze_track(track_id, &cache_dir)?;
+    Ok(format!("Track {} frozen ({:.2}s)", track_id, seconds))
+}
+
+/// Unfreeze a track: reload its plugins and drop the render
+pub fn unfreeze_track(track_id: TrackId) -> Result<String, String> {
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    graph.unfreeze_track(track_id)?;
+    Ok(format!("Track {} unfrozen", track_id))
+}
+
+/// Check whether a track is frozen
+pub fn is_track_frozen(track_id: TrackId) -> Result<bool, String> {
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    Ok(graph.is_track_frozen(track_id))
+}
+
 // ============================================================================
 // TRACK QUERIES
 // ============================================================================
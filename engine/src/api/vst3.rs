@@ -18,24 +18,22 @@ pub fn add_vst3_effect_to_track(track_id: TrackId, plugin_path: &str) -> Result<
 
     let graph_mutex = get_audio_graph()?;
     let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
-    let track_manager = graph.track_manager.lock().map_err(|e| e.to_string())?;
-    let mut effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
 
     // Get audio settings
     let sample_rate = crate::audio_file::TARGET_SAMPLE_RATE as f64;
-    let block_size = 512; // TODO: Get from config
+    let block_size = graph.plugin_block_size();
 
-    // Load VST3 plugin
-    let mut vst3_effect = VST3Effect::new(plugin_path, sample_rate, block_size as i32)
+    // Load the plugin before taking the track and effect locks: loading can
+    // take a while and the audio callback locks the track manager every block.
+    // A warm instance from the pool comes already initialized and activated
+    let vst3_effect = VST3Effect::from_pool(plugin_path, sample_rate, block_size as i32)
         .map_err(|e| format!("Failed to load VST3 plugin: {}", e))?;
 
-    // Initialize and activate the plugin for audio processing
-    vst3_effect
-        .initialize()
-        .map_err(|e| format!("Failed to initialize VST3 plugin: {}", e))?;
-
     let effect = EffectType::VST3(vst3_effect);
 
+    let track_manager = graph.track_manager.lock().map_err(|e| e.to_string())?;
+    let mut effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
     // Add effect to effect manager
     let effect_id = effect_manager.create_effect(effect);
 
@@ -47,12 +45,36 @@ pub fn add_vst3_effect_to_track(track_id: TrackId, plugin_path: &str) -> Result<
             "🎛️ [API] Added VST3 plugin from {} (ID: {}) to track {}",
             plugin_path, effect_id, track_id
         );
+        drop(track);
+        drop(effect_manager);
+        drop(track_manager);
+        graph.fx_chains_changed();
         Ok(effect_id)
     } else {
         Err(format!("Track {} not found", track_id))
     }
 }
 
+#[cfg(not(target_os = "ios"))]
+/// Keep `instances_per_class` warm instances of pinned plugins and of the
+/// `max_classes` most recently added ones, so adding or auditioning them is
+/// instant. 0 instances turns the pool off
+pub fn configure_vst3_instance_pool(instances_per_class: usize, max_classes: usize) -> Result<(), String> {
+    use crate::vst3_host::VST3Host;
+
+    let graph_mutex = get_audio_graph()?;
+    let block_size = graph_mutex.lock().map_err(|e| e.to_string())?.plugin_block_size();
+    let sample_rate = crate::audio_file::TARGET_SAMPLE_RATE as f64;
+
+    VST3Host::configure_instance_pool(instances_per_class, max_classes, sample_rate, block_size as i32)
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Keep a plugin warm in the instance pool (e.g. a favourite instrument)
+pub fn pin_vst3_plugin(plugin_path: &str, pinned: bool) -> Result<(), String> {
+    crate::vst3_host::VST3Host::pin_pooled_plugin(plugin_path, pinned)
+}
+
 #[cfg(not(target_os = "ios"))]
 /// Get the number of parameters in a VST3 plugin
 pub fn get_vst3_parameter_count(effect_id: u64) -> Result<u32, String> {
@@ -90,7 +112,54 @@ pub fn get_vst3_parameter_info(effect_id: u64, param_index: u32) -> Result<Strin
         if let EffectType::VST3(vst3) = &*effect {
             let info = vst3.get_parameter_info(param_index as i32)?;
             // VST3 parameters are normalized 0.0-1.0
-            Ok(format!("{},0.0,1.0,0.5", info.title_str()))
+            Ok(format!("{},0.0,1.0,{}", info.title_str(), info.default_value))
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Get the metadata of every parameter of a VST3 plugin in one call.
+/// One line per parameter, in index order:
+/// "index,id,default,min,max,step_count,units,short_title,title"
+/// (default is normalized, min/max the plain range; title last since it
+/// may contain commas)
+pub fn get_vst3_parameter_catalog(effect_id: u64) -> Result<String, String> {
+    use crate::effects::EffectType;
+    use std::fmt::Write as _;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &*effect {
+            let catalog = vst3.get_parameter_catalog()?;
+            let mut result = String::with_capacity(catalog.len() * 64);
+            for (index, info) in catalog.iter().enumerate() {
+                if index > 0 {
+                    result.push('\n');
+                }
+                let _ = write!(
+                    result,
+                    "{},{},{},{},{},{},{},{},{}",
+                    index,
+                    info.id,
+                    info.default_value,
+                    info.min_value,
+                    info.max_value,
+                    info.step_count,
+                    info.units_str(),
+                    info.short_title_str(),
+                    info.title_str()
+                );
+            }
+            Ok(result)
         } else {
             Err(format!("Effect {} is not a VST3 plugin", effect_id))
         }
@@ -121,6 +190,67 @@ pub fn get_vst3_parameter_value(effect_id: u64, param_index: u32) -> Result<f64,
     }
 }
 
+#[cfg(not(target_os = "ios"))]
+/// Drain parameter changes the plugin reported from its audio processing
+/// (meters, values learned by the processor) since the last poll.
+/// Returns (param_id, normalized value) pairs in the order they were produced.
+pub fn poll_vst3_parameter_changes(effect_id: u64) -> Result<Vec<(u32, f64)>, String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+
+    // Polled regularly by the UI, so pick up latency changes here too
+    graph.refresh_delay_compensation();
+
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &*effect {
+            Ok(vst3
+                .poll_parameter_changes()
+                .into_iter()
+                .map(|change| (change.id, change.value))
+                .collect())
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Drain the parameters the user edited in a VST3 plugin's own editor since
+/// the last poll, as (param_id, value, flags) with the latest value per
+/// parameter. flags are `VST3_EDIT_*` bits (value changed, gesture
+/// began/ended) for touch automation recording.
+pub fn poll_vst3_editor_changes(effect_id: u64) -> Result<Vec<(u32, f64, i32)>, String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &*effect {
+            Ok(vst3
+                .poll_editor_changes()
+                .into_iter()
+                .map(|change| (change.id, change.value, change.flags))
+                .collect())
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
 #[cfg(not(target_os = "ios"))]
 /// Set a VST3 parameter value (normalized 0.0-1.0)
 pub fn set_vst3_parameter_value(
@@ -148,6 +278,57 @@ pub fn set_vst3_parameter_value(
     }
 }
 
+#[cfg(not(target_os = "ios"))]
+/// Get the normalized values of many VST3 parameters (by parameter ID) in one call
+pub fn get_vst3_parameter_values(effect_id: u64, param_ids: Vec<u32>) -> Result<Vec<f64>, String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &*effect {
+            let mut values = vec![0.0; param_ids.len()];
+            vst3.get_parameter_values(&param_ids, &mut values)?;
+            Ok(values)
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Set many VST3 parameters (by parameter ID) in one call; each value also
+/// goes to the processor's parameter queue
+pub fn set_vst3_parameter_values(effect_id: u64, param_ids: Vec<u32>, values: Vec<f64>) -> Result<(), String> {
+    use crate::effects::EffectType;
+
+    if param_ids.len() != values.len() {
+        return Err(format!("{} parameter IDs but {} values", param_ids.len(), values.len()));
+    }
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let mut effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &mut *effect {
+            vst3.set_parameter_values(&param_ids, &values)
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
 // ============================================================================
 // M7: VST3 Editor Functions - Desktop only (not available on iOS)
 // ============================================================================
@@ -318,57 +499,115 @@ pub fn scan_vst3_plugins(directory_path: &str) -> Result<String, String> {
 }
 
 #[cfg(not(target_os = "ios"))]
-/// Scan standard system locations for VST3 plugins
+/// Serialize catalog records for the browser, one
+/// "name|path|vendor|is_instrument|is_effect" line each
+fn format_catalog_plugins(catalog: &crate::vst3_host::PluginCatalog, ids: &[u32]) -> String {
+    ids.iter()
+        .filter_map(|&id| catalog.entry(id))
+        .map(|entry| {
+            format!(
+                "{}|{}|{}|{}|{}",
+                entry.name,
+                entry.file_path,
+                entry.vendor,
+                if entry.is_instrument { "1" } else { "0" },
+                if entry.is_effect { "1" } else { "0" }
+            )
+        })
+        .collect::<Vec<_>>()
+        .join("\n")
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Scan standard system locations for VST3 plugins, then list every plugin
+/// in the catalog the scan wrote
 pub fn scan_vst3_plugins_standard() -> Result<String, String> {
-    use crate::vst3_host;
+    use crate::vst3_host::{self, PluginCatalog, VST3Host};
 
     eprintln!("🔍 [Rust API] Starting VST3 standard location scan...");
 
-    match vst3_host::scan_standard_locations() {
-        Ok(plugins) => {
-            eprintln!("✅ [Rust API] Scan returned {} plugins", plugins.len());
-
-            for (i, info) in plugins.iter().enumerate() {
-                let plugin_type = if info.is_instrument {
-                    "instrument"
-                } else if info.is_effect {
-                    "effect"
-                } else {
-                    "unknown"
-                };
-                eprintln!(
-                    "  Plugin {}: {} at {} [{}]",
-                    i + 1,
+    let count = VST3Host::scan_standard_locations(|_| {}).map_err(|e| {
+        eprintln!("❌ [Rust API] Scan failed: {}", e);
+        format!("Failed to scan VST3 plugins: {}", e)
+    })?;
+    eprintln!("✅ [Rust API] Scan returned {} plugins", count);
+
+    let result = match PluginCatalog::open() {
+        Some(catalog) => format_catalog_plugins(&catalog, catalog.all()),
+        // No cache location (no home directory): scan again the old way
+        None => vst3_host::scan_standard_locations()?
+            .iter()
+            .map(|info| {
+                format!(
+                    "{}|{}|{}|{}|{}",
                     info.name_str(),
                     info.file_path_str(),
-                    plugin_type
-                );
-            }
-
-            // Serialize with type information: name|path|vendor|is_instrument|is_effect
-            let plugin_list: Vec<String> = plugins
-                .iter()
-                .map(|info| {
-                    format!(
-                        "{}|{}|{}|{}|{}",
-                        info.name_str(),
-                        info.file_path_str(),
-                        info.vendor_str(),
-                        if info.is_instrument { "1" } else { "0" },
-                        if info.is_effect { "1" } else { "0" }
-                    )
-                })
-                .collect();
+                    info.vendor_str(),
+                    if info.is_instrument { "1" } else { "0" },
+                    if info.is_effect { "1" } else { "0" }
+                )
+            })
+            .collect::<Vec<_>>()
+            .join("\n"),
+    };
+    eprintln!("📦 [Rust API] Returning string: {} bytes", result.len());
+    Ok(result)
+}
 
-            let result = plugin_list.join("\n");
-            eprintln!("📦 [Rust API] Returning string: {} bytes", result.len());
-            Ok(result)
-        }
-        Err(e) => {
-            eprintln!("❌ [Rust API] Scan failed: {}", e);
-            Err(format!("Failed to scan VST3 plugins: {}", e))
+#[cfg(not(target_os = "ios"))]
+/// Plugins from the last scan's catalog matching every non-empty filter,
+/// without scanning. `kind` is "instrument" or "effect"; the name filter is
+/// a prefix. All filters ignore ASCII case. Same line format as
+/// `scan_vst3_plugins_standard`
+pub fn query_vst3_plugins(
+    vendor: &str,
+    subcategory: &str,
+    kind: &str,
+    name_prefix: &str,
+) -> Result<String, String> {
+    use crate::vst3_host::{intersect_ids, CatalogIndex, PluginCatalog};
+
+    let catalog = PluginCatalog::open().ok_or("No VST3 plugin catalog yet; scan for plugins first")?;
+
+    let mut filters = vec![catalog.name_prefix(name_prefix)];
+    for (index, key) in [
+        (CatalogIndex::Vendor, vendor),
+        (CatalogIndex::Subcategory, subcategory),
+        (CatalogIndex::Kind, kind),
+    ] {
+        if !key.is_empty() {
+            filters.push(catalog.find(index, key));
         }
     }
+
+    // Narrowest span first keeps every merge short
+    filters.sort_by_key(|ids| ids.len());
+    let mut ids = filters[0].to_vec();
+    for other in &filters[1..] {
+        ids = intersect_ids(&ids, other);
+    }
+    Ok(format_catalog_plugins(&catalog, &ids))
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Distinct vendors ("vendor") or subcategories ("subcategory") in the
+/// catalog, one "label|plugin count" line each, for browser filters
+pub fn get_vst3_plugin_filters(index: &str) -> Result<String, String> {
+    use crate::vst3_host::{CatalogIndex, PluginCatalog};
+
+    let index = match index {
+        "vendor" => CatalogIndex::Vendor,
+        "subcategory" => CatalogIndex::Subcategory,
+        other => return Err(format!("Unknown plugin filter: {}", other)),
+    };
+    let catalog = PluginCatalog::open().ok_or("No VST3 plugin catalog yet; scan for plugins first")?;
+
+    Ok(catalog
+        .groups(index)
+        .iter()
+        .map(|(label, ids)| format!("{}|{}", label, ids.len()))
+        .collect::<Vec<_>>()
+        .join("\n"))
 }
 
 // ============================================================================
@@ -471,6 +710,144 @@ pub fn set_vst3_state(effect_id: u64, data: &[u8]) -> Result<(), String> {
     }
 }
 
+#[cfg(not(target_os = "ios"))]
+/// Get a VST3 plugin's DSP load statistics
+/// (returns "calls,mean_us,p99_us,max_us,overruns,load")
+pub fn get_vst3_plugin_stats(effect_id: u64) -> Result<String, String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &*effect {
+            let stats = vst3.get_stats();
+            Ok(format!(
+                "{},{:.1},{:.1},{:.1},{},{:.4}",
+                stats.process_calls, stats.mean_us, stats.p99_us, stats.max_us, stats.overruns, stats.load
+            ))
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Report the VST3 plugins with the highest p99 process() time, worst first.
+/// One line per plugin: "effect_id,name,calls,mean_us,p99_us,max_us,overruns,load"
+pub fn get_vst3_dsp_load_report(limit: usize) -> Result<String, String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    let mut rows = Vec::new();
+    for effect_id in effect_manager.get_all_effect_ids() {
+        if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+            let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+            if let EffectType::VST3(vst3) = &*effect {
+                rows.push((effect_id, vst3.get_name().to_string(), vst3.get_stats()));
+            }
+        }
+    }
+
+    rows.sort_by(|a, b| b.2.p99_us.total_cmp(&a.2.p99_us));
+    rows.truncate(limit);
+
+    Ok(rows
+        .iter()
+        .map(|(effect_id, name, stats)| {
+            format!(
+                "{},{},{},{:.1},{:.1},{:.1},{},{:.4}",
+                effect_id, name, stats.process_calls, stats.mean_us, stats.p99_us, stats.max_us,
+                stats.overruns, stats.load
+            )
+        })
+        .collect::<Vec<_>>()
+        .join("\n"))
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Start every VST3 plugin's DSP load statistics over
+pub fn reset_vst3_plugin_stats() -> Result<(), String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    for effect_id in effect_manager.get_all_effect_ids() {
+        if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+            let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+            if let EffectType::VST3(vst3) = &*effect {
+                vst3.reset_stats();
+            }
+        }
+    }
+    Ok(())
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Load the plugin bundle at `plugin_path` in its own helper process from
+/// now on (or in-process again). Effects already on a track keep running
+/// where they are until they're re-added or the project is reloaded
+pub fn set_vst3_plugin_bridged(plugin_path: &str, bridged: bool) -> Result<(), String> {
+    crate::vst3_host::VST3Host::set_plugin_bridged(plugin_path, bridged)
+}
+
+#[cfg(not(target_os = "ios"))]
+/// Whether a VST3 effect runs in a bridge helper process
+pub fn is_vst3_effect_bridged(effect_id: u64) -> Result<bool, String> {
+    use crate::effects::EffectType;
+
+    let graph_mutex = get_audio_graph()?;
+    let graph = graph_mutex.lock().map_err(|e| e.to_string())?;
+    let effect_manager = graph.effect_manager.lock().map_err(|e| e.to_string())?;
+
+    if let Some(effect_arc) = effect_manager.get_effect(effect_id) {
+        let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+
+        if let EffectType::VST3(vst3) = &*effect {
+            Ok(vst3.is_bridged())
+        } else {
+            Err(format!("Effect {} is not a VST3 plugin", effect_id))
+        }
+    } else {
+        Err(format!("Effect {} not found", effect_id))
+    }
+}
+
+#[cfg(target_os = "ios")]
+pub fn get_vst3_plugin_stats(_effect_id: u64) -> Result<String, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn get_vst3_dsp_load_report(_limit: usize) -> Result<String, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn reset_vst3_plugin_stats() -> Result<(), String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn set_vst3_plugin_bridged(_plugin_path: &str, _bridged: bool) -> Result<(), String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn is_vst3_effect_bridged(_effect_id: u64) -> Result<bool, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
 #[cfg(target_os = "ios")]
 pub fn get_vst3_state(_effect_id: u64) -> Result<Vec<u8>, String> {
     Err("VST3 plugins are not supported on iOS".to_string())
@@ -500,11 +877,36 @@ pub fn get_vst3_parameter_info(_effect_id: u64, _param_index: u32) -> Result<Str
     Err("VST3 plugins are not supported on iOS".to_string())
 }
 
+#[cfg(target_os = "ios")]
+pub fn get_vst3_parameter_catalog(_effect_id: u64) -> Result<String, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
 #[cfg(target_os = "ios")]
 pub fn get_vst3_parameter_value(_effect_id: u64, _param_index: u32) -> Result<f64, String> {
     Err("VST3 plugins are not supported on iOS".to_string())
 }
 
+#[cfg(target_os = "ios")]
+pub fn poll_vst3_parameter_changes(_effect_id: u64) -> Result<Vec<(u32, f64)>, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn poll_vst3_editor_changes(_effect_id: u64) -> Result<Vec<(u32, f64, i32)>, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn get_vst3_parameter_values(_effect_id: u64, _param_ids: Vec<u32>) -> Result<Vec<f64>, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn set_vst3_parameter_values(_effect_id: u64, _param_ids: Vec<u32>, _values: Vec<f64>) -> Result<(), String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
 #[cfg(target_os = "ios")]
 pub fn set_vst3_parameter_value(
     _effect_id: u64,
@@ -551,3 +953,28 @@ pub fn scan_vst3_plugins(_directory_path: &str) -> Result<String, String> {
 pub fn scan_vst3_plugins_standard() -> Result<String, String> {
     Err("VST3 plugins are not supported on iOS".to_string())
 }
+
+#[cfg(target_os = "ios")]
+pub fn configure_vst3_instance_pool(_instances_per_class: usize, _max_classes: usize) -> Result<(), String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn pin_vst3_plugin(_plugin_path: &str, _pinned: bool) -> Result<(), String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn query_vst3_plugins(
+    _vendor: &str,
+    _subcategory: &str,
+    _kind: &str,
+    _name_prefix: &str,
+) -> Result<String, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
+
+#[cfg(target_os = "ios")]
+pub fn get_vst3_plugin_filters(_index: &str) -> Result<String, String> {
+    Err("VST3 plugins are not supported on iOS".to_string())
+}
@@ -5,13 +5,23 @@ use crate::recorder::Recorder;
 use crate::midi::MidiClip;
 use crate::midi_input::MidiInputManager;
 use crate::midi_recorder::MidiRecorder;
-use crate::synth::TrackSynthManager;
-use crate::track::{ClipId, TimelineClip, TimelineMidiClip, TrackId, TrackManager};  // Import from track module
-use crate::effects::{Effect, EffectManager, Limiter};  // Import from effects module
+use crate::synth::{Synth, TrackSynthManager};
+use crate::track::{ClipId, FrozenTrack, TimelineClip, TimelineMidiClip, TrackId, TrackManager, TrackType};  // Import from track module
+use crate::effects::{Effect, EffectManager, EffectType, Limiter, ParkedEffect};  // Import from effects module
+use crate::delay_compensation::{DelayCompensation, RoutedTrack};
+use crate::fx_chains::{process_chain, resolve_chain, ChainEffect, ChainPublisher, ChainSnapshot};
+use crate::mix_graph::{MixGraph, MixNode, MixOutput};
+use crate::render_ahead::{
+    ahead_ring, AheadBlock, AheadReader, AheadTable, AheadTablePublisher, AheadTrack, AheadWriter,
+    RenderAheadState, MAX_RENDER_AHEAD_MS,
+    RENDER_AHEAD_BLOCK_FRAMES,
+};
+use crate::callback_telemetry::{lock_charged, CallbackStage, CallbackTelemetry};
+use crate::work_pool::WorkStealingPool;
 use cpal::traits::{DeviceTrait, HostTrait, StreamTrait};
 use std::collections::HashMap;
 use std::sync::{Arc, Mutex};
-use std::sync::atomic::{AtomicBool, AtomicU8, AtomicU64, Ordering};
+use std::sync::atomic::{AtomicU8, AtomicU64, Ordering};
 
 /// Transport state
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -70,6 +80,212 @@ impl BufferSizePreset {
     }
 }
 
+/// Block size used for offline rendering (export). Plugins are switched
+/// into offline mode with this as their max block size for the render
+pub const OFFLINE_BLOCK_SIZE: usize = 8192;
+
+/// Silence rendered past a frozen track's last clip, for effect tails
+pub const FREEZE_TAIL_SECONDS: f64 = 4.0;
+
+/// Longest `play()` waits for render-ahead tracks to have audio ready
+const RENDER_AHEAD_PRIME_TIMEOUT_MS: u64 = 150;
+
+/// How often the render-ahead thread re-checks which tracks it renders
+const RENDER_AHEAD_SCAN_INTERVAL_MS: u64 = 250;
+
+/// Scratch buffers used by the audio callback for block-based processing.
+/// Owned by the callback closure and grown to the largest buffer the device
+/// hands us, so steady-state callbacks don't allocate.
+#[derive(Default)]
+struct BlockBuffers {
+    track_left: Vec<f32>,
+    track_right: Vec<f32>,
+    mix_left: Vec<f32>,
+    mix_right: Vec<f32>,
+    met_left: Vec<f32>,
+    met_right: Vec<f32>,
+    /// Captured input, read a block at a time
+    input_left: Vec<f32>,
+    input_right: Vec<f32>,
+    /// One block per track for the parallel mix, indexed like the MixGraph
+    tracks: Vec<TrackBlock>,
+}
+
+/// A track's block in the parallel mix. Buses receive their inputs here
+/// before their own task runs
+#[derive(Default)]
+struct TrackBlock {
+    left: Vec<f32>,
+    right: Vec<f32>,
+}
+
+impl BlockBuffers {
+    fn ensure(&mut self, frames: usize) {
+        if self.track_left.len() < frames {
+            for buf in [
+                &mut self.track_left, &mut self.track_right,
+                &mut self.mix_left, &mut self.mix_right,
+                &mut self.met_left, &mut self.met_right,
+                &mut self.input_left, &mut self.input_right,
+            ] {
+                buf.resize(frames, 0.0);
+            }
+        }
+    }
+
+    /// Make room for `count` track blocks of `frames` and zero them
+    fn ensure_tracks(&mut self, count: usize, frames: usize) {
+        if self.tracks.len() < count {
+            self.tracks.resize_with(count, TrackBlock::default);
+        }
+        for block in &mut self.tracks[..count] {
+            if block.left.len() < frames {
+                block.left.resize(frames, 0.0);
+                block.right.resize(frames, 0.0);
+            }
+            block.left[..frames].fill(0.0);
+            block.right[..frames].fill(0.0);
+        }
+    }
+}
+
+/// A track's mixer state for one callback, copied under the track lock so
+/// the mix itself runs without touching the TrackManager
+struct TrackSnapshot {
+    id: u64,
+    track_type: TrackType,
+    parent_group: Option<TrackId>,
+    sends: Vec<crate::track::Send>,
+    audio_clips: Vec<TimelineClip>,
+    midi_clips: Vec<TimelineMidiClip>,
+    volume_gain: f32,
+    pan_left: f32,
+    pan_right: f32,
+    muted: bool,
+    soloed: bool,
+    fx_chain: Vec<u64>,
+}
+
+impl TrackSnapshot {
+    fn capture(track: &crate::track::Track) -> Self {
+        let (pan_left, pan_right) = track.get_pan_gains();
+        Self {
+            id: track.id,
+            track_type: track.track_type,
+            parent_group: track.parent_group,
+            sends: track.sends.clone(),
+            audio_clips: track.playback_audio_clips().to_vec(),
+            midi_clips: track.playback_midi_clips().to_vec(),
+            volume_gain: track.get_gain(),
+            pan_left,
+            pan_right,
+            muted: track.mute,
+            soloed: track.solo,
+            fx_chain: track.fx_chain.clone(),
+        }
+    }
+
+    /// Capture `track` into this snapshot, reusing its Vecs (audio callback)
+    fn recapture(&mut self, track: &crate::track::Track) {
+        let (pan_left, pan_right) = track.get_pan_gains();
+        self.id = track.id;
+        self.track_type = track.track_type;
+        self.parent_group = track.parent_group;
+        self.sends.clone_from(&track.sends);
+        self.audio_clips.clear();
+        self.audio_clips.extend_from_slice(track.playback_audio_clips());
+        self.midi_clips.clear();
+        self.midi_clips.extend_from_slice(track.playback_midi_clips());
+        self.volume_gain = track.get_gain();
+        self.pan_left = pan_left;
+        self.pan_right = pan_right;
+        self.muted = track.mute;
+        self.soloed = track.solo;
+        self.fx_chain.clone_from(&track.fx_chain);
+    }
+}
+
+impl MixNode for TrackSnapshot {
+    fn id(&self) -> TrackId {
+        self.id
+    }
+
+    fn track_type(&self) -> TrackType {
+        self.track_type
+    }
+
+    fn parent_group(&self) -> Option<TrackId> {
+        self.parent_group
+    }
+
+    fn sends(&self) -> &[crate::track::Send] {
+        &self.sends
+    }
+}
+
+/// The callback's track snapshots, kept between callbacks so capturing
+/// an unchanged session doesn't allocate
+#[derive(Default)]
+struct SnapshotBuffers {
+    tracks: Vec<TrackSnapshot>,
+    count: usize,
+    master: Option<TrackSnapshot>,
+    has_master: bool,
+}
+
+impl SnapshotBuffers {
+    fn begin(&mut self) {
+        self.count = 0;
+        self.has_master = false;
+    }
+
+    fn capture(&mut self, track: &crate::track::Track) {
+        if track.track_type == TrackType::Master {
+            match self.master.as_mut() {
+                Some(master) => master.recapture(track),
+                None => self.master = Some(TrackSnapshot::capture(track)),
+            }
+            self.has_master = true;
+            return;
+        }
+        match self.tracks.get_mut(self.count) {
+            Some(snap) => snap.recapture(track),
+            None => self.tracks.push(TrackSnapshot::capture(track)),
+        }
+        self.count += 1;
+    }
+
+    /// Non-master tracks captured since `begin`
+    fn tracks(&self) -> &[TrackSnapshot] {
+        &self.tracks[..self.count]
+    }
+
+    fn master(&self) -> Option<&TrackSnapshot> {
+        self.master.as_ref().filter(|_| self.has_master)
+    }
+}
+
+/// Move an emptied task list's allocation to a list with another lifetime.
+/// The tasks borrow from the callback's locals, so the list can't be kept
+/// between callbacks as is; collecting an empty `IntoIter` into a Vec of
+/// the same layout reuses its buffer
+fn recycle_tasks<'a>(mut tasks: Vec<Mutex<TrackTask<'_>>>) -> Vec<Mutex<TrackTask<'a>>> {
+    tasks.clear();
+    tasks.into_iter().map(|_| unreachable!()).collect()
+}
+
+/// Everything one track's task touches in the parallel mix. Each task
+/// locks only its own (uncontended); the routing pass between levels
+/// locks a track and the bus it feeds
+struct TrackTask<'a> {
+    block: &'a mut TrackBlock,
+    synth: Option<&'a mut Synth>,
+    /// FX chain in order, from the chain snapshot of this block
+    effects: &'a [ChainEffect],
+    /// Set if the track is rendered ahead: read this instead of processing
+    ahead: Option<&'a Mutex<AheadReader>>,
+}
+
 /// The main audio graph that manages playback
 pub struct AudioGraph {
     /// All audio clips on the timeline (legacy - will migrate to tracks)
@@ -97,6 +313,8 @@ pub struct AudioGraph {
     pub track_manager: Arc<Mutex<TrackManager>>,
     /// Effect manager (handles all effect instances)
     pub effect_manager: Arc<Mutex<EffectManager>>,
+    /// FX chains as published to the audio callback (see fx_chains.rs)
+    fx_chains: ChainPublisher,
     /// Master limiter (prevents clipping)
     pub master_limiter: Arc<Mutex<Limiter>>,
 
@@ -104,11 +322,25 @@ pub struct AudioGraph {
     /// Per-track synthesizer manager
     pub track_synth_manager: Arc<Mutex<TrackSynthManager>>,
 
+    // --- Plugin Delay Compensation ---
+    /// Per-track delay lines that line up tracks with different FX latency
+    pub delay_compensation: Arc<Mutex<DelayCompensation>>,
+    /// Worker threads that process independent tracks in parallel
+    track_pool: Arc<WorkStealingPool>,
+
+    // --- Render-ahead ---
+    /// Settings and per-track rings for tracks rendered ahead of the playhead
+    render_ahead: Arc<RenderAheadState>,
+    /// Background thread filling the render-ahead rings (started on first enable)
+    render_ahead_thread: Option<std::thread::JoinHandle<()>>,
+
     // --- Latency Control ---
     /// Preferred buffer size for audio output
     preferred_buffer_size: Arc<Mutex<BufferSizePreset>>,
     /// Actual buffer size being used (set by audio callback)
     actual_buffer_size: Arc<std::sync::atomic::AtomicU32>,
+    /// Per-callback duration, lock waits and xruns
+    callback_telemetry: Arc<CallbackTelemetry>,
 }
 
 // SAFETY: AudioGraph is only accessed through a Mutex in the API layer,
@@ -116,6 +348,15 @@ pub struct AudioGraph {
 // The stream is created and used only within the context of the Mutex lock.
 unsafe impl Send for AudioGraph {}
 
+impl Drop for AudioGraph {
+    fn drop(&mut self) {
+        self.render_ahead.shutdown.store(true, Ordering::SeqCst);
+        if let Some(thread) = self.render_ahead_thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
 impl AudioGraph {
     /// Create a new audio graph
     pub fn new() -> anyhow::Result<Self> {
@@ -148,10 +389,16 @@ impl AudioGraph {
             midi_recorder: Arc::new(Mutex::new(midi_recorder)),
             track_manager: Arc::new(Mutex::new(track_manager)),
             effect_manager: Arc::new(Mutex::new(effect_manager)),
+            fx_chains: ChainPublisher::new(),
             master_limiter: Arc::new(Mutex::new(master_limiter)),
             track_synth_manager: Arc::new(Mutex::new(TrackSynthManager::new(TARGET_SAMPLE_RATE as f32))),
+            delay_compensation: Arc::new(Mutex::new(DelayCompensation::new())),
+            track_pool: Arc::new(WorkStealingPool::with_default_workers()),
+            render_ahead: Arc::new(RenderAheadState::new()),
+            render_ahead_thread: None,
             preferred_buffer_size: Arc::new(Mutex::new(BufferSizePreset::Balanced)),
             actual_buffer_size: Arc::new(std::sync::atomic::AtomicU32::new(0)),
+            callback_telemetry: Arc::new(CallbackTelemetry::new()),
         };
 
         // Create audio stream immediately (prevents deadlock on first play)
@@ -329,6 +576,11 @@ impl AudioGraph {
         // Simple conversion: seconds to samples (no tempo scaling)
         let samples = (position_seconds * TARGET_SAMPLE_RATE as f64) as u64;
         self.playhead_samples.store(samples, Ordering::SeqCst);
+
+        // Start rendering ahead from the new position right away
+        if self.render_ahead.enabled.load(Ordering::Relaxed) {
+            self.render_ahead.restart_all(samples);
+        }
     }
 
     /// Get current transport state
@@ -343,6 +595,7 @@ impl AudioGraph {
         if current == TransportState::Playing as u8 {
             return Ok(()); // Already playing
         }
+        self.prime_render_ahead();
         self.state.store(TransportState::Playing as u8, Ordering::SeqCst);
 
         // Stream is always running (for MIDI preview) - no need to start/stop it
@@ -375,7 +628,7 @@ impl AudioGraph {
                                     if let crate::effects::EffectType::VST3(ref mut vst3) = *effect {
                                         // Send note-off for all 128 MIDI notes
                                         for note in 0..128i32 {
-                                            let _ = vst3.process_midi_event(1, 0, note, 0, 0);
+                                            let _ = vst3.try_process_midi_event(1, 0, note, 0, 0);
                                         }
                                     }
                                 }
@@ -415,7 +668,7 @@ impl AudioGraph {
                                     if let crate::effects::EffectType::VST3(ref mut vst3) = *effect {
                                         // Send note-off for all 128 MIDI notes
                                         for note in 0..128i32 {
-                                            let _ = vst3.process_midi_event(1, 0, note, 0, 0);
+                                            let _ = vst3.try_process_midi_event(1, 0, note, 0, 0);
                                         }
                                     }
                                 }
@@ -456,9 +709,46 @@ impl AudioGraph {
         // Restart the audio stream with new buffer size
         self.restart_audio_stream()?;
 
+        // Let plugins take a device block in one process() call
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        self.reconfigure_plugins();
+
         Ok(())
     }
 
+    /// Max block size plugins are set up for: the preferred buffer size,
+    /// and never below 512 frames
+    pub fn plugin_block_size(&self) -> usize {
+        self.get_buffer_size_preset().samples().max(512) as usize
+    }
+
+    /// Move every VST3 plugin on a track to the current sample rate and
+    /// plugin block size. Plugins already there cost nothing
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    fn reconfigure_plugins(&self) {
+        let sample_rate = TARGET_SAMPLE_RATE as f64;
+        let block_size = self.plugin_block_size() as i32;
+        // Collect first: the callback needs the track manager every block
+        let mut effects = Vec::new();
+        if let (Ok(track_mgr), Ok(effect_mgr)) = (self.track_manager.lock(), self.effect_manager.lock()) {
+            for track_arc in track_mgr.get_all_tracks() {
+                if let Ok(track) = track_arc.lock() {
+                    effects.extend(track.fx_chain.iter().filter_map(|id| effect_mgr.get_effect(*id)));
+                }
+            }
+        }
+
+        for effect_arc in effects {
+            if let Ok(mut effect) = effect_arc.lock() {
+                if let crate::effects::EffectType::VST3(ref mut vst3) = *effect {
+                    if let Err(e) = vst3.reconfigure(sample_rate, block_size) {
+                        eprintln!("⚠️  [AudioGraph] Plugin reconfigure failed: {}", e);
+                    }
+                }
+            }
+        }
+    }
+
     /// Get the current buffer size preset
     pub fn get_buffer_size_preset(&self) -> BufferSizePreset {
         *self.preferred_buffer_size.lock().expect("mutex poisoned")
@@ -488,6 +778,189 @@ impl AudioGraph {
         (buffer_samples, input_latency_ms, output_latency_ms, total_roundtrip_ms)
     }
 
+    // --- Plugin Delay Compensation ---
+
+    /// Publish the FX chains to the audio callback and line up their
+    /// latencies. Call after anything that changes a chain
+    /// (add/remove/bypass/reorder, loading, freezing)
+    pub fn fx_chains_changed(&self) {
+        self.publish_fx_chains();
+        self.update_delay_compensation();
+    }
+
+    /// Snapshot every track's FX chain for the audio callback. It switches
+    /// over at its next block; effects dropped from the chains are unloaded
+    /// on the reclaim thread once it has
+    pub fn publish_fx_chains(&self) {
+        let snapshot = {
+            let tm = self.track_manager.lock().expect("mutex poisoned");
+            let effect_mgr = self.effect_manager.lock().expect("mutex poisoned");
+            ChainSnapshot::capture(&tm, &effect_mgr)
+        };
+        self.fx_chains.publish(snapshot);
+    }
+
+    /// Recompute every track's FX chain latency and resize the delay lines
+    /// (see `fx_chains_changed`)
+    pub fn update_delay_compensation(&self) {
+        self.configure_delay_compensation(true);
+    }
+
+    /// Update delay compensation if a plugin reported a latency change since
+    /// the last update, re-reading only the chains whose plugins reported one.
+    /// Cheap enough to call on every UI poll
+    pub fn refresh_delay_compensation(&self) {
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        {
+            let count = crate::vst3_host::VST3Host::latency_change_count();
+            let seen = self.delay_compensation.lock().expect("mutex poisoned").latency_change_count;
+            if count != seen {
+                eprintln!("⏱️ [AudioGraph] Plugin latency changed, updating delay compensation");
+                self.configure_delay_compensation(false);
+            }
+        }
+    }
+
+    /// Resize the delay lines for the current routing. Unless `requery_all`,
+    /// a chain's latency is only read again when its change count moved
+    fn configure_delay_compensation(&self, requery_all: bool) {
+        let known: HashMap<TrackId, (u32, u32)> = if requery_all {
+            HashMap::new()
+        } else {
+            let pdc = self.delay_compensation.lock().expect("mutex poisoned");
+            pdc.tracks().map(|(id, track)| (id, (track.chain_latency, track.latency_changes))).collect()
+        };
+        // Read before the per-plugin counts, so a change in between is seen next time
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let change_count = crate::vst3_host::VST3Host::latency_change_count();
+
+        let routing: Vec<RoutedTrack> = {
+            let tm = self.track_manager.lock().expect("mutex poisoned");
+            let effect_mgr = self.effect_manager.lock().expect("mutex poisoned");
+            tm.get_all_tracks()
+                .iter()
+                .filter_map(|track_arc| {
+                    let track = track_arc.lock().ok()?;
+                    // Everything passes through the master, so it needs no compensation
+                    if track.track_type == crate::track::TrackType::Master {
+                        return None;
+                    }
+                    let latency_changes = effect_mgr.chain_latency_changes(&track.fx_chain);
+                    let chain_latency = match known.get(&track.id) {
+                        Some(&(latency, changes)) if changes == latency_changes => latency,
+                        _ => effect_mgr.chain_latency(&track.fx_chain),
+                    };
+                    Some(RoutedTrack {
+                        id: track.id,
+                        track_type: track.track_type,
+                        parent_group: track.parent_group,
+                        sends: track.sends.clone(),
+                        chain_latency,
+                        latency_changes,
+                    })
+                })
+                .collect()
+        };
+
+        let mut pdc = self.delay_compensation.lock().expect("mutex poisoned");
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        {
+            pdc.latency_change_count = change_count;
+        }
+        pdc.configure_routed(&routing);
+    }
+
+    /// Turn plugin delay compensation on or off
+    pub fn set_delay_compensation_enabled(&self, enabled: bool) {
+        self.delay_compensation
+            .lock()
+            .expect("mutex poisoned")
+            .set_enabled(enabled);
+    }
+
+    /// Get (chain_latency, compensation) in samples for a track
+    pub fn get_track_delay_compensation(&self, track_id: TrackId) -> Option<(u32, u32)> {
+        let pdc = self.delay_compensation.lock().expect("mutex poisoned");
+        pdc.track(track_id)
+            .map(|track| (track.chain_latency, track.compensation()))
+    }
+
+    // --- Render-ahead ---
+
+    /// Turn render-ahead on or off. Tracks that aren't armed or monitored
+    /// (and have an FX chain but no built-in synth) are then rendered
+    /// `lead_ms` ahead of the playhead on a background thread
+    pub fn set_render_ahead(&mut self, enabled: bool, lead_ms: u32) {
+        let min_lead_ms = (RENDER_AHEAD_BLOCK_FRAMES as u64 * 1000 / TARGET_SAMPLE_RATE as u64) as u32 + 1;
+        let lead_ms = lead_ms.clamp(min_lead_ms, MAX_RENDER_AHEAD_MS);
+        self.render_ahead.lead_ms.store(lead_ms, Ordering::Relaxed);
+        self.render_ahead.enabled.store(enabled, Ordering::SeqCst);
+        self.render_ahead.config_generation.fetch_add(1, Ordering::SeqCst);
+
+        if enabled && self.render_ahead_thread.is_none() {
+            let context = RenderAheadContext {
+                render_ahead: self.render_ahead.clone(),
+                transport: self.state.clone(),
+                playhead_samples: self.playhead_samples.clone(),
+                track_manager: self.track_manager.clone(),
+                effect_manager: self.effect_manager.clone(),
+                track_synth_manager: self.track_synth_manager.clone(),
+                #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+                recorder: self.recorder.get_callback_refs(),
+            };
+            match std::thread::Builder::new()
+                .name("render-ahead".to_string())
+                .spawn(move || render_ahead_loop(context))
+            {
+                Ok(handle) => self.render_ahead_thread = Some(handle),
+                Err(e) => eprintln!("❌ [AudioGraph] Failed to start render-ahead thread: {}", e),
+            }
+        }
+        eprintln!(
+            "🎚️ [AudioGraph] Render-ahead {} ({}ms lead)",
+            if enabled { "enabled" } else { "disabled" },
+            lead_ms
+        );
+    }
+
+    /// Returns: (enabled, lead_ms, tracks rendered ahead, total underruns)
+    pub fn get_render_ahead_info(&self) -> (bool, u32, usize, u32) {
+        let (tracks, underruns) = self.render_ahead.stats();
+        (
+            self.render_ahead.enabled.load(Ordering::Relaxed),
+            self.render_ahead.lead_ms.load(Ordering::Relaxed),
+            tracks,
+            underruns,
+        )
+    }
+
+    /// Output callback duration, lock-wait and xrun telemetry
+    pub fn callback_telemetry(&self) -> &CallbackTelemetry {
+        &self.callback_telemetry
+    }
+
+    /// Restart the render-ahead streams at the playhead and give the render
+    /// thread a moment to take over its tracks and fill their rings before
+    /// the transport starts moving
+    fn prime_render_ahead(&self) {
+        if !self.render_ahead.enabled.load(Ordering::Relaxed) {
+            return;
+        }
+        let playhead = self.playhead_samples.load(Ordering::SeqCst);
+        self.render_ahead.primed.store(false, Ordering::SeqCst);
+        self.render_ahead.priming.store(true, Ordering::SeqCst);
+        self.render_ahead.restart_all(playhead);
+
+        let deadline = std::time::Instant::now() + std::time::Duration::from_millis(RENDER_AHEAD_PRIME_TIMEOUT_MS);
+        while std::time::Instant::now() < deadline {
+            if self.render_ahead.primed.load(Ordering::SeqCst) {
+                break;
+            }
+            std::thread::sleep(std::time::Duration::from_millis(2));
+        }
+        self.render_ahead.priming.store(false, Ordering::SeqCst);
+    }
+
     /// Restart the audio stream (used when changing buffer size)
     fn restart_audio_stream(&mut self) -> anyhow::Result<()> {
         // Stop current stream
@@ -554,90 +1027,99 @@ impl AudioGraph {
 
         // Clone for tracking actual buffer size in callback
         let actual_buffer_size = self.actual_buffer_size.clone();
+        let callback_telemetry = self.callback_telemetry.clone();
+        let device_sample_rate = config.sample_rate.0;
 
         // Clone Arcs for the audio callback
-        let clips = self.clips.clone();
-        let midi_clips = self.midi_clips.clone();
         let playhead_samples = self.playhead_samples.clone();
         let state = self.state.clone();
-        let input_manager = self.input_manager.clone();
+        let mut input_reader = self.input_manager.lock().expect("mutex poisoned").block_reader();
         let recorder_refs = self.recorder.get_callback_refs();
 
-        // M4: Clone track and effect managers
+        // M4: Clone track manager (FX chains come from `fx_chains`)
         let track_manager = self.track_manager.clone();
-        let effect_manager = self.effect_manager.clone();
         let master_limiter = self.master_limiter.clone();
 
         // M6: Clone track synth manager
         let track_synth_manager = self.track_synth_manager.clone();
 
+        // Per-track delay compensation
+        let delay_compensation = self.delay_compensation.clone();
+
+        // Parallel mixing: shared worker pool, routing graph owned by the callback
+        let track_pool = self.track_pool.clone();
+        let mut mix_graph = MixGraph::new();
+        let mut ahead_tables = self.render_ahead.table_reader();
+
+        // FX chains, published by the UI thread without touching the
+        // locks the callback takes
+        let mut fx_chains = self.fx_chains.reader();
+
+        // Block scratch owned by the callback
+        let mut blocks = BlockBuffers::default();
+        let mut snapshots = SnapshotBuffers::default();
+        let mut task_storage: Vec<Mutex<TrackTask<'static>>> = Vec::new();
+        let mut track_peaks: Vec<Option<(f32, f32)>> = Vec::new();
+
+        // Plugins' ProcessContext, computed once per callback
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let mut transport = crate::vst3_host::TransportContext::new();
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let mut continuous_samples: i64 = 0;
+
         let stream = device.build_output_stream(
             &config,
             move |data: &mut [f32], _: &cpal::OutputCallbackInfo| {
+                // Flush denormals and raise scheduling (a no-op after the
+                // first callback on this thread)
+                #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+                crate::vst3_host::VST3Host::prepare_realtime_thread();
+
                 // Track actual buffer size (frames = samples / 2 for stereo)
                 let frames = data.len() / 2;
                 actual_buffer_size.store(frames as u32, Ordering::Relaxed);
+                if frames == 0 {
+                    return;
+                }
+                let telemetry = &*callback_telemetry;
+                let _telemetry =
+                    telemetry.begin(frames, device_sample_rate, playhead_samples.load(Ordering::Relaxed));
+                blocks.ensure(frames);
 
                 // Check if we should be playing (lock-free atomic read)
                 let is_playing = state.load(Ordering::SeqCst) == TransportState::Playing as u8;
 
+                #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+                let _transport = {
+                    transport.update(&block_transport(
+                        &recorder_refs,
+                        playhead_samples.load(Ordering::SeqCst),
+                        continuous_samples,
+                        is_playing,
+                        transport.state(),
+                        Some(telemetry),
+                    ));
+                    continuous_samples += frames as i64;
+                    transport.bind()
+                };
+
                 if !is_playing {
                     // Even when not playing, we might be recording or using virtual piano
                     // Process metronome, recording, AND synths (for real-time MIDI input)
                     // but DON'T advance playhead or trigger MIDI clips from timeline
 
-                    // Debug: log that we're in stopped callback (once)
-                    static LOGGED_STOPPED: AtomicBool = AtomicBool::new(false);
-                    if !LOGGED_STOPPED.swap(true, Ordering::Relaxed) {
-                        eprintln!("🔇 Audio callback: NOT PLAYING branch active");
-                    }
-
-                    // Log channel info once
-                    static LOGGED_CHANNELS: AtomicBool = AtomicBool::new(false);
-
                     // Lock synth manager once for the entire buffer
-                    let mut synth_guard = track_synth_manager.lock().ok();
+                    let mut synth_guard = telemetry.lock(CallbackStage::SynthManager, &track_synth_manager).ok();
 
-                    // Debug: log if we got the lock
-                    static LOGGED_LOCK: AtomicBool = AtomicBool::new(false);
-                    if !LOGGED_LOCK.swap(true, Ordering::Relaxed) {
-                        eprintln!("🔇 Synth guard acquired: {}", synth_guard.is_some());
-                    }
+                    // Input for the whole block (if recording), from the capture ring
+                    let input_left = &mut blocks.input_left[..frames];
+                    let input_right = &mut blocks.input_right[..frames];
+                    input_reader.read_block(input_left, input_right);
 
                     for frame_idx in 0..frames {
-                        // Get input samples (if recording)
-                        let (input_left, input_right) = if let Ok(input_mgr) = input_manager.lock() {
-                            let channels = input_mgr.get_input_channels();
-
-                            // Log once for debugging
-                            if !LOGGED_CHANNELS.swap(true, Ordering::Relaxed) {
-                                eprintln!("🔊 [AudioGraph] Reading input with {} channels", channels);
-                            }
-
-                            if channels == 1 {
-                                // Mono input: read 1 sample and duplicate to both channels
-                                if let Some(samples) = input_mgr.read_samples(1) {
-                                    let mono_sample = samples.get(0).copied().unwrap_or(0.0);
-                                    (mono_sample, mono_sample)
-                                } else {
-                                    (0.0, 0.0)
-                                }
-                            } else {
-                                // Stereo input: read 2 samples
-                                if let Some(samples) = input_mgr.read_samples(2) {
-                                    (samples.get(0).copied().unwrap_or(0.0),
-                                     samples.get(1).copied().unwrap_or(0.0))
-                                } else {
-                                    (0.0, 0.0)
-                                }
-                            }
-                        } else {
-                            // Failed to acquire input manager lock - audio samples will be dropped
-                            (0.0, 0.0)
-                        };
-
                         // Process recording and get metronome output
-                        let (met_left, met_right) = recorder_refs.process_frame(input_left, input_right, false);
+                        let (met_left, met_right) =
+                            recorder_refs.process_frame(input_left[frame_idx], input_right[frame_idx], false);
 
                         // Process synths for real-time MIDI input (virtual piano)
                         // This allows synths to produce sound from real-time note_on/note_off calls
@@ -647,114 +1129,74 @@ impl AudioGraph {
                             synth_output = synth_manager.process_all_synths();
                         }
 
-                        // Debug: log if synth is producing output (only first frame to avoid spam)
-                        if frame_idx == 0 && synth_output.abs() > 0.001 {
-                            static LAST_LOG: std::sync::atomic::AtomicU64 = std::sync::atomic::AtomicU64::new(0);
-                            let now = std::time::SystemTime::now()
-                                .duration_since(std::time::UNIX_EPOCH)
-                                .unwrap_or_default()
-                                .as_millis() as u64;
-                            let last = LAST_LOG.load(Ordering::Relaxed);
-                            if now - last > 100 { // Log every 100ms max
-                                LAST_LOG.store(now, Ordering::Relaxed);
-                                eprintln!("🔊 Synth output (stopped): {:.4}", synth_output);
-                            }
-                        }
-
                         // Start with metronome + synth (synth handles virtual keyboard when stopped)
-                        let mut out_left = met_left + synth_output;
-                        let mut out_right = met_right + synth_output;
-
-                        // Process VST3 instruments in FX chains even when stopped
-                        // This is necessary because VST3 instruments (like Serum) need
-                        // continuous process() calls to stay active and respond to MIDI
-                        //
-                        // We process each track separately and apply volume/pan per track
-                        if let Ok(effect_mgr) = effect_manager.lock() {
-                            if let Ok(tm) = track_manager.lock() {
-                                let has_solo = tm.has_solo();
-                                for track_arc in tm.get_all_tracks() {
-                                    if let Ok(track) = track_arc.lock() {
-                                        // Skip master track in per-track processing
-                                        if track.track_type == crate::track::TrackType::Master {
-                                            continue;
-                                        }
+                        data[frame_idx * 2] = met_left + synth_output;
+                        data[frame_idx * 2 + 1] = met_right + synth_output;
+                    }
 
-                                        // Handle mute/solo
-                                        if track.mute {
-                                            // Still process to keep VST3 alive, but don't mix
-                                            for effect_id in &track.fx_chain {
-                                                if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                                    if let Ok(mut effect) = effect_arc.lock() {
-                                                        let _ = effect.process_frame(0.0, 0.0);
-                                                    }
-                                                }
-                                            }
-                                            continue;
-                                        }
-                                        if has_solo && !track.solo {
-                                            // Still process to keep VST3 alive
-                                            for effect_id in &track.fx_chain {
-                                                if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                                    if let Ok(mut effect) = effect_arc.lock() {
-                                                        let _ = effect.process_frame(0.0, 0.0);
-                                                    }
-                                                }
-                                            }
-                                            continue;
-                                        }
+                    // Process VST3 instruments in FX chains even when stopped
+                    // This is necessary because VST3 instruments (like Serum) need
+                    // continuous process() calls to stay active and respond to MIDI
+                    //
+                    // We process each track separately (one block per chain) and
+                    // apply volume/pan per track
+                    let track_left = &mut blocks.track_left[..frames];
+                    let track_right = &mut blocks.track_right[..frames];
+                    let mut pdc_guard = telemetry.lock(CallbackStage::DelayCompensation, &delay_compensation).ok();
+                    // Tracks still in the render-ahead table belong to the
+                    // render thread until it publishes one without them
+                    let ahead = ahead_tables.current();
+                    let chains = fx_chains.current();
+                    if let Ok(tm) = telemetry.lock(CallbackStage::TrackManager, &track_manager) {
+                        let has_solo = tm.has_solo();
+                        for track_arc in tm.get_all_tracks() {
+                            if let Ok(track) = track_arc.lock() {
+                                // Skip master track in per-track processing
+                                if track.track_type == crate::track::TrackType::Master {
+                                    continue;
+                                }
+                                if ahead.contains(track.id) {
+                                    continue;
+                                }
 
-                                        // Process FX chain for this track (instruments generate audio from MIDI)
-                                        let mut track_left = 0.0f32;
-                                        let mut track_right = 0.0f32;
-                                        for effect_id in &track.fx_chain {
-                                            // Skip bypassed effects (audio passes through unchanged)
-                                            if effect_mgr.is_bypassed(*effect_id) {
-                                                continue;
-                                            }
-                                            if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                                if let Ok(mut effect) = effect_arc.lock() {
-                                                    let (fx_l, fx_r) = effect.process_frame(track_left, track_right);
-                                                    track_left = fx_l;
-                                                    track_right = fx_r;
-                                                }
-                                            }
-                                        }
+                                track_left.fill(0.0);
+                                track_right.fill(0.0);
 
-                                        // Apply track volume and pan AFTER FX chain
-                                        let volume_gain = track.get_gain();
-                                        let (pan_left, pan_right) = track.get_pan_gains();
-
-                                        // Debug: log volume application (only occasionally)
-                                        let fx_chain_len = track.fx_chain.len();
-                                        if frame_idx == 0 && (track_left.abs() > 0.001 || track_right.abs() > 0.001) {
-                                            static LAST_VOL_LOG: std::sync::atomic::AtomicU64 = std::sync::atomic::AtomicU64::new(0);
-                                            let now = std::time::SystemTime::now()
-                                                .duration_since(std::time::UNIX_EPOCH)
-                                                .unwrap_or_default()
-                                                .as_millis() as u64;
-                                            let last = LAST_VOL_LOG.load(Ordering::Relaxed);
-                                            if now - last > 500 {
-                                                LAST_VOL_LOG.store(now, Ordering::Relaxed);
-                                                eprintln!("🎚️ Track {} (fx_chain={}) pre-vol: L={:.4} R={:.4}, gain={:.4}, vol_db={:.1}",
-                                                    track.id, fx_chain_len, track_left, track_right, volume_gain, track.volume_db);
-                                            }
+                                // Handle mute/solo
+                                if track.mute || (has_solo && !track.solo) {
+                                    // Still process to keep VST3 alive, but don't mix
+                                    for entry in chains.chain(track.id) {
+                                        if let Ok(mut effect) = telemetry.lock(CallbackStage::Effects, &entry.effect) {
+                                            effect.process_block(track_left, track_right);
                                         }
+                                    }
+                                    if let Some(ref mut pdc) = pdc_guard {
+                                        pdc.silence_track(track.id);
+                                    }
+                                    continue;
+                                }
 
-                                        track_left *= volume_gain * pan_left;
-                                        track_right *= volume_gain * pan_right;
+                                // Process FX chain for this track (instruments generate audio from MIDI)
+                                process_chain(chains.chain(track.id), track_left, track_right, Some(telemetry));
 
-                                        // Mix into output
-                                        out_left += track_left;
-                                        out_right += track_right;
-                                    }
+                                // Delay to line up with the slowest track's FX chain
+                                if let Some(ref mut pdc) = pdc_guard {
+                                    pdc.process_track(track.id, track_left, track_right);
+                                }
+
+                                // Apply track volume and pan AFTER FX chain
+                                let volume_gain = track.get_gain();
+                                let (pan_left, pan_right) = track.get_pan_gains();
+
+                                // Mix into output
+                                let gain_left = volume_gain * pan_left;
+                                let gain_right = volume_gain * pan_right;
+                                for frame_idx in 0..frames {
+                                    data[frame_idx * 2] += track_left[frame_idx] * gain_left;
+                                    data[frame_idx * 2 + 1] += track_right[frame_idx] * gain_right;
                                 }
                             }
                         }
-
-                        // Output metronome + synths + VST3 when not playing
-                        data[frame_idx * 2] = out_left;
-                        data[frame_idx * 2 + 1] = out_right;
                     }
                     return;
                 }
@@ -762,22 +1204,6 @@ impl AudioGraph {
                 // frames already calculated at top of callback
                 let current_playhead = playhead_samples.load(Ordering::SeqCst);
 
-                // Get clips (lock briefly) - keeping for potential future use
-                let _clips_snapshot = {
-                    let clips_lock = clips.lock().expect("mutex poisoned");
-                    clips_lock.clone()
-                };
-
-                // Get MIDI clips (lock briefly) - kept for potential future use
-                let _midi_clips_snapshot = {
-                    let midi_clips_lock = midi_clips.lock().expect("mutex poisoned");
-                    midi_clips_lock.clone()
-                };
-
-                // Get current tempo for MIDI playback scaling
-                let current_tempo = *recorder_refs.tempo.lock().expect("mutex poisoned");
-                let _tempo_ratio = current_tempo / 120.0;
-
                 // NOTE: Legacy MIDI clip processing removed - all MIDI now handled per-track
 
                 // M5.5: Track-based mixing (replaces legacy clip mixing)
@@ -785,312 +1211,232 @@ impl AudioGraph {
                 // OPTIMIZATION: Lock tracks ONCE and extract all data before frame loop
                 // This prevents locking for every frame (which causes UI freezing)
 
-                struct TrackSnapshot {
-                    id: u64,
-                    audio_clips: Vec<TimelineClip>,
-                    midi_clips: Vec<TimelineMidiClip>,
-                    volume_gain: f32,
-                    pan_left: f32,
-                    pan_right: f32,
-                    muted: bool,
-                    soloed: bool,
-                    fx_chain: Vec<u64>,
-                }
-
-                let track_data_option = if let Ok(tm) = track_manager.lock() {
-                    let has_solo_flag = tm.has_solo();
-                    let all_tracks = tm.get_all_tracks();
-                    let mut snapshots = Vec::new();
-                    let mut master_snap = None;
-
-                    for track_arc in all_tracks {
+                // If the lock fails the track list stays empty
+                snapshots.begin();
+                let mut has_solo = false;
+                if let Ok(tm) = telemetry.lock(CallbackStage::TrackManager, &track_manager) {
+                    has_solo = tm.has_solo();
+                    for track_arc in tm.get_all_tracks() {
                         if let Ok(track) = track_arc.lock() {
                             // Extract all data we need from this track
-                            let snap = TrackSnapshot {
-                                id: track.id,
-                                audio_clips: track.audio_clips.clone(),
-                                midi_clips: track.midi_clips.clone(),
-                                volume_gain: track.get_gain(),
-                                pan_left: track.get_pan_gains().0,
-                                pan_right: track.get_pan_gains().1,
-                                muted: track.mute,
-                                soloed: track.solo,
-                                fx_chain: track.fx_chain.clone(),
-                            };
-
-                            if track.track_type == crate::track::TrackType::Master {
-                                master_snap = Some(snap);
-                            } else {
-                                snapshots.push(snap);
-                            }
+                            snapshots.capture(&track);
                         }
                     }
+                } // All locks released here!
 
-                    Some((snapshots, has_solo_flag, master_snap))
-                } else {
-                    None // Lock failed, use empty track list
-                }; // All locks released here!
-
-                let (track_snapshots, has_solo, master_snapshot) = track_data_option
-                    .unwrap_or_else(|| (Vec::new(), false, None));
+                let track_snapshots = snapshots.tracks();
+                let master_snapshot = snapshots.master();
+                let chains = fx_chains.current();
 
-                // Track peak levels per track for metering (track_id -> (max_left, max_right))
-                let mut track_peaks: HashMap<TrackId, (f32, f32)> = HashMap::new();
+                // Track peak levels per node for metering ((max_left, max_right), None if not mixed)
+                track_peaks.clear();
+                track_peaks.resize(track_snapshots.len(), None);
                 let mut master_peak_left = 0.0f32;
                 let mut master_peak_right = 0.0f32;
 
-                // OPTIMIZATION: Lock synth manager ONCE before the frame loop
-                // This prevents lock contention that causes audio dropouts
-                let mut synth_guard = track_synth_manager.lock().ok();
-
-                // Process each frame (using snapshots - NO LOCKS in hot path!)
-                for frame_idx in 0..frames {
-                    let playhead_frame = current_playhead + frame_idx as u64;
-                    let playhead_seconds = playhead_frame as f64 / TARGET_SAMPLE_RATE as f64;
-
-                    let mut mix_left = 0.0;
-                    let mut mix_right = 0.0;
+                // Compile the routing DAG: tracks in a level only depend on
+                // earlier levels (groups after their members, returns after
+                // their senders), so each level runs in parallel
+                mix_graph.compile(track_snapshots);
+                mix_graph.resolve_active(
+                    has_solo,
+                    |node| track_snapshots[node].muted,
+                    |node| track_snapshots[node].soloed,
+                );
 
-                    // Mix all tracks using snapshots (no locking!)
-                    for track_snap in &track_snapshots {
-                        // Handle mute/solo logic
-                        if track_snap.muted {
-                            continue; // Muted tracks produce no sound
+                // Hand every track its own block, synth and FX chain so the
+                // tasks share nothing. The synth manager stays locked for the
+                // whole buffer (as before), but tasks only see their own synth
+                blocks.ensure_tracks(track_snapshots.len(), frames);
+                let mut synth_guard = telemetry.lock(CallbackStage::SynthManager, &track_synth_manager).ok();
+                let mut tasks = recycle_tasks(std::mem::take(&mut task_storage));
+                tasks.extend(blocks.tracks[..track_snapshots.len()].iter_mut().zip(track_snapshots).map(
+                    |(block, snap)| {
+                        Mutex::new(TrackTask { block, synth: None, effects: chains.chain(snap.id), ahead: None })
+                    },
+                ));
+                if let Some(ref mut synth_manager) = synth_guard {
+                    for (track_id, synth) in synth_manager.synths_mut() {
+                        if let Some(node) = mix_graph.index_of(track_id) {
+                            if let Ok(task) = tasks[node].get_mut() {
+                                task.synth = Some(synth);
+                            }
                         }
-                        if has_solo && !track_snap.soloed {
-                            continue; // If any track is soloed, skip non-soloed tracks
+                    }
+                }
+                // Tracks rendered ahead are read from their ring instead
+                for (track_id, track) in ahead_tables.current().tracks() {
+                    if let Some(node) = mix_graph.index_of(*track_id) {
+                        if let Ok(task) = tasks[node].get_mut() {
+                            task.ahead = Some(&track.reader);
                         }
-
-                        let mut track_left = 0.0;
-                        let mut track_right = 0.0;
-
-                        // Mix all audio clips on this track
-                        for timeline_clip in &track_snap.audio_clips {
-                            let clip_duration = timeline_clip.duration
-                                .unwrap_or(timeline_clip.clip.duration_seconds);
-                            let clip_end = timeline_clip.start_time + clip_duration;
-
-                            if playhead_seconds >= timeline_clip.start_time
-                                && playhead_seconds < clip_end
-                            {
-                                let time_in_clip = playhead_seconds - timeline_clip.start_time + timeline_clip.offset;
-                                let frame_in_clip = (time_in_clip * TARGET_SAMPLE_RATE as f64) as usize;
-
-                                if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                                    track_left += l;
-                                }
-                                if timeline_clip.clip.channels > 1 {
-                                    if let Some(r) = timeline_clip.clip.get_sample(frame_in_clip, 1) {
-                                        track_right += r;
-                                    }
+                    }
+                }
+                let mut pdc_guard = telemetry.lock(CallbackStage::DelayCompensation, &delay_compensation).ok();
+                let mix_left = &mut blocks.mix_left[..frames];
+                let mix_right = &mut blocks.mix_right[..frames];
+                let send_left = &mut blocks.track_left[..frames];
+                let send_right = &mut blocks.track_right[..frames];
+                mix_left.fill(0.0);
+                mix_right.fill(0.0);
+
+                for level in mix_graph.levels() {
+                    // Clips, MIDI and FX for every audible track in this level,
+                    // spread over the worker pool (joins before returning)
+                    track_pool.run(level.len(), |k| {
+                        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+                        let _transport = transport.bind();
+                        let node = level[k];
+                        let Ok(mut task) = tasks[node].lock() else {
+                            return;
+                        };
+                        let TrackTask { block, synth, effects, ahead } = &mut *task;
+                        let track_left = &mut block.left[..frames];
+                        let track_right = &mut block.right[..frames];
+
+                        if let Some(reader) = ahead {
+                            // Only a control-thread restart holds the reader:
+                            // leave the block silent, the next read resyncs
+                            if let Ok(mut reader) = reader.try_lock() {
+                                // Muted ahead tracks still consume their ring to stay aligned
+                                if mix_graph.is_active(node) {
+                                    reader.read(current_playhead, track_left, track_right);
                                 } else {
-                                    // Mono clip - duplicate to right
-                                    if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                                        track_right += l;
-                                    }
+                                    reader.skip(current_playhead, frames);
                                 }
                             }
+                        } else if mix_graph.is_active(node) {
+                            render_live_track(
+                                &track_snapshots[node],
+                                synth.as_deref_mut(),
+                                effects,
+                                current_playhead,
+                                track_left,
+                                track_right,
+                                Some(telemetry),
+                            );
                         }
+                    });
 
-                        // Process per-track MIDI clips (using pre-acquired synth lock)
-                        // Also send MIDI to VST3 instruments in the FX chain
-                        if let Some(ref mut synth_manager) = synth_guard {
-                            for timeline_midi_clip in &track_snap.midi_clips {
-                                let clip_start_samples = (timeline_midi_clip.start_time * TARGET_SAMPLE_RATE as f64) as u64;
-                                let clip_end_samples = clip_start_samples + timeline_midi_clip.clip.duration_samples;
-
-                                // Check if clip is active at this frame
-                                // Use <= for end boundary to ensure note-offs at exact clip end are triggered
-                                if playhead_frame >= clip_start_samples && playhead_frame <= clip_end_samples {
-                                    let frame_in_clip = playhead_frame - clip_start_samples;
-
-                                    // Check for MIDI events that should trigger at this exact sample
-                                    for event in &timeline_midi_clip.clip.events {
-                                        if event.timestamp_samples == frame_in_clip {
-                                            match event.event_type {
-                                                crate::midi::MidiEventType::NoteOn { note, velocity } => {
-                                                    // Send to built-in synth
-                                                    synth_manager.note_on(track_snap.id, note, velocity);
-
-                                                    // Send to VST3 instruments in FX chain
-                                                    if let Ok(effect_mgr) = effect_manager.lock() {
-                                                        for effect_id in &track_snap.fx_chain {
-                                                            if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                                                if let Ok(mut effect) = effect_arc.lock() {
-                                                                    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
-                                                                    if let crate::effects::EffectType::VST3(ref mut vst3) = *effect {
-                                                                        let _ = vst3.process_midi_event(0, 0, note as i32, velocity as i32, 0);
-                                                                    }
-                                                                }
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                                crate::midi::MidiEventType::NoteOff { note, velocity: _ } => {
-                                                    // Send to built-in synth
-                                                    synth_manager.note_off(track_snap.id, note);
-
-                                                    // Send to VST3 instruments in FX chain
-                                                    if let Ok(effect_mgr) = effect_manager.lock() {
-                                                        for effect_id in &track_snap.fx_chain {
-                                                            if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                                                if let Ok(mut effect) = effect_arc.lock() {
-                                                                    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
-                                                                    if let crate::effects::EffectType::VST3(ref mut vst3) = *effect {
-                                                                        let _ = vst3.process_midi_event(1, 0, note as i32, 0, 0);
-                                                                    }
-                                                                }
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
+                    // Route the level's output into buses and the mix bus.
+                    // Serial: several tracks may feed the same bus
+                    for &node in level {
+                        let track_snap = &track_snapshots[node];
 
-                            // Add per-track synthesizer output (M6) - no lock needed, already held
-                            let synth_sample = synth_manager.process_sample(track_snap.id);
-                            track_left += synth_sample;
-                            track_right += synth_sample;
+                        // Muted tracks produce no sound; if any track is soloed, skip
+                        // tracks that aren't soloed or feeding a soloed track
+                        if !mix_graph.is_active(node) {
+                            if let Some(ref mut pdc) = pdc_guard {
+                                pdc.silence_track(track_snap.id);
+                            }
+                            continue;
                         }
 
-                        // Process FX chain on this track BEFORE volume/pan
-                        // This is important because VST3 instruments generate their own audio
-                        // and we want the fader to control the post-FX output level
-                        let mut fx_left = track_left;
-                        let mut fx_right = track_right;
-
-                        if let Ok(effect_mgr) = effect_manager.lock() {
-                            for effect_id in &track_snap.fx_chain {
-                                // Skip bypassed effects (audio passes through unchanged)
-                                if effect_mgr.is_bypassed(*effect_id) {
-                                    continue;
-                                }
-                                if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                    if let Ok(mut effect) = effect_arc.lock() {
-                                        let (out_l, out_r) = effect.process_frame(fx_left, fx_right);
-                                        fx_left = out_l;
-                                        fx_right = out_r;
-                                    }
-                                }
+                        let Ok(mut task) = tasks[node].lock() else {
+                            continue;
+                        };
+                        let block = &mut *task.block;
+                        let track_left = &mut block.left[..frames];
+                        let track_right = &mut block.right[..frames];
+
+                        for send in mix_graph.sends(node).iter().filter(|send| send.pre_fader) {
+                            send_left.copy_from_slice(track_left);
+                            send_right.copy_from_slice(track_right);
+                            if let Some(ref mut pdc) = pdc_guard {
+                                pdc.process_send(track_snap.id, track_snapshots[send.target].id, send_left, send_right);
                             }
+                            mix_into_task(&tasks[send.target], send_left, send_right, send.amount);
                         }
 
-                        // Apply track volume AFTER FX chain (from snapshot)
+                        // Apply track volume and pan AFTER FX chain (from snapshot)
                         // This ensures VST3 instrument output is also affected by the fader
-                        fx_left *= track_snap.volume_gain;
-                        fx_right *= track_snap.volume_gain;
-
-                        // Apply track pan AFTER FX chain (from snapshot)
-                        fx_left *= track_snap.pan_left;
-                        fx_right *= track_snap.pan_right;
-
-                        // Update track peak levels for metering
-                        let entry = track_peaks.entry(track_snap.id).or_insert((0.0, 0.0));
-                        entry.0 = entry.0.max(fx_left.abs());
-                        entry.1 = entry.1.max(fx_right.abs());
-
-                        // Accumulate to mix bus
-                        mix_left += fx_left;
-                        mix_right += fx_right;
-                    }
+                        let gain_left = track_snap.volume_gain * track_snap.pan_left;
+                        let gain_right = track_snap.volume_gain * track_snap.pan_right;
 
-                    // NOTE: Legacy synth output removed - all synth now per-track
+                        let entry = track_peaks[node].get_or_insert((0.0, 0.0));
+                        for frame_idx in 0..frames {
+                            track_left[frame_idx] *= gain_left;
+                            track_right[frame_idx] *= gain_right;
 
-                    // REMOVED: Legacy mixing that bypassed track controls
-                    // All clips now go through tracks with proper volume/pan/mute/solo
+                            // Update track peak levels for metering
+                            entry.0 = entry.0.max(track_left[frame_idx].abs());
+                            entry.1 = entry.1.max(track_right[frame_idx].abs());
+                        }
 
-                    /* LEGACY CODE REMOVED FOR MIXER FIX
-                    for timeline_clip in &clips_snapshot {
-                        let clip_duration = timeline_clip.duration
-                            .unwrap_or(timeline_clip.clip.duration_seconds);
-                        let clip_end = timeline_clip.start_time + clip_duration;
+                        for send in mix_graph.sends(node).iter().filter(|send| !send.pre_fader) {
+                            send_left.copy_from_slice(track_left);
+                            send_right.copy_from_slice(track_right);
+                            if let Some(ref mut pdc) = pdc_guard {
+                                pdc.process_send(track_snap.id, track_snapshots[send.target].id, send_left, send_right);
+                            }
+                            mix_into_task(&tasks[send.target], send_left, send_right, send.amount);
+                        }
 
-                        if playhead_seconds >= timeline_clip.start_time
-                            && playhead_seconds < clip_end
-                        {
-                            let time_in_clip = playhead_seconds - timeline_clip.start_time + timeline_clip.offset;
-                            let frame_in_clip = (time_in_clip * TARGET_SAMPLE_RATE as f64) as usize;
+                        // Delay so everything summed at the destination
+                        // (group or master) arrives together
+                        if let Some(ref mut pdc) = pdc_guard {
+                            pdc.process_track(track_snap.id, track_left, track_right);
+                        }
 
-                            if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                                mix_left += l;
+                        match mix_graph.output(node) {
+                            MixOutput::Bus(parent) => {
+                                mix_into_task(&tasks[parent], track_left, track_right, 1.0);
                             }
-                            if timeline_clip.clip.channels > 1 {
-                                if let Some(r) = timeline_clip.clip.get_sample(frame_in_clip, 1) {
-                                    mix_right += r;
-                                }
-                            } else {
-                                if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                                    mix_right += l;
+                            MixOutput::Master => {
+                                // Accumulate to mix bus
+                                for frame_idx in 0..frames {
+                                    mix_left[frame_idx] += track_left[frame_idx];
+                                    mix_right[frame_idx] += track_right[frame_idx];
                                 }
                             }
                         }
                     }
-                    */ // END LEGACY CODE REMOVAL
-
-                    // Get input samples (if recording)
-                    let (input_left, input_right) = if let Ok(input_mgr) = input_manager.lock() {
-                        let channels = input_mgr.get_input_channels();
-                        if channels == 1 {
-                            if let Some(samples) = input_mgr.read_samples(1) {
-                                let mono_sample = samples.get(0).copied().unwrap_or(0.0);
-                                (mono_sample, mono_sample)
-                            } else {
-                                (0.0, 0.0)
-                            }
-                        } else {
-                            if let Some(samples) = input_mgr.read_samples(2) {
-                                (samples.get(0).copied().unwrap_or(0.0),
-                                 samples.get(1).copied().unwrap_or(0.0))
-                            } else {
-                                (0.0, 0.0)
-                            }
-                        }
-                    } else {
-                        (0.0, 0.0)
-                    };
+                }
 
-                    // Process recording (metronome handled separately below)
-                    let (met_left, met_right) = recorder_refs.process_frame(input_left, input_right, true);
+                drop(pdc_guard);
+                task_storage = recycle_tasks(tasks);
+                drop(synth_guard);
 
-                    // Apply master track processing (using snapshot - no locks!)
-                    let mut master_left = mix_left;
-                    let mut master_right = mix_right;
+                // NOTE: Legacy synth output removed - all synth now per-track
 
-                    if let Some(ref master_snap) = master_snapshot {
-                        // Apply master volume
-                        master_left *= master_snap.volume_gain;
-                        master_right *= master_snap.volume_gain;
+                // REMOVED: Legacy mixing that bypassed track controls
+                // All clips now go through tracks with proper volume/pan/mute/solo
 
-                        // Apply master pan
-                        master_left *= master_snap.pan_left;
-                        master_right *= master_snap.pan_right;
+                // Get input samples (if recording) and process recording
+                // (metronome handled separately below)
+                let met_left = &mut blocks.met_left[..frames];
+                let met_right = &mut blocks.met_right[..frames];
+                let input_left = &mut blocks.input_left[..frames];
+                let input_right = &mut blocks.input_right[..frames];
+                input_reader.read_block(input_left, input_right);
+                for frame_idx in 0..frames {
+                    let (frame_met_left, frame_met_right) =
+                        recorder_refs.process_frame(input_left[frame_idx], input_right[frame_idx], true);
+                    met_left[frame_idx] = frame_met_left;
+                    met_right[frame_idx] = frame_met_right;
+                }
 
-                        // Process master FX chain
-                        if let Ok(effect_mgr) = effect_manager.lock() {
-                            for effect_id in &master_snap.fx_chain {
-                                // Skip bypassed effects (audio passes through unchanged)
-                                if effect_mgr.is_bypassed(*effect_id) {
-                                    continue;
-                                }
-                                if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                                    if let Ok(mut effect) = effect_arc.lock() {
-                                        let (out_l, out_r) = effect.process_frame(master_left, master_right);
-                                        master_left = out_l;
-                                        master_right = out_r;
-                                    }
-                                }
-                            }
-                        }
+                // Apply master track processing (using snapshot - no locks!)
+                if let Some(master_snap) = master_snapshot {
+                    // Apply master volume and pan
+                    let gain_left = master_snap.volume_gain * master_snap.pan_left;
+                    let gain_right = master_snap.volume_gain * master_snap.pan_right;
+                    for frame_idx in 0..frames {
+                        mix_left[frame_idx] *= gain_left;
+                        mix_right[frame_idx] *= gain_right;
                     }
 
-                    // Apply master limiter to prevent clipping
-                    let (limited_left, limited_right) = if let Ok(mut limiter) = master_limiter.lock() {
-                        limiter.process_frame(master_left, master_right)
+                    // Process master FX chain
+                    process_chain(chains.chain(master_snap.id), mix_left, mix_right, Some(telemetry));
+                }
+
+                // Apply master limiter to prevent clipping
+                let mut limiter_guard = telemetry.lock(CallbackStage::MasterLimiter, &master_limiter).ok();
+                for frame_idx in 0..frames {
+                    let (limited_left, limited_right) = if let Some(ref mut limiter) = limiter_guard {
+                        limiter.process_frame(mix_left[frame_idx], mix_right[frame_idx])
                     } else {
-                        (master_left.clamp(-1.0, 1.0), master_right.clamp(-1.0, 1.0))
+                        (mix_left[frame_idx].clamp(-1.0, 1.0), mix_right[frame_idx].clamp(-1.0, 1.0))
                     };
 
                     // Update master peak levels for metering (before metronome is added)
@@ -1099,20 +1445,21 @@ impl AudioGraph {
 
                     // Add metronome AFTER metering so it doesn't affect the master meter
                     // Metronome goes directly to output, bypassing master volume/effects
-                    let output_left = limited_left + met_left;
-                    let output_right = limited_right + met_right;
-
                     // Write to output buffer (interleaved stereo)
-                    data[frame_idx * 2] = output_left;
-                    data[frame_idx * 2 + 1] = output_right;
+                    data[frame_idx * 2] = limited_left + met_left[frame_idx];
+                    data[frame_idx * 2 + 1] = limited_right + met_right[frame_idx];
                 }
+                drop(limiter_guard);
 
                 // Update track peak levels in track manager (brief lock after buffer processing)
-                if let Ok(tm) = track_manager.lock() {
-                    for (track_id, (peak_l, peak_r)) in &track_peaks {
-                        if let Some(track_arc) = tm.get_track(*track_id) {
+                if let Ok(tm) = telemetry.lock(CallbackStage::TrackManager, &track_manager) {
+                    for (snap, peaks) in track_snapshots.iter().zip(track_peaks.iter()) {
+                        let Some((peak_l, peak_r)) = *peaks else {
+                            continue;
+                        };
+                        if let Some(track_arc) = tm.get_track(snap.id) {
                             if let Ok(mut track) = track_arc.lock() {
-                                track.update_peaks(*peak_l, *peak_r);
+                                track.update_peaks(peak_l, peak_r);
                             }
                         }
                     }
@@ -1168,9 +1515,21 @@ impl AudioGraph {
 
     /// Export current state to ProjectData (for saving)
     pub fn export_to_project_data(&self, project_name: String) -> crate::project::ProjectData {
-        use crate::project::*;
-        use crate::effects::EffectType as ET;
-        use std::collections::HashMap;
+        self.export_project_data(project_name, true)
+    }
+
+    /// Export current state without serializing any VST3 plugin state
+    /// (`state_base64` is left empty), for savers that store plugin states
+    /// separately
+    pub fn export_to_project_data_without_plugin_states(&self, project_name: String) -> crate::project::ProjectData {
+        self.export_project_data(project_name, false)
+    }
+
+    #[cfg_attr(target_os = "ios", allow(unused_variables))]
+    fn export_project_data(&self, project_name: String, capture_plugin_states: bool) -> crate::project::ProjectData {
+        use crate::project::*;
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        use crate::effects::EffectType as ET;
         #[cfg(all(feature = "vst3", not(target_os = "ios")))]
         use base64::Engine as _;
 
@@ -1183,77 +1542,22 @@ impl AudioGraph {
         let tracks_data: Vec<TrackData> = all_tracks.iter().map(|track_arc| {
             let track = track_arc.lock().expect("mutex poisoned");
 
-            // Get effect chain for this track
-            let fx_chain: Vec<EffectData> = track.fx_chain.iter().filter_map(|effect_id| {
-                // Get effect from effect manager
-                if let Some(effect_arc) = effect_manager.get_effect(*effect_id) {
+            // Get effect chain for this track. A frozen track saves the
+            // chain it was frozen with (it loads unfrozen) ahead of anything
+            // added since
+            let frozen_chain = track.frozen.iter().flat_map(|frozen| frozen.fx_chain.iter());
+            let fx_chain: Vec<EffectData> = frozen_chain
+                .map(|(effect_id, _, parked)| match parked {
+                    ParkedEffect::Builtin(effect) => effect_to_data(*effect_id, effect),
+                    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+                    ParkedEffect::VST3(_) => vst3_effect_data(*effect_id),
+                })
+                .chain(track.fx_chain.iter().filter_map(|effect_id| {
+                    let effect_arc = effect_manager.get_effect(*effect_id)?;
                     let effect = effect_arc.lock().expect("mutex poisoned");
-                    let mut parameters = HashMap::new();
-                    let effect_type_str;
-
-                    // Get parameters based on effect type
-                    match &*effect {
-                        ET::EQ(eq) => {
-                            effect_type_str = "eq".to_string();
-                            parameters.insert("low_freq".to_string(), eq.low_freq);
-                            parameters.insert("low_gain_db".to_string(), eq.low_gain_db);
-                            parameters.insert("mid1_freq".to_string(), eq.mid1_freq);
-                            parameters.insert("mid1_gain_db".to_string(), eq.mid1_gain_db);
-                            parameters.insert("mid1_q".to_string(), eq.mid1_q);
-                            parameters.insert("mid2_freq".to_string(), eq.mid2_freq);
-                            parameters.insert("mid2_gain_db".to_string(), eq.mid2_gain_db);
-                            parameters.insert("mid2_q".to_string(), eq.mid2_q);
-                            parameters.insert("high_freq".to_string(), eq.high_freq);
-                            parameters.insert("high_gain_db".to_string(), eq.high_gain_db);
-                        }
-                        ET::Compressor(comp) => {
-                            effect_type_str = "compressor".to_string();
-                            parameters.insert("threshold_db".to_string(), comp.threshold_db);
-                            parameters.insert("ratio".to_string(), comp.ratio);
-                            parameters.insert("attack_ms".to_string(), comp.attack_ms);
-                            parameters.insert("release_ms".to_string(), comp.release_ms);
-                            parameters.insert("makeup_gain_db".to_string(), comp.makeup_gain_db);
-                        }
-                        ET::Reverb(rev) => {
-                            effect_type_str = "reverb".to_string();
-                            parameters.insert("room_size".to_string(), rev.room_size);
-                            parameters.insert("damping".to_string(), rev.damping);
-                            parameters.insert("wet_dry_mix".to_string(), rev.wet_dry_mix);
-                        }
-                        ET::Delay(dly) => {
-                            effect_type_str = "delay".to_string();
-                            parameters.insert("delay_time_ms".to_string(), dly.delay_time_ms);
-                            parameters.insert("feedback".to_string(), dly.feedback);
-                            parameters.insert("wet_dry_mix".to_string(), dly.wet_dry_mix);
-                        }
-                        ET::Chorus(chr) => {
-                            effect_type_str = "chorus".to_string();
-                            parameters.insert("rate_hz".to_string(), chr.rate_hz);
-                            parameters.insert("depth".to_string(), chr.depth);
-                            parameters.insert("wet_dry_mix".to_string(), chr.wet_dry_mix);
-                        }
-                        ET::Limiter(_) => {
-                            effect_type_str = "limiter".to_string();
-                            // Limiter has no user-adjustable parameters
-                        }
-                        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
-                        ET::VST3(_vst3) => {
-                            effect_type_str = "vst3".to_string();
-                            // TODO M7: Save VST3 plugin path and state
-                            // For now, just mark the type - full state persistence coming later
-                            parameters.insert("name".to_string(), 0.0); // Placeholder
-                        }
-                    }
-
-                    Some(EffectData {
-                        id: *effect_id,
-                        effect_type: effect_type_str,
-                        parameters,
-                    })
-                } else {
-                    None
-                }
-            }).collect();
+                    Some(effect_to_data(*effect_id, &effect))
+                }))
+                .collect();
 
             // Get audio clips on this track
             let audio_clips_data: Vec<ClipData> = track.audio_clips.iter().map(|timeline_clip| {
@@ -1295,7 +1599,9 @@ impl AudioGraph {
             let track_type_str = format!("{:?}", track.track_type);
 
             // Get synth settings for MIDI tracks
-            let synth_settings = if track_type_str == "Midi" {
+            let synth_settings = if let Some(frozen) = &track.frozen {
+                frozen.synth.clone()
+            } else if track_type_str == "Midi" {
                 synth_manager.get_synth_parameters(track.id)
             } else {
                 None
@@ -1309,14 +1615,37 @@ impl AudioGraph {
             }).collect();
 
             // Collect VST3 plugin data with state
+            // A frozen track's plugins are already just their saved state,
+            // so it is always written inline
             #[cfg(all(feature = "vst3", not(target_os = "ios")))]
-            let vst3_plugins: Vec<Vst3PluginData> = track.fx_chain.iter().filter_map(|effect_id| {
+            let frozen_plugins = track.frozen.iter().flat_map(|frozen| frozen.fx_chain.iter()).filter_map(|(effect_id, _, parked)| {
+                let ParkedEffect::VST3(saved) = parked else {
+                    return None;
+                };
+                Some(Vst3PluginData {
+                    effect_id: *effect_id,
+                    plugin_path: saved.plugin_path.clone(),
+                    plugin_name: saved.name.clone(),
+                    is_instrument: saved.is_instrument,
+                    state_base64: base64::engine::general_purpose::STANDARD.encode(&saved.state),
+                    state_file: None,
+                    state_data: Vec::new(),
+                })
+            });
+
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            let vst3_plugins: Vec<Vst3PluginData> = frozen_plugins.chain(track.fx_chain.iter().filter_map(|effect_id| {
                 if let Some(effect_arc) = effect_manager.get_effect(*effect_id) {
                     let effect = effect_arc.lock().expect("mutex poisoned");
                     if let ET::VST3(vst3) = &*effect {
                         // Get plugin state
-                        let state_data = vst3.get_state().unwrap_or_default();
-                        let state_base64 = base64::engine::general_purpose::STANDARD.encode(&state_data);
+                        let state_base64 = if capture_plugin_states {
+                            vst3.snapshot_state()
+                                .map(|state| base64::engine::general_purpose::STANDARD.encode(&*state))
+                                .unwrap_or_default()
+                        } else {
+                            String::new()
+                        };
 
                         Some(Vst3PluginData {
                             effect_id: *effect_id,
@@ -1324,6 +1653,8 @@ impl AudioGraph {
                             plugin_name: vst3.get_name().to_string(),
                             is_instrument: vst3.is_instrument,
                             state_base64,
+                            state_file: None,
+                            state_data: Vec::new(),
                         })
                     } else {
                         None
@@ -1331,7 +1662,7 @@ impl AudioGraph {
                 } else {
                     None
                 }
-            }).collect();
+            })).collect();
 
             #[cfg(target_os = "ios")]
             let vst3_plugins: Vec<Vst3PluginData> = Vec::new();
@@ -1452,8 +1783,14 @@ impl AudioGraph {
             eprintln!("   - Buffer size: {:?}", buffer_preset);
         }
 
+        // VST3 plugins being loaded in parallel: (track, saved data, load)
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let mut pending_vst3 = Vec::new();
+
         // Recreate tracks and effects
         for track_data in project_data.tracks {
+            #[cfg_attr(not(all(feature = "vst3", not(target_os = "ios"))), allow(unused_mut))]
+            let mut track_data = track_data;
             let track_manager = self.track_manager.lock().expect("mutex poisoned");
             let mut effect_manager = self.effect_manager.lock().expect("mutex poisoned");
 
@@ -1599,61 +1936,23 @@ impl AudioGraph {
                 }
             }
 
-            // Restore VST3 plugins from vst3_plugins field
+            // Start loading VST3 plugins from vst3_plugins field. They are
+            // instantiated on the host's loader threads while the rest of the
+            // project is restored, and attached to their tracks below.
             #[cfg(all(feature = "vst3", not(target_os = "ios")))]
             {
-                use base64::Engine as _;
                 use crate::vst3_host::VST3Effect;
                 use crate::audio_file::TARGET_SAMPLE_RATE;
 
-                for vst3_data in &track_data.vst3_plugins {
+                // Moved out rather than cloned: state_data can be large
+                for vst3_data in std::mem::take(&mut track_data.vst3_plugins) {
                     eprintln!("   - Restoring VST3 plugin: {} from {}", vst3_data.plugin_name, vst3_data.plugin_path);
 
-                    // Load the VST3 plugin
                     let sample_rate = TARGET_SAMPLE_RATE as f64;
                     let block_size = 512; // TODO: Get from config
 
-                    match VST3Effect::new(&vst3_data.plugin_path, sample_rate, block_size) {
-                        Ok(mut vst3_effect) => {
-                            // Initialize the plugin
-                            if let Err(e) = vst3_effect.initialize() {
-                                eprintln!("⚠️  Failed to initialize VST3 plugin {}: {}", vst3_data.plugin_name, e);
-                                continue;
-                            }
-
-                            // Restore plugin state
-                            if !vst3_data.state_base64.is_empty() {
-                                match base64::engine::general_purpose::STANDARD.decode(&vst3_data.state_base64) {
-                                    Ok(state_bytes) => {
-                                        if let Err(e) = vst3_effect.set_state(&state_bytes) {
-                                            eprintln!("⚠️  Failed to restore VST3 state for {}: {}", vst3_data.plugin_name, e);
-                                        } else {
-                                            eprintln!("   ✅ Restored VST3 state ({} bytes)", state_bytes.len());
-                                        }
-                                    }
-                                    Err(e) => {
-                                        eprintln!("⚠️  Failed to decode VST3 state for {}: {}", vst3_data.plugin_name, e);
-                                    }
-                                }
-                            }
-
-                            // Add to effect manager
-                            let effect = EffectType::VST3(vst3_effect);
-                            let effect_id = effect_manager.create_effect(effect);
-
-                            // Add to track's FX chain
-                            let tm = self.track_manager.lock().expect("mutex poisoned");
-                            if let Some(track_arc) = tm.get_track(track_id) {
-                                let mut track = track_arc.lock().expect("mutex poisoned");
-                                track.fx_chain.push(effect_id);
-                            }
-
-                            eprintln!("   ✅ Loaded VST3 plugin {} (effect_id={})", vst3_data.plugin_name, effect_id);
-                        }
-                        Err(e) => {
-                            eprintln!("⚠️  Failed to load VST3 plugin {}: {}", vst3_data.plugin_name, e);
-                        }
-                    }
+                    let load = VST3Effect::load_async(&vst3_data.plugin_path, sample_rate, block_size);
+                    pending_vst3.push((track_id, vst3_data, load));
                 }
             }
 
@@ -1709,6 +2008,62 @@ impl AudioGraph {
                 track_data.name, track_type, track_data.fx_chain.len(), midi_clip_count);
         }
 
+        // Attach the VST3 plugins once loaded, in project order
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        {
+            use base64::Engine as _;
+
+            for (track_id, vst3_data, load) in pending_vst3 {
+                let mut vst3_effect = match load.and_then(|load| load.wait()) {
+                    Ok(vst3_effect) => vst3_effect,
+                    Err(e) => {
+                        eprintln!("⚠️  Failed to load VST3 plugin {}: {}", vst3_data.plugin_name, e);
+                        continue;
+                    }
+                };
+
+                // Restore plugin state (from its own blob file, or inline)
+                if !vst3_data.state_data.is_empty() {
+                    if let Err(e) = vst3_effect.set_state(&vst3_data.state_data) {
+                        eprintln!("⚠️  Failed to restore VST3 state for {}: {}", vst3_data.plugin_name, e);
+                    } else {
+                        eprintln!("   ✅ Restored VST3 state ({} bytes)", vst3_data.state_data.len());
+                    }
+                } else if !vst3_data.state_base64.is_empty() {
+                    match base64::engine::general_purpose::STANDARD.decode(&vst3_data.state_base64) {
+                        Ok(state_bytes) => {
+                            if let Err(e) = vst3_effect.set_state(&state_bytes) {
+                                eprintln!("⚠️  Failed to restore VST3 state for {}: {}", vst3_data.plugin_name, e);
+                            } else {
+                                eprintln!("   ✅ Restored VST3 state ({} bytes)", state_bytes.len());
+                            }
+                        }
+                        Err(e) => {
+                            eprintln!("⚠️  Failed to decode VST3 state for {}: {}", vst3_data.plugin_name, e);
+                        }
+                    }
+                }
+
+                // Add to effect manager
+                let effect_id = {
+                    let mut effect_manager = self.effect_manager.lock().expect("mutex poisoned");
+                    effect_manager.create_effect(EffectType::VST3(vst3_effect))
+                };
+
+                // Add to track's FX chain
+                let tm = self.track_manager.lock().expect("mutex poisoned");
+                if let Some(track_arc) = tm.get_track(track_id) {
+                    let mut track = track_arc.lock().expect("mutex poisoned");
+                    track.fx_chain.push(effect_id);
+                }
+
+                eprintln!("   ✅ Loaded VST3 plugin {} (effect_id={})", vst3_data.plugin_name, effect_id);
+            }
+        }
+
+        // Hand the restored chains to the callback and line them up
+        self.fx_chains_changed();
+
         // Note: Audio clips are restored in the API layer (load_project)
         // because they need access to the loaded AudioClip objects
 
@@ -1717,6 +2072,26 @@ impl AudioGraph {
 
     // --- Offline Rendering (Export) ---
 
+    /// Switch every plugin on every track (and the master) into offline
+    /// rendering mode with OFFLINE_BLOCK_SIZE blocks, or back to realtime.
+    /// The render functions below do this themselves around each render
+    pub fn set_offline_render_mode(&self, offline: bool) {
+        let chains: Vec<Vec<u64>> = {
+            let tm = self.track_manager.lock().expect("mutex poisoned");
+            tm.get_all_tracks()
+                .iter()
+                .filter_map(|track_arc| track_arc.lock().ok().map(|track| track.fx_chain.clone()))
+                .collect()
+        };
+        self.set_chains_offline(&chains, offline);
+    }
+
+    fn set_chains_offline(&self, chains: &[Vec<u64>], offline: bool) {
+        let chain_refs: Vec<&[u64]> = chains.iter().map(|chain| chain.as_slice()).collect();
+        let effect_mgr = self.effect_manager.lock().expect("mutex poisoned");
+        effect_mgr.set_offline_mode(&chain_refs, offline, OFFLINE_BLOCK_SIZE);
+    }
+
     /// Render the entire project offline to a buffer of stereo f32 samples
     /// Returns interleaved stereo audio (L, R, L, R, ...)
     pub fn render_offline(&self, duration_seconds: f64) -> Vec<f32> {
@@ -1750,8 +2125,8 @@ impl AudioGraph {
                 if let Ok(track) = track_arc.lock() {
                     let snap = TrackSnapshot {
                         id: track.id,
-                        audio_clips: track.audio_clips.clone(),
-                        midi_clips: track.midi_clips.clone(),
+                        audio_clips: track.playback_audio_clips().to_vec(),
+                        midi_clips: track.playback_midi_clips().to_vec(),
                         volume_gain: track.get_gain(),
                         pan_left: track.get_pan_gains().0,
                         pan_right: track.get_pan_gains().1,
@@ -1773,14 +2148,52 @@ impl AudioGraph {
 
         eprintln!("🎵 [AudioGraph] Rendering {} tracks", track_snapshots.len());
 
-        // Process each frame
-        for frame_idx in 0..total_frames {
-            let playhead_seconds = frame_idx as f64 / sample_rate as f64;
+        // Plugins render with their offline algorithms in large blocks
+        let chains: Vec<Vec<u64>> = track_snapshots
+            .iter()
+            .chain(master_snapshot.iter())
+            .map(|snap| snap.fx_chain.clone())
+            .collect();
+        self.set_chains_offline(&chains, true);
+
+        let mut track_left = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let mut track_right = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let mut mix_left = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let mut mix_right = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let progress_step = (total_frames / 10).max(1);
+        let mut next_progress = 0;
+
+        // Plugins see the export as the transport playing from the start
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let recorder_refs = self.recorder.get_callback_refs();
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let mut transport = crate::vst3_host::TransportContext::new();
 
-            let mut mix_left = 0.0f32;
-            let mut mix_right = 0.0f32;
+        // Process one block at a time
+        let mut block_start = 0;
+        while block_start < total_frames {
+            let frames = OFFLINE_BLOCK_SIZE.min(total_frames - block_start);
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            let _transport = {
+                transport.update(&block_transport(
+                    &recorder_refs,
+                    block_start as u64,
+                    block_start as i64,
+                    true,
+                    transport.state(),
+                    None,
+                ));
+                transport.bind()
+            };
+            let mix_left = &mut mix_left[..frames];
+            let mix_right = &mut mix_right[..frames];
+            let track_left = &mut track_left[..frames];
+            let track_right = &mut track_right[..frames];
+            mix_left.fill(0.0);
+            mix_right.fill(0.0);
 
             // Mix all tracks
+            let mut synth_guard = self.track_synth_manager.lock().ok();
             for track_snap in &track_snapshots {
                 // Handle mute/solo logic
                 if track_snap.muted {
@@ -1790,148 +2203,81 @@ impl AudioGraph {
                     continue;
                 }
 
-                let mut track_left = 0.0f32;
-                let mut track_right = 0.0f32;
-
-                // Mix all audio clips on this track
-                for timeline_clip in &track_snap.audio_clips {
-                    let clip_duration = timeline_clip.duration
-                        .unwrap_or(timeline_clip.clip.duration_seconds);
-                    let clip_end = timeline_clip.start_time + clip_duration;
-
-                    if playhead_seconds >= timeline_clip.start_time
-                        && playhead_seconds < clip_end
-                    {
-                        let time_in_clip = playhead_seconds - timeline_clip.start_time + timeline_clip.offset;
-                        let frame_in_clip = (time_in_clip * sample_rate as f64) as usize;
-
-                        if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                            track_left += l;
-                        }
-                        if timeline_clip.clip.channels > 1 {
-                            if let Some(r) = timeline_clip.clip.get_sample(frame_in_clip, 1) {
-                                track_right += r;
-                            }
-                        } else {
-                            // Mono clip - duplicate to right
-                            if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                                track_right += l;
-                            }
-                        }
-                    }
-                }
-
-                // Process MIDI clips through track synthesizer
-                for timeline_midi_clip in &track_snap.midi_clips {
-                    let clip_start_samples = (timeline_midi_clip.start_time * sample_rate as f64) as u64;
-                    let clip_end_samples = clip_start_samples + timeline_midi_clip.clip.duration_samples;
-
-                    // Check if clip is active at this frame
-                    // Use <= for end boundary to ensure note-offs at exact clip end are triggered
-                    if frame_idx as u64 >= clip_start_samples && (frame_idx as u64) <= clip_end_samples {
-                        let frame_in_clip = frame_idx as u64 - clip_start_samples;
-
-                        // Check for MIDI events at this exact frame
-                        for event in &timeline_midi_clip.clip.events {
-                            if event.timestamp_samples == frame_in_clip {
-                                if let Ok(mut synth_manager) = self.track_synth_manager.lock() {
-                                    match event.event_type {
-                                        crate::midi::MidiEventType::NoteOn { note, velocity } => {
-                                            synth_manager.note_on(track_snap.id, note, velocity);
-                                        }
-                                        crate::midi::MidiEventType::NoteOff { note, velocity: _ } => {
-                                            synth_manager.note_off(track_snap.id, note);
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+                render_track_sources(
+                    track_snap.id,
+                    &track_snap.audio_clips,
+                    &track_snap.midi_clips,
+                    block_start,
+                    track_left,
+                    track_right,
+                    synth_guard.as_deref_mut(),
+                );
 
-                // Add synthesizer output
-                if let Ok(mut synth_manager) = self.track_synth_manager.lock() {
-                    let synth_sample = synth_manager.process_sample(track_snap.id);
-                    track_left += synth_sample;
-                    track_right += synth_sample;
+                // Apply track volume and pan
+                let gain_left = track_snap.volume_gain * track_snap.pan_left;
+                let gain_right = track_snap.volume_gain * track_snap.pan_right;
+                for frame_idx in 0..frames {
+                    track_left[frame_idx] *= gain_left;
+                    track_right[frame_idx] *= gain_right;
                 }
 
-                // Apply track volume
-                track_left *= track_snap.volume_gain;
-                track_right *= track_snap.volume_gain;
-
-                // Apply track pan
-                track_left *= track_snap.pan_left;
-                track_right *= track_snap.pan_right;
-
                 // Process FX chain on this track
-                let mut fx_left = track_left;
-                let mut fx_right = track_right;
-
                 if let Ok(effect_mgr) = self.effect_manager.lock() {
-                    for effect_id in &track_snap.fx_chain {
-                        if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                            if let Ok(mut effect) = effect_arc.lock() {
-                                let (out_l, out_r) = effect.process_frame(fx_left, fx_right);
-                                fx_left = out_l;
-                                fx_right = out_r;
-                            }
-                        }
-                    }
+                    effect_mgr.process_chain_block(&track_snap.fx_chain, track_left, track_right);
                 }
 
                 // Accumulate to mix bus
-                mix_left += fx_left;
-                mix_right += fx_right;
+                for frame_idx in 0..frames {
+                    mix_left[frame_idx] += track_left[frame_idx];
+                    mix_right[frame_idx] += track_right[frame_idx];
+                }
             }
 
-            // Apply master track processing
-            let mut master_left = mix_left;
-            let mut master_right = mix_right;
+            drop(synth_guard);
 
+            // Apply master track processing
             if let Some(ref master_snap) = master_snapshot {
-                // Apply master volume
-                master_left *= master_snap.volume_gain;
-                master_right *= master_snap.volume_gain;
+                for frame_idx in 0..frames {
+                    // Apply master volume
+                    let master_left = mix_left[frame_idx] * master_snap.volume_gain;
+                    let master_right = mix_right[frame_idx] * master_snap.volume_gain;
 
-                // Apply master pan
-                let temp_l = master_left * master_snap.pan_left + master_right * master_snap.pan_left;
-                let temp_r = master_left * master_snap.pan_right + master_right * master_snap.pan_right;
-                master_left = temp_l;
-                master_right = temp_r;
+                    // Apply master pan
+                    mix_left[frame_idx] = master_left * master_snap.pan_left + master_right * master_snap.pan_left;
+                    mix_right[frame_idx] = master_left * master_snap.pan_right + master_right * master_snap.pan_right;
+                }
 
                 // Process master FX chain
                 if let Ok(effect_mgr) = self.effect_manager.lock() {
-                    for effect_id in &master_snap.fx_chain {
-                        if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                            if let Ok(mut effect) = effect_arc.lock() {
-                                let (out_l, out_r) = effect.process_frame(master_left, master_right);
-                                master_left = out_l;
-                                master_right = out_r;
-                            }
-                        }
-                    }
+                    effect_mgr.process_chain_block(&master_snap.fx_chain, mix_left, mix_right);
                 }
             }
 
-            // Apply master limiter
-            let (limited_left, limited_right) = if let Ok(mut limiter) = self.master_limiter.lock() {
-                limiter.process_frame(master_left, master_right)
-            } else {
-                (master_left.clamp(-1.0, 1.0), master_right.clamp(-1.0, 1.0))
-            };
-
-            // Write to output buffer (interleaved stereo)
-            output.push(limited_left);
-            output.push(limited_right);
+            // Apply master limiter and write to output buffer (interleaved stereo)
+            let mut limiter_guard = self.master_limiter.lock().ok();
+            for frame_idx in 0..frames {
+                let (limited_left, limited_right) = if let Some(ref mut limiter) = limiter_guard {
+                    limiter.process_frame(mix_left[frame_idx], mix_right[frame_idx])
+                } else {
+                    (mix_left[frame_idx].clamp(-1.0, 1.0), mix_right[frame_idx].clamp(-1.0, 1.0))
+                };
+                output.push(limited_left);
+                output.push(limited_right);
+            }
+            drop(limiter_guard);
 
             // Progress logging every 10%
-            if frame_idx % (total_frames / 10).max(1) == 0 {
-                let progress = (frame_idx as f64 / total_frames as f64 * 100.0) as i32;
+            if block_start >= next_progress {
+                let progress = (block_start as f64 / total_frames as f64 * 100.0) as i32;
                 eprintln!("   {}% complete...", progress);
+                next_progress += progress_step;
             }
+
+            block_start += frames;
         }
 
+        self.set_chains_offline(&chains, false);
+
         eprintln!("✅ [AudioGraph] Offline render complete: {} samples", output.len());
         output
     }
@@ -1967,8 +2313,8 @@ impl AudioGraph {
                 if let Ok(track) = track_arc.lock() {
                     if track.id == track_id {
                         snapshot = Some(TrackSnapshot {
-                            audio_clips: track.audio_clips.clone(),
-                            midi_clips: track.midi_clips.clone(),
+                            audio_clips: track.playback_audio_clips().to_vec(),
+                            midi_clips: track.playback_midi_clips().to_vec(),
                             volume_gain: track.get_gain(),
                             pan_left: track.get_pan_gains().0,
                             pan_right: track.get_pan_gains().1,
@@ -1987,116 +2333,456 @@ impl AudioGraph {
             return output;
         };
 
-        // Process each frame
-        for frame_idx in 0..total_frames {
-            let playhead_seconds = frame_idx as f64 / sample_rate as f64;
+        let chains = [track_snap.fx_chain.clone()];
+        self.set_chains_offline(&chains, true);
 
-            let mut track_left = 0.0f32;
-            let mut track_right = 0.0f32;
+        let mut track_left = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let mut track_right = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let progress_step = (total_frames / 4).max(1);
+        let mut next_progress = progress_step;
 
-            // Mix all audio clips on this track
-            for timeline_clip in &track_snap.audio_clips {
-                let clip_duration = timeline_clip
-                    .duration
-                    .unwrap_or(timeline_clip.clip.duration_seconds);
-                let clip_end = timeline_clip.start_time + clip_duration;
+        // Plugins see the export as the transport playing from the start
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let recorder_refs = self.recorder.get_callback_refs();
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let mut transport = crate::vst3_host::TransportContext::new();
 
-                if playhead_seconds >= timeline_clip.start_time && playhead_seconds < clip_end {
-                    let time_in_clip =
-                        playhead_seconds - timeline_clip.start_time + timeline_clip.offset;
-                    let frame_in_clip = (time_in_clip * sample_rate as f64) as usize;
+        // Process one block at a time
+        let mut block_start = 0;
+        while block_start < total_frames {
+            let frames = OFFLINE_BLOCK_SIZE.min(total_frames - block_start);
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            let _transport = {
+                transport.update(&block_transport(
+                    &recorder_refs,
+                    block_start as u64,
+                    block_start as i64,
+                    true,
+                    transport.state(),
+                    None,
+                ));
+                transport.bind()
+            };
+            let track_left = &mut track_left[..frames];
+            let track_right = &mut track_right[..frames];
+
+            render_track_sources(
+                track_id,
+                &track_snap.audio_clips,
+                &track_snap.midi_clips,
+                block_start,
+                track_left,
+                track_right,
+                self.track_synth_manager.lock().ok().as_deref_mut(),
+            );
+
+            // Apply track volume and pan
+            let gain_left = track_snap.volume_gain * track_snap.pan_left;
+            let gain_right = track_snap.volume_gain * track_snap.pan_right;
+            for frame_idx in 0..frames {
+                track_left[frame_idx] *= gain_left;
+                track_right[frame_idx] *= gain_right;
+            }
 
-                    if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                        track_left += l;
-                    }
-                    if timeline_clip.clip.channels > 1 {
-                        if let Some(r) = timeline_clip.clip.get_sample(frame_in_clip, 1) {
-                            track_right += r;
-                        }
-                    } else {
-                        // Mono clip - duplicate to right
-                        if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
-                            track_right += l;
-                        }
-                    }
-                }
+            // Process FX chain on this track
+            if let Ok(effect_mgr) = self.effect_manager.lock() {
+                effect_mgr.process_chain_block(&track_snap.fx_chain, track_left, track_right);
             }
 
-            // Process MIDI clips through track synthesizer
-            for timeline_midi_clip in &track_snap.midi_clips {
-                let clip_start_samples = (timeline_midi_clip.start_time * sample_rate as f64) as u64;
-                let clip_end_samples =
-                    clip_start_samples + timeline_midi_clip.clip.duration_samples;
-
-                if frame_idx as u64 >= clip_start_samples && (frame_idx as u64) <= clip_end_samples
-                {
-                    let frame_in_clip = frame_idx as u64 - clip_start_samples;
-
-                    for event in &timeline_midi_clip.clip.events {
-                        if event.timestamp_samples == frame_in_clip {
-                            if let Ok(mut synth_manager) = self.track_synth_manager.lock() {
-                                match event.event_type {
-                                    crate::midi::MidiEventType::NoteOn { note, velocity } => {
-                                        synth_manager.note_on(track_id, note, velocity);
-                                    }
-                                    crate::midi::MidiEventType::NoteOff { note, velocity: _ } => {
-                                        synth_manager.note_off(track_id, note);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+            // Write to output buffer (interleaved stereo)
+            for frame_idx in 0..frames {
+                output.push(track_left[frame_idx]);
+                output.push(track_right[frame_idx]);
             }
 
-            // Add synthesizer output
-            if let Ok(mut synth_manager) = self.track_synth_manager.lock() {
-                let synth_sample = synth_manager.process_sample(track_id);
-                track_left += synth_sample;
-                track_right += synth_sample;
+            // Progress logging every 25%
+            if block_start >= next_progress {
+                let progress = (block_start as f64 / total_frames as f64 * 100.0) as i32;
+                eprintln!("   Track {} - {}% complete...", track_id, progress);
+                next_progress += progress_step;
             }
 
-            // Apply track volume
-            track_left *= track_snap.volume_gain;
-            track_right *= track_snap.volume_gain;
+            block_start += frames;
+        }
 
-            // Apply track pan
-            track_left *= track_snap.pan_left;
-            track_right *= track_snap.pan_right;
+        self.set_chains_offline(&chains, false);
 
-            // Process FX chain on this track
-            let mut fx_left = track_left;
-            let mut fx_right = track_right;
+        eprintln!(
+            "✅ [AudioGraph] Track {} offline render complete: {} samples",
+            track_id,
+            output.len()
+        );
+        output
+    }
 
-            if let Ok(effect_mgr) = self.effect_manager.lock() {
-                for effect_id in &track_snap.fx_chain {
-                    if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
-                        if let Ok(mut effect) = effect_arc.lock() {
-                            let (out_l, out_r) = effect.process_frame(fx_left, fx_right);
-                            fx_left = out_l;
-                            fx_right = out_r;
-                        }
+    /// Render several tracks in isolation in parallel, one worker per core.
+    /// Each track renders through its own copy of its FX chain (plugins are
+    /// re-instantiated from their saved state), so stems neither wait on
+    /// each other nor touch the live instances. Tracks whose chain can't be
+    /// copied fall back to `render_track_offline` afterwards.
+    ///
+    /// `on_track_done(done, total)` is called from the workers as tracks
+    /// finish; once `should_stop` returns true the remaining renders are
+    /// abandoned and left out of the result.
+    /// Returns (track_id, interleaved stereo samples) in `track_ids` order
+    pub fn render_tracks_offline_parallel(
+        &self,
+        track_ids: &[u64],
+        duration_seconds: f64,
+        on_track_done: &(dyn Fn(usize, usize) + Sync),
+        should_stop: &(dyn Fn() -> bool + Sync),
+    ) -> Vec<(u64, Vec<f32>)> {
+        let total_frames = (duration_seconds * TARGET_SAMPLE_RATE as f64) as usize;
+        let total = track_ids.len();
+
+        // Prepare jobs on this thread: plugin instances are created here,
+        // only processing happens on the workers
+        let mut jobs: Vec<Mutex<Option<TrackRenderJob>>> = Vec::with_capacity(total);
+        for &track_id in track_ids {
+            let job = match self.prepare_track_render_job(track_id) {
+                Ok(job) => Some(job),
+                Err(e) => {
+                    eprintln!("⚠️  [AudioGraph] Track {} renders on the shared chain: {}", track_id, e);
+                    None
+                }
+            };
+            jobs.push(Mutex::new(job));
+        }
+
+        let workers = std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(4)
+            .min(total)
+            .max(1);
+        eprintln!(
+            "🎚️ [AudioGraph] Rendering {} tracks on {} worker threads: {:.2}s ({} frames)",
+            total, workers, duration_seconds, total_frames
+        );
+
+        let results: Vec<Mutex<Option<Vec<f32>>>> = (0..total).map(|_| Mutex::new(None)).collect();
+        let next_job = std::sync::atomic::AtomicUsize::new(0);
+        let done = std::sync::atomic::AtomicUsize::new(0);
+
+        std::thread::scope(|scope| {
+            for _ in 0..workers {
+                scope.spawn(|| loop {
+                    let index = next_job.fetch_add(1, Ordering::Relaxed);
+                    if index >= total || should_stop() {
+                        break;
                     }
+                    let Some(job) = jobs[index].lock().expect("mutex poisoned").take() else {
+                        continue;
+                    };
+                    if let Some(samples) = job.render(total_frames, should_stop) {
+                        *results[index].lock().expect("mutex poisoned") = Some(samples);
+                        on_track_done(done.fetch_add(1, Ordering::Relaxed) + 1, total);
+                    }
+                });
+            }
+        });
+
+        let mut rendered = Vec::with_capacity(total);
+        for (index, &track_id) in track_ids.iter().enumerate() {
+            if should_stop() {
+                break;
+            }
+            let samples = match results[index].lock().expect("mutex poisoned").take() {
+                Some(samples) => samples,
+                None => {
+                    let samples = self.render_track_offline(track_id, duration_seconds);
+                    on_track_done(done.fetch_add(1, Ordering::Relaxed) + 1, total);
+                    samples
+                }
+            };
+            rendered.push((track_id, samples));
+        }
+
+        eprintln!("✅ [AudioGraph] Parallel render complete: {} tracks", rendered.len());
+        rendered
+    }
+
+    /// Snapshot a track and copy its FX chain (bypassed effects are left
+    /// out, as in the live chain) for a `TrackRenderJob`
+    fn prepare_track_render_job(&self, track_id: u64) -> Result<TrackRenderJob, String> {
+        let (audio_clips, midi_clips, volume_gain, pan_left, pan_right, fx_chain) = {
+            let tm = self.track_manager.lock().expect("mutex poisoned");
+            let track_arc = tm
+                .get_track(track_id)
+                .ok_or_else(|| format!("Track {} not found", track_id))?;
+            let track = track_arc.lock().map_err(|e| e.to_string())?;
+            (
+                track.playback_audio_clips().to_vec(),
+                track.playback_midi_clips().to_vec(),
+                track.get_gain(),
+                track.get_pan_gains().0,
+                track.get_pan_gains().1,
+                track.fx_chain.clone(),
+            )
+        };
+
+        let mut effects = Vec::with_capacity(fx_chain.len());
+        {
+            let effect_mgr = self.effect_manager.lock().expect("mutex poisoned");
+            for effect_id in &fx_chain {
+                if effect_mgr.is_bypassed(*effect_id) {
+                    continue;
+                }
+                if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
+                    let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+                    effects.push(effect.clone_instance()?);
                 }
             }
+        }
 
-            // Write to output buffer (interleaved stereo)
-            output.push(fx_left);
-            output.push(fx_right);
+        let synth = self
+            .track_synth_manager
+            .lock()
+            .expect("mutex poisoned")
+            .copy_synth_to_new_manager(track_id);
 
-            // Progress logging every 25%
-            if frame_idx % (total_frames / 4).max(1) == 0 && frame_idx > 0 {
-                let progress = (frame_idx as f64 / total_frames as f64 * 100.0) as i32;
-                eprintln!("   Track {} - {}% complete...", track_id, progress);
+        Ok(TrackRenderJob {
+            track_id,
+            audio_clips,
+            midi_clips,
+            volume_gain,
+            pan_left,
+            pan_right,
+            effects,
+            synth,
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            recorder: self.recorder.get_callback_refs(),
+        })
+    }
+
+    // --- Track Freeze ---
+
+    /// Freeze a track: render its clips, synth and FX chain (pre-fader, in
+    /// offline mode) to an audio file in `cache_dir`, then unload the chain
+    /// and synth and play the render through the clip path instead. Volume,
+    /// pan, sends and effects added after freezing stay live.
+    /// Returns the length of the render in seconds
+    pub fn freeze_track(&self, track_id: TrackId, cache_dir: &std::path::Path) -> Result<f64, String> {
+        let (snapshot, fx_chain) = {
+            let tm = self.track_manager.lock().map_err(|e| e.to_string())?;
+            let track_arc = tm
+                .get_track(track_id)
+                .ok_or_else(|| format!("Track {} not found", track_id))?;
+            let track = track_arc.lock().map_err(|e| e.to_string())?;
+            if !matches!(track.track_type, TrackType::Audio | TrackType::Midi) {
+                return Err(format!("Track {} is not an audio or MIDI track", track_id));
             }
+            if track.frozen.is_some() {
+                return Err(format!("Track {} is already frozen", track_id));
+            }
+            (TrackSnapshot::capture(&track), track.fx_chain.clone())
+        };
+
+        let end_seconds = snapshot
+            .audio_clips
+            .iter()
+            .map(|clip| clip.start_time + clip.duration.unwrap_or(clip.clip.duration_seconds))
+            .chain(snapshot.midi_clips.iter().map(|clip| {
+                clip.start_time + clip.clip.duration_samples as f64 / TARGET_SAMPLE_RATE as f64
+            }))
+            .fold(0.0, f64::max);
+        if end_seconds <= 0.0 {
+            return Err(format!("Track {} has no clips to freeze", track_id));
         }
+        let total_frames = ((end_seconds + FREEZE_TAIL_SECONDS) * TARGET_SAMPLE_RATE as f64) as usize;
+
+        // Render through copies of the chain and synth, so the track keeps
+        // playing live until the render is swapped in
+        let mut effects = Vec::with_capacity(fx_chain.len());
+        let mut latency = 0;
+        {
+            let effect_mgr = self.effect_manager.lock().map_err(|e| e.to_string())?;
+            for effect_id in &fx_chain {
+                if effect_mgr.is_bypassed(*effect_id) {
+                    continue;
+                }
+                if let Some(effect_arc) = effect_mgr.get_effect(*effect_id) {
+                    let mut copy = effect_arc.lock().map_err(|e| e.to_string())?.clone_instance()?;
+                    copy.set_offline_mode(true, OFFLINE_BLOCK_SIZE);
+                    latency += copy.latency_samples() as usize;
+                    effects.push(ChainEffect { effect: Arc::new(Mutex::new(copy)), bypassed: false });
+                }
+            }
+        }
+        let (mut synth_copy, synth_data) = {
+            let synth_mgr = self.track_synth_manager.lock().map_err(|e| e.to_string())?;
+            (synth_mgr.copy_synth_to_new_manager(track_id), synth_mgr.get_synth_parameters(track_id))
+        };
 
         eprintln!(
-            "✅ [AudioGraph] Track {} offline render complete: {} samples",
+            "🧊 [AudioGraph] Freezing track {}: {:.2}s, {} effects",
             track_id,
-            output.len()
+            total_frames as f64 / TARGET_SAMPLE_RATE as f64,
+            effects.len()
         );
-        output
+        let synth = synth_copy.synths_mut().next().map(|(_, synth)| synth);
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let samples = render_frozen_track(
+            &snapshot,
+            synth,
+            &effects,
+            total_frames,
+            latency,
+            &self.recorder.get_callback_refs(),
+        );
+        #[cfg(not(all(feature = "vst3", not(target_os = "ios"))))]
+        let samples = render_frozen_track(&snapshot, synth, &effects, total_frames, latency);
+        drop(effects);
+
+        std::fs::create_dir_all(cache_dir).map_err(|e| format!("Failed to create freeze cache folder: {}", e))?;
+        let stamp = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .map(|elapsed| elapsed.as_millis())
+            .unwrap_or(0);
+        let cache_path = cache_dir.join(format!("freeze-track{}-{}.wav", track_id, stamp));
+        let options = crate::export::ExportOptions::wav(crate::export::WavBitDepth::Float32)
+            .with_sample_rate(TARGET_SAMPLE_RATE);
+        crate::export::export_wav(&samples, &cache_path, &options)?;
+
+        let duration_seconds = (samples.len() / 2) as f64 / TARGET_SAMPLE_RATE as f64;
+        let clip_id = {
+            let mut next_id = self.next_clip_id.lock().map_err(|e| e.to_string())?;
+            let id = *next_id;
+            *next_id += 1;
+            id
+        };
+        let clip = TimelineClip {
+            id: clip_id,
+            clip: Arc::new(AudioClip {
+                samples,
+                channels: 2,
+                sample_rate: TARGET_SAMPLE_RATE,
+                duration_seconds,
+                file_path: cache_path.to_string_lossy().to_string(),
+            }),
+            start_time: 0.0,
+            offset: 0.0,
+            duration: None,
+        };
+
+        // Save the plugins' states, then swap the render in (unless the
+        // chain was edited while rendering)
+        let mut parked = Vec::with_capacity(fx_chain.len());
+        for effect_id in &fx_chain {
+            let (effect_arc, bypassed) = {
+                let effect_mgr = self.effect_manager.lock().map_err(|e| e.to_string())?;
+                (effect_mgr.get_effect(*effect_id), effect_mgr.is_bypassed(*effect_id))
+            };
+            if let Some(effect_arc) = effect_arc {
+                let effect = effect_arc.lock().map_err(|e| e.to_string())?;
+                parked.push((*effect_id, bypassed, ParkedEffect::park(&effect)?));
+            }
+        }
+
+        {
+            // Same order as everywhere else: track manager, then effects
+            let tm = self.track_manager.lock().map_err(|e| e.to_string())?;
+            let mut effect_mgr = self.effect_manager.lock().map_err(|e| e.to_string())?;
+            let track_arc = tm
+                .get_track(track_id)
+                .ok_or_else(|| format!("Track {} not found", track_id))?;
+            let mut track = track_arc.lock().map_err(|e| e.to_string())?;
+            if track.fx_chain != fx_chain || track.frozen.is_some() {
+                let _ = std::fs::remove_file(&cache_path);
+                return Err(format!("Track {} changed while freezing", track_id));
+            }
+
+            for effect_id in &fx_chain {
+                effect_mgr.remove_effect(*effect_id);
+            }
+            track.fx_chain.clear();
+            track.frozen = Some(Box::new(FrozenTrack {
+                clip,
+                cache_path,
+                fx_chain: parked,
+                synth: synth_data.clone(),
+            }));
+        }
+        if synth_data.is_some() {
+            self.track_synth_manager.lock().map_err(|e| e.to_string())?.remove_synth(track_id);
+        }
+        self.fx_chains_changed();
+
+        eprintln!("✅ [AudioGraph] Track {} frozen ({} effects unloaded)", track_id, fx_chain.len());
+        Ok(duration_seconds)
+    }
+
+    /// Unfreeze a track: load its FX chain (plugins restored from the state
+    /// saved when freezing) and synth back, ahead of any effects added while
+    /// frozen, and delete the cached render. If a plugin fails to load the
+    /// track stays frozen
+    pub fn unfreeze_track(&self, track_id: TrackId) -> Result<(), String> {
+        let (parked, synth_data) = {
+            let tm = self.track_manager.lock().map_err(|e| e.to_string())?;
+            let track_arc = tm
+                .get_track(track_id)
+                .ok_or_else(|| format!("Track {} not found", track_id))?;
+            let track = track_arc.lock().map_err(|e| e.to_string())?;
+            let frozen = track
+                .frozen
+                .as_ref()
+                .ok_or_else(|| format!("Track {} is not frozen", track_id))?;
+            (frozen.fx_chain.clone(), frozen.synth.clone())
+        };
+
+        // Plugins can take a while to load; do it before touching the track
+        let mut restored = Vec::with_capacity(parked.len());
+        for (_, bypassed, effect) in &parked {
+            let live = effect
+                .restore()
+                .map_err(|e| format!("Failed to reload {}: {}", effect.name(), e))?;
+            restored.push((live, *bypassed));
+        }
+
+        if let Some(synth_data) = &synth_data {
+            let mut synth_mgr = self.track_synth_manager.lock().map_err(|e| e.to_string())?;
+            synth_mgr.create_synth(track_id);
+            synth_mgr.restore_synth_parameters(track_id, synth_data);
+        }
+
+        let frozen = {
+            // Same order as everywhere else: track manager, then effects
+            let tm = self.track_manager.lock().map_err(|e| e.to_string())?;
+            let mut effect_mgr = self.effect_manager.lock().map_err(|e| e.to_string())?;
+            let track_arc = tm
+                .get_track(track_id)
+                .ok_or_else(|| format!("Track {} not found", track_id))?;
+            let mut track = track_arc.lock().map_err(|e| e.to_string())?;
+            let Some(frozen) = track.frozen.take() else {
+                return Err(format!("Track {} is not frozen", track_id));
+            };
+
+            let mut chain = Vec::with_capacity(restored.len() + track.fx_chain.len());
+            for (effect, bypassed) in restored {
+                let effect_id = effect_mgr.create_effect(effect);
+                effect_mgr.set_bypass(effect_id, bypassed);
+                chain.push(effect_id);
+            }
+            chain.extend_from_slice(&track.fx_chain);
+            track.fx_chain = chain;
+            frozen
+        };
+        self.fx_chains_changed();
+
+        if let Err(e) = std::fs::remove_file(&frozen.cache_path) {
+            eprintln!("⚠️  [AudioGraph] Failed to delete freeze cache {:?}: {}", frozen.cache_path, e);
+        }
+        eprintln!("✅ [AudioGraph] Track {} unfrozen ({} effects reloaded)", track_id, frozen.fx_chain.len());
+        Ok(())
+    }
+
+    /// Whether a track is frozen (false if it doesn't exist)
+    pub fn is_track_frozen(&self, track_id: TrackId) -> bool {
+        let Ok(tm) = self.track_manager.lock() else {
+            return false;
+        };
+        tm.get_track(track_id)
+            .and_then(|track_arc| track_arc.lock().ok().map(|track| track.frozen.is_some()))
+            .unwrap_or(false)
     }
 
     /// Get track info for stem export (id, name, type)
@@ -2211,6 +2897,776 @@ impl AudioGraph {
     }
 }
 
+// ============================================================================
+// LIVE TRACK MIXING
+// ============================================================================
+
+/// Transport for plugins processing the block at `playhead`. The timeline
+/// has no loop range, so the cycle is never active. Anything whose lock
+/// fails keeps its value from `previous`, the last block's transport
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+fn block_transport(
+    recorder: &crate::recorder::RecorderCallbackRefs,
+    playhead: u64,
+    continuous_samples: i64,
+    playing: bool,
+    previous: &crate::vst3_host::VST3Transport,
+    telemetry: Option<&CallbackTelemetry>,
+) -> crate::vst3_host::VST3Transport {
+    let recording = lock_charged(telemetry, CallbackStage::Recorder, &recorder.state)
+        .map(|state| *state == crate::recorder::RecordingState::Recording)
+        .unwrap_or(previous.recording);
+    let tempo = lock_charged(telemetry, CallbackStage::Recorder, &recorder.tempo)
+        .map(|tempo| *tempo)
+        .unwrap_or(previous.tempo);
+    let time_sig_numerator = lock_charged(telemetry, CallbackStage::Recorder, &recorder.time_signature)
+        .map(|numerator| *numerator as i32)
+        .unwrap_or(previous.time_sig_numerator);
+    crate::vst3_host::VST3Transport {
+        sample_rate: TARGET_SAMPLE_RATE as f64,
+        project_time_samples: playhead as i64,
+        continuous_time_samples: continuous_samples,
+        tempo,
+        time_sig_numerator,
+        time_sig_denominator: 4,
+        playing,
+        recording,
+        ..Default::default()
+    }
+}
+
+/// Render one track's block starting at timeline frame `current_playhead`:
+/// clips and per-track MIDI (to the built-in synth and to VST3 instruments
+/// in the chain), then the FX chain. Adds on top of the block, which already
+/// holds the track's bus inputs if it's a group or return. Runs on a pool
+/// worker, for the live callback (charging `telemetry`) or the render-ahead
+/// thread
+fn render_live_track(
+    track_snap: &TrackSnapshot,
+    synth: Option<&mut Synth>,
+    effects: &[ChainEffect],
+    current_playhead: u64,
+    track_left: &mut [f32],
+    track_right: &mut [f32],
+    telemetry: Option<&CallbackTelemetry>,
+) {
+    let frames = track_left.len().min(track_right.len());
+
+    for frame_idx in 0..frames {
+        let playhead_frame = current_playhead + frame_idx as u64;
+        let playhead_seconds = playhead_frame as f64 / TARGET_SAMPLE_RATE as f64;
+
+        let mut frame_left = 0.0;
+        let mut frame_right = 0.0;
+
+        // Mix all audio clips on this track
+        for timeline_clip in &track_snap.audio_clips {
+            let clip_duration = timeline_clip.duration
+                .unwrap_or(timeline_clip.clip.duration_seconds);
+            let clip_end = timeline_clip.start_time + clip_duration;
+
+            if playhead_seconds >= timeline_clip.start_time
+                && playhead_seconds < clip_end
+            {
+                let time_in_clip = playhead_seconds - timeline_clip.start_time + timeline_clip.offset;
+                let frame_in_clip = (time_in_clip * TARGET_SAMPLE_RATE as f64) as usize;
+
+                if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
+                    frame_left += l;
+                }
+                if timeline_clip.clip.channels > 1 {
+                    if let Some(r) = timeline_clip.clip.get_sample(frame_in_clip, 1) {
+                        frame_right += r;
+                    }
+                } else {
+                    // Mono clip - duplicate to right
+                    if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
+                        frame_right += l;
+                    }
+                }
+            }
+        }
+
+        track_left[frame_idx] += frame_left;
+        track_right[frame_idx] += frame_right;
+    }
+
+    // Per-track MIDI clips. VST3 instruments in the FX chain get the block's
+    // events queued up front with their offsets into it, delivered when the
+    // chain processes the block below
+    let block_end = current_playhead + frames as u64;
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    queue_block_midi(&track_snap.midi_clips, effects, current_playhead, block_end, telemetry);
+
+    // The built-in synth (M6) renders up to each event, then takes it
+    if let Some(synth) = synth {
+        // `cursor` is the first timeline frame whose events haven't fired
+        let mut frame = 0;
+        let mut cursor = current_playhead;
+        loop {
+            let next = next_midi_frame(&track_snap.midi_clips, cursor, block_end);
+            let until = next.map_or(frames, |at| (at - current_playhead) as usize);
+            for frame_idx in frame..until {
+                let synth_sample = synth.process_sample();
+                track_left[frame_idx] += synth_sample;
+                track_right[frame_idx] += synth_sample;
+            }
+            let Some(at) = next else {
+                break;
+            };
+            for timeline_midi_clip in &track_snap.midi_clips {
+                for event in clip_events_between(timeline_midi_clip, at, at + 1).1 {
+                    match event.event_type {
+                        crate::midi::MidiEventType::NoteOn { note, velocity } => synth.note_on(note, velocity),
+                        crate::midi::MidiEventType::NoteOff { note, velocity: _ } => synth.note_off(note),
+                    }
+                }
+            }
+            frame = until;
+            cursor = at + 1;
+        }
+    }
+
+    // Process FX chain on this track BEFORE volume/pan
+    // This is important because VST3 instruments generate their own audio
+    // and we want the fader to control the post-FX output level
+    process_chain(effects, track_left, track_right, telemetry);
+}
+
+/// A MIDI clip's first timeline frame and its events in timeline frames
+/// `[start, end)`. A clip plays through its end frame, so note-offs placed
+/// exactly at the end still fire
+fn clip_events_between(clip: &TimelineMidiClip, start: u64, end: u64) -> (u64, &[crate::midi::MidiEvent]) {
+    let clip_start = (clip.start_time * TARGET_SAMPLE_RATE as f64) as u64;
+    let clip_end = clip_start + clip.clip.duration_samples + 1;
+    let (start, end) = (start.max(clip_start), end.min(clip_end));
+    if start >= end {
+        return (clip_start, &[]);
+    }
+    (clip_start, clip.clip.events_between(start - clip_start, end - clip_start))
+}
+
+/// Timeline frame of the first MIDI event in `[start, end)` on any clip
+fn next_midi_frame(clips: &[TimelineMidiClip], start: u64, end: u64) -> Option<u64> {
+    clips
+        .iter()
+        .filter_map(|clip| {
+            let (clip_start, events) = clip_events_between(clip, start, end);
+            events.first().map(|event| clip_start + event.timestamp_samples)
+        })
+        .min()
+}
+
+/// Queue the MIDI events of timeline frames `[start, end)` on the chain's
+/// VST3 instruments, with their offsets into the block. Locks each plugin
+/// once, and only if the block has events
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+fn queue_block_midi(
+    clips: &[TimelineMidiClip],
+    effects: &[ChainEffect],
+    start: u64,
+    end: u64,
+    telemetry: Option<&CallbackTelemetry>,
+) {
+    if next_midi_frame(clips, start, end).is_none() {
+        return;
+    }
+    for entry in effects {
+        let Ok(mut effect) = entry.lock(telemetry) else {
+            continue;
+        };
+        let EffectType::VST3(ref mut vst3) = *effect else {
+            continue;
+        };
+        for clip in clips {
+            let (clip_start, events) = clip_events_between(clip, start, end);
+            for event in events {
+                let offset = (clip_start + event.timestamp_samples - start) as i32;
+                let _ = match event.event_type {
+                    crate::midi::MidiEventType::NoteOn { note, velocity } => {
+                        vst3.try_process_midi_event(0, 0, note as i32, velocity as i32, offset)
+                    }
+                    crate::midi::MidiEventType::NoteOff { note, velocity: _ } => {
+                        vst3.try_process_midi_event(1, 0, note as i32, 0, offset)
+                    }
+                };
+            }
+        }
+    }
+}
+
+/// Add a routed block (a group member's output or a send) into a bus's block
+fn mix_into_task(target: &Mutex<TrackTask>, left: &[f32], right: &[f32], gain: f32) {
+    if let Ok(mut target) = target.lock() {
+        let block = &mut *target.block;
+        for (dst, src) in block.left.iter_mut().zip(left) {
+            *dst += src * gain;
+        }
+        for (dst, src) in block.right.iter_mut().zip(right) {
+            *dst += src * gain;
+        }
+    }
+}
+
+// ============================================================================
+// RENDER-AHEAD THREAD
+// ============================================================================
+
+/// What the render-ahead thread shares with the graph
+struct RenderAheadContext {
+    render_ahead: Arc<RenderAheadState>,
+    transport: Arc<AtomicU8>,
+    playhead_samples: Arc<AtomicU64>,
+    track_manager: Arc<Mutex<TrackManager>>,
+    effect_manager: Arc<Mutex<EffectManager>>,
+    track_synth_manager: Arc<Mutex<TrackSynthManager>>,
+    /// Tempo and time signature for the plugins' transport
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    recorder: crate::recorder::RecorderCallbackRefs,
+}
+
+/// One block to render for one track
+struct AheadJob {
+    snapshot: TrackSnapshot,
+    effects: Vec<ChainEffect>,
+    block: AheadBlock,
+}
+
+/// Tracks that can be rendered ahead: audio/MIDI tracks nobody is playing
+/// live (not armed, not monitored) whose FX chain has something to run.
+/// Tracks with a built-in synth stay live - it shares a lock with the
+/// callback and costs little
+fn render_ahead_candidates(context: &RenderAheadContext) -> Vec<TrackId> {
+    let tracks: Vec<(TrackId, Vec<u64>)> = {
+        let Ok(tm) = context.track_manager.lock() else {
+            return Vec::new();
+        };
+        tm.get_all_tracks()
+            .iter()
+            .filter_map(|track_arc| {
+                let track = track_arc.lock().ok()?;
+                let eligible = matches!(track.track_type, TrackType::Audio | TrackType::Midi)
+                    && !track.armed
+                    && !track.input_monitoring
+                    && !track.fx_chain.is_empty();
+                eligible.then(|| (track.id, track.fx_chain.clone()))
+            })
+            .collect()
+    };
+
+    let tracks: Vec<TrackId> = match context.effect_manager.lock() {
+        Ok(effect_mgr) => tracks
+            .into_iter()
+            .filter(|(_, chain)| chain.iter().any(|id| effect_mgr.get_effect(*id).is_some() && !effect_mgr.is_bypassed(*id)))
+            .map(|(id, _)| id)
+            .collect(),
+        Err(_) => return Vec::new(),
+    };
+
+    match context.track_synth_manager.lock() {
+        Ok(synths) => tracks.into_iter().filter(|id| !synths.has_synth(*id)).collect(),
+        Err(_) => Vec::new(),
+    }
+}
+
+/// Fills the render-ahead rings: whenever a track's lead isn't full, renders
+/// its next block (clips, MIDI and FX chain) with the same code as the live
+/// path, on the thread's own worker pool
+fn render_ahead_loop(context: RenderAheadContext) {
+    let pool = WorkStealingPool::with_default_workers();
+    let mut publisher = AheadTablePublisher::new(context.render_ahead.clone());
+    // Writer, the track the callback reads and the table generation that
+    // added it (not rendered until the callback has switched to that table)
+    let mut writers: Vec<(TrackId, AheadWriter, Arc<AheadTrack>, u64)> = Vec::new();
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    let mut transports: Vec<crate::vst3_host::TransportContext> = Vec::new();
+    let mut config_generation = u64::MAX;
+    let mut last_scan: Option<std::time::Instant> = None;
+    let idle = std::time::Duration::from_millis(1);
+
+    while !context.render_ahead.shutdown.load(Ordering::Relaxed) {
+        let enabled = context.render_ahead.enabled.load(Ordering::Relaxed);
+        let generation = context.render_ahead.config_generation.load(Ordering::SeqCst);
+        if !enabled || generation != config_generation {
+            // Settings changed: every track goes back to the live path
+            // until the next play() hands it over again
+            if !writers.is_empty() {
+                publisher.publish(AheadTable::default());
+                writers.clear();
+            }
+            config_generation = generation;
+            last_scan = None;
+            if !enabled {
+                std::thread::sleep(std::time::Duration::from_millis(20));
+                continue;
+            }
+        }
+
+        // Plugins only run ahead while the transport does (or play() is
+        // priming); once stopped, the callback gets every track back
+        let playing = context.transport.load(Ordering::SeqCst) == TransportState::Playing as u8;
+        let priming = context.render_ahead.priming.load(Ordering::SeqCst);
+        if !playing && !priming {
+            if !writers.is_empty() {
+                publisher.publish(AheadTable::default());
+                writers.clear();
+            }
+            publisher.reclaim();
+            std::thread::sleep(std::time::Duration::from_millis(5));
+            continue;
+        }
+
+        // Pick up tracks being armed, disarmed, added or removed
+        let joining = priming && !context.render_ahead.primed.load(Ordering::SeqCst);
+        let scan_due = joining
+            || last_scan.map_or(true, |at| {
+                at.elapsed() >= std::time::Duration::from_millis(RENDER_AHEAD_SCAN_INTERVAL_MS)
+            });
+        if scan_due {
+            let candidates = render_ahead_candidates(&context);
+            let lead_frames = context.render_ahead.lead_frames(TARGET_SAMPLE_RATE);
+            let count = writers.len();
+            writers.retain(|(id, ..)| candidates.contains(id));
+            let mut changed = writers.len() != count;
+
+            // New rings are built here; the callback only sees them in a
+            // published table, and removed ones are freed by `reclaim`.
+            // Tracks only join while priming: during playback the callback
+            // is running their plugins live and can't hand them over
+            // without a gap, so they wait for the next play()
+            let mut added = Vec::new();
+            if joining {
+                let playhead = context.playhead_samples.load(Ordering::SeqCst);
+                for &id in &candidates {
+                    if !writers.iter().any(|(writer_id, ..)| *writer_id == id) {
+                        let (writer, mut reader) = ahead_ring(lead_frames);
+                        reader.restart_at(playhead);
+                        added.push((id, writer, Arc::new(AheadTrack::new(reader))));
+                    }
+                }
+            }
+            changed |= !added.is_empty();
+            if changed {
+                let tracks = writers
+                    .iter()
+                    .map(|(id, _, track, _)| (*id, track.clone()))
+                    .chain(added.iter().map(|(id, _, track)| (*id, track.clone())))
+                    .collect();
+                let generation = publisher.publish(AheadTable::new(tracks));
+                writers.extend(added.into_iter().map(|(id, writer, track)| (id, writer, track, generation)));
+            }
+            publisher.reclaim();
+            last_scan = Some(std::time::Instant::now());
+        }
+
+        let playhead = context.playhead_samples.load(Ordering::SeqCst);
+        let acknowledged = publisher.acknowledged();
+        // play() waits until the callback holds the table and every ring
+        // has the playhead, so no track starts on silence
+        if joining
+            && writers
+                .iter_mut()
+                .all(|(_, writer, _, generation)| *generation <= acknowledged && writer.has_frame(playhead))
+        {
+            context.render_ahead.primed.store(true, Ordering::SeqCst);
+        }
+        let wanted: Vec<usize> = writers
+            .iter_mut()
+            .enumerate()
+            .filter(|(_, (_, _, _, generation))| *generation <= acknowledged)
+            .filter_map(|(index, (_, writer, ..))| writer.wants_block(playhead).then_some(index))
+            .collect();
+        if wanted.is_empty() {
+            std::thread::sleep(idle);
+            continue;
+        }
+
+        let snapshots: Vec<Option<TrackSnapshot>> = match context.track_manager.lock() {
+            Ok(tm) => wanted
+                .iter()
+                .map(|&index| {
+                    let track_arc = tm.get_track(writers[index].0)?;
+                    let track = track_arc.lock().ok()?;
+                    Some(TrackSnapshot::capture(&track))
+                })
+                .collect(),
+            Err(_) => {
+                std::thread::sleep(idle);
+                continue;
+            }
+        };
+
+        let mut jobs: Vec<(usize, Mutex<AheadJob>)> = Vec::with_capacity(wanted.len());
+        if let Ok(effect_mgr) = context.effect_manager.lock() {
+            for (&index, snapshot) in wanted.iter().zip(snapshots) {
+                let Some(snapshot) = snapshot else {
+                    continue;
+                };
+                let Some(block) = writers[index].1.begin_block(playhead) else {
+                    continue;
+                };
+                let effects = resolve_chain(&effect_mgr, &snapshot.fx_chain);
+                jobs.push((index, Mutex::new(AheadJob { snapshot, effects, block })));
+            }
+        }
+
+        // Every job is a block at its own position, so each gets its own
+        // transport; plugins see it playing from the block's start
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        {
+            while transports.len() < jobs.len() {
+                transports.push(crate::vst3_host::TransportContext::new());
+            }
+            for (transport, (_, job)) in transports.iter_mut().zip(&jobs) {
+                if let Ok(job) = job.lock() {
+                    let start = job.block.start_frame();
+                    transport.update(&block_transport(
+                        &context.recorder,
+                        start,
+                        start as i64,
+                        true,
+                        transport.state(),
+                        None,
+                    ));
+                }
+            }
+        }
+
+        pool.run(jobs.len(), |k| {
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            let _transport = transports[k].bind();
+            if let Ok(mut job) = jobs[k].1.lock() {
+                let AheadJob { snapshot, effects, block } = &mut *job;
+                let start_frame = block.start_frame();
+                render_live_track(snapshot, None, effects, start_frame, &mut block.left, &mut block.right, None);
+            }
+        });
+
+        for (index, job) in jobs {
+            if let Ok(job) = job.into_inner() {
+                writers[index].1.commit(job.block);
+            }
+        }
+    }
+
+    publisher.publish(AheadTable::default());
+}
+
+// ============================================================================
+// OFFLINE TRACK RENDERING
+// ============================================================================
+
+/// A track prepared for rendering on its own thread: copies of its clips
+/// and synth and fresh instances of its FX chain, so it shares no state with
+/// the live graph or with other jobs
+struct TrackRenderJob {
+    track_id: u64,
+    audio_clips: Vec<TimelineClip>,
+    midi_clips: Vec<TimelineMidiClip>,
+    volume_gain: f32,
+    pan_left: f32,
+    pan_right: f32,
+    effects: Vec<EffectType>,
+    synth: TrackSynthManager,
+    /// Tempo and time signature for the plugins' transport
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    recorder: crate::recorder::RecorderCallbackRefs,
+}
+
+impl TrackRenderJob {
+    /// Render the track in isolation (no master bus), like `render_track_offline`.
+    /// Returns None if `should_stop` asked to abandon the render
+    fn render(mut self, total_frames: usize, should_stop: &(dyn Fn() -> bool + Sync)) -> Option<Vec<f32>> {
+        for effect in &mut self.effects {
+            effect.set_offline_mode(true, OFFLINE_BLOCK_SIZE);
+        }
+
+        let mut output = Vec::with_capacity(total_frames * 2);
+        let mut left = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let mut right = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+        let gain_left = self.volume_gain * self.pan_left;
+        let gain_right = self.volume_gain * self.pan_right;
+
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let mut transport = crate::vst3_host::TransportContext::new();
+
+        let mut block_start = 0;
+        while block_start < total_frames {
+            if should_stop() {
+                return None;
+            }
+
+            let frames = OFFLINE_BLOCK_SIZE.min(total_frames - block_start);
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            let _transport = {
+                transport.update(&block_transport(
+                    &self.recorder,
+                    block_start as u64,
+                    block_start as i64,
+                    true,
+                    transport.state(),
+                    None,
+                ));
+                transport.bind()
+            };
+            let left = &mut left[..frames];
+            let right = &mut right[..frames];
+
+            render_track_sources(
+                self.track_id,
+                &self.audio_clips,
+                &self.midi_clips,
+                block_start,
+                left,
+                right,
+                Some(&mut self.synth),
+            );
+
+            for frame_idx in 0..frames {
+                left[frame_idx] *= gain_left;
+                right[frame_idx] *= gain_right;
+            }
+
+            for effect in &mut self.effects {
+                effect.process_block(left, right);
+            }
+
+            for frame_idx in 0..frames {
+                output.push(left[frame_idx]);
+                output.push(right[frame_idx]);
+            }
+
+            block_start += frames;
+        }
+
+        // The effect instances (and any cloned plugins) are released here
+        Some(output)
+    }
+}
+
+/// Render a track for freezing: sources then FX chain, as on the live path
+/// (pre-fader), in offline blocks. The chain's latency is rendered past the
+/// end and trimmed off the front, so the result lines up with the timeline.
+/// Plugins see the transport playing from the render position. Returns
+/// interleaved stereo
+fn render_frozen_track(
+    snapshot: &TrackSnapshot,
+    mut synth: Option<&mut Synth>,
+    effects: &[ChainEffect],
+    total_frames: usize,
+    latency: usize,
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))] recorder: &crate::recorder::RecorderCallbackRefs,
+) -> Vec<f32> {
+    let rendered_frames = total_frames + latency;
+    let mut output = Vec::with_capacity(total_frames * 2);
+    let mut left = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+    let mut right = vec![0.0f32; OFFLINE_BLOCK_SIZE];
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    let mut transport = crate::vst3_host::TransportContext::new();
+
+    let mut block_start = 0;
+    while block_start < rendered_frames {
+        let frames = OFFLINE_BLOCK_SIZE.min(rendered_frames - block_start);
+        let left = &mut left[..frames];
+        let right = &mut right[..frames];
+        left.fill(0.0);
+        right.fill(0.0);
+
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        let _transport = {
+            transport.update(&block_transport(
+                recorder,
+                block_start as u64,
+                block_start as i64,
+                true,
+                transport.state(),
+                None,
+            ));
+            transport.bind()
+        };
+        render_live_track(snapshot, synth.as_deref_mut(), effects, block_start as u64, left, right, None);
+
+        let skip = latency.saturating_sub(block_start).min(frames);
+        for frame_idx in skip..frames {
+            output.push(left[frame_idx]);
+            output.push(right[frame_idx]);
+        }
+        block_start += frames;
+    }
+    output
+}
+
+/// Render a track's clips and synth into one offline block, before
+/// volume, pan and FX. `start_frame` is the block's position on the timeline.
+/// The synth (if any) is the manager holding this track's synth
+fn render_track_sources(
+    track_id: u64,
+    audio_clips: &[TimelineClip],
+    midi_clips: &[TimelineMidiClip],
+    start_frame: usize,
+    left: &mut [f32],
+    right: &mut [f32],
+    synth: Option<&mut TrackSynthManager>,
+) {
+    let sample_rate = TARGET_SAMPLE_RATE;
+
+    for frame_idx in 0..left.len().min(right.len()) {
+        let timeline_frame = start_frame + frame_idx;
+        let playhead_seconds = timeline_frame as f64 / sample_rate as f64;
+
+        let mut frame_left = 0.0f32;
+        let mut frame_right = 0.0f32;
+
+        // Mix all audio clips on this track
+        for timeline_clip in audio_clips {
+            let clip_duration = timeline_clip
+                .duration
+                .unwrap_or(timeline_clip.clip.duration_seconds);
+            let clip_end = timeline_clip.start_time + clip_duration;
+
+            if playhead_seconds >= timeline_clip.start_time && playhead_seconds < clip_end {
+                let time_in_clip =
+                    playhead_seconds - timeline_clip.start_time + timeline_clip.offset;
+                let frame_in_clip = (time_in_clip * sample_rate as f64) as usize;
+
+                if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
+                    frame_left += l;
+                }
+                if timeline_clip.clip.channels > 1 {
+                    if let Some(r) = timeline_clip.clip.get_sample(frame_in_clip, 1) {
+                        frame_right += r;
+                    }
+                } else {
+                    // Mono clip - duplicate to right
+                    if let Some(l) = timeline_clip.clip.get_sample(frame_in_clip, 0) {
+                        frame_right += l;
+                    }
+                }
+            }
+        }
+
+        left[frame_idx] = frame_left;
+        right[frame_idx] = frame_right;
+    }
+
+    // The synth renders up to each MIDI event, then takes it
+    if let Some(synth_manager) = synth {
+        let frames = left.len().min(right.len());
+        let block_start = start_frame as u64;
+        let block_end = block_start + frames as u64;
+        // `cursor` is the first timeline frame whose events haven't fired
+        let mut frame = 0;
+        let mut cursor = block_start;
+        loop {
+            let next = next_midi_frame(midi_clips, cursor, block_end);
+            let until = next.map_or(frames, |at| (at - block_start) as usize);
+            for frame_idx in frame..until {
+                let synth_sample = synth_manager.process_sample(track_id);
+                left[frame_idx] += synth_sample;
+                right[frame_idx] += synth_sample;
+            }
+            let Some(at) = next else {
+                break;
+            };
+            for timeline_midi_clip in midi_clips {
+                for event in clip_events_between(timeline_midi_clip, at, at + 1).1 {
+                    match event.event_type {
+                        crate::midi::MidiEventType::NoteOn { note, velocity } => {
+                            synth_manager.note_on(track_id, note, velocity);
+                        }
+                        crate::midi::MidiEventType::NoteOff { note, velocity: _ } => {
+                            synth_manager.note_off(track_id, note);
+                        }
+                    }
+                }
+            }
+            frame = until;
+            cursor = at + 1;
+        }
+    }
+}
+
+// ============================================================================
+// EFFECT SERIALIZATION HELPERS
+// ============================================================================
+
+/// Built-in effect parameters for the project file. VST3 plugins get a
+/// placeholder here; their state goes into `vst3_plugins`
+fn effect_to_data(effect_id: u64, effect: &EffectType) -> crate::project::EffectData {
+    use crate::effects::EffectType as ET;
+
+    let mut parameters = HashMap::new();
+    let effect_type_str;
+
+    // Get parameters based on effect type
+    match effect {
+        ET::EQ(eq) => {
+            effect_type_str = "eq".to_string();
+            parameters.insert("low_freq".to_string(), eq.low_freq);
+            parameters.insert("low_gain_db".to_string(), eq.low_gain_db);
+            parameters.insert("mid1_freq".to_string(), eq.mid1_freq);
+            parameters.insert("mid1_gain_db".to_string(), eq.mid1_gain_db);
+            parameters.insert("mid1_q".to_string(), eq.mid1_q);
+            parameters.insert("mid2_freq".to_string(), eq.mid2_freq);
+            parameters.insert("mid2_gain_db".to_string(), eq.mid2_gain_db);
+            parameters.insert("mid2_q".to_string(), eq.mid2_q);
+            parameters.insert("high_freq".to_string(), eq.high_freq);
+            parameters.insert("high_gain_db".to_string(), eq.high_gain_db);
+        }
+        ET::Compressor(comp) => {
+            effect_type_str = "compressor".to_string();
+            parameters.insert("threshold_db".to_string(), comp.threshold_db);
+            parameters.insert("ratio".to_string(), comp.ratio);
+            parameters.insert("attack_ms".to_string(), comp.attack_ms);
+            parameters.insert("release_ms".to_string(), comp.release_ms);
+            parameters.insert("makeup_gain_db".to_string(), comp.makeup_gain_db);
+        }
+        ET::Reverb(rev) => {
+            effect_type_str = "reverb".to_string();
+            parameters.insert("room_size".to_string(), rev.room_size);
+            parameters.insert("damping".to_string(), rev.damping);
+            parameters.insert("wet_dry_mix".to_string(), rev.wet_dry_mix);
+        }
+        ET::Delay(dly) => {
+            effect_type_str = "delay".to_string();
+            parameters.insert("delay_time_ms".to_string(), dly.delay_time_ms);
+            parameters.insert("feedback".to_string(), dly.feedback);
+            parameters.insert("wet_dry_mix".to_string(), dly.wet_dry_mix);
+        }
+        ET::Chorus(chr) => {
+            effect_type_str = "chorus".to_string();
+            parameters.insert("rate_hz".to_string(), chr.rate_hz);
+            parameters.insert("depth".to_string(), chr.depth);
+            parameters.insert("wet_dry_mix".to_string(), chr.wet_dry_mix);
+        }
+        ET::Limiter(_) => {
+            effect_type_str = "limiter".to_string();
+            // Limiter has no user-adjustable parameters
+        }
+        #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+        ET::VST3(_) => return vst3_effect_data(effect_id),
+    }
+
+    crate::project::EffectData {
+        id: effect_id,
+        effect_type: effect_type_str,
+        parameters,
+    }
+}
+
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+fn vst3_effect_data(effect_id: u64) -> crate::project::EffectData {
+    // TODO M7: Save VST3 plugin path and state
+    // For now, just mark the type - full state persistence coming later
+    let mut parameters = HashMap::new();
+    parameters.insert("name".to_string(), 0.0); // Placeholder
+    crate::project::EffectData {
+        id: effect_id,
+        effect_type: "vst3".to_string(),
+        parameters,
+    }
+}
+
 // ============================================================================
 // MIDI SERIALIZATION HELPERS
 // ============================================================================
@@ -2375,5 +3831,202 @@ mod tests {
         graph.stop().unwrap();
         assert_eq!(graph.get_state(), TransportState::Stopped);
     }
+
+    #[test]
+    fn test_parallel_track_render_matches_sequential() {
+        use crate::effects::{Compressor, EffectType};
+        use crate::track::TrackType;
+
+        let graph = AudioGraph::new().unwrap();
+        let mut track_ids = Vec::new();
+        for i in 0..3 {
+            let track_id = graph
+                .track_manager
+                .lock()
+                .unwrap()
+                .create_track(TrackType::Audio, format!("Track {}", i));
+            graph.add_clip_to_track(track_id, Arc::new(create_test_clip(0.5)), i as f64 * 0.1);
+            let effect_id = graph
+                .effect_manager
+                .lock()
+                .unwrap()
+                .create_effect(EffectType::Compressor(Compressor::new()));
+            let tm = graph.track_manager.lock().unwrap();
+            tm.get_track(track_id).unwrap().lock().unwrap().fx_chain.push(effect_id);
+            track_ids.push(track_id);
+        }
+
+        let rendered = graph.render_tracks_offline_parallel(&track_ids, 1.0, &|_, _| {}, &|| false);
+        assert_eq!(rendered.len(), track_ids.len());
+        for (track_id, samples) in rendered {
+            assert_eq!(samples, graph.render_track_offline(track_id, 1.0));
+        }
+    }
+
+    #[test]
+    fn test_freeze_and_unfreeze_track() {
+        use crate::effects::{Compressor, EffectType};
+        use crate::track::TrackType;
+
+        let graph = AudioGraph::new().unwrap();
+        let track_id = graph
+            .track_manager
+            .lock()
+            .unwrap()
+            .create_track(TrackType::Audio, "Frozen".to_string());
+        graph.add_clip_to_track(track_id, Arc::new(create_test_clip(0.5)), 0.25);
+        let effect_id = graph
+            .effect_manager
+            .lock()
+            .unwrap()
+            .create_effect(EffectType::Compressor(Compressor::new()));
+        graph.effect_manager.lock().unwrap().set_bypass(effect_id, true);
+        let track_arc = graph.track_manager.lock().unwrap().get_track(track_id).unwrap();
+        track_arc.lock().unwrap().fx_chain.push(effect_id);
+
+        let cache_dir = std::env::temp_dir().join("boojy_test_freeze");
+        let seconds = graph.freeze_track(track_id, &cache_dir).unwrap();
+        assert!((seconds - (0.75 + FREEZE_TAIL_SECONDS)).abs() < 0.001);
+        assert!(graph.is_track_frozen(track_id));
+        assert!(graph.effect_manager.lock().unwrap().get_effect(effect_id).is_none());
+
+        let cache_path = {
+            let track = track_arc.lock().unwrap();
+            assert!(track.fx_chain.is_empty());
+            let clips = track.playback_audio_clips();
+            assert_eq!(clips.len(), 1);
+            // The clip starts at 0.25s (the compressor is bypassed)
+            let render = &clips[0].clip;
+            let start = (0.25 * TARGET_SAMPLE_RATE as f64) as usize;
+            assert_eq!(render.get_sample(start - 1, 0), Some(0.0));
+            assert_eq!(render.get_sample(start, 0), Some(0.1));
+            track.frozen.as_ref().unwrap().cache_path.clone()
+        };
+        assert!(cache_path.exists());
+        assert!(graph.freeze_track(track_id, &cache_dir).is_err());
+
+        graph.unfreeze_track(track_id).unwrap();
+        assert!(!graph.is_track_frozen(track_id));
+        assert!(!cache_path.exists());
+        let track = track_arc.lock().unwrap();
+        assert_eq!(track.fx_chain.len(), 1);
+        assert!(graph.effect_manager.lock().unwrap().is_bypassed(track.fx_chain[0]));
+        assert_eq!(track.playback_audio_clips().len(), 1);
+    }
+
+    #[test]
+    fn test_block_midi_events_include_clip_end() {
+        use crate::midi::MidiEvent;
+
+        let clip = MidiClip::with_events(
+            vec![MidiEvent::note_on(60, 100, 0), MidiEvent::note_off(60, 64, TARGET_SAMPLE_RATE as u64 * 2)],
+            TARGET_SAMPLE_RATE,
+        );
+        let timeline_clip = TimelineMidiClip { id: 0, clip: Arc::new(clip), start_time: 1.0, track_id: None };
+        let clip_start = TARGET_SAMPLE_RATE as u64;
+        let clips = [timeline_clip];
+
+        assert_eq!(next_midi_frame(&clips, 0, clip_start), None);
+        assert_eq!(next_midi_frame(&clips, clip_start - 10, clip_start + 10), Some(clip_start));
+        assert_eq!(next_midi_frame(&clips, clip_start + 1, u64::MAX / 2), Some(clip_start * 3));
+        assert_eq!(clip_events_between(&clips[0], clip_start * 3, clip_start * 3 + 1).1.len(), 1);
+    }
+
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    #[test]
+    fn test_block_transport_survives_poisoned_locks() {
+        let recorder = Recorder::new();
+        let refs = recorder.get_callback_refs();
+        let previous = crate::vst3_host::VST3Transport { tempo: 97.0, time_sig_numerator: 7, ..Default::default() };
+        let transport = block_transport(&refs, 0, 0, true, &previous, None);
+        assert_ne!(transport.tempo, previous.tempo, "read from the recorder while it's fine");
+
+        let (tempo, time_signature) = (refs.tempo.clone(), refs.time_signature.clone());
+        let _ = std::thread::spawn(move || {
+            let _tempo = tempo.lock().unwrap();
+            let _time_signature = time_signature.lock().unwrap();
+            panic!("poison the tempo and time signature");
+        })
+        .join();
+        assert!(refs.tempo.is_poisoned());
+
+        let transport = block_transport(&refs, 512, 512, true, &previous, None);
+        assert_eq!(transport.tempo, previous.tempo);
+        assert_eq!(transport.time_sig_numerator, previous.time_sig_numerator);
+        assert_eq!(transport.project_time_samples, 512);
+    }
+
+    #[test]
+    fn test_callback_scratch_is_reused() {
+        // Task lists keep their buffer from one callback to the next
+        let mut storage: Vec<Mutex<TrackTask<'static>>> = Vec::with_capacity(8);
+        let buffer = storage.as_ptr() as usize;
+        let mut blocks = vec![TrackBlock::default(), TrackBlock::default()];
+        let mut tasks = recycle_tasks(std::mem::take(&mut storage));
+        tasks.extend(
+            blocks.iter_mut().map(|block| Mutex::new(TrackTask { block, synth: None, effects: &[], ahead: None })),
+        );
+        assert_eq!(tasks.len(), 2);
+        storage = recycle_tasks(tasks);
+        assert!(storage.is_empty());
+        assert_eq!(storage.as_ptr() as usize, buffer);
+        assert_eq!(storage.capacity(), 8);
+
+        // Snapshots are recaptured in place
+        let mut tm = TrackManager::new();
+        let id = tm.create_track(TrackType::Audio, "Audio".to_string());
+        let mut snapshots = SnapshotBuffers::default();
+        for round in 0..2 {
+            snapshots.begin();
+            for track_arc in tm.get_all_tracks() {
+                snapshots.capture(&track_arc.lock().unwrap());
+            }
+            assert_eq!(snapshots.tracks().len(), 1, "round {}", round);
+            assert_eq!(snapshots.tracks()[0].id, id);
+            assert!(snapshots.master().is_some());
+        }
+        assert_eq!(snapshots.tracks.len(), 1);
+    }
+
+    #[test]
+    fn test_synth_note_mid_block_fires_once() {
+        use crate::midi::MidiEvent;
+
+        let clip = MidiClip::with_events(vec![MidiEvent::note_on(60, 100, 100)], TARGET_SAMPLE_RATE);
+        let clips = vec![TimelineMidiClip { id: 0, clip: Arc::new(clip), start_time: 0.0, track_id: None }];
+        let mut left = vec![0.0f32; 256];
+        let mut right = vec![0.0f32; 256];
+
+        // Offline path (export, stems, freeze)
+        let mut synths = TrackSynthManager::new(TARGET_SAMPLE_RATE as f32);
+        synths.create_synth(1);
+        render_track_sources(1, &[], &clips, 0, &mut left, &mut right, Some(&mut synths));
+        assert!(left[..100].iter().all(|sample| *sample == 0.0));
+        assert!(left[100..].iter().any(|sample| *sample != 0.0));
+        assert_eq!(synths.synths_mut().next().unwrap().1.active_voice_count(), 1);
+
+        // Live path (callback, render-ahead)
+        let snapshot = TrackSnapshot {
+            id: 1,
+            track_type: TrackType::Midi,
+            parent_group: None,
+            sends: Vec::new(),
+            audio_clips: Vec::new(),
+            midi_clips: clips,
+            volume_gain: 1.0,
+            pan_left: 1.0,
+            pan_right: 1.0,
+            muted: false,
+            soloed: false,
+            fx_chain: Vec::new(),
+        };
+        let mut synth = Synth::new(TARGET_SAMPLE_RATE as f32);
+        left.fill(0.0);
+        right.fill(0.0);
+        render_live_track(&snapshot, Some(&mut synth), &[], 0, &mut left, &mut right, None);
+        assert!(left[..100].iter().all(|sample| *sample == 0.0));
+        assert!(left[100..].iter().any(|sample| *sample != 0.0));
+        assert_eq!(synth.active_voice_count(), 1);
+    }
 }
 
@@ -1,6 +1,7 @@
 /// Audio input and recording functionality
 use cpal::traits::{DeviceTrait, HostTrait};
-use ringbuf::{traits::*, HeapRb};
+use ringbuf::{traits::*, HeapCons, HeapRb};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 use std::sync::{Arc, Mutex};
 use anyhow::Result;
 
@@ -14,6 +15,117 @@ pub struct AudioInputDevice {
     pub is_default: bool,
 }
 
+/// Samples the output callback deinterleaves per chunk (no allocation)
+const READ_CHUNK_SAMPLES: usize = 2048;
+
+/// Consumer half of a capture ring and the device's channel count
+struct CaptureRing {
+    consumer: HeapCons<f32>,
+    channels: u16,
+}
+
+/// Rings handed to and from the output callback. Only touched when a
+/// capture starts or stops; the callback takes the lock with `try_lock`
+#[derive(Default)]
+struct CaptureRings {
+    /// Ring the callback should switch to (None: stop reading)
+    next: Option<CaptureRing>,
+    /// Ring the callback switched away from, freed off the audio thread
+    retired: Option<CaptureRing>,
+}
+
+/// Shared between the manager and the output callback's [`InputBlockReader`]
+#[derive(Default)]
+struct CaptureHandoff {
+    /// Bumped whenever `rings.next` is replaced
+    generation: AtomicU64,
+    rings: Mutex<CaptureRings>,
+    /// Samples in the ring after the last input callback
+    fill: AtomicUsize,
+    clear_requested: AtomicBool,
+}
+
+/// Reads whole blocks of captured input for the output callback. Owns the
+/// consumer end of the capture ring (single producer, single consumer), so
+/// reading is wait-free and never allocates
+pub struct InputBlockReader {
+    handoff: Arc<CaptureHandoff>,
+    generation: u64,
+    ring: Option<CaptureRing>,
+    scratch: Box<[f32]>,
+}
+
+impl InputBlockReader {
+    /// Fill `left`/`right` with the next captured frames (mono is copied to
+    /// both sides, channels past the second are dropped). Frames the device
+    /// hasn't delivered yet are silent. Returns the frames read
+    pub fn read_block(&mut self, left: &mut [f32], right: &mut [f32]) -> usize {
+        let frames = left.len().min(right.len());
+        self.refresh();
+        let Some(ring) = self.ring.as_mut() else {
+            left.fill(0.0);
+            right.fill(0.0);
+            return 0;
+        };
+        if self.handoff.clear_requested.swap(false, Ordering::Relaxed) {
+            ring.consumer.clear();
+        }
+
+        let channels = ring.channels.max(1) as usize;
+        let chunk_frames = self.scratch.len() / channels;
+        let mut read = 0;
+        while read < frames {
+            // Whole frames only (the producer pushes no partial ones)
+            let wanted = chunk_frames.min(frames - read).min(ring.consumer.occupied_len() / channels);
+            if wanted == 0 {
+                break;
+            }
+            let popped = ring.consumer.pop_slice(&mut self.scratch[..wanted * channels]) / channels;
+            for (frame, samples) in self.scratch.chunks_exact(channels).take(popped).enumerate() {
+                left[read + frame] = samples[0];
+                right[read + frame] = samples[if channels > 1 { 1 } else { 0 }];
+            }
+            read += popped;
+            if popped < wanted {
+                break;
+            }
+        }
+        left[read..frames].fill(0.0);
+        right[read..frames].fill(0.0);
+        read
+    }
+
+    /// Switch to the ring the manager published last, if it changed
+    fn refresh(&mut self) {
+        if self.handoff.generation.load(Ordering::Acquire) == self.generation {
+            return;
+        }
+        // The manager only holds the lock to publish; try again next block
+        let Ok(mut rings) = self.handoff.rings.try_lock() else {
+            return;
+        };
+        self.generation = self.handoff.generation.load(Ordering::Acquire);
+        let previous = std::mem::replace(&mut self.ring, rings.next.take());
+        if previous.is_some() {
+            rings.retired = previous;
+        }
+    }
+}
+
+impl Drop for InputBlockReader {
+    /// Give the ring back (when the output stream is rebuilt the new
+    /// callback's reader takes it over), unless a newer one was published
+    fn drop(&mut self) {
+        let Ok(mut rings) = self.handoff.rings.lock() else {
+            return;
+        };
+        if self.ring.is_some() && self.handoff.generation.load(Ordering::Acquire) == self.generation {
+            rings.next = self.ring.take();
+            self.handoff.generation.fetch_add(1, Ordering::Release);
+        }
+    }
+}
+
 /// Audio input manager that handles device enumeration and recording
 pub struct AudioInputManager {
     /// Available input devices
@@ -22,9 +134,9 @@ pub struct AudioInputManager {
     selected_device_index: Option<usize>,
     /// Input stream (if active)
     input_stream: Option<cpal::Stream>,
-    /// Ring buffer for captured audio (lock-free, thread-safe)
-    /// Stores raw samples (mono or stereo depending on device)
-    input_buffer: Option<Arc<Mutex<HeapRb<f32>>>>,
+    /// Hands the capture ring's consumer to the output callback. The ring
+    /// stores raw interleaved samples (mono or stereo depending on device)
+    handoff: Arc<CaptureHandoff>,
     /// Number of input channels (1 = mono, 2 = stereo)
     input_channels: u16,
 }
@@ -36,7 +148,7 @@ impl AudioInputManager {
             devices: Vec::new(),
             selected_device_index: None,
             input_stream: None,
-            input_buffer: None,
+            handoff: Arc::new(CaptureHandoff::default()),
             input_channels: 1, // Default to mono
         })
     }
@@ -129,27 +241,29 @@ impl AudioInputManager {
         self.input_channels = config.channels();
         eprintln!("🎙️  [AudioInput] Input channels: {} (1=mono, 2=stereo)", self.input_channels);
 
-        // Create ring buffer (stereo, size based on buffer_size_seconds)
+        // Create ring buffer (stereo, size based on buffer_size_seconds).
+        // The input callback owns the producer, the output callback the consumer
         let buffer_samples = (buffer_size_seconds * TARGET_SAMPLE_RATE as f64 * 2.0) as usize;
         let ring_buffer: HeapRb<f32> = HeapRb::new(buffer_samples);
-        let ring_buffer_arc = Arc::new(Mutex::new(ring_buffer));
-        let ring_buffer_clone = ring_buffer_arc.clone();
+        let (mut producer, consumer) = ring_buffer.split();
+        let handoff = self.handoff.clone();
+        let channels = self.input_channels.max(1) as usize;
+        let mut overflowed = false;
 
         // Create input stream
         let stream = device.build_input_stream(
             &config.into(),
             move |data: &[f32], _: &cpal::InputCallbackInfo| {
-                // Write input samples to ring buffer
-                if let Ok(mut buffer) = ring_buffer_clone.lock() {
-                    for &sample in data {
-                        // If buffer is full, drop oldest samples
-                        if buffer.is_full() {
-                            eprintln!("⚠️  [AudioInput] Ring buffer overflow! Dropping oldest sample.");
-                            let _ = buffer.try_pop();
-                        }
-                        let _ = buffer.try_push(sample);
-                    }
+                // A full ring drops the newest samples (the consumer end
+                // belongs to the output callback). Only whole frames go in,
+                // so the reader never sees a frame split across blocks
+                let room = producer.vacant_len().min(data.len()) / channels * channels;
+                let pushed = producer.push_slice(&data[..room]);
+                if pushed < data.len() && !overflowed {
+                    overflowed = true;
+                    eprintln!("⚠️  [AudioInput] Ring buffer overflow! Dropping {} samples.", data.len() - pushed);
                 }
+                handoff.fill.store(producer.occupied_len(), Ordering::Relaxed);
             },
             move |err| {
                 eprintln!("Audio input stream error: {}", err);
@@ -161,7 +275,7 @@ impl AudioInputManager {
         stream.play()?;
 
         self.input_stream = Some(stream);
-        self.input_buffer = Some(ring_buffer_arc);
+        self.publish_ring(Some(CaptureRing { consumer, channels: self.input_channels }));
 
         Ok(())
     }
@@ -173,51 +287,44 @@ impl AudioInputManager {
             stream.pause()?;
             drop(stream);
         }
-        self.input_buffer = None;
+        self.publish_ring(None);
+        self.handoff.fill.store(0, Ordering::Relaxed);
         Ok(())
     }
 
+    /// Reader for the output callback. There should only be one: each
+    /// capture ring has a single consumer
+    pub fn block_reader(&self) -> InputBlockReader {
+        InputBlockReader {
+            handoff: self.handoff.clone(),
+            generation: 0,
+            ring: None,
+            scratch: vec![0.0; READ_CHUNK_SAMPLES].into_boxed_slice(),
+        }
+    }
+
+    /// Hand the output callback a new ring (or none), freeing the one it
+    /// gave back last time
+    fn publish_ring(&self, ring: Option<CaptureRing>) {
+        let mut rings = self.handoff.rings.lock().expect("mutex poisoned");
+        rings.next = ring;
+        rings.retired = None;
+        self.handoff.generation.fetch_add(1, Ordering::Release);
+    }
+
     /// Check if currently capturing audio
     pub fn is_capturing(&self) -> bool {
         self.input_stream.is_some()
     }
 
-    /// Read captured audio samples from the ring buffer
-    /// Returns samples in interleaved stereo format
-    pub fn read_samples(&self, num_samples: usize) -> Option<Vec<f32>> {
-        if let Some(buffer_arc) = &self.input_buffer {
-            if let Ok(mut buffer) = buffer_arc.lock() {
-                let mut samples = Vec::with_capacity(num_samples);
-                for _ in 0..num_samples {
-                    if let Some(sample) = buffer.try_pop() {
-                        samples.push(sample);
-                    } else {
-                        break;
-                    }
-                }
-                return Some(samples);
-            }
-        }
-        None
-    }
-
-    /// Get the number of samples currently in the buffer
+    /// Get the number of samples in the buffer as of the last input callback
     pub fn get_buffer_fill(&self) -> usize {
-        if let Some(buffer_arc) = &self.input_buffer {
-            if let Ok(buffer) = buffer_arc.lock() {
-                return buffer.occupied_len();
-            }
-        }
-        0
+        self.handoff.fill.load(Ordering::Relaxed)
     }
 
-    /// Clear the input buffer
+    /// Clear the input buffer (done by the output callback on its next block)
     pub fn clear_buffer(&self) {
-        if let Some(buffer_arc) = &self.input_buffer {
-            if let Ok(mut buffer) = buffer_arc.lock() {
-                buffer.clear();
-            }
-        }
+        self.handoff.clear_requested.store(true, Ordering::Relaxed);
     }
 
     /// Get the number of input channels (1 = mono, 2 = stereo)
@@ -239,6 +346,36 @@ mod tests {
         assert!(manager.is_ok());
     }
 
+    #[test]
+    fn test_block_reader_deinterleaves_and_pads() {
+        let manager = AudioInputManager::new().unwrap();
+        let mut reader = manager.block_reader();
+        let (mut producer, consumer) = HeapRb::<f32>::new(16).split();
+        manager.publish_ring(Some(CaptureRing { consumer, channels: 2 }));
+        producer.push_slice(&[0.1, 0.2, 0.3, 0.4]);
+
+        let mut left = [1.0; 3];
+        let mut right = [1.0; 3];
+        assert_eq!(reader.read_block(&mut left, &mut right), 2);
+        assert_eq!(left, [0.1, 0.3, 0.0]);
+        assert_eq!(right, [0.2, 0.4, 0.0]);
+
+        // A rebuilt output stream's reader takes the ring over
+        drop(reader);
+        let mut reader = manager.block_reader();
+        producer.push_slice(&[0.5, 0.6]);
+        assert_eq!(reader.read_block(&mut left[..1], &mut right[..1]), 1);
+        assert_eq!((left[0], right[0]), (0.5, 0.6));
+
+        // Half a frame stays in the ring until the rest arrives
+        producer.push_slice(&[0.7, 0.8, 0.9]);
+        assert_eq!(reader.read_block(&mut left[..2], &mut right[..2]), 1);
+        assert_eq!((left[0], right[0], left[1]), (0.7, 0.8, 0.0));
+        producer.push_slice(&[1.0]);
+        assert_eq!(reader.read_block(&mut left[..1], &mut right[..1]), 1);
+        assert_eq!((left[0], right[0]), (0.9, 1.0));
+    }
+
     #[test]
     fn test_device_enumeration() {
         let mut manager = AudioInputManager::new().unwrap();
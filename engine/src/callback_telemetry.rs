@@ -0,0 +1,450 @@
+// Audio callback telemetry
+//
+// Every output callback records how long it took against its deadline (the
+// duration of the audio it produced) and how long it waited on each of the
+// locks it shares with the UI thread. Durations go into log-scale
+// histograms; a callback that overran its deadline also goes into a ring of
+// xrun events with a timestamp, the playhead and the stage that cost the
+// most, which the UI polls. The audio thread only touches atomics: nothing
+// locks or allocates, and an uncontended lock costs no clock reads at all
+// (waits are only timed once `try_lock` fails).
+//
+// Measuring doesn't make a lock safe: a contended `lock` still blocks the
+// callback until the UI thread lets go. Locks the callback can do without
+// for a block use `try_lock` instead and are not listed here.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{LockResult, Mutex, MutexGuard, TryLockError};
+use std::time::{Instant, SystemTime, UNIX_EPOCH};
+
+/// Where a callback spent its time
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CallbackStage {
+    TrackManager = 0,
+    /// Per-effect locks while processing FX chains
+    Effects = 1,
+    SynthManager = 2,
+    DelayCompensation = 3,
+    MasterLimiter = 4,
+    /// Tempo, time signature and recording state for the plugin transport
+    Recorder = 5,
+    /// Everything that isn't waiting on a lock
+    Processing = 6,
+}
+
+/// Stages that are lock waits (all but Processing)
+pub const LOCK_STAGES: [CallbackStage; 6] = [
+    CallbackStage::TrackManager,
+    CallbackStage::Effects,
+    CallbackStage::SynthManager,
+    CallbackStage::DelayCompensation,
+    CallbackStage::MasterLimiter,
+    CallbackStage::Recorder,
+];
+
+impl CallbackStage {
+    pub fn name(self) -> &'static str {
+        match self {
+            CallbackStage::TrackManager => "track_manager",
+            CallbackStage::Effects => "effects",
+            CallbackStage::SynthManager => "synth_manager",
+            CallbackStage::DelayCompensation => "delay_compensation",
+            CallbackStage::MasterLimiter => "master_limiter",
+            CallbackStage::Recorder => "recorder",
+            CallbackStage::Processing => "processing",
+        }
+    }
+
+    fn from_index(index: u64) -> Self {
+        match index {
+            0 => CallbackStage::TrackManager,
+            1 => CallbackStage::Effects,
+            2 => CallbackStage::SynthManager,
+            3 => CallbackStage::DelayCompensation,
+            4 => CallbackStage::MasterLimiter,
+            5 => CallbackStage::Recorder,
+            _ => CallbackStage::Processing,
+        }
+    }
+}
+
+/// Sub-buckets per power of two (about 19% resolution)
+const SUB_BUCKET_BITS: u32 = 2;
+const HISTOGRAM_BUCKETS: usize = 64 << SUB_BUCKET_BITS;
+
+/// Xrun events kept between polls; older ones are overwritten
+pub const XRUN_LOG_SIZE: usize = 256;
+
+/// Log-scale histogram of nanosecond durations
+struct Histogram {
+    buckets: Box<[AtomicU64]>,
+    count: AtomicU64,
+    total_ns: AtomicU64,
+    max_ns: AtomicU64,
+}
+
+fn bucket_of(ns: u64) -> usize {
+    if ns < (1 << SUB_BUCKET_BITS) {
+        return ns as usize;
+    }
+    let octave = 63 - ns.leading_zeros();
+    let sub = (ns >> (octave - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+    (((octave - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) as u64 + sub) as usize
+}
+
+/// Upper edge of a bucket
+fn bucket_limit(bucket: usize) -> u64 {
+    if bucket < (1 << SUB_BUCKET_BITS) {
+        return bucket as u64;
+    }
+    let octave = (bucket >> SUB_BUCKET_BITS) as u32 + SUB_BUCKET_BITS - 1;
+    let sub = (bucket & ((1 << SUB_BUCKET_BITS) - 1)) as u64;
+    let step = 1u64 << (octave - SUB_BUCKET_BITS);
+    (1u64 << octave) - 1 + (sub + 1) * step
+}
+
+impl Histogram {
+    fn new() -> Self {
+        Self {
+            buckets: (0..HISTOGRAM_BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            count: AtomicU64::new(0),
+            total_ns: AtomicU64::new(0),
+            max_ns: AtomicU64::new(0),
+        }
+    }
+
+    fn record(&self, ns: u64) {
+        self.buckets[bucket_of(ns)].fetch_add(1, Ordering::Relaxed);
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.total_ns.fetch_add(ns, Ordering::Relaxed);
+        self.max_ns.fetch_max(ns, Ordering::Relaxed);
+    }
+
+    fn reset(&self) {
+        for bucket in self.buckets.iter() {
+            bucket.store(0, Ordering::Relaxed);
+        }
+        self.count.store(0, Ordering::Relaxed);
+        self.total_ns.store(0, Ordering::Relaxed);
+        self.max_ns.store(0, Ordering::Relaxed);
+    }
+
+    fn summary(&self) -> HistogramSummary {
+        let count = self.count.load(Ordering::Relaxed);
+        let max_ns = self.max_ns.load(Ordering::Relaxed);
+        let mut summary = HistogramSummary {
+            count,
+            mean_us: 0.0,
+            p99_us: 0.0,
+            max_us: max_ns as f64 / 1000.0,
+        };
+        if count == 0 {
+            return summary;
+        }
+        summary.mean_us = self.total_ns.load(Ordering::Relaxed) as f64 / count as f64 / 1000.0;
+
+        // Bucket counts may be a callback ahead of `count`; that only moves
+        // the percentile by one sample
+        let rank = count - count / 100;
+        let mut seen = 0;
+        for (bucket, counter) in self.buckets.iter().enumerate() {
+            seen += counter.load(Ordering::Relaxed);
+            if seen >= rank {
+                summary.p99_us = bucket_limit(bucket).min(max_ns) as f64 / 1000.0;
+                break;
+            }
+        }
+        summary
+    }
+}
+
+#[derive(Debug, Clone, Copy, Default)]
+pub struct HistogramSummary {
+    pub count: u64,
+    pub mean_us: f64,
+    pub p99_us: f64,
+    pub max_us: f64,
+}
+
+/// One callback that missed its deadline
+#[derive(Debug, Clone, Copy)]
+pub struct XrunEvent {
+    /// Wall clock, milliseconds since the Unix epoch
+    pub timestamp_ms: u64,
+    /// Timeline frame the callback started at
+    pub playhead: u64,
+    pub duration_us: f64,
+    pub deadline_us: f64,
+    /// The lock wait or processing that took longest
+    pub stage: CallbackStage,
+    pub stage_us: f64,
+}
+
+/// Ring slot, written field by field by the callback. `sequence` is the
+/// event's sequence number + 1 once complete, so a reader can tell a slot
+/// that was overwritten while it read it (seqlock)
+struct XrunSlot {
+    sequence: AtomicU64,
+    timestamp_ms: AtomicU64,
+    playhead: AtomicU64,
+    duration_ns: AtomicU64,
+    deadline_ns: AtomicU64,
+    stage: AtomicU64,
+    stage_ns: AtomicU64,
+}
+
+impl XrunSlot {
+    fn new() -> Self {
+        Self {
+            sequence: AtomicU64::new(0),
+            timestamp_ms: AtomicU64::new(0),
+            playhead: AtomicU64::new(0),
+            duration_ns: AtomicU64::new(0),
+            deadline_ns: AtomicU64::new(0),
+            stage: AtomicU64::new(0),
+            stage_ns: AtomicU64::new(0),
+        }
+    }
+}
+
+/// Per-callback measurement handed out by [`CallbackTelemetry::begin`];
+/// recorded when dropped
+pub struct CallbackScope<'a> {
+    telemetry: &'a CallbackTelemetry,
+    start: Instant,
+    playhead: u64,
+    deadline_ns: u64,
+}
+
+impl Drop for CallbackScope<'_> {
+    fn drop(&mut self) {
+        self.telemetry.finish(self.start.elapsed().as_nanos() as u64, self.deadline_ns, self.playhead);
+    }
+}
+
+pub struct CallbackTelemetry {
+    /// This callback's lock waits so far, per LOCK_STAGES entry. Mix
+    /// workers add to them too
+    waits: [AtomicU64; LOCK_STAGES.len()],
+    duration: Histogram,
+    lock_waits: [Histogram; LOCK_STAGES.len()],
+    deadline_ns: AtomicU64,
+    xruns: AtomicU64,
+    /// Events written so far / read by the last poll
+    xrun_head: AtomicU64,
+    xrun_cursor: AtomicU64,
+    xrun_log: Box<[XrunSlot]>,
+}
+
+impl CallbackTelemetry {
+    pub fn new() -> Self {
+        Self {
+            waits: std::array::from_fn(|_| AtomicU64::new(0)),
+            duration: Histogram::new(),
+            lock_waits: std::array::from_fn(|_| Histogram::new()),
+            deadline_ns: AtomicU64::new(0),
+            xruns: AtomicU64::new(0),
+            xrun_head: AtomicU64::new(0),
+            xrun_cursor: AtomicU64::new(0),
+            xrun_log: (0..XRUN_LOG_SIZE).map(|_| XrunSlot::new()).collect(),
+        }
+    }
+
+    /// Start measuring a callback producing `frames` at `sample_rate`
+    pub fn begin(&self, frames: usize, sample_rate: u32, playhead: u64) -> CallbackScope<'_> {
+        for wait in &self.waits {
+            wait.store(0, Ordering::Relaxed);
+        }
+        CallbackScope {
+            telemetry: self,
+            start: Instant::now(),
+            playhead,
+            deadline_ns: frames as u64 * 1_000_000_000 / sample_rate.max(1) as u64,
+        }
+    }
+
+    /// Lock `mutex`, charging any wait to `stage` of the current callback.
+    /// Still blocks while the lock is held elsewhere; only the wait is added
+    pub fn lock<'a, T>(&self, stage: CallbackStage, mutex: &'a Mutex<T>) -> LockResult<MutexGuard<'a, T>> {
+        match mutex.try_lock() {
+            Ok(guard) => Ok(guard),
+            Err(TryLockError::Poisoned(poisoned)) => Err(poisoned),
+            Err(TryLockError::WouldBlock) => {
+                let start = Instant::now();
+                let result = mutex.lock();
+                self.waits[stage as usize].fetch_add(start.elapsed().as_nanos() as u64, Ordering::Relaxed);
+                result
+            }
+        }
+    }
+
+    fn finish(&self, duration_ns: u64, deadline_ns: u64, playhead: u64) {
+        self.duration.record(duration_ns);
+        self.deadline_ns.store(deadline_ns, Ordering::Relaxed);
+
+        let mut worst = (CallbackStage::Processing, 0u64);
+        let mut waited = 0u64;
+        for (index, wait) in self.waits.iter().enumerate() {
+            let ns = wait.load(Ordering::Relaxed);
+            self.lock_waits[index].record(ns);
+            waited += ns;
+            if ns > worst.1 {
+                worst = (LOCK_STAGES[index], ns);
+            }
+        }
+        if duration_ns <= deadline_ns {
+            return;
+        }
+
+        // Worker waits overlap, so their sum can exceed the callback
+        let processing = duration_ns.saturating_sub(waited);
+        if processing >= worst.1 {
+            worst = (CallbackStage::Processing, processing);
+        }
+        self.xruns.fetch_add(1, Ordering::Relaxed);
+
+        let sequence = self.xrun_head.load(Ordering::Relaxed);
+        let slot = &self.xrun_log[sequence as usize % XRUN_LOG_SIZE];
+        let timestamp_ms = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map(|elapsed| elapsed.as_millis() as u64)
+            .unwrap_or(0);
+        slot.sequence.store(0, Ordering::Release);
+        slot.timestamp_ms.store(timestamp_ms, Ordering::Relaxed);
+        slot.playhead.store(playhead, Ordering::Relaxed);
+        slot.duration_ns.store(duration_ns, Ordering::Relaxed);
+        slot.deadline_ns.store(deadline_ns, Ordering::Relaxed);
+        slot.stage.store(worst.0 as u64, Ordering::Relaxed);
+        slot.stage_ns.store(worst.1, Ordering::Relaxed);
+        slot.sequence.store(sequence + 1, Ordering::Release);
+        self.xrun_head.store(sequence + 1, Ordering::Release);
+    }
+
+    /// Xrun events since the last poll, oldest first. Events overwritten
+    /// before they were polled are skipped. Single consumer (the UI)
+    pub fn poll_xruns(&self) -> Vec<XrunEvent> {
+        let head = self.xrun_head.load(Ordering::Acquire);
+        let cursor = self
+            .xrun_cursor
+            .load(Ordering::Relaxed)
+            .max(head.saturating_sub(XRUN_LOG_SIZE as u64));
+        let mut events = Vec::with_capacity((head - cursor) as usize);
+        for sequence in cursor..head {
+            let slot = &self.xrun_log[sequence as usize % XRUN_LOG_SIZE];
+            if slot.sequence.load(Ordering::Acquire) != sequence + 1 {
+                continue;
+            }
+            let event = XrunEvent {
+                timestamp_ms: slot.timestamp_ms.load(Ordering::Relaxed),
+                playhead: slot.playhead.load(Ordering::Relaxed),
+                duration_us: slot.duration_ns.load(Ordering::Relaxed) as f64 / 1000.0,
+                deadline_us: slot.deadline_ns.load(Ordering::Relaxed) as f64 / 1000.0,
+                stage: CallbackStage::from_index(slot.stage.load(Ordering::Relaxed)),
+                stage_us: slot.stage_ns.load(Ordering::Relaxed) as f64 / 1000.0,
+            };
+            if slot.sequence.load(Ordering::Acquire) == sequence + 1 {
+                events.push(event);
+            }
+        }
+        self.xrun_cursor.store(head, Ordering::Relaxed);
+        events
+    }
+
+    /// Callback duration, plus each lock stage's wait per callback
+    pub fn summary(&self) -> (HistogramSummary, Vec<(CallbackStage, HistogramSummary)>) {
+        let waits = LOCK_STAGES
+            .iter()
+            .zip(&self.lock_waits)
+            .map(|(stage, histogram)| (*stage, histogram.summary()))
+            .collect();
+        (self.duration.summary(), waits)
+    }
+
+    /// Deadline of the last callback in microseconds
+    pub fn deadline_us(&self) -> f64 {
+        self.deadline_ns.load(Ordering::Relaxed) as f64 / 1000.0
+    }
+
+    pub fn xrun_count(&self) -> u64 {
+        self.xruns.load(Ordering::Relaxed)
+    }
+
+    /// Start the histograms and xrun count over (the event log keeps its
+    /// unpolled events). May race with a callback in progress, which then
+    /// lands half in the old and half in the new counts
+    pub fn reset(&self) {
+        self.duration.reset();
+        for histogram in &self.lock_waits {
+            histogram.reset();
+        }
+        self.xruns.store(0, Ordering::Relaxed);
+    }
+}
+
+/// `CallbackTelemetry::lock` for code shared with offline renders, which
+/// have no callback to charge (`None` is a plain `lock`)
+pub fn lock_charged<'a, T>(
+    telemetry: Option<&CallbackTelemetry>,
+    stage: CallbackStage,
+    mutex: &'a Mutex<T>,
+) -> LockResult<MutexGuard<'a, T>> {
+    match telemetry {
+        Some(telemetry) => telemetry.lock(stage, mutex),
+        None => mutex.lock(),
+    }
+}
+
+impl Default for CallbackTelemetry {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_histogram_buckets_are_ordered() {
+        let mut last = 0;
+        for ns in [0u64, 1, 3, 4, 5, 7, 8, 100, 1_000, 999_999, 1 << 40, u64::MAX] {
+            let bucket = bucket_of(ns);
+            assert!(bucket < HISTOGRAM_BUCKETS);
+            assert!(bucket >= last, "{} went back to bucket {}", ns, bucket);
+            assert!(bucket_limit(bucket) >= ns, "{} above its bucket's limit", ns);
+            last = bucket;
+        }
+    }
+
+    #[test]
+    fn test_overrun_is_logged_with_its_stage() {
+        let telemetry = CallbackTelemetry::new();
+        telemetry.finish(1_000_000, 2_000_000, 0);
+        assert_eq!(telemetry.xrun_count(), 0);
+
+        telemetry.waits[CallbackStage::TrackManager as usize].store(4_000_000, Ordering::Relaxed);
+        telemetry.finish(5_000_000, 2_000_000, 48_000);
+        let events = telemetry.poll_xruns();
+        assert_eq!(events.len(), 1);
+        assert_eq!(events[0].stage, CallbackStage::TrackManager);
+        assert_eq!(events[0].playhead, 48_000);
+        assert!(telemetry.poll_xruns().is_empty());
+
+        let (duration, waits) = telemetry.summary();
+        assert_eq!(duration.count, 2);
+        assert_eq!(duration.max_us, 5_000.0);
+        assert_eq!(waits[0].1.max_us, 4_000.0);
+    }
+
+    #[test]
+    fn test_unpolled_xruns_keep_the_newest() {
+        let telemetry = CallbackTelemetry::new();
+        for playhead in 0..(XRUN_LOG_SIZE as u64 + 10) {
+            telemetry.finish(10, 1, playhead);
+        }
+        let events = telemetry.poll_xruns();
+        assert_eq!(events.len(), XRUN_LOG_SIZE);
+        assert_eq!(events[0].playhead, 10);
+        assert_eq!(events[0].stage, CallbackStage::Processing);
+    }
+}
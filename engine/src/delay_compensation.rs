@@ -0,0 +1,403 @@
+// Plugin delay compensation (PDC)
+//
+// Plugins that look ahead (limiters, linear-phase EQs, ...) report a latency
+// and output their audio that many samples late. A track's path latency is
+// its own chain plus every bus chain it passes through on the way to the
+// master (groups, and returns for sends). Each connection into a bus or the
+// master is delayed so that everything summed there arrives together: a
+// track going straight to master waits for one going through a slow group,
+// and a group's members wait for each other before the group's chain runs.
+//
+// Delay lines are sized on the control thread whenever the chains change;
+// the audio thread only reads and writes preallocated buffers.
+
+use crate::mix_graph::{MixGraph, MixNodeDesc, MixOutput};
+use crate::track::{Send, TrackId, TrackType};
+use std::collections::HashMap;
+
+/// Upper bound for a single track's compensation (about 1.4s at 48kHz).
+/// Anything above this is almost certainly a misreported latency.
+pub const MAX_COMPENSATION_SAMPLES: u32 = 65536;
+
+/// Fixed-length stereo delay line backed by a circular buffer
+#[derive(Debug, Clone, Default)]
+pub struct DelayLine {
+    left: Vec<f32>,
+    right: Vec<f32>,
+    delay: usize,
+    write_pos: usize,
+    dirty: bool,
+}
+
+impl DelayLine {
+    /// Set the delay, reusing the buffers if they are big enough.
+    /// Changing the delay clears the line.
+    pub fn set_delay(&mut self, delay: usize) {
+        if delay == self.delay {
+            return;
+        }
+        if self.left.len() < delay {
+            self.left.resize(delay, 0.0);
+            self.right.resize(delay, 0.0);
+        }
+        self.delay = delay;
+        self.write_pos = 0;
+        self.dirty = true;
+        self.clear();
+    }
+
+    pub fn delay(&self) -> usize {
+        self.delay
+    }
+
+    /// Zero the buffered samples (only touches memory if something was written)
+    pub fn clear(&mut self) {
+        if self.dirty {
+            self.left[..self.delay].fill(0.0);
+            self.right[..self.delay].fill(0.0);
+            self.dirty = false;
+        }
+    }
+
+    /// Delay a block in place
+    pub fn process_block(&mut self, left: &mut [f32], right: &mut [f32]) {
+        if self.delay == 0 {
+            return;
+        }
+        self.dirty = true;
+
+        let len = self.delay;
+        let frames = left.len().min(right.len());
+        let mut pos = self.write_pos;
+        for i in 0..frames {
+            let delayed_left = self.left[pos];
+            let delayed_right = self.right[pos];
+            self.left[pos] = left[i];
+            self.right[pos] = right[i];
+            left[i] = delayed_left;
+            right[i] = delayed_right;
+            pos += 1;
+            if pos == len {
+                pos = 0;
+            }
+        }
+        self.write_pos = pos;
+    }
+}
+
+/// Compensation state for one track
+#[derive(Debug, Clone, Default)]
+pub struct TrackCompensation {
+    /// Latency of the track's own FX chain in samples
+    pub chain_latency: u32,
+    /// The chain's latency change count when `chain_latency` was read
+    pub latency_changes: u32,
+    /// Delay on the track's output into its group or the master
+    line: DelayLine,
+    /// Delay on each send, by Return track
+    sends: Vec<(TrackId, DelayLine)>,
+}
+
+impl TrackCompensation {
+    /// Delay added to this track's output to line it up at its destination
+    pub fn compensation(&self) -> u32 {
+        self.line.delay() as u32
+    }
+
+    fn clear(&mut self) {
+        self.line.clear();
+        for (_, line) in &mut self.sends {
+            line.clear();
+        }
+    }
+}
+
+/// A track's routing and own chain latency, as passed to `configure_routed`
+#[derive(Debug, Clone)]
+pub struct RoutedTrack {
+    pub id: TrackId,
+    pub track_type: TrackType,
+    pub parent_group: Option<TrackId>,
+    pub sends: Vec<Send>,
+    pub chain_latency: u32,
+    /// See `EffectManager::chain_latency_changes`
+    pub latency_changes: u32,
+}
+
+/// Per-track delay lines for the audio callback
+#[derive(Debug, Default)]
+pub struct DelayCompensation {
+    tracks: HashMap<TrackId, TrackCompensation>,
+    /// Routing of the last configure, to re-run it on enable/disable
+    routing: Vec<RoutedTrack>,
+    /// Path latency of the slowest track, i.e. the delay every track now has
+    max_latency: u32,
+    /// Latency change count seen at the last update
+    pub latency_change_count: u32,
+    enabled: bool,
+}
+
+impl DelayCompensation {
+    pub fn new() -> Self {
+        Self {
+            enabled: true,
+            ..Default::default()
+        }
+    }
+
+    pub fn is_enabled(&self) -> bool {
+        self.enabled
+    }
+
+    pub fn set_enabled(&mut self, enabled: bool) {
+        self.enabled = enabled;
+        let routing = std::mem::take(&mut self.routing);
+        self.configure_routed(&routing);
+    }
+
+    /// Resize the delay lines for tracks that all feed the master directly
+    /// (control thread). Tracks that aren't listed are dropped.
+    pub fn configure(&mut self, chain_latencies: &[(TrackId, u32)]) {
+        let routing: Vec<RoutedTrack> = chain_latencies
+            .iter()
+            .map(|&(id, chain_latency)| RoutedTrack {
+                id,
+                track_type: TrackType::Audio,
+                parent_group: None,
+                sends: Vec::new(),
+                chain_latency,
+                latency_changes: 0,
+            })
+            .collect();
+        self.configure_routed(&routing);
+    }
+
+    /// Resize the delay lines for the given routing and chain latencies
+    /// (control thread; master excluded). Tracks that aren't listed are
+    /// dropped.
+    pub fn configure_routed(&mut self, routing: &[RoutedTrack]) {
+        self.tracks.retain(|id, _| routing.iter().any(|track| track.id == *id));
+
+        let descs: Vec<MixNodeDesc> = routing
+            .iter()
+            .map(|track| MixNodeDesc {
+                id: track.id,
+                track_type: track.track_type,
+                parent_group: track.parent_group,
+                sends: &track.sends,
+            })
+            .collect();
+        let mut graph = MixGraph::new();
+        graph.compile(&descs);
+
+        // Walk the DAG in order: a node's output is ready when its latest
+        // input has arrived and its own chain has run
+        let count = routing.len();
+        let mut arrival = vec![0u32; count];
+        let mut ready = vec![0u32; count];
+        let mut master_arrival = 0u32;
+        for level in graph.levels() {
+            for &node in level {
+                let latency = if self.enabled { routing[node].chain_latency.min(MAX_COMPENSATION_SAMPLES) } else { 0 };
+                ready[node] = arrival[node].saturating_add(latency);
+                match graph.output(node) {
+                    MixOutput::Bus(parent) => arrival[parent] = arrival[parent].max(ready[node]),
+                    MixOutput::Master => master_arrival = master_arrival.max(ready[node]),
+                }
+                for send in graph.sends(node) {
+                    arrival[send.target] = arrival[send.target].max(ready[node]);
+                }
+            }
+        }
+        self.max_latency = master_arrival.min(MAX_COMPENSATION_SAMPLES);
+
+        let delay = |arrives: u32, node: usize| (arrives - ready[node]).min(MAX_COMPENSATION_SAMPLES) as usize;
+        for (node, routed) in routing.iter().enumerate() {
+            let track = self.tracks.entry(routed.id).or_default();
+            track.chain_latency = routed.chain_latency.min(MAX_COMPENSATION_SAMPLES);
+            track.latency_changes = routed.latency_changes;
+            let destination = match graph.output(node) {
+                MixOutput::Bus(parent) => arrival[parent],
+                MixOutput::Master => master_arrival,
+            };
+            track.line.set_delay(delay(destination, node));
+
+            // Keep the lines (and buffers) of sends that still exist
+            let mut previous = std::mem::take(&mut track.sends);
+            for send in graph.sends(node) {
+                let target = routing[send.target].id;
+                let mut line = match previous.iter().position(|(id, _)| *id == target) {
+                    Some(index) => previous.swap_remove(index).1,
+                    None => DelayLine::default(),
+                };
+                line.set_delay(delay(arrival[send.target], node));
+                track.sends.push((target, line));
+            }
+        }
+        self.routing = routing.to_vec();
+    }
+
+    /// Latency of the slowest track (what the whole mix is delayed by)
+    pub fn max_latency(&self) -> u32 {
+        self.max_latency
+    }
+
+    pub fn track(&self, track_id: TrackId) -> Option<&TrackCompensation> {
+        self.tracks.get(&track_id)
+    }
+
+    pub fn tracks(&self) -> impl Iterator<Item = (TrackId, &TrackCompensation)> {
+        self.tracks.iter().map(|(id, track)| (*id, track))
+    }
+
+    /// Delay the block a track outputs to its group or the master, in place
+    /// (audio thread, no allocation)
+    pub fn process_track(&mut self, track_id: TrackId, left: &mut [f32], right: &mut [f32]) {
+        if let Some(track) = self.tracks.get_mut(&track_id) {
+            track.line.process_block(left, right);
+        }
+    }
+
+    /// Delay the block a track sends to a Return track, in place
+    pub fn process_send(&mut self, track_id: TrackId, target: TrackId, left: &mut [f32], right: &mut [f32]) {
+        if let Some(track) = self.tracks.get_mut(&track_id) {
+            if let Some((_, line)) = track.sends.iter_mut().find(|(id, _)| *id == target) {
+                line.process_block(left, right);
+            }
+        }
+    }
+
+    /// Drop buffered audio for a track that isn't being mixed (muted etc.),
+    /// so it doesn't replay stale audio when it comes back
+    pub fn silence_track(&mut self, track_id: TrackId) {
+        if let Some(track) = self.tracks.get_mut(&track_id) {
+            track.clear();
+        }
+    }
+
+    /// Clear every delay line (transport jumps)
+    pub fn reset(&mut self) {
+        for track in self.tracks.values_mut() {
+            track.clear();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_delay_line_delays_across_blocks() {
+        let mut line = DelayLine::default();
+        line.set_delay(3);
+
+        let mut left = [1.0, 2.0];
+        let mut right = [-1.0, -2.0];
+        line.process_block(&mut left, &mut right);
+        assert_eq!(left, [0.0, 0.0]);
+        assert_eq!(right, [0.0, 0.0]);
+
+        let mut left = [3.0, 4.0, 5.0];
+        let mut right = [-3.0, -4.0, -5.0];
+        line.process_block(&mut left, &mut right);
+        assert_eq!(left, [0.0, 1.0, 2.0]);
+        assert_eq!(right, [0.0, -1.0, -2.0]);
+    }
+
+    #[test]
+    fn test_zero_delay_passes_through() {
+        let mut line = DelayLine::default();
+        let mut left = [0.5, 0.25];
+        let mut right = [0.1, 0.2];
+        line.process_block(&mut left, &mut right);
+        assert_eq!(left, [0.5, 0.25]);
+        assert_eq!(right, [0.1, 0.2]);
+    }
+
+    #[test]
+    fn test_tracks_aligned_to_slowest_chain() {
+        let mut pdc = DelayCompensation::new();
+        pdc.configure(&[(1, 0), (2, 128), (3, 64)]);
+
+        assert_eq!(pdc.max_latency(), 128);
+        assert_eq!(pdc.track(1).unwrap().compensation(), 128);
+        assert_eq!(pdc.track(2).unwrap().compensation(), 0);
+        assert_eq!(pdc.track(3).unwrap().compensation(), 64);
+
+        // Removed tracks are dropped, remaining ones re-aligned
+        pdc.configure(&[(1, 0), (3, 64)]);
+        assert!(pdc.track(2).is_none());
+        assert_eq!(pdc.track(1).unwrap().compensation(), 64);
+        assert_eq!(pdc.track(3).unwrap().compensation(), 0);
+    }
+
+    fn routed(id: TrackId, track_type: TrackType, parent_group: Option<TrackId>, chain_latency: u32) -> RoutedTrack {
+        RoutedTrack { id, track_type, parent_group, sends: Vec::new(), chain_latency, latency_changes: 0 }
+    }
+
+    #[test]
+    fn test_bus_latency_counts_toward_path() {
+        // A -> group G (100 samples), B -> master (100 samples)
+        let mut pdc = DelayCompensation::new();
+        pdc.configure_routed(&[
+            routed(1, TrackType::Audio, Some(3), 0),
+            routed(2, TrackType::Audio, None, 100),
+            routed(3, TrackType::Group, None, 100),
+        ]);
+        assert_eq!(pdc.max_latency(), 100);
+        assert_eq!(pdc.track(1).unwrap().compensation(), 0);
+        assert_eq!(pdc.track(2).unwrap().compensation(), 0);
+        assert_eq!(pdc.track(3).unwrap().compensation(), 0);
+
+        // Give A its own 50: B now waits for A's 150 through the group
+        pdc.configure_routed(&[
+            routed(1, TrackType::Audio, Some(3), 50),
+            routed(2, TrackType::Audio, None, 100),
+            routed(3, TrackType::Group, None, 100),
+        ]);
+        assert_eq!(pdc.max_latency(), 150);
+        assert_eq!(pdc.track(2).unwrap().compensation(), 50);
+        assert_eq!(pdc.track(3).unwrap().compensation(), 0);
+
+        // A second group member lines up with A before the group's chain
+        pdc.configure_routed(&[
+            routed(1, TrackType::Audio, Some(3), 50),
+            routed(2, TrackType::Audio, None, 100),
+            routed(3, TrackType::Group, None, 100),
+            routed(4, TrackType::Audio, Some(3), 0),
+        ]);
+        assert_eq!(pdc.track(4).unwrap().compensation(), 50);
+        assert_eq!(pdc.track(1).unwrap().compensation(), 0);
+    }
+
+    #[test]
+    fn test_send_and_direct_paths_line_up() {
+        // A sends to return R (64 samples) and goes to master directly
+        let mut sender = routed(1, TrackType::Audio, None, 0);
+        sender.sends.push(Send { target_track_id: 2, amount: 0.5, pre_fader: false });
+        let mut pdc = DelayCompensation::new();
+        pdc.configure_routed(&[sender, routed(2, TrackType::Return, None, 64)]);
+
+        assert_eq!(pdc.max_latency(), 64);
+        assert_eq!(pdc.track(1).unwrap().compensation(), 64);
+        assert_eq!(pdc.track(2).unwrap().compensation(), 0);
+
+        let mut left = [1.0];
+        let mut right = [1.0];
+        pdc.process_send(1, 2, &mut left, &mut right);
+        assert_eq!(left, [1.0], "the send itself isn't delayed");
+    }
+
+    #[test]
+    fn test_disabled_compensation_adds_no_delay() {
+        let mut pdc = DelayCompensation::new();
+        pdc.configure(&[(1, 0), (2, 256)]);
+        pdc.set_enabled(false);
+
+        assert_eq!(pdc.max_latency(), 0);
+        assert_eq!(pdc.track(1).unwrap().compensation(), 0);
+        assert_eq!(pdc.track(1).unwrap().chain_latency, 0);
+        assert_eq!(pdc.track(2).unwrap().chain_latency, 256);
+    }
+}
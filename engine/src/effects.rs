@@ -16,11 +16,37 @@ pub trait Effect: Send {
     /// Process a stereo frame (left, right) → (left_out, right_out)
     fn process_frame(&mut self, left: f32, right: f32) -> (f32, f32);
 
+    /// Process a block of stereo frames in place.
+    /// The default runs process_frame per frame; effects with per-call
+    /// overhead (VST3) override this to process the whole block at once.
+    fn process_block(&mut self, left: &mut [f32], right: &mut [f32]) {
+        for (l, r) in left.iter_mut().zip(right.iter_mut()) {
+            let (out_l, out_r) = self.process_frame(*l, *r);
+            *l = out_l;
+            *r = out_r;
+        }
+    }
+
     /// Reset internal state (clear buffers, etc.)
     fn reset(&mut self);
 
     /// Get effect name
     fn name(&self) -> &str;
+
+    /// Processing latency in samples (used for delay compensation)
+    fn latency_samples(&self) -> u32 {
+        0
+    }
+
+    /// Bumped whenever the latency changes, so callers only re-read
+    /// `latency_samples` for effects whose count moved
+    fn latency_change_count(&self) -> u32 {
+        0
+    }
+
+    /// Switch to offline rendering (export) with blocks of up to
+    /// `max_block_size` frames, or back to realtime. Only plugins care
+    fn set_offline_mode(&mut self, _offline: bool, _max_block_size: usize) {}
 }
 
 /// Unique identifier for effects
@@ -801,6 +827,19 @@ impl EffectType {
         }
     }
 
+    pub fn process_block(&mut self, left: &mut [f32], right: &mut [f32]) {
+        match self {
+            EffectType::EQ(fx) => fx.process_block(left, right),
+            EffectType::Compressor(fx) => fx.process_block(left, right),
+            EffectType::Reverb(fx) => fx.process_block(left, right),
+            EffectType::Delay(fx) => fx.process_block(left, right),
+            EffectType::Limiter(fx) => fx.process_block(left, right),
+            EffectType::Chorus(fx) => fx.process_block(left, right),
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            EffectType::VST3(fx) => fx.process_block(left, right),
+        }
+    }
+
     pub fn reset(&mut self) {
         match self {
             EffectType::EQ(fx) => fx.reset(),
@@ -826,6 +865,88 @@ impl EffectType {
             EffectType::VST3(fx) => fx.name(),
         }
     }
+
+    pub fn latency_samples(&self) -> u32 {
+        match self {
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            EffectType::VST3(fx) => fx.latency_samples(),
+            _ => 0,
+        }
+    }
+
+    pub fn latency_change_count(&self) -> u32 {
+        match self {
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            EffectType::VST3(fx) => fx.latency_change_count(),
+            _ => 0,
+        }
+    }
+
+    /// Independent copy for rendering on another thread. Built-in effects
+    /// are cloned with cleared buffers; VST3 plugins get a new instance
+    /// restored from this one's state
+    pub fn clone_instance(&self) -> Result<EffectType, String> {
+        match self {
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            EffectType::VST3(fx) => Ok(EffectType::VST3(fx.clone_instance()?)),
+            _ => {
+                let mut copy = self.clone();
+                copy.reset();
+                Ok(copy)
+            }
+        }
+    }
+
+    pub fn set_offline_mode(&mut self, offline: bool, max_block_size: usize) {
+        match self {
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            EffectType::VST3(fx) => fx.set_offline_mode(offline, max_block_size),
+            _ => {
+                let _ = (offline, max_block_size);
+            }
+        }
+    }
+}
+
+/// An effect taken out of the graph with its settings kept: built-in
+/// effects as they are, VST3 plugins unloaded down to their saved state
+#[derive(Clone)]
+pub enum ParkedEffect {
+    Builtin(EffectType),
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    VST3(crate::vst3_host::VST3SavedInstance),
+}
+
+impl ParkedEffect {
+    /// Capture an effect for parking. Built-in effects lose their buffers
+    pub fn park(effect: &EffectType) -> Result<ParkedEffect, String> {
+        match effect {
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            EffectType::VST3(fx) => Ok(ParkedEffect::VST3(fx.save_instance()?)),
+            _ => {
+                let mut copy = effect.clone();
+                copy.reset();
+                Ok(ParkedEffect::Builtin(copy))
+            }
+        }
+    }
+
+    /// Get a live effect back (loads the plugin again for VST3)
+    pub fn restore(&self) -> Result<EffectType, String> {
+        match self {
+            ParkedEffect::Builtin(effect) => Ok(effect.clone()),
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            ParkedEffect::VST3(saved) => Ok(EffectType::VST3(saved.restore()?)),
+        }
+    }
+
+    pub fn name(&self) -> &str {
+        match self {
+            ParkedEffect::Builtin(effect) => effect.name(),
+            #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+            ParkedEffect::VST3(saved) => &saved.name,
+        }
+    }
 }
 
 // ========================================================================
@@ -901,6 +1022,53 @@ impl EffectManager {
         self.bypass_states.get(&id).copied().unwrap_or(false)
     }
 
+    /// Run a block through an FX chain in place, skipping bypassed effects
+    pub fn process_chain_block(&self, chain: &[EffectId], left: &mut [f32], right: &mut [f32]) {
+        for effect_id in chain {
+            if self.is_bypassed(*effect_id) {
+                continue;
+            }
+            if let Some(effect_arc) = self.effects.get(effect_id) {
+                if let Ok(mut effect) = effect_arc.lock() {
+                    effect.process_block(left, right);
+                }
+            }
+        }
+    }
+
+    /// Total latency of an FX chain in samples, skipping bypassed effects
+    pub fn chain_latency(&self, chain: &[EffectId]) -> u32 {
+        chain
+            .iter()
+            .filter(|effect_id| !self.is_bypassed(**effect_id))
+            .filter_map(|effect_id| self.effects.get(effect_id))
+            .filter_map(|effect_arc| effect_arc.lock().ok().map(|effect| effect.latency_samples()))
+            .sum()
+    }
+
+    /// Latency change counts of an FX chain's effects, summed. Moves when
+    /// any of them reports a new latency (see `Effect::latency_change_count`)
+    pub fn chain_latency_changes(&self, chain: &[EffectId]) -> u32 {
+        chain
+            .iter()
+            .filter(|effect_id| !self.is_bypassed(**effect_id))
+            .filter_map(|effect_id| self.effects.get(effect_id))
+            .filter_map(|effect_arc| effect_arc.lock().ok().map(|effect| effect.latency_change_count()))
+            .fold(0, u32::wrapping_add)
+    }
+
+    /// Switch every effect in the given chains into or out of offline
+    /// rendering mode (see `Effect::set_offline_mode`)
+    pub fn set_offline_mode(&self, chains: &[&[EffectId]], offline: bool, max_block_size: usize) {
+        for effect_id in chains.iter().flat_map(|chain| chain.iter()) {
+            if let Some(effect_arc) = self.effects.get(effect_id) {
+                if let Ok(mut effect) = effect_arc.lock() {
+                    effect.set_offline_mode(offline, max_block_size);
+                }
+            }
+        }
+    }
+
     /// Get all effect IDs
     pub fn get_all_effect_ids(&self) -> Vec<EffectId> {
         self.effects.keys().copied().collect()
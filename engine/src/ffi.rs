@@ -189,6 +189,87 @@ pub extern "C" fn get_latency_info_ffi(
     }
 }
 
+/// Enable or disable plugin delay compensation
+#[no_mangle]
+pub extern "C" fn set_delay_compensation_enabled_ffi(enabled: bool) -> *mut c_char {
+    match api::set_delay_compensation_enabled(enabled) {
+        Ok(msg) => safe_cstring(msg).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Get a track's FX chain latency and the delay added to compensate it (samples)
+/// Returns false if the track doesn't exist
+#[no_mangle]
+pub extern "C" fn get_track_delay_compensation_ffi(
+    track_id: u64,
+    out_latency_samples: *mut u32,
+    out_compensation_samples: *mut u32,
+) -> bool {
+    match api::get_track_delay_compensation(track_id) {
+        Ok((latency, compensation)) => {
+            unsafe {
+                if !out_latency_samples.is_null() { *out_latency_samples = latency; }
+                if !out_compensation_samples.is_null() { *out_compensation_samples = compensation; }
+            }
+            true
+        }
+        Err(_) => false,
+    }
+}
+
+/// Get the latency all tracks are aligned to, in samples
+#[no_mangle]
+pub extern "C" fn get_delay_compensation_latency_ffi() -> u32 {
+    api::get_delay_compensation_latency().unwrap_or(0)
+}
+
+/// Enable or disable render-ahead for non-live tracks
+#[no_mangle]
+pub extern "C" fn set_render_ahead_ffi(enabled: bool, lead_ms: u32) -> *mut c_char {
+    match api::set_render_ahead(enabled, lead_ms) {
+        Ok(msg) => safe_cstring(msg).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Get render-ahead status as "enabled,lead_ms,tracks,underruns"
+#[no_mangle]
+pub extern "C" fn get_render_ahead_info_ffi() -> *mut c_char {
+    match api::get_render_ahead_info() {
+        Ok(info) => safe_cstring(info).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Get output callback timing: a "callback,..." summary line, then one
+/// line per lock the callback waits on
+#[no_mangle]
+pub extern "C" fn get_audio_callback_telemetry_ffi() -> *mut c_char {
+    match api::get_audio_callback_telemetry() {
+        Ok(info) => safe_cstring(info).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Get callbacks that missed their deadline since the last poll, one per line
+#[no_mangle]
+pub extern "C" fn poll_audio_xruns_ffi() -> *mut c_char {
+    match api::poll_audio_xruns() {
+        Ok(xruns) => safe_cstring(xruns).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Reset the callback timing histograms and xrun count
+#[no_mangle]
+pub extern "C" fn reset_audio_callback_telemetry_ffi() -> *mut c_char {
+    match api::reset_audio_callback_telemetry() {
+        Ok(msg) => safe_cstring(msg).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
 /// Get clip duration in seconds
 #[no_mangle]
 pub extern "C" fn get_clip_duration_ffi(clip_id: u64) -> f64 {
@@ -707,6 +788,36 @@ pub extern "C" fn set_track_name_ffi(track_id: u64, name: *const c_char) -> *mut
     }
 }
 
+/// Freeze a track (render to a cached file, unload plugins)
+/// `cache_dir` may be null or empty for the system temp folder
+#[no_mangle]
+pub extern "C" fn freeze_track_ffi(track_id: u64, cache_dir: *const c_char) -> *mut c_char {
+    let cache_dir_str = if cache_dir.is_null() {
+        String::new()
+    } else {
+        unsafe { CStr::from_ptr(cache_dir).to_string_lossy().to_string() }
+    };
+    match api::freeze_track(track_id, cache_dir_str) {
+        Ok(msg) => safe_cstring(msg).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Unfreeze a track (reload its plugins)
+#[no_mangle]
+pub extern "C" fn unfreeze_track_ffi(track_id: u64) -> *mut c_char {
+    match api::unfreeze_track(track_id) {
+        Ok(msg) => safe_cstring(msg).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Check whether a track is frozen
+#[no_mangle]
+pub extern "C" fn is_track_frozen_ffi(track_id: u64) -> bool {
+    api::is_track_frozen(track_id).unwrap_or(false)
+}
+
 /// Get track count
 #[no_mangle]
 pub extern "C" fn get_track_count_ffi() -> usize {
@@ -950,6 +1061,43 @@ pub extern "C" fn load_project_ffi(project_path: *const c_char) -> *mut c_char {
     }
 }
 
+/// Autosave project to .audio folder in the background, rewriting only
+/// plugin states that changed since the last autosave to the same folder
+#[no_mangle]
+pub extern "C" fn autosave_project_ffi(
+    project_name: *const c_char,
+    project_path: *const c_char,
+    compress: bool,
+) -> *mut c_char {
+    let project_name_str = unsafe {
+        match CStr::from_ptr(project_name).to_str() {
+            Ok(s) => s.to_string(),
+            Err(_) => return safe_cstring("Error: Invalid project name".to_string()).into_raw(),
+        }
+    };
+
+    let project_path_str = unsafe {
+        match CStr::from_ptr(project_path).to_str() {
+            Ok(s) => s.to_string(),
+            Err(_) => return safe_cstring("Error: Invalid project path".to_string()).into_raw(),
+        }
+    };
+
+    match api::autosave_project(project_name_str, project_path_str, compress) {
+        Ok(msg) => safe_cstring(msg).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Result of the last autosave ("running" while one is in progress)
+#[no_mangle]
+pub extern "C" fn get_autosave_status_ffi() -> *mut c_char {
+    match api::get_autosave_status() {
+        Ok(status) => safe_cstring(status).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
 /// Export to WAV file
 #[no_mangle]
 pub extern "C" fn export_to_wav_ffi(
@@ -1079,6 +1227,83 @@ pub extern "C" fn scan_vst3_plugins_standard_ffi() -> *mut c_char {
     }
 }
 
+/// Keep warm instances of pinned and recently added VST3 plugins so adding
+/// them is instant. 0 instances per class turns the pool off
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn configure_vst3_instance_pool_ffi(instances_per_class: i32, max_classes: i32) -> bool {
+    match api::configure_vst3_instance_pool(instances_per_class.max(0) as usize, max_classes.max(0) as usize) {
+        Ok(()) => true,
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to configure VST3 instance pool: {}", e);
+            false
+        }
+    }
+}
+
+/// Keep a VST3 plugin warm in the instance pool (or stop)
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn pin_vst3_plugin_ffi(plugin_path: *const c_char, pinned: bool) -> bool {
+    if plugin_path.is_null() {
+        return false;
+    }
+    let plugin_path = unsafe { CStr::from_ptr(plugin_path).to_string_lossy().into_owned() };
+
+    match api::pin_vst3_plugin(&plugin_path, pinned) {
+        Ok(()) => true,
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to pin VST3 plugin: {}", e);
+            false
+        }
+    }
+}
+
+/// List catalog plugins matching every non-NULL, non-empty filter, without
+/// scanning. Same "name|path|vendor|is_instrument|is_effect" lines as the scan
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn query_vst3_plugins_ffi(
+    vendor: *const c_char,
+    subcategory: *const c_char,
+    kind: *const c_char,
+    name_prefix: *const c_char,
+) -> *mut c_char {
+    let filter = |ptr: *const c_char| -> String {
+        if ptr.is_null() {
+            return String::new();
+        }
+        unsafe { CStr::from_ptr(ptr).to_string_lossy().into_owned() }
+    };
+
+    match api::query_vst3_plugins(&filter(vendor), &filter(subcategory), &filter(kind), &filter(name_prefix)) {
+        Ok(plugin_list) => safe_cstring(plugin_list).into_raw(),
+        Err(e) => {
+            eprintln!("❌ [FFI] VST3 catalog query failed: {}", e);
+            safe_cstring(String::new()).into_raw()
+        }
+    }
+}
+
+/// Distinct vendors or subcategories in the plugin catalog as
+/// "label|plugin count" lines. `index` is "vendor" or "subcategory"
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn get_vst3_plugin_filters_ffi(index: *const c_char) -> *mut c_char {
+    if index.is_null() {
+        return safe_cstring(String::new()).into_raw();
+    }
+    let index = unsafe { CStr::from_ptr(index).to_string_lossy().into_owned() };
+
+    match api::get_vst3_plugin_filters(&index) {
+        Ok(filters) => safe_cstring(filters).into_raw(),
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to list VST3 plugin filters: {}", e);
+            safe_cstring(String::new()).into_raw()
+        }
+    }
+}
+
 /// Add a VST3 effect to a track
 /// Returns the effect ID, or -1 on failure
 #[cfg(all(feature = "vst3", not(target_os = "ios")))]
@@ -1138,6 +1363,18 @@ pub extern "C" fn get_vst3_parameter_info_ffi(
     }
 }
 
+/// Get the metadata of every VST3 parameter in one call
+/// Returns one line per parameter:
+/// "index,id,default,min,max,step_count,units,short_title,title"
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn get_vst3_parameter_catalog_ffi(effect_id: i64) -> *mut c_char {
+    match api::get_vst3_parameter_catalog(effect_id as u64) {
+        Ok(catalog) => safe_cstring(catalog).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
 /// Get the current value of a VST3 parameter (0.0-1.0)
 #[cfg(all(feature = "vst3", not(target_os = "ios")))]
 #[no_mangle]
@@ -1172,6 +1409,100 @@ pub extern "C" fn set_vst3_parameter_value_ffi(
     }
 }
 
+/// Read `count` VST3 parameter values (by parameter ID) into `out_values`
+/// Returns the number of values read, or -1 on failure
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn get_vst3_parameter_values_ffi(
+    effect_id: i64,
+    param_ids: *const u32,
+    out_values: *mut f64,
+    count: i32,
+) -> i32 {
+    if param_ids.is_null() || out_values.is_null() || count <= 0 {
+        return if count == 0 { 0 } else { -1 };
+    }
+
+    let ids = unsafe { std::slice::from_raw_parts(param_ids, count as usize) };
+    match api::get_vst3_parameter_values(effect_id as u64, ids.to_vec()) {
+        Ok(values) => {
+            unsafe { std::ptr::copy_nonoverlapping(values.as_ptr(), out_values, values.len()) };
+            values.len() as i32
+        }
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to get VST3 parameter values: {}", e);
+            -1
+        }
+    }
+}
+
+/// Set `count` VST3 parameters (by parameter ID) from `values`
+/// Returns 1 on success, 0 on failure
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn set_vst3_parameter_values_ffi(
+    effect_id: i64,
+    param_ids: *const u32,
+    values: *const f64,
+    count: i32,
+) -> i32 {
+    if param_ids.is_null() || values.is_null() || count <= 0 {
+        return (count == 0) as i32;
+    }
+
+    let ids = unsafe { std::slice::from_raw_parts(param_ids, count as usize) };
+    let values = unsafe { std::slice::from_raw_parts(values, count as usize) };
+    match api::set_vst3_parameter_values(effect_id as u64, ids.to_vec(), values.to_vec()) {
+        Ok(()) => 1,
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to set VST3 parameter values: {}", e);
+            0
+        }
+    }
+}
+
+/// Drain parameter changes reported by a VST3 plugin's processor
+/// Returns a string of "id:value" pairs separated by ';' (empty if none)
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn poll_vst3_parameter_changes_ffi(effect_id: i64) -> *mut c_char {
+    match api::poll_vst3_parameter_changes(effect_id as u64) {
+        Ok(changes) => {
+            let encoded = changes
+                .iter()
+                .map(|(id, value)| format!("{}:{}", id, value))
+                .collect::<Vec<_>>()
+                .join(";");
+            safe_cstring(encoded).into_raw()
+        }
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to poll VST3 parameter changes: {}", e);
+            safe_cstring(String::new()).into_raw()
+        }
+    }
+}
+
+/// Drain the parameters edited in a VST3 plugin's own editor
+/// Returns "id:value:flags" entries separated by ';' (empty if none)
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn poll_vst3_editor_changes_ffi(effect_id: i64) -> *mut c_char {
+    match api::poll_vst3_editor_changes(effect_id as u64) {
+        Ok(changes) => {
+            let encoded = changes
+                .iter()
+                .map(|(id, value, flags)| format!("{}:{}:{}", id, value, flags))
+                .collect::<Vec<_>>()
+                .join(";");
+            safe_cstring(encoded).into_raw()
+        }
+        Err(e) => {
+            eprintln!("❌ [FFI] Failed to poll VST3 editor changes: {}", e);
+            safe_cstring(String::new()).into_raw()
+        }
+    }
+}
+
 // ============================================================================
 // M7: VST3 Editor FFI Functions
 // ============================================================================
@@ -1291,6 +1622,71 @@ pub extern "C" fn vst3_send_midi_note_ffi(
     }
 }
 
+/// Get a VST3 plugin's DSP load statistics
+/// Returns "calls,mean_us,p99_us,max_us,overruns,load" or error message
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn get_vst3_plugin_stats_ffi(effect_id: i64) -> *mut c_char {
+    match api::get_vst3_plugin_stats(effect_id as u64) {
+        Ok(stats) => safe_cstring(stats).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Get the VST3 plugins with the highest p99 process() time, worst first
+/// Returns newline-separated "effect_id,name,calls,mean_us,p99_us,max_us,overruns,load"
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn get_vst3_dsp_load_report_ffi(limit: i32) -> *mut c_char {
+    match api::get_vst3_dsp_load_report(limit.max(0) as usize) {
+        Ok(report) => safe_cstring(report).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Reset every VST3 plugin's DSP load statistics
+/// Returns empty string on success, error message on failure
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn reset_vst3_plugin_stats_ffi() -> *mut c_char {
+    match api::reset_vst3_plugin_stats() {
+        Ok(()) => safe_cstring(String::new()).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Load a VST3 plugin bundle in its own helper process from now on
+/// Returns empty string on success, error message on failure
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn set_vst3_plugin_bridged_ffi(plugin_path: *const c_char, bridged: bool) -> *mut c_char {
+    let plugin_path_str = unsafe {
+        match CStr::from_ptr(plugin_path).to_str() {
+            Ok(s) => s.to_string(),
+            Err(_) => return safe_cstring("Error: Invalid plugin path".to_string()).into_raw(),
+        }
+    };
+
+    match api::set_vst3_plugin_bridged(&plugin_path_str, bridged) {
+        Ok(()) => safe_cstring(String::new()).into_raw(),
+        Err(e) => safe_cstring(format!("Error: {}", e)).into_raw(),
+    }
+}
+
+/// Check whether a VST3 effect runs in a bridge helper process
+/// Returns 1 if bridged, 0 if in-process, -1 on error
+#[cfg(all(feature = "vst3", not(target_os = "ios")))]
+#[no_mangle]
+pub extern "C" fn is_vst3_effect_bridged_ffi(effect_id: i64) -> i32 {
+    match api::is_vst3_effect_bridged(effect_id as u64) {
+        Ok(bridged) => if bridged { 1 } else { 0 },
+        Err(e) => {
+            eprintln!("❌ [FFI] is_vst3_effect_bridged error: {}", e);
+            -1
+        }
+    }
+}
+
 // ============================================================================
 // MIDI Clip Info FFI (for restoring clips after project load)
 // ============================================================================
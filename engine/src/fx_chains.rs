@@ -0,0 +1,333 @@
+// FX chains as the audio callback sees them
+//
+// Chains are edited on the UI thread under the track and effect manager
+// locks, which the callback must never wait for. Instead every edit
+// publishes an immutable `ChainSnapshot` of all chains (effect handles
+// plus bypass state), RCU style: the callback picks up the newest one at
+// the start of a block with an atomic load - and an uncontended try_lock
+// when it changed - and keeps using it until the next edit.
+//
+// The snapshot the callback lets go of is retired to a fixed-size
+// lock-free list rather than dropped, so the callback never drops the
+// last reference to an effect. A reclaim thread frees retired snapshots;
+// a plugin removed while it was still in a published chain is
+// deactivated, disconnected and unloaded there.
+
+use crate::callback_telemetry::{lock_charged, CallbackStage, CallbackTelemetry};
+use crate::effects::{EffectId, EffectManager, EffectType};
+use crate::track::{TrackId, TrackManager};
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicBool, AtomicPtr, AtomicU64, Ordering};
+use std::sync::{Arc, LockResult, Mutex, MutexGuard};
+use std::thread::{self, JoinHandle};
+use std::time::Duration;
+
+/// Retired snapshots waiting for the reclaim thread. A reader that finds
+/// the list full keeps its current snapshot and tries again next block
+const RETIRED_SLOTS: usize = 64;
+
+/// How often the reclaim thread looks for retired snapshots
+const RECLAIM_INTERVAL: Duration = Duration::from_millis(50);
+
+/// One effect in a published chain
+pub struct ChainEffect {
+    pub effect: Arc<Mutex<EffectType>>,
+    pub bypassed: bool,
+}
+
+impl ChainEffect {
+    /// Lock the effect, charging any wait to `telemetry` (the live callback)
+    pub fn lock(&self, telemetry: Option<&CallbackTelemetry>) -> LockResult<MutexGuard<'_, EffectType>> {
+        lock_charged(telemetry, CallbackStage::Effects, &self.effect)
+    }
+}
+
+/// Every track's FX chain at one point in time. Never changes once published
+#[derive(Default)]
+pub struct ChainSnapshot {
+    chains: HashMap<TrackId, Vec<ChainEffect>>,
+}
+
+impl ChainSnapshot {
+    /// Capture the chains of every track (master included)
+    pub fn capture(track_manager: &TrackManager, effect_manager: &EffectManager) -> Self {
+        let mut chains = HashMap::new();
+        for track_arc in track_manager.get_all_tracks() {
+            let Ok(track) = track_arc.lock() else {
+                continue;
+            };
+            let chain = resolve_chain(effect_manager, &track.fx_chain);
+            if !chain.is_empty() {
+                chains.insert(track.id, chain);
+            }
+        }
+        Self { chains }
+    }
+
+    /// A track's chain in order (empty for unknown tracks)
+    pub fn chain(&self, track_id: TrackId) -> &[ChainEffect] {
+        self.chains.get(&track_id).map_or(&[], Vec::as_slice)
+    }
+}
+
+/// Look up a chain's effects and bypass states, dropping unknown IDs
+pub fn resolve_chain(effect_manager: &EffectManager, chain: &[EffectId]) -> Vec<ChainEffect> {
+    chain
+        .iter()
+        .filter_map(|&id| {
+            effect_manager.get_effect(id).map(|effect| ChainEffect {
+                effect,
+                bypassed: effect_manager.is_bypassed(id),
+            })
+        })
+        .collect()
+}
+
+/// Run a block through a chain in place, skipping bypassed effects. From
+/// the live callback, `telemetry` is charged with waits on effect locks
+pub fn process_chain(
+    chain: &[ChainEffect],
+    left: &mut [f32],
+    right: &mut [f32],
+    telemetry: Option<&CallbackTelemetry>,
+) {
+    for entry in chain {
+        if entry.bypassed {
+            continue;
+        }
+        if let Ok(mut effect) = entry.lock(telemetry) {
+            effect.process_block(left, right);
+        }
+    }
+}
+
+struct Shared {
+    latest: Mutex<Arc<ChainSnapshot>>,
+    /// Bumped on every publish; readers compare it with what they hold
+    generation: AtomicU64,
+    /// Each non-null slot owns one strong count (from `Arc::into_raw`)
+    retired: Box<[AtomicPtr<ChainSnapshot>]>,
+    shutdown: AtomicBool,
+}
+
+impl Shared {
+    /// Hand a snapshot to the reclaim thread. Lock- and allocation-free;
+    /// gives it back if every slot is taken
+    fn retire(&self, snapshot: Arc<ChainSnapshot>) -> Result<(), Arc<ChainSnapshot>> {
+        let raw = Arc::into_raw(snapshot) as *mut ChainSnapshot;
+        for slot in self.retired.iter() {
+            if slot
+                .compare_exchange(std::ptr::null_mut(), raw, Ordering::AcqRel, Ordering::Relaxed)
+                .is_ok()
+            {
+                return Ok(());
+            }
+        }
+        // SAFETY: `raw` came from `Arc::into_raw` above and wasn't stored
+        Err(unsafe { Arc::from_raw(raw) })
+    }
+
+    /// Drop every retired snapshot. Returns how many there were
+    fn reclaim(&self) -> usize {
+        let mut count = 0;
+        for slot in self.retired.iter() {
+            let raw = slot.swap(std::ptr::null_mut(), Ordering::AcqRel);
+            if !raw.is_null() {
+                // SAFETY: slots only hold pointers from `Arc::into_raw`
+                drop(unsafe { Arc::from_raw(raw as *const ChainSnapshot) });
+                count += 1;
+            }
+        }
+        count
+    }
+}
+
+/// Publishes chain snapshots and owns the reclaim thread. Lives in the
+/// audio graph; the callback holds a `ChainReader`
+pub struct ChainPublisher {
+    shared: Arc<Shared>,
+    reclaimer: Option<JoinHandle<()>>,
+}
+
+impl ChainPublisher {
+    pub fn new() -> Self {
+        let shared = Arc::new(Shared {
+            latest: Mutex::new(Arc::new(ChainSnapshot::default())),
+            generation: AtomicU64::new(0),
+            retired: (0..RETIRED_SLOTS).map(|_| AtomicPtr::new(std::ptr::null_mut())).collect(),
+            shutdown: AtomicBool::new(false),
+        });
+
+        let reclaimer = {
+            let shared = shared.clone();
+            thread::Builder::new()
+                .name("fx-reclaim".to_string())
+                .spawn(move || {
+                    while !shared.shutdown.load(Ordering::Acquire) {
+                        thread::park_timeout(RECLAIM_INTERVAL);
+                        shared.reclaim();
+                    }
+                })
+        };
+        let reclaimer = match reclaimer {
+            Ok(handle) => Some(handle),
+            Err(e) => {
+                // Retired snapshots then wait for the next publish
+                eprintln!("⚠️  [FxChains] Failed to start reclaim thread: {}", e);
+                None
+            }
+        };
+
+        Self { shared, reclaimer }
+    }
+
+    /// Make `snapshot` the chains the callback processes from its next block
+    pub fn publish(&self, snapshot: ChainSnapshot) {
+        let snapshot = Arc::new(snapshot);
+        let previous = {
+            let mut latest = self.shared.latest.lock().expect("mutex poisoned");
+            std::mem::replace(&mut *latest, snapshot)
+        };
+        self.shared.generation.fetch_add(1, Ordering::Release);
+
+        // Not on the audio thread, so dropping here is fine if the list is full
+        drop(self.shared.retire(previous));
+        if self.reclaimer.is_none() {
+            self.shared.reclaim();
+        }
+    }
+
+    /// A reader for one audio callback, starting at the latest snapshot
+    pub fn reader(&self) -> ChainReader {
+        let current = self.shared.latest.lock().expect("mutex poisoned").clone();
+        ChainReader {
+            shared: self.shared.clone(),
+            current,
+            generation: self.shared.generation.load(Ordering::Acquire),
+            stale: None,
+        }
+    }
+}
+
+impl Default for ChainPublisher {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Drop for ChainPublisher {
+    fn drop(&mut self) {
+        self.shared.shutdown.store(true, Ordering::Release);
+        if let Some(reclaimer) = self.reclaimer.take() {
+            reclaimer.thread().unpark();
+            let _ = reclaimer.join();
+        }
+        self.shared.reclaim();
+    }
+}
+
+/// The audio callback's view of the chains
+pub struct ChainReader {
+    shared: Arc<Shared>,
+    current: Arc<ChainSnapshot>,
+    generation: u64,
+    /// A snapshot let go of while the retired list was full
+    stale: Option<Arc<ChainSnapshot>>,
+}
+
+impl ChainReader {
+    /// Chains for this block: the newest published snapshot, or the one
+    /// already held while the publisher is mid-swap. Never blocks,
+    /// allocates or frees
+    pub fn current(&mut self) -> &ChainSnapshot {
+        if let Some(stale) = self.stale.take() {
+            if let Err(stale) = self.shared.retire(stale) {
+                self.stale = Some(stale);
+                return &self.current;
+            }
+        }
+
+        let generation = self.shared.generation.load(Ordering::Acquire);
+        if generation != self.generation {
+            if let Ok(latest) = self.shared.latest.try_lock() {
+                let previous = std::mem::replace(&mut self.current, latest.clone());
+                drop(latest);
+                self.generation = generation;
+                if let Err(previous) = self.shared.retire(previous) {
+                    self.stale = Some(previous);
+                }
+            }
+        }
+        &self.current
+    }
+}
+
+impl Drop for ChainReader {
+    fn drop(&mut self) {
+        // The field's own reference goes when this returns; the retired
+        // one keeps the snapshot alive until the reclaim thread runs
+        drop(self.shared.retire(self.current.clone()));
+        if let Some(stale) = self.stale.take() {
+            drop(self.shared.retire(stale));
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::effects::Compressor;
+
+    fn manager_with_chain(bypass_second: bool) -> (TrackManager, EffectManager, TrackId, EffectId) {
+        let mut track_manager = TrackManager::new();
+        let track_id = track_manager.create_track(crate::track::TrackType::Audio, "Track".to_string());
+        let mut effect_manager = EffectManager::new();
+        let first = effect_manager.create_effect(EffectType::Compressor(Compressor::new()));
+        let second = effect_manager.create_effect(EffectType::Compressor(Compressor::new()));
+        effect_manager.set_bypass(second, bypass_second);
+        track_manager.get_track(track_id).unwrap().lock().unwrap().fx_chain = vec![first, second];
+        (track_manager, effect_manager, track_id, second)
+    }
+
+    #[test]
+    fn test_reader_picks_up_published_chains() {
+        let (track_manager, effect_manager, track_id, _) = manager_with_chain(true);
+        let publisher = ChainPublisher::new();
+        let mut reader = publisher.reader();
+        assert!(reader.current().chain(track_id).is_empty());
+
+        publisher.publish(ChainSnapshot::capture(&track_manager, &effect_manager));
+        let chain = reader.current().chain(track_id);
+        assert_eq!(chain.len(), 2);
+        assert!(!chain[0].bypassed);
+        assert!(chain[1].bypassed);
+
+        let mut left = [0.5f32; 64];
+        let mut right = [0.5f32; 64];
+        process_chain(chain, &mut left, &mut right, None);
+        assert!(left.iter().all(|s| s.is_finite()));
+    }
+
+    #[test]
+    fn test_removed_effects_are_freed_by_the_reclaimer() {
+        let (track_manager, mut effect_manager, track_id, second) = manager_with_chain(false);
+        let publisher = ChainPublisher::new();
+        let mut reader = publisher.reader();
+        publisher.publish(ChainSnapshot::capture(&track_manager, &effect_manager));
+        let handle = Arc::downgrade(&reader.current().chain(track_id)[1].effect);
+
+        // Remove the effect and publish; the reader still holds the old chain
+        effect_manager.remove_effect(second);
+        track_manager.get_track(track_id).unwrap().lock().unwrap().fx_chain.pop();
+        publisher.publish(ChainSnapshot::capture(&track_manager, &effect_manager));
+        assert!(handle.upgrade().is_some());
+
+        // Once the reader moves on, the old snapshot is retired, not dropped
+        assert_eq!(reader.current().chain(track_id).len(), 1);
+        let deadline = std::time::Instant::now() + Duration::from_secs(2);
+        while handle.upgrade().is_some() && std::time::Instant::now() < deadline {
+            thread::sleep(Duration::from_millis(5));
+        }
+        assert!(handle.upgrade().is_none());
+    }
+}
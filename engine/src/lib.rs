@@ -14,6 +14,12 @@ mod midi_recorder;
 mod synth;
 mod track;      // M4: Track system
 mod effects;    // M4: Audio effects
+mod fx_chains;  // FX chain snapshots published to the audio callback
+mod delay_compensation;  // Plugin delay compensation
+mod mix_graph;  // Track routing DAG for parallel mixing
+mod work_pool;  // Work-stealing pool for the audio callback
+mod render_ahead;  // Render-ahead buffers for non-live tracks
+mod callback_telemetry;  // Audio callback deadline and lock-wait telemetry
 mod project;    // M5: Project serialization
 mod export;     // M8: Audio export (WAV, MP3, stems)
 
@@ -35,6 +41,11 @@ pub use midi_recorder::*;
 pub use synth::*;
 pub use track::*;
 pub use effects::*;
+pub use delay_compensation::*;
+pub use mix_graph::*;
+pub use work_pool::*;
+pub use render_ahead::*;
+pub use callback_telemetry::*;
 pub use project::*;
 pub use export::*;
 
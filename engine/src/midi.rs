@@ -148,11 +148,16 @@ impl MidiClip {
 
     /// Get all events within a time range (in samples)
     pub fn get_events_in_range(&self, start_samples: u64, end_samples: u64) -> Vec<MidiEvent> {
-        self.events
-            .iter()
-            .filter(|e| e.timestamp_samples >= start_samples && e.timestamp_samples < end_samples)
-            .copied()
-            .collect()
+        self.events_between(start_samples, end_samples).to_vec()
+    }
+
+    /// Events in `[start_samples, end_samples)`, borrowed. `events` is kept
+    /// sorted, so this is two binary searches and never allocates (used by
+    /// the audio callback)
+    pub fn events_between(&self, start_samples: u64, end_samples: u64) -> &[MidiEvent] {
+        let start = self.events.partition_point(|e| e.timestamp_samples < start_samples);
+        let end = start + self.events[start..].partition_point(|e| e.timestamp_samples < end_samples);
+        &self.events[start..end]
     }
 
     /// Get duration in seconds
@@ -253,6 +258,25 @@ mod tests {
         assert_eq!(clip.events[1].timestamp_samples, 2000);
     }
 
+    #[test]
+    fn test_events_between() {
+        let clip = MidiClip::with_events(
+            vec![
+                MidiEvent::note_on(60, 100, 1000),
+                MidiEvent::note_on(64, 100, 1000),
+                MidiEvent::note_off(60, 64, 2000),
+                MidiEvent::note_off(64, 64, 3000),
+            ],
+            48000,
+        );
+
+        assert_eq!(clip.events_between(1000, 2000).len(), 2);
+        assert_eq!(clip.events_between(1001, 3000).len(), 1);
+        assert_eq!(clip.events_between(3000, 4000)[0].timestamp_samples, 3000);
+        assert!(clip.events_between(3001, 9000).is_empty());
+        assert!(clip.events_between(2000, 1000).is_empty());
+    }
+
     #[test]
     fn test_midi_clip_quantize() {
         let mut clip = MidiClip::new(48000);
@@ -0,0 +1,368 @@
+// Mixer routing graph
+//
+// Compiles the track list into a DAG for the audio callback. Every track
+// is a node; a track feeds its parent group (if that's a Group track) or
+// the master bus, and sends feed Return tracks. Nodes are grouped into
+// levels: everything in a level depends only on earlier levels, so a level's
+// tracks can be processed in parallel and summed into their buses before the
+// next level runs. The master bus always comes last and isn't a node.
+//
+// Routing that would form a cycle (a group inside its own child, a return
+// sending back into itself through another return) is cut: the offending
+// edge is dropped and that track goes straight to master instead.
+
+use crate::track::{Send, TrackId, TrackType};
+use std::collections::HashMap;
+
+/// Where a node's post-fader output goes
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum MixOutput {
+    Master,
+    /// Another node (a Group track), by index
+    Bus(usize),
+}
+
+/// A send from one node into a Return track node
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct MixSend {
+    pub target: usize,
+    pub amount: f32,
+    pub pre_fader: bool,
+}
+
+/// Routing-relevant part of a track, as read by `MixGraph::compile`.
+/// The callback compiles straight from its track snapshots
+pub trait MixNode {
+    fn id(&self) -> TrackId;
+    fn track_type(&self) -> TrackType;
+    fn parent_group(&self) -> Option<TrackId>;
+    fn sends(&self) -> &[Send];
+}
+
+/// A `MixNode` borrowing its sends from elsewhere
+pub struct MixNodeDesc<'a> {
+    pub id: TrackId,
+    pub track_type: TrackType,
+    pub parent_group: Option<TrackId>,
+    pub sends: &'a [Send],
+}
+
+impl MixNode for MixNodeDesc<'_> {
+    fn id(&self) -> TrackId {
+        self.id
+    }
+
+    fn track_type(&self) -> TrackType {
+        self.track_type
+    }
+
+    fn parent_group(&self) -> Option<TrackId> {
+        self.parent_group
+    }
+
+    fn sends(&self) -> &[Send] {
+        self.sends
+    }
+}
+
+/// Compiled routing for one callback. Reused between callbacks so
+/// recompiling an unchanged session doesn't allocate
+#[derive(Debug, Default)]
+pub struct MixGraph {
+    index_of: HashMap<TrackId, usize>,
+    outputs: Vec<MixOutput>,
+    sends: Vec<Vec<MixSend>>,
+    /// Nodes feeding each node (through its output or a send)
+    inputs: Vec<Vec<usize>>,
+    levels: Vec<Vec<usize>>,
+    level_count: usize,
+    active: Vec<bool>,
+    // Scratch
+    level_of: Vec<usize>,
+    pending_inputs: Vec<usize>,
+    solo_down: Vec<bool>,
+}
+
+const UNPLACED: usize = usize::MAX;
+
+impl MixGraph {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Rebuild the graph for `nodes`; node indices are positions in `nodes`.
+    /// Master must not be among them
+    pub fn compile<N: MixNode>(&mut self, nodes: &[N]) {
+        let count = nodes.len();
+
+        self.index_of.clear();
+        for (index, node) in nodes.iter().enumerate() {
+            self.index_of.insert(node.id(), index);
+        }
+
+        self.outputs.clear();
+        self.sends.resize_with(count, Vec::new);
+        self.inputs.resize_with(count, Vec::new);
+        for index in 0..count {
+            self.sends[index].clear();
+            self.inputs[index].clear();
+        }
+
+        for (index, node) in nodes.iter().enumerate() {
+            let output = node
+                .parent_group()
+                .and_then(|id| self.index_of.get(&id).copied())
+                .filter(|&parent| parent != index && nodes[parent].track_type() == TrackType::Group)
+                .map_or(MixOutput::Master, MixOutput::Bus);
+            if let MixOutput::Bus(parent) = output {
+                self.inputs[parent].push(index);
+            }
+            self.outputs.push(output);
+
+            for send in node.sends() {
+                let Some(&target) = self.index_of.get(&send.target_track_id) else {
+                    continue;
+                };
+                if target == index || nodes[target].track_type() != TrackType::Return || send.amount <= 0.0 {
+                    continue;
+                }
+                self.sends[index].push(MixSend {
+                    target,
+                    amount: send.amount,
+                    pre_fader: send.pre_fader,
+                });
+                self.inputs[target].push(index);
+            }
+        }
+
+        self.place_levels(count);
+    }
+
+    /// Assign every node a level, longest path from a source first (Kahn's
+    /// algorithm). When only cycles are left, the lowest-index remaining
+    /// node loses its inputs from other remaining nodes
+    fn place_levels(&mut self, count: usize) {
+        self.level_of.clear();
+        self.level_of.resize(count, UNPLACED);
+        self.pending_inputs.clear();
+        self.pending_inputs.extend(self.inputs.iter().take(count).map(Vec::len));
+
+        let mut placed = 0;
+        let mut level_count = 0;
+        while placed < count {
+            let mut progressed = false;
+            for index in 0..count {
+                if self.level_of[index] != UNPLACED || self.pending_inputs[index] != 0 {
+                    continue;
+                }
+                self.place(index);
+                level_count = level_count.max(self.level_of[index] + 1);
+                placed += 1;
+                progressed = true;
+            }
+
+            if !progressed {
+                let Some(stuck) = (0..count).find(|&index| self.level_of[index] == UNPLACED) else {
+                    break;
+                };
+                self.cut_unplaced_inputs(stuck);
+            }
+        }
+
+        for level in &mut self.levels {
+            level.clear();
+        }
+        if self.levels.len() < level_count {
+            self.levels.resize_with(level_count, Vec::new);
+        }
+        for index in 0..count {
+            self.levels[self.level_of[index]].push(index);
+        }
+        self.level_count = level_count;
+    }
+
+    fn place(&mut self, index: usize) {
+        let level = self.inputs[index]
+            .iter()
+            .map(|&source| self.level_of[source] + 1)
+            .max()
+            .unwrap_or(0);
+        self.level_of[index] = level;
+
+        if let MixOutput::Bus(parent) = self.outputs[index] {
+            self.pending_inputs[parent] -= 1;
+        }
+        for send in &self.sends[index] {
+            self.pending_inputs[send.target] -= 1;
+        }
+    }
+
+    fn cut_unplaced_inputs(&mut self, target: usize) {
+        let mut inputs = std::mem::take(&mut self.inputs[target]);
+        inputs.retain(|&source| {
+            if self.level_of[source] != UNPLACED {
+                return true;
+            }
+            if self.outputs[source] == MixOutput::Bus(target) {
+                self.outputs[source] = MixOutput::Master;
+            }
+            self.sends[source].retain(|send| send.target != target);
+            false
+        });
+        self.inputs[target] = inputs;
+        self.pending_inputs[target] = 0;
+    }
+
+    pub fn len(&self) -> usize {
+        self.outputs.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.outputs.is_empty()
+    }
+
+    pub fn index_of(&self, track_id: TrackId) -> Option<usize> {
+        self.index_of.get(&track_id).copied()
+    }
+
+    /// Node indices by level; every node's inputs are in earlier levels
+    pub fn levels(&self) -> &[Vec<usize>] {
+        &self.levels[..self.level_count]
+    }
+
+    pub fn output(&self, index: usize) -> MixOutput {
+        self.outputs[index]
+    }
+
+    pub fn sends(&self, index: usize) -> &[MixSend] {
+        &self.sends[index]
+    }
+
+    pub fn inputs(&self, index: usize) -> &[usize] {
+        &self.inputs[index]
+    }
+
+    /// Work out which nodes are heard, from per-node mute and solo flags.
+    /// With any solo active, a node plays if it's soloed, sits inside a
+    /// soloed group, or is a bus with an audible input (so soloing a
+    /// track keeps its group and returns audible). Muted nodes never play
+    pub fn resolve_active(
+        &mut self,
+        has_solo: bool,
+        muted: impl Fn(usize) -> bool,
+        soloed: impl Fn(usize) -> bool,
+    ) {
+        let count = self.len();
+        self.solo_down.clear();
+        self.solo_down.resize(count, false);
+        self.active.clear();
+        self.active.resize(count, false);
+
+        // Solo flows down from groups to their members...
+        for level in self.levels[..self.level_count].iter().rev() {
+            for &index in level {
+                self.solo_down[index] = soloed(index)
+                    || matches!(self.outputs[index], MixOutput::Bus(parent) if self.solo_down[parent]);
+            }
+        }
+        // ...and audibility flows up from members to their buses
+        for level in &self.levels[..self.level_count] {
+            for &index in level {
+                self.active[index] = !muted(index)
+                    && (!has_solo
+                        || self.solo_down[index]
+                        || self.inputs[index].iter().any(|&source| self.active[source]));
+            }
+        }
+    }
+
+    /// Result of the last `resolve_active` for a node
+    pub fn is_active(&self, index: usize) -> bool {
+        self.active.get(index).copied().unwrap_or(false)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn node(id: TrackId, track_type: TrackType, parent_group: Option<TrackId>, sends: &[Send]) -> MixNodeDesc<'_> {
+        MixNodeDesc { id, track_type, parent_group, sends }
+    }
+
+    fn send(target_track_id: TrackId) -> Send {
+        Send { target_track_id, amount: 0.5, pre_fader: false }
+    }
+
+    #[test]
+    fn test_flat_session_is_one_level() {
+        let mut graph = MixGraph::new();
+        graph.compile(&[
+            node(1, TrackType::Audio, None, &[]),
+            node(2, TrackType::Midi, None, &[]),
+            node(3, TrackType::Audio, None, &[]),
+        ]);
+        assert_eq!(graph.levels(), &[vec![0, 1, 2]]);
+        assert!((0..3).all(|i| graph.output(i) == MixOutput::Master));
+    }
+
+    #[test]
+    fn test_groups_and_returns_run_after_their_inputs() {
+        let to_reverb = [send(10)];
+        let mut graph = MixGraph::new();
+        graph.compile(&[
+            node(1, TrackType::Audio, Some(5), &to_reverb),
+            node(2, TrackType::Audio, Some(5), &[]),
+            node(5, TrackType::Group, None, &[]),
+            node(10, TrackType::Return, None, &[]),
+            // A parent that isn't a group is ignored
+            node(3, TrackType::Audio, Some(1), &[]),
+        ]);
+
+        assert_eq!(graph.levels(), &[vec![0, 1, 4], vec![2, 3]]);
+        assert_eq!(graph.output(0), MixOutput::Bus(2));
+        assert_eq!(graph.output(4), MixOutput::Master);
+        assert_eq!(graph.sends(0), &[MixSend { target: 3, amount: 0.5, pre_fader: false }]);
+        assert_eq!(graph.inputs(2), &[0, 1]);
+    }
+
+    #[test]
+    fn test_cycles_are_cut() {
+        // Two returns sending into each other
+        let to_b = [send(2)];
+        let to_a = [send(1)];
+        let mut graph = MixGraph::new();
+        graph.compile(&[
+            node(1, TrackType::Return, None, &to_b),
+            node(2, TrackType::Return, None, &to_a),
+        ]);
+
+        // Node 0 lost its input from node 1, so 0 -> 1 remains
+        assert_eq!(graph.levels(), &[vec![0], vec![1]]);
+        assert!(graph.sends(1).is_empty());
+        assert_eq!(graph.sends(0).len(), 1);
+    }
+
+    #[test]
+    fn test_solo_keeps_buses_of_soloed_tracks_audible() {
+        let mut graph = MixGraph::new();
+        graph.compile(&[
+            node(1, TrackType::Audio, Some(3), &[]),
+            node(2, TrackType::Audio, None, &[]),
+            node(3, TrackType::Group, None, &[]),
+            node(4, TrackType::Audio, Some(6), &[]),
+            node(6, TrackType::Group, None, &[]),
+        ]);
+
+        // Solo track 1 and group 6
+        let soloed = [true, false, false, false, true];
+        graph.resolve_active(true, |_| false, |i| soloed[i]);
+        let active: Vec<bool> = (0..5).map(|i| graph.is_active(i)).collect();
+        assert_eq!(active, [true, false, true, true, true]);
+
+        // A muted group is silent; its soloed member still plays into it
+        graph.resolve_active(true, |i| i == 2, |i| soloed[i]);
+        assert!(!graph.is_active(2));
+        assert!(graph.is_active(0));
+    }
+}
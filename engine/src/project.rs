@@ -5,10 +5,13 @@
 /// - project.json (all metadata)
 /// - audio/ (imported audio files)
 /// - cache/ (waveform peaks, etc.)
+/// - plugins/ (VST3 state blobs written by incremental autosave)
 
 use serde::{Deserialize, Serialize};
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::fs;
+use std::hash::Hasher;
+use std::io::{Read, Write};
 use std::path::{Path, PathBuf};
 use anyhow::{Context, Result};
 
@@ -190,7 +193,15 @@ pub struct Vst3PluginData {
     /// Is this an instrument (vs effect)?
     pub is_instrument: bool,
     /// Base64-encoded plugin state blob
+    #[serde(default)]
     pub state_base64: String,
+    /// Plugin state stored as a separate file instead (relative to the
+    /// project folder, see `write_plugin_state`)
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub state_file: Option<String>,
+    /// Contents of `state_file`, read by `load_plugin_state_files`
+    #[serde(skip)]
+    pub state_data: Vec<u8>,
 }
 
 /// Synthesizer settings data
@@ -286,30 +297,196 @@ pub fn copy_audio_file_to_project(
     fs::create_dir_all(&audio_dir)
         .context("Failed to create audio directory")?;
 
-    // Generate filename: 001-filename.wav
-    let original_name = source_path
-        .file_name()
-        .and_then(|n| n.to_str())
-        .unwrap_or("audio.wav");
-
-    let dest_filename = format!("{:03}-{}", file_id, original_name);
-    let dest_path = audio_dir.join(&dest_filename);
+    let relative_path = audio_file_relative_path(source_path, file_id);
+    let dest_path = project_path.join(&relative_path);
 
     // Copy file
     fs::copy(source_path, &dest_path)
         .context("Failed to copy audio file")?;
 
-    // Return relative path
-    let relative_path = format!("audio/{}", dest_filename);
     eprintln!("📁 [Project] Copied audio file: {}", relative_path);
     Ok(relative_path)
 }
 
+/// Where `copy_audio_file_to_project` puts a file: audio/001-filename.wav
+pub fn audio_file_relative_path(source_path: &Path, file_id: u64) -> String {
+    let original_name = source_path
+        .file_name()
+        .and_then(|n| n.to_str())
+        .unwrap_or("audio.wav");
+
+    format!("audio/{:03}-{}", file_id, original_name)
+}
+
 /// Resolve audio file path (relative to project folder)
 pub fn resolve_audio_file_path(project_path: &Path, relative_path: &str) -> PathBuf {
     project_path.join(relative_path)
 }
 
+// ========================================================================
+// PLUGIN STATE BLOBS
+// ========================================================================
+//
+// Incremental autosave keeps each VST3 plugin's state in its own file
+// under plugins/ instead of base64 inside project.json, so a save only
+// rewrites the plugins whose state actually changed.
+
+/// Folder (inside the project) holding plugin state blobs
+pub const PLUGIN_STATE_DIR: &str = "plugins";
+
+/// Hash of a plugin state blob, to tell a re-serialized but identical
+/// state from a real change
+pub fn plugin_state_hash(data: &[u8]) -> u64 {
+    let mut hasher = std::collections::hash_map::DefaultHasher::new();
+    hasher.write(data);
+    hasher.finish()
+}
+
+/// Write a plugin's state blob, optionally gzip-compressed.
+/// The file is written next to its final name and renamed over it, so an
+/// interrupted save leaves the previous blob intact.
+/// Returns the path relative to the project folder.
+pub fn write_plugin_state(
+    project_path: &Path,
+    effect_id: u64,
+    data: &[u8],
+    compress: bool,
+) -> Result<String> {
+    let state_dir = project_path.join(PLUGIN_STATE_DIR);
+    fs::create_dir_all(&state_dir)
+        .context("Failed to create plugins directory")?;
+
+    let file_name = if compress {
+        format!("{}.vst3state.gz", effect_id)
+    } else {
+        format!("{}.vst3state", effect_id)
+    };
+    let dest_path = state_dir.join(&file_name);
+    let temp_path = state_dir.join(format!("{}.tmp", file_name));
+
+    if compress {
+        let file = fs::File::create(&temp_path)
+            .context("Failed to create plugin state file")?;
+        let mut encoder = flate2::write::GzEncoder::new(file, flate2::Compression::fast());
+        encoder.write_all(data)
+            .context("Failed to write plugin state")?;
+        encoder.finish()
+            .context("Failed to write plugin state")?;
+    } else {
+        fs::write(&temp_path, data)
+            .context("Failed to write plugin state")?;
+    }
+
+    fs::rename(&temp_path, &dest_path)
+        .context("Failed to replace plugin state file")?;
+
+    // Drop the other encoding's blob if compression was toggled
+    let other_name = if compress {
+        format!("{}.vst3state", effect_id)
+    } else {
+        format!("{}.vst3state.gz", effect_id)
+    };
+    let _ = fs::remove_file(state_dir.join(other_name));
+
+    Ok(format!("{}/{}", PLUGIN_STATE_DIR, file_name))
+}
+
+/// Read a plugin state blob written by `write_plugin_state`
+pub fn read_plugin_state(project_path: &Path, relative_path: &str) -> Result<Vec<u8>> {
+    let path = project_path.join(relative_path);
+    let file = fs::File::open(&path)
+        .with_context(|| format!("Failed to open plugin state {:?}", path))?;
+
+    let mut data = Vec::new();
+    if relative_path.ends_with(".gz") {
+        flate2::read::GzDecoder::new(file).read_to_end(&mut data)
+    } else {
+        std::io::BufReader::new(file).read_to_end(&mut data)
+    }
+    .with_context(|| format!("Failed to read plugin state {:?}", path))?;
+
+    Ok(data)
+}
+
+/// Read every plugin's `state_file` into `state_data` after loading
+/// project.json. Unreadable blobs are reported and skipped so the rest of
+/// the project still loads.
+pub fn load_plugin_state_files(project_data: &mut ProjectData, project_path: &Path) {
+    for track in &mut project_data.tracks {
+        for plugin in &mut track.vst3_plugins {
+            if let Some(state_file) = &plugin.state_file {
+                match read_plugin_state(project_path, state_file) {
+                    Ok(data) => plugin.state_data = data,
+                    Err(e) => eprintln!("⚠️  [Project] {}: {:#}", plugin.plugin_name, e),
+                }
+            }
+        }
+    }
+}
+
+/// Delete blobs in plugins/ that no plugin refers to any more
+pub fn remove_unused_plugin_states(project_path: &Path, used: &HashSet<String>) {
+    let Ok(entries) = fs::read_dir(project_path.join(PLUGIN_STATE_DIR)) else {
+        return;
+    };
+    for entry in entries.flatten() {
+        let relative_path = format!("{}/{}", PLUGIN_STATE_DIR, entry.file_name().to_string_lossy());
+        if !used.contains(&relative_path) {
+            let _ = fs::remove_file(entry.path());
+        }
+    }
+}
+
+/// What was last written for one plugin
+#[derive(Debug, Clone, PartialEq)]
+pub struct SavedPluginState {
+    /// Plugin state generation the blob was captured at
+    pub generation: u64,
+    /// `plugin_state_hash` of the blob
+    pub hash: u64,
+    /// Blob path relative to the project folder
+    pub state_file: String,
+}
+
+/// Plugin blobs already on disk for one project folder, keyed by effect ID
+#[derive(Debug, Default)]
+pub struct PluginStateCache {
+    project_path: Option<PathBuf>,
+    compress: bool,
+    entries: HashMap<u64, SavedPluginState>,
+}
+
+impl PluginStateCache {
+    /// Start saving into `project_path`. Switching folders or compression
+    /// forgets everything, since none of those blobs exist there yet.
+    pub fn target(&mut self, project_path: &Path, compress: bool) {
+        if self.project_path.as_deref() != Some(project_path) || self.compress != compress {
+            self.project_path = Some(project_path.to_path_buf());
+            self.compress = compress;
+            self.entries.clear();
+        }
+    }
+
+    pub fn get(&self, effect_id: u64) -> Option<&SavedPluginState> {
+        self.entries.get(&effect_id)
+    }
+
+    pub fn insert(&mut self, effect_id: u64, saved: SavedPluginState) {
+        self.entries.insert(effect_id, saved);
+    }
+
+    /// Keep only the listed effects (the others were removed)
+    pub fn retain(&mut self, effect_ids: &HashSet<u64>) {
+        self.entries.retain(|effect_id, _| effect_ids.contains(effect_id));
+    }
+
+    /// Forget everything (effect IDs are reassigned when a project loads)
+    pub fn clear(&mut self) {
+        self.project_path = None;
+        self.entries.clear();
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -348,4 +525,52 @@ mod tests {
         // Clean up
         fs::remove_dir_all(&temp_dir).unwrap();
     }
+
+    #[test]
+    fn test_plugin_state_blob_round_trip() {
+        let temp_dir = env::temp_dir().join("boojy_test_plugin_state.audio");
+        let _ = fs::remove_dir_all(&temp_dir);
+
+        let state: Vec<u8> = (0..10_000u32).map(|i| (i % 251) as u8).collect();
+
+        let plain = write_plugin_state(&temp_dir, 7, &state, false).unwrap();
+        assert_eq!(plain, "plugins/7.vst3state");
+        assert_eq!(read_plugin_state(&temp_dir, &plain).unwrap(), state);
+
+        // Switching to compressed replaces the plain blob
+        let compressed = write_plugin_state(&temp_dir, 7, &state, true).unwrap();
+        assert_eq!(compressed, "plugins/7.vst3state.gz");
+        assert!(!temp_dir.join(&plain).exists());
+        assert_eq!(read_plugin_state(&temp_dir, &compressed).unwrap(), state);
+
+        let stale = write_plugin_state(&temp_dir, 8, &state, true).unwrap();
+        remove_unused_plugin_states(&temp_dir, &HashSet::from([compressed.clone()]));
+        assert!(temp_dir.join(&compressed).exists());
+        assert!(!temp_dir.join(&stale).exists());
+
+        fs::remove_dir_all(&temp_dir).unwrap();
+    }
+
+    #[test]
+    fn test_plugin_state_cache_resets_on_new_target() {
+        let mut cache = PluginStateCache::default();
+        let saved = SavedPluginState {
+            generation: 3,
+            hash: plugin_state_hash(b"state"),
+            state_file: "plugins/1.vst3state".to_string(),
+        };
+
+        cache.target(Path::new("/a.audio"), false);
+        cache.insert(1, saved.clone());
+        cache.insert(2, saved.clone());
+
+        cache.target(Path::new("/a.audio"), false);
+        assert_eq!(cache.get(1), Some(&saved));
+
+        cache.retain(&HashSet::from([1]));
+        assert!(cache.get(2).is_none());
+
+        cache.target(Path::new("/b.audio"), false);
+        assert!(cache.get(1).is_none());
+    }
 }
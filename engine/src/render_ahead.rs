@@ -0,0 +1,613 @@
+// Anticipative (render-ahead) processing
+//
+// Tracks nobody is playing live - not armed, not monitored - don't have to
+// be processed at the device buffer size. A background thread renders
+// them up to a configurable lead ahead of the playhead in large blocks;
+// the audio callback only copies finished audio out of a per-track ring.
+// Armed and monitored tracks stay on the low-latency path, so the device
+// buffer can be small for tracking while heavy chains on finished tracks
+// run in big, efficient blocks.
+//
+// Each track has two single-producer/single-consumer rings of blocks: the
+// render thread fills blocks and pushes them to the callback, and the
+// callback pushes spent blocks back for reuse. Neither side locks or
+// allocates. Every block carries the timeline frame it starts at and the
+// stream generation it was rendered for; whenever the callback finds the
+// stream doesn't continue where it's reading (play start, seek, the render
+// thread falling behind), it bumps the generation and asks for a restart
+// at the frame it needs.
+//
+// The set of tracks rendered ahead is an immutable `AheadTable`, published
+// RCU style by the render thread (as `fx_chains` publishes chains). The
+// callback swaps to a new table with an atomic load and an uncontended
+// try_lock and acknowledges it; the render thread only renders a new track
+// once the callback has switched to the table containing it (before that
+// the callback still plays it live), and keeps every table the callback
+// may hold alive, so rings are built and freed on the render thread only.
+//
+// A track's plugins belong to whoever the callback's table says: the render
+// thread for tracks listed in it, the callback for the rest, whether the
+// transport is moving or not. Tracks only join the table while `play()`
+// primes it, so their rings hold the playhead before the callback reads
+// them, and the table is emptied when the transport stops.
+
+use crate::track::TrackId;
+use ringbuf::{traits::*, HeapCons, HeapProd, HeapRb};
+use std::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+
+/// Frames per render-ahead block. Plugins still see their usual block
+/// size; the host splits larger blocks into sub-blocks
+pub const RENDER_AHEAD_BLOCK_FRAMES: usize = 2048;
+
+/// Default lead when render-ahead is turned on
+pub const DEFAULT_RENDER_AHEAD_MS: u32 = 200;
+
+/// Longest lead accepted
+pub const MAX_RENDER_AHEAD_MS: u32 = 2000;
+
+/// A rendered stretch of one track (pre-fader, post-FX)
+pub struct AheadBlock {
+    generation: u64,
+    start_frame: u64,
+    frames: usize,
+    pub left: Vec<f32>,
+    pub right: Vec<f32>,
+}
+
+impl AheadBlock {
+    /// Timeline frame of the block's first sample
+    pub fn start_frame(&self) -> u64 {
+        self.start_frame
+    }
+
+    fn end_frame(&self) -> u64 {
+        self.start_frame + self.frames as u64
+    }
+}
+
+#[derive(Default)]
+struct RingShared {
+    /// Bumped by the reader to restart the stream at `resync_frame`
+    resync_generation: AtomicU64,
+    resync_frame: AtomicU64,
+    /// Frame the writer will render next, for the reader's late check
+    write_frame: AtomicU64,
+    underruns: AtomicU32,
+}
+
+/// Render-thread side of a track's ring
+pub struct AheadWriter {
+    filled: HeapProd<AheadBlock>,
+    free: HeapCons<AheadBlock>,
+    generation: u64,
+    next_frame: u64,
+    lead_frames: u64,
+    shared: Arc<RingShared>,
+}
+
+/// Audio-callback side of a track's ring
+pub struct AheadReader {
+    filled: HeapCons<AheadBlock>,
+    free: HeapProd<AheadBlock>,
+    current: Option<AheadBlock>,
+    generation: u64,
+    /// Frame the next read should ask for if playback is continuous
+    expected: Option<u64>,
+    /// Frame the last restart asked for; silence before it isn't an underrun
+    resync_target: u64,
+    shared: Arc<RingShared>,
+}
+
+/// Create a ring holding enough blocks for `lead_frames` plus the blocks
+/// being read and written
+pub fn ahead_ring(lead_frames: usize) -> (AheadWriter, AheadReader) {
+    let block_count = lead_frames.div_ceil(RENDER_AHEAD_BLOCK_FRAMES) + 2;
+    let (filled_prod, filled_cons) = HeapRb::<AheadBlock>::new(block_count).split();
+    let (mut free_prod, free_cons) = HeapRb::<AheadBlock>::new(block_count).split();
+    for _ in 0..block_count {
+        let _ = free_prod.try_push(AheadBlock {
+            generation: 0,
+            start_frame: 0,
+            frames: 0,
+            left: vec![0.0; RENDER_AHEAD_BLOCK_FRAMES],
+            right: vec![0.0; RENDER_AHEAD_BLOCK_FRAMES],
+        });
+    }
+
+    let shared = Arc::new(RingShared::default());
+    let writer = AheadWriter {
+        filled: filled_prod,
+        free: free_cons,
+        generation: 0,
+        next_frame: 0,
+        lead_frames: lead_frames as u64,
+        shared: shared.clone(),
+    };
+    let reader = AheadReader {
+        filled: filled_cons,
+        free: free_prod,
+        current: None,
+        generation: 0,
+        expected: None,
+        resync_target: 0,
+        shared,
+    };
+    (writer, reader)
+}
+
+impl AheadWriter {
+    /// True once the stream the reader asked for has been rendered past
+    /// `frame`
+    pub fn has_frame(&mut self, frame: u64) -> bool {
+        self.poll_resync();
+        let start = self.shared.resync_frame.load(Ordering::Relaxed);
+        self.generation != 0 && start <= frame && frame < self.next_frame
+    }
+
+    /// Pick up a restart requested by the reader
+    fn poll_resync(&mut self) {
+        let generation = self.shared.resync_generation.load(Ordering::Acquire);
+        if generation != self.generation {
+            self.generation = generation;
+            self.next_frame = self.shared.resync_frame.load(Ordering::Relaxed);
+            self.shared.write_frame.store(self.next_frame, Ordering::Relaxed);
+        }
+    }
+
+    /// True if the reader has asked for a stream, a block is free and the
+    /// lead ahead of `playhead` isn't full yet
+    pub fn wants_block(&mut self, playhead: u64) -> bool {
+        self.poll_resync();
+        let horizon = playhead.max(self.shared.resync_frame.load(Ordering::Relaxed)) + self.lead_frames;
+        self.generation != 0 && self.next_frame < horizon && !self.free.is_empty()
+    }
+
+    /// Take a zeroed block to render next (see `wants_block`). Render
+    /// audio for frames `start_frame()..` into it and `commit` it
+    pub fn begin_block(&mut self, playhead: u64) -> Option<AheadBlock> {
+        if !self.wants_block(playhead) {
+            return None;
+        }
+        let mut block = self.free.try_pop()?;
+        block.generation = self.generation;
+        block.start_frame = self.next_frame;
+        block.frames = RENDER_AHEAD_BLOCK_FRAMES;
+        block.left.fill(0.0);
+        block.right.fill(0.0);
+        Some(block)
+    }
+
+    /// Hand a rendered block to the reader
+    pub fn commit(&mut self, block: AheadBlock) {
+        if block.generation == self.generation && block.start_frame == self.next_frame {
+            self.next_frame = block.end_frame();
+            self.shared.write_frame.store(self.next_frame, Ordering::Relaxed);
+        }
+        // Capacity equals the block count, so this can't fail
+        let _ = self.filled.try_push(block);
+    }
+}
+
+impl AheadReader {
+    /// Restart the stream at `frame` (seek or play start). The next read
+    /// at `frame` counts as continuous, so the render thread gets a
+    /// head start if this is called before playback reaches it
+    pub fn restart_at(&mut self, frame: u64) {
+        if let Some(block) = self.current.take() {
+            self.recycle(block);
+        }
+        self.generation += 1;
+        self.expected = Some(frame);
+        self.resync_target = frame;
+        self.shared.resync_frame.store(frame, Ordering::Relaxed);
+        self.shared.resync_generation.store(self.generation, Ordering::Release);
+    }
+
+    /// Copy frames `frame..frame + left.len()` into left/right. Frames
+    /// not rendered yet are zero-filled; returns false if the ring ran dry.
+    /// Audio thread: no locks, no allocation
+    pub fn read(&mut self, frame: u64, left: &mut [f32], right: &mut [f32]) -> bool {
+        let frames = left.len().min(right.len());
+        self.read_into(frame, frames, Some((left, right)))
+    }
+
+    /// Advance past frames without copying them (muted track), so the
+    /// stream is still aligned when the track comes back
+    pub fn skip(&mut self, frame: u64, frames: usize) -> bool {
+        self.read_into(frame, frames, None)
+    }
+
+    /// Blocks ready to be read (not counting the one being read)
+    pub fn buffered_blocks(&self) -> usize {
+        self.filled.occupied_len()
+    }
+
+    pub fn underruns(&self) -> u32 {
+        self.shared.underruns.load(Ordering::Relaxed)
+    }
+
+    fn recycle(&mut self, block: AheadBlock) {
+        // Capacity equals the block count, so this can't fail (and drop
+        // the block on the audio thread)
+        let _ = self.free.try_push(block);
+    }
+
+    fn read_into(&mut self, frame: u64, frames: usize, mut out: Option<(&mut [f32], &mut [f32])>) -> bool {
+        // Restart the stream a little ahead if this isn't where it left off
+        if self.expected != Some(frame) {
+            self.restart_at(frame + frames as u64 + RENDER_AHEAD_BLOCK_FRAMES as u64 / 4);
+        }
+        self.expected = Some(frame + frames as u64);
+
+        let mut done = 0;
+        while done < frames {
+            let position = frame + done as u64;
+            let block = match self.current.take() {
+                Some(block) => block,
+                None => match self.filled.try_pop() {
+                    Some(block) => block,
+                    None => break,
+                },
+            };
+
+            // Stale: another generation, or entirely behind us
+            if block.generation != self.generation || block.end_frame() <= position {
+                self.recycle(block);
+                continue;
+            }
+
+            // Ahead of us: silence until it starts
+            if block.start_frame > position {
+                let gap = ((block.start_frame - position) as usize).min(frames - done);
+                if let Some((left, right)) = out.as_mut() {
+                    left[done..done + gap].fill(0.0);
+                    right[done..done + gap].fill(0.0);
+                }
+                done += gap;
+                self.current = Some(block);
+                continue;
+            }
+
+            let offset = (position - block.start_frame) as usize;
+            let count = (block.frames - offset).min(frames - done);
+            if let Some((left, right)) = out.as_mut() {
+                left[done..done + count].copy_from_slice(&block.left[offset..offset + count]);
+                right[done..done + count].copy_from_slice(&block.right[offset..offset + count]);
+            }
+            done += count;
+
+            if offset + count < block.frames {
+                self.current = Some(block);
+            } else {
+                self.recycle(block);
+            }
+        }
+
+        if done == frames {
+            return true;
+        }
+
+        if let Some((left, right)) = out.as_mut() {
+            left[done..frames].fill(0.0);
+            right[done..frames].fill(0.0);
+        }
+        // Silence while a restart is still being rendered is expected
+        let position = frame + done as u64;
+        if position >= self.resync_target {
+            self.shared.underruns.fetch_add(1, Ordering::Relaxed);
+            // The writer fell behind the playhead: nothing it renders now
+            // will be in time, so jump it ahead
+            if self.shared.write_frame.load(Ordering::Relaxed) <= position {
+                self.restart_at(frame + frames as u64 + RENDER_AHEAD_BLOCK_FRAMES as u64 / 4);
+                self.expected = Some(frame + frames as u64);
+            }
+        }
+        false
+    }
+}
+
+/// One track rendered ahead. The callback is the reader's only user
+/// during playback; the control thread locks it to restart the stream,
+/// and the callback skips the block if it finds it locked
+pub struct AheadTrack {
+    pub reader: Mutex<AheadReader>,
+    shared: Arc<RingShared>,
+}
+
+impl AheadTrack {
+    pub fn new(reader: AheadReader) -> Self {
+        let shared = reader.shared.clone();
+        Self { reader: Mutex::new(reader), shared }
+    }
+
+    pub fn underruns(&self) -> u32 {
+        self.shared.underruns.load(Ordering::Relaxed)
+    }
+}
+
+/// The tracks rendered ahead at one point in time. Tracks listed here are
+/// read by the callback instead of being processed live
+#[derive(Default)]
+pub struct AheadTable {
+    tracks: Vec<(TrackId, Arc<AheadTrack>)>,
+}
+
+impl AheadTable {
+    pub fn new(tracks: Vec<(TrackId, Arc<AheadTrack>)>) -> Self {
+        Self { tracks }
+    }
+
+    pub fn tracks(&self) -> &[(TrackId, Arc<AheadTrack>)] {
+        &self.tracks
+    }
+
+    pub fn contains(&self, track_id: TrackId) -> bool {
+        self.tracks.iter().any(|(id, _)| *id == track_id)
+    }
+}
+
+/// Render-ahead settings and the published table, shared by the control
+/// thread, the render-ahead thread and the audio callback
+#[derive(Default)]
+pub struct RenderAheadState {
+    pub enabled: AtomicBool,
+    pub lead_ms: AtomicU32,
+    /// Bumped whenever the settings change so the render thread rebuilds
+    pub config_generation: AtomicU64,
+    /// Set while `play()` lets the render thread fill rings before the
+    /// transport starts moving
+    pub priming: AtomicBool,
+    /// Set by the render thread once, while priming, the callback holds
+    /// the table and every ring in it covers the playhead
+    pub primed: AtomicBool,
+    pub shutdown: AtomicBool,
+    /// Latest table and its generation (only changed under the lock)
+    table: Mutex<Arc<AheadTable>>,
+    table_generation: AtomicU64,
+    /// Generation of the table the callback holds
+    table_acknowledged: AtomicU64,
+}
+
+impl RenderAheadState {
+    pub fn new() -> Self {
+        Self {
+            lead_ms: AtomicU32::new(DEFAULT_RENDER_AHEAD_MS),
+            ..Default::default()
+        }
+    }
+
+    pub fn lead_frames(&self, sample_rate: u32) -> usize {
+        let lead_ms = self.lead_ms.load(Ordering::Relaxed).min(MAX_RENDER_AHEAD_MS);
+        (lead_ms as u64 * sample_rate as u64 / 1000) as usize
+    }
+
+    fn latest_table(&self) -> Arc<AheadTable> {
+        self.table.lock().map(|table| table.clone()).unwrap_or_default()
+    }
+
+    /// Restart every track's stream at `frame` (control thread)
+    pub fn restart_all(&self, frame: u64) {
+        for (_, track) in self.latest_table().tracks() {
+            if let Ok(mut reader) = track.reader.lock() {
+                reader.restart_at(frame);
+            }
+        }
+    }
+
+    /// (tracks rendered ahead, total underruns)
+    pub fn stats(&self) -> (usize, u32) {
+        let table = self.latest_table();
+        (table.tracks().len(), table.tracks().iter().map(|(_, track)| track.underruns()).sum())
+    }
+
+    /// The callback's view of the table. One per output stream
+    pub fn table_reader(self: &Arc<Self>) -> AheadTableReader {
+        let (current, generation) = {
+            let table = self.table.lock().expect("mutex poisoned");
+            (table.clone(), self.table_generation.load(Ordering::Acquire))
+        };
+        self.table_acknowledged.store(generation, Ordering::Release);
+        AheadTableReader { state: self.clone(), current, generation }
+    }
+}
+
+/// Publishes tables for the render thread and keeps every table the
+/// callback may still hold, so the callback never drops the last reference
+pub struct AheadTablePublisher {
+    state: Arc<RenderAheadState>,
+    /// Published tables not yet known to be released by the callback
+    history: Vec<(u64, Arc<AheadTable>)>,
+}
+
+impl AheadTablePublisher {
+    pub fn new(state: Arc<RenderAheadState>) -> Self {
+        let history = {
+            let table = state.table.lock().expect("mutex poisoned");
+            vec![(state.table_generation.load(Ordering::Acquire), table.clone())]
+        };
+        Self { state, history }
+    }
+
+    /// Make `table` the one the callback reads from its next block.
+    /// Returns its generation
+    pub fn publish(&mut self, table: AheadTable) -> u64 {
+        let table = Arc::new(table);
+        let generation = {
+            let mut latest = self.state.table.lock().expect("mutex poisoned");
+            *latest = table.clone();
+            self.state.table_generation.fetch_add(1, Ordering::AcqRel) + 1
+        };
+        self.history.push((generation, table));
+        self.reclaim();
+        generation
+    }
+
+    /// Generation of the table the callback has switched to
+    pub fn acknowledged(&self) -> u64 {
+        self.state.table_acknowledged.load(Ordering::Acquire)
+    }
+
+    /// Free tables older than the one the callback holds
+    pub fn reclaim(&mut self) {
+        let acknowledged = self.acknowledged();
+        self.history.retain(|(generation, _)| *generation >= acknowledged);
+    }
+}
+
+/// The audio callback's side of the table
+pub struct AheadTableReader {
+    state: Arc<RenderAheadState>,
+    current: Arc<AheadTable>,
+    generation: u64,
+}
+
+impl AheadTableReader {
+    /// Tracks rendered ahead for this block: the newest table, or the one
+    /// already held while the publisher is mid-swap. Never blocks,
+    /// allocates or frees
+    pub fn current(&mut self) -> &AheadTable {
+        if self.state.table_generation.load(Ordering::Acquire) != self.generation {
+            if let Ok(latest) = self.state.table.try_lock() {
+                let generation = self.state.table_generation.load(Ordering::Acquire);
+                // The publisher still holds the previous table
+                self.current = latest.clone();
+                drop(latest);
+                self.generation = generation;
+                self.state.table_acknowledged.store(generation, Ordering::Release);
+            }
+        }
+        &self.current
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Render blocks whose samples are their own timeline frame numbers
+    fn fill(writer: &mut AheadWriter, playhead: u64) -> usize {
+        let mut count = 0;
+        while let Some(mut block) = writer.begin_block(playhead) {
+            for i in 0..block.frames {
+                block.left[i] = (block.start_frame() + i as u64) as f32;
+                block.right[i] = -block.left[i];
+            }
+            writer.commit(block);
+            count += 1;
+        }
+        count
+    }
+
+    #[test]
+    fn test_continuous_reads_across_blocks() {
+        let (mut writer, mut reader) = ahead_ring(RENDER_AHEAD_BLOCK_FRAMES * 2);
+        assert_eq!(fill(&mut writer, 0), 0, "nothing renders before the reader asks");
+
+        reader.restart_at(100);
+        assert_eq!(fill(&mut writer, 100), 2);
+
+        let mut left = vec![0.0; 1500];
+        let mut right = vec![0.0; 1500];
+        for read in 0..3u64 {
+            let start = 100 + read * 1500;
+            assert!(reader.read(start, &mut left, &mut right));
+            assert_eq!(left[0], start as f32);
+            assert_eq!(left[1499], (start + 1499) as f32);
+            assert_eq!(right[7], -((start + 7) as f32));
+            fill(&mut writer, start + 1500);
+        }
+        assert_eq!(reader.underruns(), 0);
+    }
+
+    #[test]
+    fn test_writer_has_frame_once_rendered() {
+        let (mut writer, mut reader) = ahead_ring(RENDER_AHEAD_BLOCK_FRAMES);
+        assert!(!writer.has_frame(0), "no stream before the reader asks");
+
+        reader.restart_at(1000);
+        assert!(!writer.has_frame(1000));
+        fill(&mut writer, 1000);
+        assert!(writer.has_frame(1000));
+        assert!(!writer.has_frame(999), "before the restart point");
+
+        // A restart elsewhere needs rendering again
+        reader.restart_at(50_000);
+        assert!(!writer.has_frame(50_000));
+        assert!(!writer.has_frame(1000));
+    }
+
+    #[test]
+    fn test_publisher_keeps_tables_until_callback_moves_on() {
+        let state = Arc::new(RenderAheadState::new());
+        let mut publisher = AheadTablePublisher::new(state.clone());
+        let mut callback = state.table_reader();
+
+        let (_writer, reader) = ahead_ring(RENDER_AHEAD_BLOCK_FRAMES);
+        let track = Arc::new(AheadTrack::new(reader));
+        let generation = publisher.publish(AheadTable::new(vec![(7, track.clone())]));
+        assert!(publisher.acknowledged() < generation);
+        assert_eq!(state.stats().0, 1);
+
+        assert!(callback.current().contains(7));
+        assert_eq!(publisher.acknowledged(), generation);
+
+        // Dropping the track: the callback's table keeps it alive and the
+        // publisher keeps that table until the callback switches
+        publisher.publish(AheadTable::default());
+        assert_eq!(Arc::strong_count(&track), 2);
+        assert!(!callback.current().contains(7));
+        publisher.reclaim();
+        assert_eq!(Arc::strong_count(&track), 1);
+    }
+
+    #[test]
+    fn test_seek_restarts_stream() {
+        let (mut writer, mut reader) = ahead_ring(RENDER_AHEAD_BLOCK_FRAMES);
+        reader.restart_at(0);
+        fill(&mut writer, 0);
+
+        let mut left = vec![0.0; 256];
+        let mut right = vec![0.0; 256];
+        assert!(reader.read(0, &mut left, &mut right));
+
+        // Jump: the first read is silent and restarts the writer just ahead
+        assert!(!reader.read(48_000, &mut left, &mut right));
+        assert!(left.iter().all(|s| *s == 0.0));
+        assert_eq!(reader.underruns(), 0, "warm-up silence isn't an underrun");
+
+        // The restart point is one read plus a quarter block ahead;
+        // reads before it are silent
+        let restart = 48_256 + RENDER_AHEAD_BLOCK_FRAMES as u64 / 4;
+        fill(&mut writer, 48_256);
+        let mut position = 48_256;
+        while position < restart {
+            assert!(reader.read(position, &mut left, &mut right));
+            assert!(left.iter().all(|s| *s == 0.0));
+            position += 256;
+        }
+        assert!(reader.read(restart, &mut left, &mut right));
+        assert_eq!(left[0], restart as f32);
+        assert_eq!(reader.underruns(), 0);
+    }
+
+    #[test]
+    fn test_writer_falling_behind_counts_underrun() {
+        let (mut writer, mut reader) = ahead_ring(RENDER_AHEAD_BLOCK_FRAMES);
+        reader.restart_at(0);
+        fill(&mut writer, 0);
+
+        let mut left = vec![0.0; RENDER_AHEAD_BLOCK_FRAMES];
+        let mut right = vec![0.0; RENDER_AHEAD_BLOCK_FRAMES];
+        let mut position = 0;
+        for _ in 0..3 {
+            reader.read(position, &mut left, &mut right);
+            position += RENDER_AHEAD_BLOCK_FRAMES as u64;
+        }
+        assert!(reader.underruns() > 0);
+
+        // Skipping keeps a muted track aligned without copying
+        fill(&mut writer, position);
+        assert!(reader.skip(position, 16));
+    }
+}
@@ -415,6 +415,12 @@ impl TrackSynthManager {
         }
     }
 
+    /// Every synth at once, keyed by track, so each track's synth can be
+    /// handed to a different worker in the same callback
+    pub fn synths_mut(&mut self) -> impl Iterator<Item = (u64, &mut Synth)> {
+        self.synths.iter_mut().map(|(track_id, synth)| (*track_id, synth))
+    }
+
     pub fn has_synth(&self, track_id: u64) -> bool {
         self.synths.contains_key(&track_id)
     }
@@ -478,6 +484,20 @@ impl TrackSynthManager {
         }
     }
 
+    /// A manager holding only a copy of one track's synth settings (with
+    /// fresh voices), for rendering that track on another thread
+    pub fn copy_synth_to_new_manager(&self, track_id: u64) -> TrackSynthManager {
+        let mut manager = TrackSynthManager::new(self.sample_rate);
+        if let Some(source) = self.synths.get(&track_id) {
+            let mut new_synth = Synth::new(self.sample_rate);
+            new_synth.osc_type = source.osc_type;
+            new_synth.filter_cutoff = source.filter_cutoff;
+            new_synth.envelope = source.envelope;
+            manager.synths.insert(track_id, new_synth);
+        }
+        manager
+    }
+
     /// Get synth parameters for serialization
     pub fn get_synth_parameters(&self, track_id: u64) -> Option<SynthData> {
         self.synths.get(&track_id).map(|synth| synth.get_parameters())
@@ -9,7 +9,8 @@
 use std::sync::Arc;
 use crate::audio_file::AudioClip;
 use crate::midi::MidiClip;
-use crate::effects::EffectId;
+use crate::effects::{EffectId, ParkedEffect};
+use crate::project::SynthData;
 
 /// Unique identifier for tracks
 pub type TrackId = u64;
@@ -67,6 +68,19 @@ pub struct Send {
     pub pre_fader: bool,
 }
 
+/// A frozen track: its clips, synth and FX chain rendered to one audio
+/// clip, with the plugins unloaded until the track is unfrozen
+pub struct FrozenTrack {
+    /// The render (pre-fader), placed at the start of the timeline
+    pub clip: TimelineClip,
+    /// Cached copy of the render on disk
+    pub cache_path: std::path::PathBuf,
+    /// The FX chain that was unloaded, in order: (effect ID, bypassed, effect)
+    pub fx_chain: Vec<(EffectId, bool, ParkedEffect)>,
+    /// Built-in synth settings, if the track had one
+    pub synth: Option<SynthData>,
+}
+
 /// A track in the DAW
 pub struct Track {
     /// Unique ID
@@ -109,6 +123,10 @@ pub struct Track {
     /// Input monitoring enabled
     pub input_monitoring: bool,
 
+    // --- Freeze ---
+    /// Set while the track is frozen (see `AudioGraph::freeze_track`)
+    pub frozen: Option<Box<FrozenTrack>>,
+
     // --- Metering ---
     /// Peak level for left channel (for meters)
     pub peak_left: f32,
@@ -137,6 +155,7 @@ impl Track {
             fx_chain: Vec::new(),
             armed,
             input_monitoring: false,
+            frozen: None,
             peak_left: 0.0,
             peak_right: 0.0,
         }
@@ -171,6 +190,23 @@ impl Track {
         (left_gain, right_gain)
     }
 
+    /// Audio clips to play: just the render while the track is frozen
+    pub fn playback_audio_clips(&self) -> &[TimelineClip] {
+        match &self.frozen {
+            Some(frozen) => std::slice::from_ref(&frozen.clip),
+            None => &self.audio_clips,
+        }
+    }
+
+    /// MIDI clips to play (none while frozen: they're in the render)
+    pub fn playback_midi_clips(&self) -> &[TimelineMidiClip] {
+        if self.frozen.is_some() {
+            &[]
+        } else {
+            &self.midi_clips
+        }
+    }
+
     /// Update peak meters (called from audio thread)
     pub fn update_peaks(&mut self, left: f32, right: f32) {
         self.peak_left = left.abs();
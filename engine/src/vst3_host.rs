@@ -86,11 +86,203 @@ impl VST3ParameterInfo {
                 .unwrap_or("")
         }
     }
+
+    pub fn short_title_str(&self) -> &str {
+        unsafe {
+            CStr::from_ptr(self.short_title.as_ptr())
+                .to_str()
+                .unwrap_or("")
+        }
+    }
+}
+
+/// Audio bus info (matches C header)
+#[repr(C)]
+#[derive(Debug, Clone)]
+pub struct VST3BusInfo {
+    pub name: [c_char; 128],
+    pub channel_count: c_int,
+    pub is_aux: bool,
+    pub is_active: bool,
+}
+
+impl VST3BusInfo {
+    pub fn name_str(&self) -> &str {
+        unsafe {
+            CStr::from_ptr(self.name.as_ptr())
+                .to_str()
+                .unwrap_or("")
+        }
+    }
+}
+
+/// Channel pointers for one bus, passed to `vst3_process_buses`
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct VST3AudioBus {
+    pub channels: *mut *mut c_float,
+    pub num_channels: c_int,
+}
+
+/// Timing of a plugin's process() calls
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct VST3PluginStats {
+    pub process_calls: u64,
+    /// Realtime calls that took longer than the audio they produced
+    pub overruns: u64,
+    pub mean_us: c_double,
+    pub p99_us: c_double,
+    pub max_us: c_double,
+    pub last_us: c_double,
+    /// Time in process() / duration of the audio processed (1.0 = 100%)
+    pub load: c_double,
+}
+
+/// Musical position of a block at its first sample (matches C header)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct VST3Transport {
+    pub sample_rate: c_double,
+    /// Playhead
+    pub project_time_samples: i64,
+    /// Keeps running while stopped and across loops
+    pub continuous_time_samples: i64,
+    pub tempo: c_double,
+    pub time_sig_numerator: c_int,
+    pub time_sig_denominator: c_int,
+    /// Loop range in quarter notes
+    pub cycle_start_ppq: c_double,
+    pub cycle_end_ppq: c_double,
+    pub playing: bool,
+    pub recording: bool,
+    pub cycle_active: bool,
+}
+
+/// Plugin state chunk owned by the C++ host, freed on drop.
+/// Derefs to the chunk bytes (the format `set_state` takes).
+pub struct VST3StateSnapshot {
+    handle: *mut c_void,
+    data: *const u8,
+    size: usize,
+}
+
+// The buffer is immutable and not tied to the plugin instance
+unsafe impl Send for VST3StateSnapshot {}
+unsafe impl Sync for VST3StateSnapshot {}
+
+impl std::ops::Deref for VST3StateSnapshot {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        if self.size == 0 {
+            return &[];
+        }
+        unsafe { std::slice::from_raw_parts(self.data, self.size) }
+    }
+}
+
+impl Drop for VST3StateSnapshot {
+    fn drop(&mut self) {
+        unsafe { vst3_release_state(self.handle) }
+    }
+}
+
+/// Error code from the C++ host (`VST3Result`)
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct VST3ErrorCode(pub c_int);
+
+impl VST3ErrorCode {
+    pub const OK: Self = Self(0);
+    pub const INVALID_HANDLE: Self = Self(1);
+    pub const INVALID_ARGUMENT: Self = Self(2);
+    pub const NOT_INITIALIZED: Self = Self(3);
+    pub const NOT_ACTIVE: Self = Self(4);
+    pub const WRONG_STATE: Self = Self(5);
+    pub const NOT_SUPPORTED: Self = Self(6);
+    pub const LOAD_FAILED: Self = Self(7);
+    pub const PLUGIN_REFUSED: Self = Self(8);
+    pub const PROCESS_FAILED: Self = Self(9);
+    pub const QUEUE_FULL: Self = Self(10);
+    pub const EDITOR: Self = Self(11);
+    pub const BRIDGE: Self = Self(12);
+
+    /// Code of the calling thread's last failed host call. Allocation-free,
+    /// so it can be used on the audio thread
+    pub fn last() -> Self {
+        unsafe { Self(vst3_get_last_error_code()) }
+    }
+
+    /// Static description of the code
+    pub fn description(self) -> &'static str {
+        unsafe {
+            let ptr = vst3_result_string(self.0);
+            if ptr.is_null() {
+                "unknown error"
+            } else {
+                CStr::from_ptr(ptr).to_str().unwrap_or("unknown error")
+            }
+        }
+    }
+}
+
+/// Parameter change reported by a plugin's processor
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct VST3ParameterChange {
+    pub id: u32,
+    pub sample_offset: c_int,
+    pub value: c_double,
+}
+
+/// `VST3EditorChange::flags`: `value` holds the latest value
+pub const VST3_EDIT_VALUE_CHANGED: i32 = 1;
+/// `VST3EditorChange::flags`: gesture started (touch)
+pub const VST3_EDIT_BEGAN: i32 = 2;
+/// `VST3EditorChange::flags`: gesture finished (release)
+pub const VST3_EDIT_ENDED: i32 = 4;
+
+/// Parameter edited in the plugin's own editor (matches C header)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct VST3EditorChange {
+    pub id: u32,
+    pub flags: c_int,
+    pub value: c_double,
+}
+
+/// Record ids from a plugin catalog query (matches C header)
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct VST3CatalogSpan {
+    pub ids: *const u32,
+    pub count: c_int,
+}
+
+/// Plugin catalog record; the strings live in the catalog (matches C header)
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct VST3CatalogEntry {
+    pub name: *const c_char,
+    pub vendor: *const c_char,
+    pub version: *const c_char,
+    pub category: *const c_char,
+    pub file_path: *const c_char,
+    pub is_instrument: bool,
+    pub is_effect: bool,
 }
 
+/// Catalog index to query (matches `VST3CatalogIndex` in the C header)
+pub const VST3_CATALOG_VENDOR: c_int = 0;
+pub const VST3_CATALOG_SUBCATEGORY: c_int = 1;
+pub const VST3_CATALOG_KIND: c_int = 2;
+
 /// Scan callback type
 pub type VST3ScanCallback = extern "C" fn(*const VST3PluginInfo, *mut c_void);
 
+/// Async load completion callback type
+pub type VST3LoadCallback = extern "C" fn(*mut VST3PluginHandle, *const c_char, *mut c_void);
+
 // External C functions from the C++ library
 extern "C" {
     pub fn vst3_host_init() -> bool;
@@ -107,9 +299,65 @@ extern "C" {
         user_data: *mut c_void,
     ) -> c_int;
 
+    pub fn vst3_set_scan_cache_path(path: *const c_char);
+
+    pub fn vst3_set_scan_helper_path(path: *const c_char);
+
+    pub fn vst3_clear_scan_cache();
+
+    pub fn vst3_catalog_acquire() -> *mut c_void;
+    pub fn vst3_catalog_release(catalog: *mut c_void);
+    pub fn vst3_catalog_size(catalog: *mut c_void) -> c_int;
+    pub fn vst3_catalog_get_entry(catalog: *mut c_void, id: u32, entry: *mut VST3CatalogEntry) -> bool;
+    pub fn vst3_catalog_all(catalog: *mut c_void) -> VST3CatalogSpan;
+    pub fn vst3_catalog_find(catalog: *mut c_void, index: c_int, key: *const c_char) -> VST3CatalogSpan;
+    pub fn vst3_catalog_name_prefix(catalog: *mut c_void, prefix: *const c_char) -> VST3CatalogSpan;
+    pub fn vst3_catalog_group_count(catalog: *mut c_void, index: c_int) -> c_int;
+    pub fn vst3_catalog_get_group(
+        catalog: *mut c_void,
+        index: c_int,
+        group: c_int,
+        label: *mut *const c_char,
+        members: *mut VST3CatalogSpan,
+    ) -> bool;
+
     pub fn vst3_load_plugin(file_path: *const c_char) -> *mut VST3PluginHandle;
+
+    pub fn vst3_load_plugin_async(
+        file_path: *const c_char,
+        sample_rate: c_double,
+        max_block_size: c_int,
+        callback: VST3LoadCallback,
+        user_data: *mut c_void,
+    ) -> bool;
+
+    pub fn vst3_pool_configure(
+        instances_per_class: c_int,
+        max_classes: c_int,
+        sample_rate: c_double,
+        max_block_size: c_int,
+    ) -> bool;
+
+    pub fn vst3_pool_pin(file_path: *const c_char, pinned: bool) -> bool;
+
+    pub fn vst3_pool_acquire(
+        file_path: *const c_char,
+        sample_rate: c_double,
+        max_block_size: c_int,
+    ) -> *mut VST3PluginHandle;
+
+    pub fn vst3_pool_release(handle: *mut VST3PluginHandle);
+
+    pub fn vst3_load_plugin_class(
+        file_path: *const c_char,
+        class_name: *const c_char,
+    ) -> *mut VST3PluginHandle;
     pub fn vst3_unload_plugin(handle: *mut VST3PluginHandle);
 
+    pub fn vst3_set_bridge_helper_path(path: *const c_char);
+    pub fn vst3_set_plugin_bridged(file_path: *const c_char, bridged: bool) -> bool;
+    pub fn vst3_is_plugin_bridged(handle: *mut VST3PluginHandle) -> bool;
+
     pub fn vst3_get_plugin_info(
         handle: *mut VST3PluginHandle,
         info: *mut VST3PluginInfo,
@@ -123,6 +371,17 @@ extern "C" {
 
     pub fn vst3_activate_plugin(handle: *mut VST3PluginHandle) -> bool;
     pub fn vst3_deactivate_plugin(handle: *mut VST3PluginHandle) -> bool;
+    pub fn vst3_reset_plugin(handle: *mut VST3PluginHandle) -> bool;
+    pub fn vst3_reconfigure(handle: *mut VST3PluginHandle, sample_rate: c_double, max_block_size: c_int) -> bool;
+
+    pub fn vst3_process_block(
+        handle: *mut VST3PluginHandle,
+        input_left: *const c_float,
+        input_right: *const c_float,
+        output_left: *mut c_float,
+        output_right: *mut c_float,
+        num_frames: c_int,
+    ) -> bool;
 
     pub fn vst3_process_audio(
         handle: *mut VST3PluginHandle,
@@ -133,6 +392,85 @@ extern "C" {
         num_frames: c_int,
     ) -> bool;
 
+    pub fn vst3_process_interleaved(
+        handle: *mut VST3PluginHandle,
+        input: *const c_float,
+        output: *mut c_float,
+        num_frames: c_int,
+    ) -> bool;
+
+    pub fn vst3_set_auto_sleep(handle: *mut VST3PluginHandle, enabled: bool) -> bool;
+
+    pub fn vst3_is_output_silent(handle: *mut VST3PluginHandle) -> bool;
+
+    pub fn vst3_get_plugin_stats(handle: *mut VST3PluginHandle, stats: *mut VST3PluginStats) -> bool;
+
+    pub fn vst3_reset_plugin_stats(handle: *mut VST3PluginHandle);
+
+    pub fn vst3_get_latency_samples(handle: *mut VST3PluginHandle) -> c_int;
+
+    pub fn vst3_get_latency_change_count() -> u32;
+
+    pub fn vst3_get_plugin_latency_change_count(handle: *mut VST3PluginHandle) -> u32;
+
+    pub fn vst3_prepare_realtime_thread() -> bool;
+
+    pub fn vst3_release_realtime_thread();
+
+    pub fn vst3_transport_create() -> *mut c_void;
+    pub fn vst3_transport_destroy(transport: *mut c_void);
+    pub fn vst3_transport_update(transport: *mut c_void, state: *const VST3Transport);
+    pub fn vst3_transport_bind(transport: *mut c_void) -> *mut c_void;
+
+    pub fn vst3_set_offline_mode(handle: *mut VST3PluginHandle, offline: bool, max_block_size: c_int) -> bool;
+
+    pub fn vst3_is_offline_mode(handle: *mut VST3PluginHandle) -> bool;
+
+    pub fn vst3_set_double_precision(handle: *mut VST3PluginHandle, enabled: bool) -> bool;
+
+    pub fn vst3_get_sample_size(handle: *mut VST3PluginHandle) -> c_int;
+
+    pub fn vst3_process_block_double(
+        handle: *mut VST3PluginHandle,
+        input_left: *const c_double,
+        input_right: *const c_double,
+        output_left: *mut c_double,
+        output_right: *mut c_double,
+        num_frames: c_int,
+    ) -> bool;
+
+    pub fn vst3_get_bus_count(handle: *mut VST3PluginHandle, input: bool) -> c_int;
+
+    pub fn vst3_get_bus_info(
+        handle: *mut VST3PluginHandle,
+        input: bool,
+        index: c_int,
+        info: *mut VST3BusInfo,
+    ) -> bool;
+
+    pub fn vst3_set_bus_channels(
+        handle: *mut VST3PluginHandle,
+        input: bool,
+        index: c_int,
+        channels: c_int,
+    ) -> bool;
+
+    pub fn vst3_set_bus_active(
+        handle: *mut VST3PluginHandle,
+        input: bool,
+        index: c_int,
+        active: bool,
+    ) -> bool;
+
+    pub fn vst3_process_buses(
+        handle: *mut VST3PluginHandle,
+        inputs: *const VST3AudioBus,
+        num_inputs: c_int,
+        outputs: *const VST3AudioBus,
+        num_outputs: c_int,
+        num_frames: c_int,
+    ) -> bool;
+
     pub fn vst3_process_midi_event(
         handle: *mut VST3PluginHandle,
         event_type: c_int,
@@ -142,6 +480,17 @@ extern "C" {
         sample_offset: c_int,
     ) -> bool;
 
+    pub fn vst3_queue_midi_event_at(
+        handle: *mut VST3PluginHandle,
+        event_type: c_int,
+        channel: c_int,
+        data1: c_int,
+        data2: c_int,
+        sample_time: i64,
+    ) -> bool;
+
+    pub fn vst3_get_sample_position(handle: *mut VST3PluginHandle) -> i64;
+
     pub fn vst3_get_parameter_count(handle: *mut VST3PluginHandle) -> c_int;
 
     pub fn vst3_get_parameter_info(
@@ -150,6 +499,14 @@ extern "C" {
         info: *mut VST3ParameterInfo,
     ) -> bool;
 
+    pub fn vst3_get_parameter_catalog(
+        handle: *mut VST3PluginHandle,
+        infos: *mut VST3ParameterInfo,
+        max_params: c_int,
+    ) -> c_int;
+
+    pub fn vst3_get_parameter_index(handle: *mut VST3PluginHandle, param_id: u32) -> c_int;
+
     pub fn vst3_get_parameter_value(
         handle: *mut VST3PluginHandle,
         param_id: u32,
@@ -161,8 +518,51 @@ extern "C" {
         value: c_double,
     ) -> bool;
 
+    pub fn vst3_get_parameter_values(
+        handle: *mut VST3PluginHandle,
+        ids: *const u32,
+        values: *mut c_double,
+        count: c_int,
+    ) -> c_int;
+
+    pub fn vst3_set_parameter_values(
+        handle: *mut VST3PluginHandle,
+        ids: *const u32,
+        values: *const c_double,
+        count: c_int,
+    ) -> c_int;
+
+    pub fn vst3_queue_parameter_change(
+        handle: *mut VST3PluginHandle,
+        param_id: u32,
+        value: c_double,
+        sample_offset: c_int,
+    ) -> bool;
+
+    pub fn vst3_poll_parameter_changes(
+        handle: *mut VST3PluginHandle,
+        changes: *mut VST3ParameterChange,
+        max_changes: c_int,
+    ) -> c_int;
+
+    pub fn vst3_poll_editor_changes(
+        handle: *mut VST3PluginHandle,
+        changes: *mut VST3EditorChange,
+        max_changes: c_int,
+    ) -> c_int;
+
+    pub fn vst3_snapshot_state(
+        handle: *mut VST3PluginHandle,
+        data: *mut *const c_void,
+        size: *mut c_int,
+    ) -> *mut c_void;
+
+    pub fn vst3_release_state(snapshot: *mut c_void);
+
     pub fn vst3_get_state_size(handle: *mut VST3PluginHandle) -> c_int;
 
+    pub fn vst3_get_state_generation(handle: *mut VST3PluginHandle) -> u64;
+
     pub fn vst3_get_state(
         handle: *mut VST3PluginHandle,
         data: *mut c_void,
@@ -187,6 +587,12 @@ extern "C" {
     pub fn vst3_attach_editor(handle: *mut VST3PluginHandle, parent: *mut c_void) -> bool;
 
     pub fn vst3_get_last_error() -> *const c_char;
+
+    pub fn vst3_get_last_error_code() -> c_int;
+
+    pub fn vst3_clear_last_error();
+
+    pub fn vst3_result_string(result: c_int) -> *const c_char;
 }
 
 // Rust-safe wrapper API
@@ -273,16 +679,122 @@ impl VST3Host {
         }
     }
 
-    fn get_last_error() -> String {
+    /// Set the on-disk scan cache file (None restores the default location)
+    pub fn set_scan_cache_path(path: Option<&str>) -> Result<(), String> {
+        let path_cstr = path.map(CString::new).transpose().map_err(|e| e.to_string())?;
+        unsafe {
+            vst3_set_scan_cache_path(path_cstr.as_ref().map_or(std::ptr::null(), |p| p.as_ptr()));
+        }
+        Ok(())
+    }
+
+    /// Probe bundles out-of-process with the vst3_scan_helper at this path
+    /// (None probes in-process)
+    pub fn set_scan_helper_path(path: Option<&str>) -> Result<(), String> {
+        let path_cstr = path.map(CString::new).transpose().map_err(|e| e.to_string())?;
+        unsafe {
+            vst3_set_scan_helper_path(path_cstr.as_ref().map_or(std::ptr::null(), |p| p.as_ptr()));
+        }
+        Ok(())
+    }
+
+    /// Run bridged plugins in the vst3_bridge_helper at this path
+    /// (None disables bridging for plugins loaded from now on)
+    pub fn set_bridge_helper_path(path: Option<&str>) -> Result<(), String> {
+        let path_cstr = path.map(CString::new).transpose().map_err(|e| e.to_string())?;
+        unsafe {
+            vst3_set_bridge_helper_path(path_cstr.as_ref().map_or(std::ptr::null(), |p| p.as_ptr()));
+        }
+        Ok(())
+    }
+
+    /// Load the bundle at `file_path` in its own helper process from now on
+    /// (or in-process again). Instances already loaded stay where they are
+    pub fn set_plugin_bridged(file_path: &str, bridged: bool) -> Result<(), String> {
+        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+        unsafe {
+            if vst3_set_plugin_bridged(path_cstr.as_ptr(), bridged) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    /// Keep `instances_per_class` warm instances of pinned bundles and of the
+    /// `max_classes` most recently acquired ones (0 instances turns the pool off)
+    pub fn configure_instance_pool(
+        instances_per_class: usize,
+        max_classes: usize,
+        sample_rate: f64,
+        max_block_size: i32,
+    ) -> Result<(), String> {
+        unsafe {
+            if vst3_pool_configure(instances_per_class as c_int, max_classes as c_int, sample_rate, max_block_size) {
+                Ok(())
+            } else {
+                Err(Self::get_last_error())
+            }
+        }
+    }
+
+    /// Keep a bundle warm in the instance pool however long it goes unused
+    pub fn pin_pooled_plugin(file_path: &str, pinned: bool) -> Result<(), String> {
+        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+        unsafe {
+            if vst3_pool_pin(path_cstr.as_ptr(), pinned) {
+                Ok(())
+            } else {
+                Err(Self::get_last_error())
+            }
+        }
+    }
+
+    /// Forget cached scan results so the next scan re-probes every bundle
+    pub fn clear_scan_cache() {
         unsafe {
+            vst3_clear_scan_cache();
+        }
+    }
+
+    /// Number of latency change notifications from all plugins so far.
+    /// When it moves, check `VST3Plugin::latency_change_count` to find the
+    /// plugins whose latency needs reading again.
+    pub fn latency_change_count() -> u32 {
+        unsafe { vst3_get_latency_change_count() }
+    }
+
+    /// Set up the calling thread for realtime processing: flush denormals,
+    /// and join MMCSS "Pro Audio" (Windows) or the output device's audio
+    /// workgroup (macOS). Idempotent and allocation-free after the first
+    /// call on a thread, so the audio callback can call it every block
+    pub fn prepare_realtime_thread() -> bool {
+        unsafe { vst3_prepare_realtime_thread() }
+    }
+
+    /// Leave whatever `prepare_realtime_thread` joined; also done at thread exit
+    pub fn release_realtime_thread() {
+        unsafe { vst3_release_realtime_thread() }
+    }
+
+    /// Error of the host call that just failed on this thread. The host
+    /// keeps one error per thread, so this must be called on the thread that
+    /// made the failing call, before it makes another one
+    fn get_last_error() -> String {
+        let code = VST3ErrorCode::last();
+        let message = unsafe {
             let err_ptr = vst3_get_last_error();
             if err_ptr.is_null() {
-                "Unknown error".to_string()
+                String::new()
             } else {
-                CStr::from_ptr(err_ptr)
-                    .to_string_lossy()
-                    .into_owned()
+                CStr::from_ptr(err_ptr).to_string_lossy().into_owned()
             }
+        };
+
+        if message.is_empty() {
+            code.description().to_string()
+        } else {
+            message
         }
     }
 }
@@ -320,39 +832,630 @@ pub fn scan_standard_locations() -> Result<Vec<VST3PluginInfo>, String> {
     Ok(plugins)
 }
 
-pub struct VST3Plugin {
-    pub handle: *mut VST3PluginHandle,
+// ============================================================================
+// Plugin Catalog
+// ============================================================================
+
+/// One plugin from the catalog, borrowed from the mapping
+#[derive(Debug, Clone, Copy)]
+pub struct CatalogEntry<'a> {
+    pub name: &'a str,
+    pub vendor: &'a str,
+    pub file_path: &'a str,
+    pub is_instrument: bool,
+    pub is_effect: bool,
 }
 
-impl VST3Plugin {
-    pub fn load(file_path: &str) -> Result<Self, String> {
-        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+/// Catalog index a filter looks in
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CatalogIndex {
+    Vendor,
+    Subcategory,
+    /// Keys "instrument" and "effect"
+    Kind,
+}
 
-        unsafe {
-            let handle = vst3_load_plugin(path_cstr.as_ptr());
-            if handle.is_null() {
-                Err(VST3Host::get_last_error())
+impl CatalogIndex {
+    fn as_raw(self) -> c_int {
+        match self {
+            CatalogIndex::Vendor => VST3_CATALOG_VENDOR,
+            CatalogIndex::Subcategory => VST3_CATALOG_SUBCATEGORY,
+            CatalogIndex::Kind => VST3_CATALOG_KIND,
+        }
+    }
+}
+
+/// The ProcessContext shared by every plugin processing one stream of
+/// blocks (the audio callback, an offline render). Update it once per block,
+/// then bind each thread that processes plugins for that block
+pub struct TransportContext {
+    handle: *mut c_void,
+    /// Last state passed to `update`
+    state: VST3Transport,
+}
+
+// SAFETY: updates take &mut self, so they can't overlap the processing
+// threads that read the context through a binding
+unsafe impl Send for TransportContext {}
+unsafe impl Sync for TransportContext {}
+
+/// Puts back the thread's previous binding when dropped
+pub struct TransportBinding<'a> {
+    previous: *mut c_void,
+    _context: std::marker::PhantomData<&'a TransportContext>,
+}
+
+impl TransportContext {
+    pub fn new() -> Self {
+        let state = VST3Transport { tempo: 120.0, time_sig_numerator: 4, time_sig_denominator: 4, ..Default::default() };
+        Self { handle: unsafe { vst3_transport_create() }, state }
+    }
+
+    /// Recompute the context for the next block
+    pub fn update(&mut self, state: &VST3Transport) {
+        self.state = *state;
+        unsafe { vst3_transport_update(self.handle, state) }
+    }
+
+    /// The previous block's transport (120 BPM in 4/4 before the first)
+    pub fn state(&self) -> &VST3Transport {
+        &self.state
+    }
+
+    /// Give the calling thread's plugins this context until the binding drops
+    pub fn bind(&self) -> TransportBinding<'_> {
+        let previous = unsafe { vst3_transport_bind(self.handle) };
+        TransportBinding { previous, _context: std::marker::PhantomData }
+    }
+}
+
+impl Drop for TransportBinding<'_> {
+    fn drop(&mut self) {
+        unsafe { vst3_transport_bind(self.previous) };
+    }
+}
+
+impl Drop for TransportContext {
+    fn drop(&mut self) {
+        unsafe { vst3_transport_destroy(self.handle) }
+    }
+}
+
+/// The memory-mapped plugin catalog the last scan wrote. Queries hand out
+/// record id slices that point into the mapping: every slice is ascending
+/// (name order), so filters combine with [`intersect_ids`]
+pub struct PluginCatalog {
+    handle: *mut c_void,
+}
+
+// SAFETY: the catalog is immutable and the host's query functions only read it
+unsafe impl Send for PluginCatalog {}
+unsafe impl Sync for PluginCatalog {}
+
+fn catalog_str<'a>(ptr: *const c_char) -> &'a str {
+    if ptr.is_null() {
+        return "";
+    }
+    unsafe { CStr::from_ptr(ptr).to_str().unwrap_or("") }
+}
+
+impl PluginCatalog {
+    /// The newest catalog, or None if no scan has written one yet
+    pub fn open() -> Option<Self> {
+        let handle = unsafe { vst3_catalog_acquire() };
+        (!handle.is_null()).then_some(Self { handle })
+    }
+
+    pub fn len(&self) -> usize {
+        unsafe { vst3_catalog_size(self.handle) as usize }
+    }
+
+    fn span(&self, span: VST3CatalogSpan) -> &[u32] {
+        if span.ids.is_null() || span.count <= 0 {
+            return &[];
+        }
+        // SAFETY: spans point into the catalog, which lives as long as self
+        unsafe { std::slice::from_raw_parts(span.ids, span.count as usize) }
+    }
+
+    /// Every plugin, by name
+    pub fn all(&self) -> &[u32] {
+        self.span(unsafe { vst3_catalog_all(self.handle) })
+    }
+
+    /// Plugins with this vendor, subcategory or kind (ASCII case-insensitive)
+    pub fn find(&self, index: CatalogIndex, key: &str) -> &[u32] {
+        let Ok(key) = CString::new(key) else {
+            return &[];
+        };
+        self.span(unsafe { vst3_catalog_find(self.handle, index.as_raw(), key.as_ptr()) })
+    }
+
+    /// Plugins whose name starts with `prefix` (ASCII case-insensitive)
+    pub fn name_prefix(&self, prefix: &str) -> &[u32] {
+        let Ok(prefix) = CString::new(prefix) else {
+            return &[];
+        };
+        self.span(unsafe { vst3_catalog_name_prefix(self.handle, prefix.as_ptr()) })
+    }
+
+    /// The distinct keys of an index with their plugins, e.g. every vendor
+    pub fn groups(&self, index: CatalogIndex) -> Vec<(&str, &[u32])> {
+        let count = unsafe { vst3_catalog_group_count(self.handle, index.as_raw()) };
+        (0..count)
+            .filter_map(|group| {
+                let mut label = std::ptr::null();
+                let mut members = VST3CatalogSpan { ids: std::ptr::null(), count: 0 };
+                let found = unsafe {
+                    vst3_catalog_get_group(self.handle, index.as_raw(), group, &mut label, &mut members)
+                };
+                found.then(|| (catalog_str(label), self.span(members)))
+            })
+            .collect()
+    }
+
+    pub fn entry(&self, id: u32) -> Option<CatalogEntry<'_>> {
+        let mut entry = VST3CatalogEntry {
+            name: std::ptr::null(),
+            vendor: std::ptr::null(),
+            version: std::ptr::null(),
+            category: std::ptr::null(),
+            file_path: std::ptr::null(),
+            is_instrument: false,
+            is_effect: false,
+        };
+        if !unsafe { vst3_catalog_get_entry(self.handle, id, &mut entry) } {
+            return None;
+        }
+        Some(CatalogEntry {
+            name: catalog_str(entry.name),
+            vendor: catalog_str(entry.vendor),
+            file_path: catalog_str(entry.file_path),
+            is_instrument: entry.is_instrument,
+            is_effect: entry.is_effect,
+        })
+    }
+}
+
+impl Drop for PluginCatalog {
+    fn drop(&mut self) {
+        unsafe { vst3_catalog_release(self.handle) }
+    }
+}
+
+/// Ids present in both ascending id lists
+pub fn intersect_ids(a: &[u32], b: &[u32]) -> Vec<u32> {
+    let mut out = Vec::with_capacity(a.len().min(b.len()));
+    let (mut i, mut j) = (0, 0);
+    while i < a.len() && j < b.len() {
+        match a[i].cmp(&b[j]) {
+            std::cmp::Ordering::Less => i += 1,
+            std::cmp::Ordering::Greater => j += 1,
+            std::cmp::Ordering::Equal => {
+                out.push(a[i]);
+                i += 1;
+                j += 1;
+            }
+        }
+    }
+    out
+}
+
+pub struct VST3Plugin {
+    pub handle: *mut VST3PluginHandle,
+    /// From the instance pool: dropping gives it back instead of unloading
+    pooled: bool,
+}
+
+impl VST3Plugin {
+    pub fn load(file_path: &str) -> Result<Self, String> {
+        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+
+        unsafe {
+            let handle = vst3_load_plugin(path_cstr.as_ptr());
+            if handle.is_null() {
+                Err(VST3Host::get_last_error())
+            } else {
+                Ok(VST3Plugin { handle, pooled: false })
+            }
+        }
+    }
+
+    /// Load, initialize and activate a plugin on the host's loader threads.
+    /// The result arrives on the returned channel once the plugin is ready.
+    pub fn load_async(
+        file_path: &str,
+        sample_rate: f64,
+        max_block_size: i32,
+    ) -> Result<std::sync::mpsc::Receiver<Result<Self, String>>, String> {
+        type LoadSender = std::sync::mpsc::Sender<Result<VST3Plugin, String>>;
+
+        extern "C" fn load_callback(
+            handle: *mut VST3PluginHandle,
+            error: *const c_char,
+            user_data: *mut c_void,
+        ) {
+            unsafe {
+                let sender = Box::from_raw(user_data as *mut LoadSender);
+                let result = if handle.is_null() {
+                    Err(if error.is_null() {
+                        "Unknown error".to_string()
+                    } else {
+                        CStr::from_ptr(error).to_string_lossy().into_owned()
+                    })
+                } else {
+                    Ok(VST3Plugin { handle, pooled: false })
+                };
+                // If the receiver is gone the plugin is dropped (and unloaded) here
+                let _ = sender.send(result);
+            }
+        }
+
+        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+        let (sender, receiver) = std::sync::mpsc::channel();
+        let user_data = Box::into_raw(Box::new(sender)) as *mut c_void;
+
+        unsafe {
+            if vst3_load_plugin_async(
+                path_cstr.as_ptr(),
+                sample_rate,
+                max_block_size,
+                load_callback,
+                user_data,
+            ) {
+                Ok(receiver)
+            } else {
+                drop(Box::from_raw(user_data as *mut LoadSender));
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    /// An initialized, activated instance from the host's instance pool:
+    /// instant if the pool has one warm, a plain load otherwise. Dropping it
+    /// returns it to the pool to be reset and recycled
+    pub fn acquire_pooled(file_path: &str, sample_rate: f64, max_block_size: i32) -> Result<Self, String> {
+        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+
+        unsafe {
+            let handle = vst3_pool_acquire(path_cstr.as_ptr(), sample_rate, max_block_size);
+            if handle.is_null() {
+                Err(VST3Host::get_last_error())
+            } else {
+                Ok(VST3Plugin { handle, pooled: true })
+            }
+        }
+    }
+
+    /// Load a specific audio class (by name or UID string) from a bundle
+    /// that contains several
+    pub fn load_class(file_path: &str, class_name: &str) -> Result<Self, String> {
+        let path_cstr = CString::new(file_path).map_err(|e| e.to_string())?;
+        let class_cstr = CString::new(class_name).map_err(|e| e.to_string())?;
+
+        unsafe {
+            let handle = vst3_load_plugin_class(path_cstr.as_ptr(), class_cstr.as_ptr());
+            if handle.is_null() {
+                Err(VST3Host::get_last_error())
+            } else {
+                Ok(VST3Plugin { handle, pooled: false })
+            }
+        }
+    }
+
+    pub fn get_info(&self) -> Result<VST3PluginInfo, String> {
+        let mut info: VST3PluginInfo = unsafe { std::mem::zeroed() };
+
+        unsafe {
+            if vst3_get_plugin_info(self.handle, &mut info) {
+                Ok(info)
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    pub fn initialize(&self, sample_rate: f64, max_block_size: i32) -> Result<(), String> {
+        unsafe {
+            if vst3_initialize_plugin(self.handle, sample_rate, max_block_size) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    pub fn activate(&self) -> Result<(), String> {
+        unsafe {
+            if vst3_activate_plugin(self.handle) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    pub fn deactivate(&self) -> Result<(), String> {
+        unsafe {
+            if vst3_deactivate_plugin(self.handle) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    /// Flush the plugin's internal state without redoing its setup (see
+    /// `vst3_reset_plugin`)
+    pub fn reset(&self) -> Result<(), String> {
+        unsafe {
+            if vst3_reset_plugin(self.handle) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    /// Change sample rate / max block size; free if neither changed
+    pub fn reconfigure(&self, sample_rate: f64, max_block_size: i32) -> Result<(), String> {
+        unsafe {
+            if vst3_reconfigure(self.handle, sample_rate, max_block_size) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    pub fn process_audio(
+        &self,
+        input_left: &[f32],
+        input_right: &[f32],
+        output_left: &mut [f32],
+        output_right: &mut [f32],
+    ) -> Result<(), String> {
+        let num_frames = input_left.len().min(output_left.len()) as i32;
+
+        unsafe {
+            if vst3_process_audio(
+                self.handle,
+                input_left.as_ptr(),
+                input_right.as_ptr(),
+                output_left.as_mut_ptr(),
+                output_right.as_mut_ptr(),
+                num_frames,
+            ) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    /// Process a whole block in one call. Blocks larger than the plugin's
+    /// max block size are split on the C++ side.
+    pub fn process_block(
+        &self,
+        input_left: &[f32],
+        input_right: &[f32],
+        output_left: &mut [f32],
+        output_right: &mut [f32],
+    ) -> Result<(), String> {
+        self.try_process_block(input_left, input_right, output_left, output_right)
+            .map_err(|_| VST3Host::get_last_error())
+    }
+
+    /// `process_block` for the audio thread: reports failures as a code,
+    /// without building a message
+    pub fn try_process_block(
+        &self,
+        input_left: &[f32],
+        input_right: &[f32],
+        output_left: &mut [f32],
+        output_right: &mut [f32],
+    ) -> Result<(), VST3ErrorCode> {
+        let num_frames = input_left.len()
+            .min(input_right.len())
+            .min(output_left.len())
+            .min(output_right.len()) as i32;
+
+        unsafe {
+            if vst3_process_block(
+                self.handle,
+                input_left.as_ptr(),
+                input_right.as_ptr(),
+                output_left.as_mut_ptr(),
+                output_right.as_mut_ptr(),
+                num_frames,
+            ) {
+                Ok(())
+            } else {
+                Err(VST3ErrorCode::last())
+            }
+        }
+    }
+
+    /// Process `left`/`right` in place. What a chain of plugins uses to
+    /// stay planar from one instance to the next
+    pub fn process_in_place(&self, left: &mut [f32], right: &mut [f32]) -> Result<(), VST3ErrorCode> {
+        let num_frames = left.len().min(right.len()) as i32;
+
+        unsafe {
+            if vst3_process_block(
+                self.handle,
+                left.as_ptr(),
+                right.as_ptr(),
+                left.as_mut_ptr(),
+                right.as_mut_ptr(),
+                num_frames,
+            ) {
+                Ok(())
+            } else {
+                Err(VST3ErrorCode::last())
+            }
+        }
+    }
+
+    /// Process interleaved stereo (LRLR...) in place, e.g. a device or mix
+    /// buffer. Split into planar and merged back on the C++ side
+    pub fn process_interleaved(&self, buffer: &mut [f32]) -> Result<(), VST3ErrorCode> {
+        let num_frames = (buffer.len() / 2) as i32;
+
+        unsafe {
+            if vst3_process_interleaved(self.handle, buffer.as_ptr(), buffer.as_mut_ptr(), num_frames) {
+                Ok(())
+            } else {
+                Err(VST3ErrorCode::last())
+            }
+        }
+    }
+
+    pub fn process_midi_event(
+        &self,
+        event_type: i32,
+        channel: i32,
+        data1: i32,
+        data2: i32,
+        sample_offset: i32,
+    ) -> Result<(), String> {
+        self.try_process_midi_event(event_type, channel, data1, data2, sample_offset)
+            .map_err(|_| VST3Host::get_last_error())
+    }
+
+    /// `process_midi_event` for the audio thread: reports failures as a
+    /// code, without building a message
+    pub fn try_process_midi_event(
+        &self,
+        event_type: i32,
+        channel: i32,
+        data1: i32,
+        data2: i32,
+        sample_offset: i32,
+    ) -> Result<(), VST3ErrorCode> {
+        unsafe {
+            if vst3_process_midi_event(
+                self.handle,
+                event_type,
+                channel,
+                data1,
+                data2,
+                sample_offset,
+            ) {
+                Ok(())
+            } else {
+                Err(VST3ErrorCode::last())
+            }
+        }
+    }
+
+    /// Queue a MIDI event at an absolute sample time on the plugin's clock
+    /// (see `sample_position`). Lock-free, callable from any thread
+    pub fn queue_midi_event_at(
+        &self,
+        event_type: i32,
+        channel: i32,
+        data1: i32,
+        data2: i32,
+        sample_time: i64,
+    ) -> Result<(), String> {
+        unsafe {
+            if vst3_queue_midi_event_at(self.handle, event_type, channel, data1, data2, sample_time) {
+                Ok(())
+            } else {
+                Err(VST3Host::get_last_error())
+            }
+        }
+    }
+
+    /// Sample time of the next block the plugin will process
+    pub fn sample_position(&self) -> i64 {
+        unsafe { vst3_get_sample_position(self.handle) }
+    }
+
+    pub fn get_parameter_count(&self) -> i32 {
+        unsafe { vst3_get_parameter_count(self.handle) }
+    }
+
+    pub fn get_parameter_info(&self, index: i32) -> Result<VST3ParameterInfo, String> {
+        let mut info: VST3ParameterInfo = unsafe { std::mem::zeroed() };
+
+        unsafe {
+            if vst3_get_parameter_info(self.handle, index, &mut info) {
+                Ok(info)
             } else {
-                Ok(VST3Plugin { handle })
+                Err(VST3Host::get_last_error())
             }
         }
     }
 
-    pub fn get_info(&self) -> Result<VST3PluginInfo, String> {
-        let mut info: VST3PluginInfo = unsafe { std::mem::zeroed() };
+    /// Metadata of every parameter in index order, from the host's cache
+    pub fn get_parameter_catalog(&self) -> Result<Vec<VST3ParameterInfo>, String> {
+        let mut infos: Vec<VST3ParameterInfo> = Vec::new();
+        loop {
+            let count = unsafe { vst3_get_parameter_catalog(self.handle, infos.as_mut_ptr(), infos.capacity() as c_int) };
+            if count < 0 {
+                return Err(VST3Host::get_last_error());
+            }
+            let count = count as usize;
+            if count <= infos.capacity() {
+                // Filled by the host, and VST3ParameterInfo is plain data
+                unsafe { infos.set_len(count) };
+                return Ok(infos);
+            }
+            // First call, or the plugin's parameter list grew in between
+            infos.reserve_exact(count);
+        }
+    }
+
+    /// Catalog index of a parameter ID
+    pub fn get_parameter_index(&self, param_id: u32) -> Option<i32> {
+        let index = unsafe { vst3_get_parameter_index(self.handle, param_id) };
+        (index >= 0).then_some(index)
+    }
+
+    pub fn get_parameter_value(&self, param_id: u32) -> f64 {
+        unsafe { vst3_get_parameter_value(self.handle, param_id) }
+    }
 
+    pub fn set_parameter_value(&self, param_id: u32, value: f64) -> Result<(), String> {
         unsafe {
-            if vst3_get_plugin_info(self.handle, &mut info) {
-                Ok(info)
+            if vst3_set_parameter_value(self.handle, param_id, value) {
+                Ok(())
             } else {
                 Err(VST3Host::get_last_error())
             }
         }
     }
 
-    pub fn initialize(&self, sample_rate: f64, max_block_size: i32) -> Result<(), String> {
+    /// Read `values[i]` for each `ids[i]` in one call
+    pub fn get_parameter_values(&self, ids: &[u32], values: &mut [f64]) -> Result<(), String> {
+        let count = ids.len().min(values.len());
+        let read = unsafe {
+            vst3_get_parameter_values(self.handle, ids.as_ptr(), values.as_mut_ptr(), count as c_int)
+        };
+        if read < 0 {
+            return Err(VST3Host::get_last_error());
+        }
+        Ok(())
+    }
+
+    /// Set each `ids[i]` to `values[i]` in one call (controller and processor)
+    pub fn set_parameter_values(&self, ids: &[u32], values: &[f64]) -> Result<(), String> {
+        let count = ids.len().min(values.len());
+        let queued = unsafe {
+            vst3_set_parameter_values(self.handle, ids.as_ptr(), values.as_ptr(), count as c_int)
+        };
+        if queued < count as c_int {
+            return Err(VST3Host::get_last_error());
+        }
+        Ok(())
+    }
+
+    /// Queue a sample-accurate parameter change for the next processed block
+    pub fn queue_parameter_change(&self, param_id: u32, value: f64, sample_offset: i32) -> Result<(), String> {
         unsafe {
-            if vst3_initialize_plugin(self.handle, sample_rate, max_block_size) {
+            if vst3_queue_parameter_change(self.handle, param_id, value, sample_offset) {
                 Ok(())
             } else {
                 Err(VST3Host::get_last_error())
@@ -360,9 +1463,52 @@ impl VST3Plugin {
         }
     }
 
-    pub fn activate(&self) -> Result<(), String> {
+    /// Skip processing while input is silent past the plugin's tail
+    pub fn set_auto_sleep(&self, enabled: bool) {
         unsafe {
-            if vst3_activate_plugin(self.handle) {
+            vst3_set_auto_sleep(self.handle, enabled);
+        }
+    }
+
+    /// True if the last processed block produced only silence
+    pub fn is_output_silent(&self) -> bool {
+        unsafe { vst3_is_output_silent(self.handle) }
+    }
+
+    /// Whether this instance runs in a bridge helper process
+    pub fn is_bridged(&self) -> bool {
+        unsafe { vst3_is_plugin_bridged(self.handle) }
+    }
+
+    /// process() timing since load or the last `reset_stats`
+    pub fn stats(&self) -> VST3PluginStats {
+        let mut stats = VST3PluginStats::default();
+        unsafe {
+            vst3_get_plugin_stats(self.handle, &mut stats);
+        }
+        stats
+    }
+
+    pub fn reset_stats(&self) {
+        unsafe { vst3_reset_plugin_stats(self.handle) }
+    }
+
+    /// Processing latency reported by the plugin, in samples
+    pub fn latency_samples(&self) -> u32 {
+        unsafe { vst3_get_latency_samples(self.handle).max(0) as u32 }
+    }
+
+    /// Number of latency change notifications from this plugin so far
+    pub fn latency_change_count(&self) -> u32 {
+        unsafe { vst3_get_plugin_latency_change_count(self.handle) }
+    }
+
+    /// Switch between realtime and offline (export) processing. A block size
+    /// of 0 keeps the current size going offline and restores the realtime
+    /// size coming back
+    pub fn set_offline_mode(&self, offline: bool, max_block_size: i32) -> Result<(), String> {
+        unsafe {
+            if vst3_set_offline_mode(self.handle, offline, max_block_size) {
                 Ok(())
             } else {
                 Err(VST3Host::get_last_error())
@@ -370,9 +1516,14 @@ impl VST3Plugin {
         }
     }
 
-    pub fn deactivate(&self) -> Result<(), String> {
+    pub fn is_offline_mode(&self) -> bool {
+        unsafe { vst3_is_offline_mode(self.handle) }
+    }
+
+    /// Ask for 64-bit processing; plugins without kSample64 support stay 32-bit
+    pub fn set_double_precision(&self, enabled: bool) -> Result<(), String> {
         unsafe {
-            if vst3_deactivate_plugin(self.handle) {
+            if vst3_set_double_precision(self.handle, enabled) {
                 Ok(())
             } else {
                 Err(VST3Host::get_last_error())
@@ -380,17 +1531,26 @@ impl VST3Plugin {
         }
     }
 
-    pub fn process_audio(
+    /// Sample size the plugin runs in (32 or 64)
+    pub fn sample_size(&self) -> u32 {
+        unsafe { vst3_get_sample_size(self.handle) as u32 }
+    }
+
+    /// `process_block` with f64 buffers, passed straight to 64-bit plugins
+    pub fn process_block_f64(
         &self,
-        input_left: &[f32],
-        input_right: &[f32],
-        output_left: &mut [f32],
-        output_right: &mut [f32],
+        input_left: &[f64],
+        input_right: &[f64],
+        output_left: &mut [f64],
+        output_right: &mut [f64],
     ) -> Result<(), String> {
-        let num_frames = input_left.len().min(output_left.len()) as i32;
+        let num_frames = input_left.len()
+            .min(input_right.len())
+            .min(output_left.len())
+            .min(output_right.len()) as i32;
 
         unsafe {
-            if vst3_process_audio(
+            if vst3_process_block_double(
                 self.handle,
                 input_left.as_ptr(),
                 input_right.as_ptr(),
@@ -405,53 +1565,37 @@ impl VST3Plugin {
         }
     }
 
-    pub fn process_midi_event(
-        &self,
-        event_type: i32,
-        channel: i32,
-        data1: i32,
-        data2: i32,
-        sample_offset: i32,
-    ) -> Result<(), String> {
+    /// Number of audio buses (input = true for inputs)
+    pub fn bus_count(&self, input: bool) -> i32 {
+        unsafe { vst3_get_bus_count(self.handle, input) }
+    }
+
+    pub fn bus_info(&self, input: bool, index: i32) -> Result<VST3BusInfo, String> {
         unsafe {
-            if vst3_process_midi_event(
-                self.handle,
-                event_type,
-                channel,
-                data1,
-                data2,
-                sample_offset,
-            ) {
-                Ok(())
+            let mut info: VST3BusInfo = std::mem::zeroed();
+            if vst3_get_bus_info(self.handle, input, index, &mut info) {
+                Ok(info)
             } else {
                 Err(VST3Host::get_last_error())
             }
         }
     }
 
-    pub fn get_parameter_count(&self) -> i32 {
-        unsafe { vst3_get_parameter_count(self.handle) }
-    }
-
-    pub fn get_parameter_info(&self, index: i32) -> Result<VST3ParameterInfo, String> {
-        let mut info: VST3ParameterInfo = unsafe { std::mem::zeroed() };
-
+    /// Request a channel count for a bus (before `initialize`)
+    pub fn set_bus_channels(&self, input: bool, index: i32, channels: i32) -> Result<(), String> {
         unsafe {
-            if vst3_get_parameter_info(self.handle, index, &mut info) {
-                Ok(info)
+            if vst3_set_bus_channels(self.handle, input, index, channels) {
+                Ok(())
             } else {
                 Err(VST3Host::get_last_error())
             }
         }
     }
 
-    pub fn get_parameter_value(&self, param_id: u32) -> f64 {
-        unsafe { vst3_get_parameter_value(self.handle, param_id) }
-    }
-
-    pub fn set_parameter_value(&self, param_id: u32, value: f64) -> Result<(), String> {
+    /// Switch a bus on or off (sidechain input, multi-out), while not activated
+    pub fn set_bus_active(&self, input: bool, index: i32, active: bool) -> Result<(), String> {
         unsafe {
-            if vst3_set_parameter_value(self.handle, param_id, value) {
+            if vst3_set_bus_active(self.handle, input, index, active) {
                 Ok(())
             } else {
                 Err(VST3Host::get_last_error())
@@ -459,29 +1603,96 @@ impl VST3Plugin {
         }
     }
 
-    pub fn get_state(&self) -> Result<Vec<u8>, String> {
+    /// Process one block with per-bus channel pointers (bus 0 = main).
+    /// Every channel pointer must be valid for `num_frames` samples.
+    pub fn process_buses(
+        &self,
+        inputs: &[VST3AudioBus],
+        outputs: &[VST3AudioBus],
+        num_frames: usize,
+    ) -> Result<(), String> {
         unsafe {
-            let size = vst3_get_state_size(self.handle);
-            if size <= 0 {
-                return Ok(Vec::new());
-            }
-
-            let mut buffer = vec![0u8; size as usize];
-            let actual_size = vst3_get_state(
+            if vst3_process_buses(
                 self.handle,
-                buffer.as_mut_ptr() as *mut c_void,
-                size,
-            );
-
-            if actual_size > 0 {
-                buffer.truncate(actual_size as usize);
-                Ok(buffer)
+                inputs.as_ptr(),
+                inputs.len() as c_int,
+                outputs.as_ptr(),
+                outputs.len() as c_int,
+                num_frames as c_int,
+            ) {
+                Ok(())
             } else {
                 Err(VST3Host::get_last_error())
             }
         }
     }
 
+    /// Drain parameter changes reported by the processor since the last poll
+    pub fn poll_parameter_changes(&self) -> Vec<VST3ParameterChange> {
+        const BATCH: usize = 64;
+        let mut changes = Vec::new();
+        let mut batch = [VST3ParameterChange::default(); BATCH];
+        loop {
+            let count = unsafe {
+                vst3_poll_parameter_changes(self.handle, batch.as_mut_ptr(), BATCH as c_int)
+            };
+            if count <= 0 {
+                break;
+            }
+            changes.extend_from_slice(&batch[..count as usize]);
+            if (count as usize) < BATCH {
+                break;
+            }
+        }
+        changes
+    }
+
+    /// Drain the parameters edited in the plugin's editor since the last
+    /// poll, one entry per parameter with its latest value
+    pub fn poll_editor_changes(&self) -> Vec<VST3EditorChange> {
+        const BATCH: usize = 64;
+        let mut changes = Vec::new();
+        let mut batch = [VST3EditorChange::default(); BATCH];
+        loop {
+            let count = unsafe {
+                vst3_poll_editor_changes(self.handle, batch.as_mut_ptr(), BATCH as c_int)
+            };
+            if count <= 0 {
+                break;
+            }
+            changes.extend_from_slice(&batch[..count as usize]);
+            if (count as usize) < BATCH {
+                break;
+            }
+        }
+        changes
+    }
+
+    /// Serialize the plugin's state once into a host-owned buffer
+    pub fn snapshot_state(&self) -> Result<VST3StateSnapshot, String> {
+        let mut data: *const c_void = std::ptr::null();
+        let mut size: c_int = 0;
+        let handle = unsafe { vst3_snapshot_state(self.handle, &mut data, &mut size) };
+        if handle.is_null() {
+            return Err(VST3Host::get_last_error());
+        }
+        Ok(VST3StateSnapshot {
+            handle,
+            data: data as *const u8,
+            size: size.max(0) as usize,
+        })
+    }
+
+    pub fn get_state(&self) -> Result<Vec<u8>, String> {
+        Ok(self.snapshot_state()?.to_vec())
+    }
+
+    /// Moves whenever the plugin's state may have changed; equal values mean
+    /// a snapshot taken at the first one is still current
+    pub fn state_generation(&self) -> u64 {
+        unsafe { vst3_get_state_generation(self.handle) }
+    }
+
     pub fn set_state(&self, data: &[u8]) -> Result<(), String> {
         unsafe {
             if vst3_set_state(
@@ -581,7 +1792,11 @@ impl Drop for VST3Plugin {
     fn drop(&mut self) {
         if !self.handle.is_null() {
             unsafe {
-                vst3_unload_plugin(self.handle);
+                if self.pooled {
+                    vst3_pool_release(self.handle);
+                } else {
+                    vst3_unload_plugin(self.handle);
+                }
             }
         }
     }
@@ -610,24 +1825,133 @@ pub struct VST3Effect {
     block_size: i32,
     initialized: bool,
     pub is_instrument: bool,  // True if this is a VST3 instrument (generates audio from MIDI)
+    // Last processing error, so a failing plugin is reported once rather
+    // than on every block
+    last_process_error: Option<VST3ErrorCode>,
+}
+
+/// A plugin that isn't loaded, kept as what `VST3Effect::save_instance`
+/// captured (used by track freeze)
+#[derive(Clone, Debug)]
+pub struct VST3SavedInstance {
+    pub plugin_path: String,
+    pub name: String,
+    pub is_instrument: bool,
+    sample_rate: f64,
+    block_size: i32,
+    /// Plugin state blob (component and controller)
+    pub state: Vec<u8>,
+}
+
+impl VST3SavedInstance {
+    /// Load, initialize and activate the plugin and restore its state
+    pub fn restore(&self) -> Result<VST3Effect, String> {
+        let mut effect = VST3Effect::new(&self.plugin_path, self.sample_rate, self.block_size)?;
+        effect.initialize()?;
+        if !self.state.is_empty() {
+            effect.set_state(&self.state)?;
+        }
+        Ok(effect)
+    }
+}
+
+/// A plugin being loaded by `VST3Effect::load_async`
+pub struct VST3EffectLoad {
+    receiver: std::sync::mpsc::Receiver<Result<VST3Plugin, String>>,
+    plugin_path: String,
+    sample_rate: f64,
+    block_size: i32,
+}
+
+impl VST3EffectLoad {
+    /// Block until the plugin is loaded, initialized and activated
+    pub fn wait(self) -> Result<VST3Effect, String> {
+        let plugin = self
+            .receiver
+            .recv()
+            .map_err(|_| "VST3 loader dropped the request".to_string())??;
+        VST3Effect::from_plugin(plugin, &self.plugin_path, self.sample_rate, self.block_size, true)
+    }
 }
 
 impl VST3Effect {
     /// Create a new VST3Effect from a plugin path
     pub fn new(plugin_path: &str, sample_rate: f64, block_size: i32) -> Result<Self, String> {
         let plugin = VST3Plugin::load(plugin_path)?;
+        Self::from_plugin(plugin, plugin_path, sample_rate, block_size, false)
+    }
+
+    /// Take an initialized, activated instance from the host's instance pool
+    /// (see `VST3Plugin::acquire_pooled`)
+    pub fn from_pool(plugin_path: &str, sample_rate: f64, block_size: i32) -> Result<Self, String> {
+        let plugin = VST3Plugin::acquire_pooled(plugin_path, sample_rate, block_size)?;
+        Self::from_plugin(plugin, plugin_path, sample_rate, block_size, true)
+    }
+
+    /// Start loading a plugin on the host's loader threads. The effect comes
+    /// back already initialized and activated; call `wait()` on the result.
+    pub fn load_async(plugin_path: &str, sample_rate: f64, block_size: i32) -> Result<VST3EffectLoad, String> {
+        let receiver = VST3Plugin::load_async(plugin_path, sample_rate, block_size)?;
+        Ok(VST3EffectLoad {
+            receiver,
+            plugin_path: plugin_path.to_string(),
+            sample_rate,
+            block_size,
+        })
+    }
+
+    fn from_plugin(
+        plugin: VST3Plugin,
+        plugin_path: &str,
+        sample_rate: f64,
+        block_size: i32,
+        initialized: bool,
+    ) -> Result<Self, String> {
         let info = plugin.get_info()?;
         let name = info.name_str().to_string();
         let is_instrument = info.is_instrument;
 
+        // Effects on idle tracks go to sleep once their tail has rung out
+        if !is_instrument {
+            plugin.set_auto_sleep(true);
+        }
+
         Ok(Self {
             plugin: Arc::new(Mutex::new(plugin)),
             name,
             plugin_path: plugin_path.to_string(),
             sample_rate,
             block_size,
-            initialized: false,
+            initialized,
             is_instrument,
+            last_process_error: None,
+        })
+    }
+
+    /// Load a second, independent instance of this plugin (the module is
+    /// shared) with the same settings, restored from this one's state
+    pub fn clone_instance(&self) -> Result<Self, String> {
+        // A plugin that can't save its state still clones with defaults
+        let state = self.snapshot_state().ok();
+        let mut copy = Self::new(&self.plugin_path, self.sample_rate, self.block_size)?;
+        copy.initialize()?;
+        if let Some(state) = state.filter(|state| !state.is_empty()) {
+            copy.set_state(&state)?;
+        }
+        Ok(copy)
+    }
+
+    /// Everything needed to load this plugin again later: its path, the
+    /// settings it was created with and its current state
+    pub fn save_instance(&self) -> Result<VST3SavedInstance, String> {
+        let state = self.snapshot_state()?;
+        Ok(VST3SavedInstance {
+            plugin_path: self.plugin_path.clone(),
+            name: self.name.clone(),
+            is_instrument: self.is_instrument,
+            sample_rate: self.sample_rate,
+            block_size: self.block_size,
+            state: state.to_vec(),
         })
     }
 
@@ -652,6 +1976,18 @@ impl VST3Effect {
         Ok(())
     }
 
+    /// Move the plugin to a new sample rate / max block size. Free when
+    /// neither changed, so it can be applied to every plugin in a session
+    pub fn reconfigure(&mut self, sample_rate: f64, block_size: i32) -> Result<(), String> {
+        if self.initialized {
+            let plugin = self.plugin.lock().expect("mutex poisoned");
+            plugin.reconfigure(sample_rate, block_size)?;
+        }
+        self.sample_rate = sample_rate;
+        self.block_size = block_size;
+        Ok(())
+    }
+
     /// Get parameter count
     pub fn get_parameter_count(&self) -> i32 {
         let plugin = self.plugin.lock().expect("mutex poisoned");
@@ -664,6 +2000,17 @@ impl VST3Effect {
         plugin.get_parameter_info(index)
     }
 
+    /// Metadata of every parameter in index order
+    pub fn get_parameter_catalog(&self) -> Result<Vec<VST3ParameterInfo>, String> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.get_parameter_catalog()
+    }
+
+    pub fn get_parameter_index(&self, param_id: u32) -> Option<i32> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.get_parameter_index(param_id)
+    }
+
     /// Get parameter value by ID
     pub fn get_parameter_value(&self, param_id: u32) -> f64 {
         let plugin = self.plugin.lock().expect("mutex poisoned");
@@ -676,6 +2023,25 @@ impl VST3Effect {
         plugin.set_parameter_value(param_id, value)
     }
 
+    /// Read many parameter values under a single lock
+    pub fn get_parameter_values(&self, ids: &[u32], values: &mut [f64]) -> Result<(), String> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.get_parameter_values(ids, values)
+    }
+
+    /// Set many parameter values under a single lock
+    pub fn set_parameter_values(&mut self, ids: &[u32], values: &[f64]) -> Result<(), String> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.set_parameter_values(ids, values)
+    }
+
+    /// Queue an automation point for the processor
+    /// sample_offset is relative to the start of the next processed block
+    pub fn queue_parameter_change(&mut self, param_id: u32, value: f64, sample_offset: i32) -> Result<(), String> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.queue_parameter_change(param_id, value, sample_offset)
+    }
+
     /// Process MIDI event
     pub fn process_midi_event(
         &mut self,
@@ -689,12 +2055,48 @@ impl VST3Effect {
         plugin.process_midi_event(event_type, channel, data1, data2, sample_offset)
     }
 
+    /// Process MIDI event, reporting failures as a code (audio thread)
+    pub fn try_process_midi_event(
+        &mut self,
+        event_type: i32,
+        channel: i32,
+        data1: i32,
+        data2: i32,
+        sample_offset: i32,
+    ) -> Result<(), VST3ErrorCode> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.try_process_midi_event(event_type, channel, data1, data2, sample_offset)
+    }
+
+    /// Drain parameter changes reported by the processor (meters, learned values)
+    pub fn poll_parameter_changes(&self) -> Vec<VST3ParameterChange> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.poll_parameter_changes()
+    }
+
+    pub fn poll_editor_changes(&self) -> Vec<VST3EditorChange> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.poll_editor_changes()
+    }
+
     /// Get plugin state
     pub fn get_state(&self) -> Result<Vec<u8>, String> {
         let plugin = self.plugin.lock().expect("mutex poisoned");
         plugin.get_state()
     }
 
+    /// Plugin state without copying it out of the host's buffer
+    pub fn snapshot_state(&self) -> Result<VST3StateSnapshot, String> {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.snapshot_state()
+    }
+
+    /// See `VST3Plugin::state_generation`
+    pub fn state_generation(&self) -> u64 {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.state_generation()
+    }
+
     /// Set plugin state
     pub fn set_state(&mut self, data: &[u8]) -> Result<(), String> {
         let plugin = self.plugin.lock().expect("mutex poisoned");
@@ -726,6 +2128,23 @@ impl VST3Effect {
         plugin.get_editor_size()
     }
 
+    /// Whether the plugin runs in a bridge helper process
+    pub fn is_bridged(&self) -> bool {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.is_bridged()
+    }
+
+    /// DSP load statistics of the plugin
+    pub fn get_stats(&self) -> VST3PluginStats {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.stats()
+    }
+
+    pub fn reset_stats(&self) {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.reset_stats();
+    }
+
     /// Attach editor to parent window
     pub fn attach_editor(&self, parent: *mut c_void) -> Result<(), String> {
         let plugin = self.plugin.lock().expect("mutex poisoned");
@@ -767,38 +2186,64 @@ impl crate::effects::Effect for VST3Effect {
     fn process_frame(&mut self, left: f32, right: f32) -> (f32, f32) {
         let plugin = self.plugin.lock().expect("mutex poisoned");
 
-        // For now, create single-sample buffers
-        // TODO: Optimize by batching frames
-        let input_left = [left];
-        let input_right = [right];
-        let mut output_left = [0.0f32];
-        let mut output_right = [0.0f32];
-
-        match plugin.process_audio(
-            &input_left,
-            &input_right,
-            &mut output_left,
-            &mut output_right,
-        ) {
-            Ok(()) => (output_left[0], output_right[0]),
-            Err(e) => {
-                eprintln!("VST3 processing error: {}", e);
+        // One interleaved frame, processed in place
+        let mut frame = [left, right];
+        match plugin.process_interleaved(&mut frame) {
+            Ok(()) => (frame[0], frame[1]),
+            Err(code) => {
+                eprintln!("VST3 processing error: {}", code.description());
                 (left, right) // Pass through on error
             }
         }
     }
 
+    fn process_block(&mut self, left: &mut [f32], right: &mut [f32]) {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+
+        // In place: the chain's buffers go to the plugin as both input and
+        // output, with no copy on either side
+        match plugin.process_in_place(left, right) {
+            Ok(()) => self.last_process_error = None,
+            Err(code) => {
+                if self.last_process_error != Some(code) {
+                    eprintln!("VST3 processing error: {}", code.description());
+                    self.last_process_error = Some(code);
+                }
+            }
+        }
+    }
+
     fn reset(&mut self) {
-        // Deactivate and reactivate the plugin to reset state
         let plugin = self.plugin.lock().expect("mutex poisoned");
-        let _ = plugin.deactivate();
-        let _ = plugin.initialize(self.sample_rate, self.block_size);
-        let _ = plugin.activate();
+        if let Err(e) = plugin.reset() {
+            eprintln!("⚠️  [VST3] {}: reset failed: {}", self.name, e);
+        }
     }
 
     fn name(&self) -> &str {
         &self.name
     }
+
+    fn latency_samples(&self) -> u32 {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.latency_samples()
+    }
+
+    fn latency_change_count(&self) -> u32 {
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        plugin.latency_change_count()
+    }
+
+    fn set_offline_mode(&mut self, offline: bool, max_block_size: usize) {
+        if !self.initialized {
+            return;
+        }
+        let plugin = self.plugin.lock().expect("mutex poisoned");
+        let block_size = if offline { max_block_size as i32 } else { self.block_size };
+        if let Err(e) = plugin.set_offline_mode(offline, block_size) {
+            eprintln!("⚠️  [VST3] {}: failed to switch offline mode: {}", self.name, e);
+        }
+    }
 }
 
 #[cfg(test)]
@@ -812,6 +2257,66 @@ mod tests {
         VST3Host::shutdown();
     }
 
+    #[test]
+    fn test_prepare_realtime_thread_flushes_denormals() {
+        std::thread::spawn(|| {
+            let tiny = std::hint::black_box(1.0e-30f32);
+            assert!(std::hint::black_box(tiny * 1.0e-10) != 0.0);
+
+            VST3Host::prepare_realtime_thread();
+            VST3Host::prepare_realtime_thread();
+            let flushed = std::hint::black_box(tiny * 1.0e-10);
+            if cfg!(any(target_arch = "x86_64", target_arch = "aarch64")) {
+                assert_eq!(flushed, 0.0);
+            }
+            VST3Host::release_realtime_thread();
+        })
+        .join()
+        .unwrap();
+    }
+
+    #[test]
+    fn test_intersect_ids() {
+        assert_eq!(intersect_ids(&[1, 3, 4, 7, 9], &[0, 3, 7, 8, 9]), vec![3, 7, 9]);
+        assert!(intersect_ids(&[1, 2], &[]).is_empty());
+    }
+
+    #[test]
+    fn test_scan_writes_catalog() {
+        VST3Host::init().unwrap();
+        let dir = std::env::temp_dir().join(format!("vst3_catalog_test_{}", std::process::id()));
+        std::fs::create_dir_all(dir.join("plugins")).unwrap();
+        let cache = dir.join("scan_cache.txt");
+        VST3Host::set_scan_cache_path(cache.to_str()).unwrap();
+
+        // No bundles: an empty catalog that still answers queries
+        VST3Host::scan_directory(dir.join("plugins").to_str().unwrap(), |_| {}).unwrap();
+        assert!(dir.join("scan_cache.catalog").exists());
+        let catalog = PluginCatalog::open().expect("scan should publish a catalog");
+        assert_eq!(catalog.len(), 0);
+        assert!(catalog.all().is_empty());
+        assert!(catalog.find(CatalogIndex::Vendor, "Steinberg").is_empty());
+        assert!(catalog.name_prefix("a").is_empty());
+        assert!(catalog.groups(CatalogIndex::Subcategory).is_empty());
+        assert!(catalog.entry(0).is_none());
+
+        VST3Host::clear_scan_cache();
+        assert!(PluginCatalog::open().is_none());
+        drop(catalog);
+        VST3Host::set_scan_cache_path(None).unwrap();
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pooled_load_of_missing_plugin_fails() {
+        VST3Host::init().unwrap();
+        // Pool on or off (other tests shut the host down), a bundle that
+        // doesn't load is an error, not a handle
+        let _ = VST3Host::configure_instance_pool(1, 2, 48000.0, 512);
+        assert!(VST3Plugin::acquire_pooled("/nonexistent/Missing.vst3", 48000.0, 512).is_err());
+        let _ = VST3Host::configure_instance_pool(0, 0, 48000.0, 512);
+    }
+
     #[test]
     fn test_vst3_scan() {
         VST3Host::init().unwrap();
@@ -0,0 +1,343 @@
+// Work-stealing thread pool for the audio callback
+//
+// `run(count, f)` calls f(0..count) spread over a fixed set of worker
+// threads plus the calling thread, and returns once every call finished.
+// Task indices are handed out as contiguous ranges, one per participant;
+// a participant that runs out steals the back half of someone else's range.
+// Claiming, stealing and the final join are all atomics - the calling
+// thread only makes a syscall to wake workers that went to sleep.
+//
+// Workers spin briefly after each run (the next track level is usually a
+// few microseconds away) and then park until the next run.
+
+use std::sync::atomic::{AtomicBool, AtomicPtr, AtomicU64, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread::{self, JoinHandle, Thread};
+
+/// Spin iterations before an idle worker parks
+const IDLE_SPINS: u32 = 4096;
+
+/// Upper bound on worker threads, whatever the core count
+pub const MAX_POOL_WORKERS: usize = 31;
+
+/// One participant's unclaimed task indices, packed as start << 32 | end
+#[repr(align(64))]
+struct TaskRange(AtomicU64);
+
+fn pack(start: u32, end: u32) -> u64 {
+    ((start as u64) << 32) | end as u64
+}
+
+fn unpack(range: u64) -> (u32, u32) {
+    ((range >> 32) as u32, range as u32)
+}
+
+/// Type-erased pointer to the closure of the run in progress. Lives on
+/// the stack of `run`, which doesn't return before every worker let go
+struct Job {
+    data: *const (),
+    call: unsafe fn(*const (), usize),
+}
+
+unsafe fn call_job<F: Fn(usize) + Sync>(data: *const (), index: usize) {
+    (*(data as *const F))(index)
+}
+
+struct Shared {
+    ranges: Box<[TaskRange]>,
+    job: AtomicPtr<Job>,
+    /// Tasks not yet finished in the current run
+    pending: AtomicUsize,
+    /// Workers currently holding `job`
+    active: AtomicUsize,
+    /// Bumped once per run (and on shutdown) to wake the workers
+    epoch: AtomicU64,
+    sleeping: Box<[AtomicBool]>,
+    shutdown: AtomicBool,
+}
+
+impl Shared {
+    /// Take the next index from a participant's own range
+    fn pop(&self, participant: usize) -> Option<usize> {
+        let range = &self.ranges[participant].0;
+        let mut current = range.load(Ordering::Acquire);
+        loop {
+            let (start, end) = unpack(current);
+            if start >= end {
+                return None;
+            }
+            match range.compare_exchange_weak(current, pack(start + 1, end), Ordering::AcqRel, Ordering::Acquire) {
+                Ok(_) => return Some(start as usize),
+                Err(actual) => current = actual,
+            }
+        }
+    }
+
+    /// Steal the back half of another participant's range. Returns the
+    /// first stolen index; the rest becomes the thief's own range (which
+    /// is empty, or it wouldn't be stealing)
+    fn steal(&self, thief: usize) -> Option<usize> {
+        let count = self.ranges.len();
+        for offset in 1..count {
+            let victim = &self.ranges[(thief + offset) % count].0;
+            let mut current = victim.load(Ordering::Acquire);
+            loop {
+                let (start, end) = unpack(current);
+                if start >= end {
+                    break;
+                }
+                let split = end - (end - start + 1) / 2;
+                match victim.compare_exchange_weak(current, pack(start, split), Ordering::AcqRel, Ordering::Acquire) {
+                    Ok(_) => {
+                        if split + 1 < end {
+                            self.ranges[thief].0.store(pack(split + 1, end), Ordering::Release);
+                        }
+                        return Some(split as usize);
+                    }
+                    Err(actual) => current = actual,
+                }
+            }
+        }
+        None
+    }
+
+    /// Run tasks of the current job until none are left to claim or steal
+    fn work(&self, participant: usize, job: &Job) {
+        while let Some(index) = self.pop(participant).or_else(|| self.steal(participant)) {
+            let call = job.call;
+            let result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| unsafe {
+                call(job.data, index)
+            }));
+            if result.is_err() {
+                eprintln!("❌ [WorkPool] Task {} panicked", index);
+            }
+            self.pending.fetch_sub(1, Ordering::Release);
+        }
+    }
+}
+
+/// Fixed-size pool of worker threads for fork/join work on the audio thread
+pub struct WorkStealingPool {
+    shared: Arc<Shared>,
+    threads: Vec<JoinHandle<()>>,
+    handles: Vec<Thread>,
+    /// Set while a run is in progress; overlapping runs execute inline
+    busy: AtomicBool,
+}
+
+impl WorkStealingPool {
+    /// Create a pool with `workers` threads (the caller of `run` is an
+    /// extra participant, so 0 workers means everything runs inline)
+    pub fn new(workers: usize) -> Self {
+        let workers = workers.min(MAX_POOL_WORKERS);
+        let shared = Arc::new(Shared {
+            ranges: (0..=workers).map(|_| TaskRange(AtomicU64::new(0))).collect(),
+            job: AtomicPtr::new(std::ptr::null_mut()),
+            pending: AtomicUsize::new(0),
+            active: AtomicUsize::new(0),
+            epoch: AtomicU64::new(0),
+            sleeping: (0..workers).map(|_| AtomicBool::new(false)).collect(),
+            shutdown: AtomicBool::new(false),
+        });
+
+        let mut threads = Vec::with_capacity(workers);
+        for participant in 0..workers {
+            let shared = shared.clone();
+            let spawned = thread::Builder::new()
+                .name(format!("audio-worker-{}", participant))
+                .spawn(move || worker_loop(&shared, participant));
+            match spawned {
+                Ok(handle) => threads.push(handle),
+                Err(e) => {
+                    eprintln!("⚠️  [WorkPool] Failed to start worker {}: {}", participant, e);
+                    break;
+                }
+            }
+        }
+
+        // A participant whose thread failed to start keeps its range;
+        // the others steal it empty, so runs still complete
+        let handles = threads.iter().map(|handle| handle.thread().clone()).collect();
+        Self {
+            shared,
+            threads,
+            handles,
+            busy: AtomicBool::new(false),
+        }
+    }
+
+    /// One worker per core, leaving a core for the calling (audio) thread
+    pub fn with_default_workers() -> Self {
+        let cores = thread::available_parallelism().map(|n| n.get()).unwrap_or(1);
+        Self::new(cores.saturating_sub(1))
+    }
+
+    pub fn worker_count(&self) -> usize {
+        self.threads.len()
+    }
+
+    /// Call `f(i)` for every i in 0..count across the pool and the calling
+    /// thread; returns when all calls are done. Runs inline when there is
+    /// nothing to split or another run is already in progress
+    pub fn run<F: Fn(usize) + Sync>(&self, count: usize, f: F) {
+        let workers = self.threads.len();
+        if count <= 1 || workers == 0 || count > u32::MAX as usize || self.busy.swap(true, Ordering::Acquire) {
+            (0..count).for_each(f);
+            return;
+        }
+
+        let shared = &*self.shared;
+        let participants = shared.ranges.len();
+        for (participant, range) in shared.ranges.iter().enumerate() {
+            let start = count * participant / participants;
+            let end = count * (participant + 1) / participants;
+            range.0.store(pack(start as u32, end as u32), Ordering::Relaxed);
+        }
+        shared.pending.store(count, Ordering::Relaxed);
+
+        let job = Job {
+            data: &f as *const F as *const (),
+            call: call_job::<F>,
+        };
+        shared.job.store(&job as *const Job as *mut Job, Ordering::SeqCst);
+        shared.epoch.fetch_add(1, Ordering::SeqCst);
+        for (sleeping, handle) in shared.sleeping.iter().zip(&self.handles) {
+            if sleeping.load(Ordering::SeqCst) {
+                handle.unpark();
+            }
+        }
+
+        // The calling thread is the last participant
+        shared.work(participants - 1, &job);
+
+        // Join: everything claimed has finished...
+        let mut spins = 0u32;
+        while shared.pending.load(Ordering::Acquire) != 0 {
+            spin_wait(&mut spins);
+        }
+        // ...and no worker still holds a pointer to `job`
+        shared.job.store(std::ptr::null_mut(), Ordering::SeqCst);
+        while shared.active.load(Ordering::SeqCst) != 0 {
+            spin_wait(&mut spins);
+        }
+
+        self.busy.store(false, Ordering::Release);
+    }
+}
+
+impl Drop for WorkStealingPool {
+    fn drop(&mut self) {
+        self.shared.shutdown.store(true, Ordering::SeqCst);
+        self.shared.epoch.fetch_add(1, Ordering::SeqCst);
+        for handle in &self.handles {
+            handle.unpark();
+        }
+        for thread in self.threads.drain(..) {
+            let _ = thread.join();
+        }
+    }
+}
+
+fn spin_wait(spins: &mut u32) {
+    if *spins < IDLE_SPINS {
+        *spins += 1;
+        std::hint::spin_loop();
+    } else {
+        thread::yield_now();
+    }
+}
+
+fn worker_loop(shared: &Shared, participant: usize) {
+    // Workers run plugins for the audio callback, so they get the same
+    // FP mode and scheduling class
+    #[cfg(all(feature = "vst3", not(target_os = "ios")))]
+    crate::vst3_host::VST3Host::prepare_realtime_thread();
+
+    // Runs may start before this thread does; the pool was created at epoch 0
+    let mut seen_epoch = 0;
+    loop {
+        // Wait for the next run: spin first, then park
+        let mut spins = 0u32;
+        loop {
+            if shared.shutdown.load(Ordering::Acquire) {
+                return;
+            }
+            let epoch = shared.epoch.load(Ordering::SeqCst);
+            if epoch != seen_epoch {
+                seen_epoch = epoch;
+                break;
+            }
+            if spins < IDLE_SPINS {
+                spins += 1;
+                std::hint::spin_loop();
+                continue;
+            }
+            shared.sleeping[participant].store(true, Ordering::SeqCst);
+            if shared.epoch.load(Ordering::SeqCst) == seen_epoch && !shared.shutdown.load(Ordering::SeqCst) {
+                thread::park();
+            }
+            shared.sleeping[participant].store(false, Ordering::SeqCst);
+        }
+
+        // Register before looking at the job so `run` can't return (and
+        // free it) between the load and our last task
+        shared.active.fetch_add(1, Ordering::SeqCst);
+        let job = shared.job.load(Ordering::SeqCst);
+        if !job.is_null() {
+            // SAFETY: `run` keeps the job alive until `active` drops to zero
+            shared.work(participant, unsafe { &*job });
+        }
+        shared.active.fetch_sub(1, Ordering::SeqCst);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_every_task_runs_exactly_once() {
+        let pool = WorkStealingPool::new(3);
+        for count in [0, 1, 2, 7, 64, 1000] {
+            let hits: Vec<AtomicUsize> = (0..count).map(|_| AtomicUsize::new(0)).collect();
+            pool.run(count, |i| {
+                hits[i].fetch_add(1, Ordering::Relaxed);
+            });
+            assert!(hits.iter().all(|h| h.load(Ordering::Relaxed) == 1), "count {}", count);
+        }
+    }
+
+    #[test]
+    fn test_uneven_tasks_are_stolen() {
+        // The three slow tasks all start out in the first participant's
+        // range; run back to back they'd take 120ms
+        let pool = WorkStealingPool::new(2);
+        let started = std::time::Instant::now();
+        pool.run(9, |i| {
+            if i < 3 {
+                thread::sleep(std::time::Duration::from_millis(40));
+            }
+        });
+        assert!(started.elapsed() < std::time::Duration::from_millis(100));
+    }
+
+    #[test]
+    fn test_repeated_runs_and_inline_pool() {
+        let pool = WorkStealingPool::new(4);
+        let total = AtomicUsize::new(0);
+        for _ in 0..500 {
+            pool.run(9, |i| {
+                total.fetch_add(i, Ordering::Relaxed);
+            });
+        }
+        assert_eq!(total.load(Ordering::Relaxed), 500 * 36);
+
+        let inline = WorkStealingPool::new(0);
+        let sum = AtomicUsize::new(0);
+        inline.run(5, |i| {
+            sum.fetch_add(i, Ordering::Relaxed);
+        });
+        assert_eq!(sum.load(Ordering::Relaxed), 10);
+    }
+
+}
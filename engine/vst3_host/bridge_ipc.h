@@ -0,0 +1,537 @@
+#ifndef VST3_HOST_BRIDGE_IPC_H
+#define VST3_HOST_BRIDGE_IPC_H
+
+// Shared-memory transport between the host and vst3_bridge_helper, which
+// runs a bridged plugin in its own process (see vst3_set_plugin_bridged).
+//
+// Every bridged instance gets one Region, created by the host and mapped by
+// the helper. It holds:
+// - a control block for non-realtime calls (load, setup, parameters,
+//   state): one request at a time, answered in place
+// - one audio block the plugin reads and writes directly, so samples cross
+//   the process boundary without going through a pipe or socket
+// - single-producer rings for the MIDI events and parameter changes that go
+//   with the next audio block
+// Each side waits for the other on a Signal: a counter in the region that
+// the waiter sleeps on with a futex (Linux) or a named semaphore (macOS).
+// Neither side makes a syscall to notify unless the other one is asleep.
+// Process wraps the helper's pid for the host.
+
+#if defined(__linux__) || defined(__APPLE__)
+#define VST3_HOST_HAS_BRIDGE 1
+#else
+#define VST3_HOST_HAS_BRIDGE 0
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "vst3_host.h"
+
+#if VST3_HOST_HAS_BRIDGE
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <semaphore.h>
+#endif
+
+extern char** environ;
+#endif
+
+namespace bridge {
+
+static constexpr uint32_t kMagic = 0x424a4252;  // "BJBR"
+static constexpr uint32_t kVersion = 3;
+
+static constexpr int kChannels = 2;              // Main stereo bus only
+static constexpr int kMaxBlockFrames = 8192;     // Larger blocks are split by the host
+static constexpr size_t kPayloadSize = 16u << 20;  // Largest state chunk or catalog
+static constexpr size_t kMidiRingSize = 4096;
+static constexpr size_t kParamRingSize = 1024;
+static constexpr size_t kErrorSize = 512;
+
+// Control requests. Arguments and results are described next to the
+// helper's handler for each
+enum Command : uint32_t {
+    kLoad = 1,
+    kInitialize,
+    kActivate,
+    kDeactivate,
+    kReset,
+    kReconfigure,
+    kSetOfflineMode,
+    kSetAutoSleep,
+    kGetLatency,
+    kGetBusCount,
+    kGetBusInfo,
+    kGetStats,
+    kResetStats,
+    kGetParameterCount,
+    kGetParameterInfo,
+    kGetParameterCatalog,
+    kGetParameterIndex,
+    kGetParameterValues,
+    kSetParameterValue,
+    kSetParameterValues,
+    kPollParameterChanges,
+    kPollEditorChanges,
+    kGetState,
+    kSetState,
+    kShutdown,
+};
+
+struct MidiEvent {
+    int32_t type;
+    int32_t channel;
+    int32_t data1;
+    int32_t data2;
+    int64_t sample_time;  // On the instance's sample clock
+};
+
+struct ParamChange {
+    uint32_t id;
+    int32_t sample_offset;  // Inside the block it travels with
+    double value;
+};
+
+// Counter one side bumps and the other waits on. `waiting` is set around
+// the waiter's sleep so the notifier can skip the wake-up syscall
+struct alignas(64) SignalWord {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> waiting;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+              std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32-bit");
+
+// Fixed-capacity ring with one producer and one consumer, which may live in
+// different processes
+template <typename T, size_t Capacity>
+struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    alignas(64) std::atomic<uint32_t> head;  // Next slot to read (consumer)
+    alignas(64) std::atomic<uint32_t> tail;  // Next slot to write (producer)
+    T items[Capacity];
+
+    bool push(const T& item) {
+        const uint32_t tail_pos = tail.load(std::memory_order_relaxed);
+        if (tail_pos - head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        items[tail_pos & (Capacity - 1)] = item;
+        tail.store(tail_pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const uint32_t head_pos = head.load(std::memory_order_relaxed);
+        if (head_pos == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[head_pos & (Capacity - 1)];
+        head.store(head_pos + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// One non-realtime call. The host fills in the request fields and payload
+// and notifies `request`; the helper overwrites result, error and payload
+// and notifies `reply`
+struct ControlBlock {
+    uint32_t command;
+    int32_t args[3];
+    double value;
+    uint32_t size;  // Payload bytes (request, then reply)
+    int64_t result;
+    int32_t error_code;  // VST3Result
+    char error[kErrorSize];
+    alignas(64) uint8_t payload[kPayloadSize];
+};
+
+// The block in flight. The host writes the input and the transport the
+// submitting thread is bound to, the helper's plugin reads them and writes
+// the output in place
+struct AudioBlock {
+    int32_t num_frames;
+    int32_t has_input;      // 0 for instruments fed no audio
+    int32_t has_transport;  // 0: process without a context
+    VST3Transport transport;
+    alignas(64) float input[kChannels][kMaxBlockFrames];
+    alignas(64) float output[kChannels][kMaxBlockFrames];
+};
+
+struct Region {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> stopping;  // Set by the host before kShutdown
+
+    // Published by the helper after every block and control request
+    std::atomic<uint32_t> output_silent;
+    std::atomic<uint32_t> latency_changes;  // Helper's vst3_get_plugin_latency_change_count
+    std::atomic<uint64_t> state_generation;
+
+    SignalWord request;  // Host -> helper: control request ready
+    SignalWord reply;    // Helper -> host: control reply ready
+    SignalWord submit;   // Host -> helper: audio block ready
+    SignalWord done;     // Helper -> host: audio block processed
+
+    SpscRing<MidiEvent, kMidiRingSize> midi;
+    SpscRing<ParamChange, kParamRingSize> params;
+    AudioBlock block;
+    ControlBlock control;
+};
+
+#if VST3_HOST_HAS_BRIDGE
+
+// Name for a new region: unique per host process and instance, and short
+// enough for macOS's 31-character limit on shm and semaphore names
+inline std::string region_name(uint32_t id) {
+    return "/bjb-" + std::to_string(getpid()) + "-" + std::to_string(id);
+}
+
+// Process-local end of a SignalWord
+class Signal {
+public:
+    Signal() = default;
+    Signal(const Signal&) = delete;
+    Signal& operator=(const Signal&) = delete;
+    ~Signal() { close(); }
+
+    // `name` is only used on macOS, where the sleep goes through a named
+    // semaphore the host creates and the helper opens
+    bool open(SignalWord* word, const std::string& name, bool create) {
+        word_ = word;
+#ifdef __APPLE__
+        if (create) {
+            name_ = name;  // Only the creator unlinks
+        }
+        sem_ = create ? sem_open(name.c_str(), O_CREAT | O_EXCL, 0600, 0) : sem_open(name.c_str(), 0);
+        return sem_ != SEM_FAILED;
+#else
+        (void)name;
+        (void)create;
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef __APPLE__
+        if (sem_ != SEM_FAILED) {
+            sem_close(sem_);
+            sem_ = SEM_FAILED;
+        }
+#endif
+        word_ = nullptr;
+    }
+
+    // Drop the semaphore's name once both sides have it open
+    void unlink() {
+#ifdef __APPLE__
+        if (!name_.empty()) {
+            sem_unlink(name_.c_str());
+            name_.clear();
+        }
+#endif
+    }
+
+    uint32_t value() const { return word_->seq.load(std::memory_order_acquire); }
+
+    void notify() {
+        word_->seq.fetch_add(1, std::memory_order_seq_cst);
+        if (word_->waiting.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word_->seq), FUTEX_WAKE, INT_MAX,
+                nullptr, nullptr, 0);
+#else
+        sem_post(sem_);
+#endif
+    }
+
+    // Wait until the counter has moved past `seen`. timeout_ms < 0 waits
+    // forever. Returns false on timeout
+    bool wait(uint32_t seen, int timeout_ms) {
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+
+        for (;;) {
+            if (value() != seen) {
+                return true;
+            }
+
+            long remaining_ns = -1;
+            if (timeout_ms >= 0) {
+                auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now());
+                if (remaining.count() <= 0) {
+                    return false;
+                }
+                remaining_ns = static_cast<long>(std::min<int64_t>(remaining.count(), 1000000000LL));
+            }
+
+            word_->waiting.store(1, std::memory_order_seq_cst);
+            if (word_->seq.load(std::memory_order_seq_cst) == seen) {
+                sleep_once(seen, remaining_ns);
+            }
+            word_->waiting.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // One bounded sleep; spurious returns are fine, the caller re-checks
+    void sleep_once(uint32_t seen, long timeout_ns) {
+#ifdef __linux__
+        timespec ts = {0, timeout_ns};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word_->seq), FUTEX_WAIT, seen,
+                timeout_ns < 0 ? nullptr : &ts, nullptr, 0);
+#else
+        (void)seen;
+        // No sem_timedwait on macOS: timed waits poll (they're only used
+        // off the realtime path), untimed ones block
+        if (timeout_ns < 0) {
+            sem_wait(sem_);
+        } else if (sem_trywait(sem_) != 0) {
+            timespec ts = {0, std::min(timeout_ns, 200000L)};
+            nanosleep(&ts, nullptr);
+        }
+#endif
+    }
+
+    SignalWord* word_ = nullptr;
+#ifdef __APPLE__
+    sem_t* sem_ = SEM_FAILED;
+    std::string name_;
+#endif
+};
+
+// Region plus the four signals, as seen from one process
+struct Endpoint {
+    Region* region = nullptr;
+    Signal request;
+    Signal reply;
+    Signal submit;
+    Signal done;
+
+    Endpoint() = default;
+    Endpoint(const Endpoint&) = delete;
+    Endpoint& operator=(const Endpoint&) = delete;
+    ~Endpoint() { close(); }
+
+    // Host side: create and map a fresh region under `name` (see region_name)
+    bool create(const std::string& name, std::string& error) {
+        base_name_ = name;
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            error = std::string("shm_open failed: ") + std::strerror(errno);
+            return false;
+        }
+        name_ = name;
+        if (ftruncate(fd, sizeof(Region)) != 0) {
+            error = std::string("ftruncate failed: ") + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        if (!map(fd, error)) {
+            return false;
+        }
+
+        // The mapping is zero-filled, which is a valid initial state for
+        // everything but the header
+        region->magic = kMagic;
+        region->version = kVersion;
+        return open_signals(true, error);
+    }
+
+    // Helper side: map the region the host created
+    bool open(const std::string& name, std::string& error) {
+        base_name_ = name;
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) {
+            error = std::string("shm_open failed: ") + std::strerror(errno);
+            return false;
+        }
+        if (!map(fd, error)) {
+            return false;
+        }
+        if (region->magic != kMagic || region->version != kVersion) {
+            error = "Bridge region version mismatch";
+            return false;
+        }
+        return open_signals(false, error);
+    }
+
+    // Drop the names once the helper has everything mapped; the memory and
+    // semaphores live on until both sides close them
+    void unlink() {
+        if (!name_.empty()) {
+            shm_unlink(name_.c_str());
+            name_.clear();
+        }
+        request.unlink();
+        reply.unlink();
+        submit.unlink();
+        done.unlink();
+    }
+
+    void close() {
+        unlink();
+        request.close();
+        reply.close();
+        submit.close();
+        done.close();
+        if (region) {
+            munmap(region, sizeof(Region));
+            region = nullptr;
+        }
+    }
+
+private:
+    bool map(int fd, std::string& error) {
+        void* memory = mmap(nullptr, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            error = std::string("mmap failed: ") + std::strerror(errno);
+            return false;
+        }
+        region = static_cast<Region*>(memory);
+        return true;
+    }
+
+    bool open_signals(bool create, std::string& error) {
+        if (!request.open(&region->request, signal_name(0), create) ||
+            !reply.open(&region->reply, signal_name(1), create) ||
+            !submit.open(&region->submit, signal_name(2), create) ||
+            !done.open(&region->done, signal_name(3), create)) {
+            error = std::string("sem_open failed: ") + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    std::string signal_name(int index) const { return base_name_ + "." + std::to_string(index); }
+
+    std::string name_;       // Region name until unlinked
+    std::string base_name_;  // Semaphore names derive from it
+};
+
+// The helper process, as seen from the host
+class Process {
+public:
+    Process() = default;
+    Process(const Process&) = delete;
+    Process& operator=(const Process&) = delete;
+    ~Process() { stop(0); }
+
+    bool spawn(const std::string& path, const std::vector<std::string>& args, std::string& error) {
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(path.c_str()));
+        for (const auto& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        int result = posix_spawn(&pid_, path.c_str(), nullptr, nullptr, argv.data(), environ);
+        if (result != 0) {
+            pid_ = -1;
+            error = "Failed to start bridge helper: " + std::string(std::strerror(result));
+            return false;
+        }
+        return true;
+    }
+
+    bool running() {
+        if (pid_ <= 0) {
+            return false;
+        }
+        int status = 0;
+        if (waitpid(pid_, &status, WNOHANG) == pid_) {
+            pid_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    // Give the helper timeout_ms to exit on its own, then kill it
+    void stop(int timeout_ms) {
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (running() && Clock::now() < deadline) {
+            timespec ts = {0, 5000000};
+            nanosleep(&ts, nullptr);
+        }
+        if (pid_ > 0) {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, nullptr, 0);
+            pid_ = -1;
+        }
+    }
+
+private:
+    pid_t pid_ = -1;
+};
+
+#else  // !VST3_HOST_HAS_BRIDGE
+
+// No shared-memory transport yet: bridged loads fail with an error and the
+// plugin can be loaded in-process instead
+inline std::string region_name(uint32_t id) { return std::to_string(id); }
+
+class Signal {
+public:
+    uint32_t value() const { return 0; }
+    void notify() {}
+    bool wait(uint32_t, int) { return false; }
+};
+
+struct Endpoint {
+    Region* region = nullptr;
+    Signal request;
+    Signal reply;
+    Signal submit;
+    Signal done;
+
+    bool create(const std::string&, std::string& error) {
+        error = "Plugin bridging is not supported on this platform";
+        return false;
+    }
+    bool open(const std::string& name, std::string& error) { return create(name, error); }
+    void unlink() {}
+    void close() {}
+};
+
+class Process {
+public:
+    bool spawn(const std::string&, const std::vector<std::string>&, std::string& error) {
+        error = "Plugin bridging is not supported on this platform";
+        return false;
+    }
+    bool running() { return false; }
+    void stop(int) {}
+};
+
+#endif  // VST3_HOST_HAS_BRIDGE
+
+}  // namespace bridge
+
+#endif  // VST3_HOST_BRIDGE_IPC_H
@@ -0,0 +1,141 @@
+#ifndef VST3_HOST_EDIT_TABLE_H
+#define VST3_HOST_EDIT_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Latest-value table for parameter edits made in a plugin's own editor
+// (IComponentHandler beginEdit / performEdit / endEdit). Each parameter
+// owns one slot: writers overwrite its value and OR in pending flags, so a
+// knob swept at 1 kHz costs one slot, and the UI drains whatever changed
+// once per frame. Open addressing on the parameter ID with a fixed
+// power-of-two capacity; record() and drain() never lock or allocate.
+// Slots are never released - a plugin edits a stable set of parameters.
+class ParamEditTable {
+public:
+    enum Flags : uint32_t {
+        kValueChanged = 1 << 0,
+        kEditBegan = 1 << 1,    // Gesture started (beginEdit)
+        kEditEnded = 1 << 2,    // Gesture finished (endEdit)
+    };
+
+    explicit ParamEditTable(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , slots_(new Slot[mask_ + 1])
+        , pending_(0)
+        , dropped_(0) {
+        for (size_t i = 0; i <= mask_; i++) {
+            slots_[i].id.store(kEmpty, std::memory_order_relaxed);
+            slots_[i].value_bits.store(0, std::memory_order_relaxed);
+            slots_[i].flags.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ParamEditTable(const ParamEditTable&) = delete;
+    ParamEditTable& operator=(const ParamEditTable&) = delete;
+
+    // Record an edit of `id`; `value` is only stored with kValueChanged.
+    // Returns false (and counts a drop) if every slot belongs to another
+    // parameter.
+    bool record(uint32_t id, uint32_t flags, double value) {
+        Slot* slot = find_or_claim(id);
+        if (!slot) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (flags & kValueChanged) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            slot->value_bits.store(bits, std::memory_order_relaxed);
+        }
+        // Release: the value above is visible to whoever takes these flags
+        if (slot->flags.fetch_or(flags, std::memory_order_release) == 0) {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Call fn(id, value, flags) for up to max_changes parameters edited
+    // since the last drain, clearing them. Parameters that don't fit stay
+    // pending for the next call. A single drain may report a whole gesture
+    // (kEditBegan | kValueChanged | kEditEnded), in that order.
+    template <typename F>
+    size_t drain(size_t max_changes, F&& fn) {
+        if (pending_.load(std::memory_order_relaxed) <= 0) {
+            return 0;
+        }
+
+        size_t count = 0;
+        for (size_t i = 0; i <= mask_ && count < max_changes; i++) {
+            Slot& slot = slots_[i];
+            if (slot.flags.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            uint32_t flags = slot.flags.exchange(0, std::memory_order_acquire);
+            if (flags == 0) {
+                continue;
+            }
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+
+            uint64_t bits = slot.value_bits.load(std::memory_order_relaxed);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            fn(slot.id.load(std::memory_order_relaxed), value, flags);
+            count++;
+        }
+        return count;
+    }
+
+    // Edits lost because the table was full, since the last call
+    uint32_t take_dropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kEmpty = 0xffffffff;  // Same as Vst::kNoParamId
+
+    struct Slot {
+        std::atomic<uint32_t> id;
+        std::atomic<uint64_t> value_bits;
+        std::atomic<uint32_t> flags;
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    Slot* find_or_claim(uint32_t id) {
+        if (id == kEmpty) {
+            return nullptr;
+        }
+        size_t index = (static_cast<size_t>(id) * 0x9E3779B1u) & mask_;
+        for (size_t probe = 0; probe <= mask_; probe++, index = (index + 1) & mask_) {
+            Slot& slot = slots_[index];
+            uint32_t current = slot.id.load(std::memory_order_acquire);
+            if (current == id) {
+                return &slot;
+            }
+            if (current == kEmpty) {
+                if (slot.id.compare_exchange_strong(current, id, std::memory_order_acq_rel)) {
+                    return &slot;
+                }
+                // Lost the race; the winner may have claimed it for `id` too
+                if (current == id) {
+                    return &slot;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<int32_t> pending_;  // Slots with flags set (may briefly run ahead or behind)
+    std::atomic<uint32_t> dropped_;
+};
+
+#endif // VST3_HOST_EDIT_TABLE_H
@@ -0,0 +1,186 @@
+#ifndef VST3_HOST_HOST_LOG_H
+#define VST3_HOST_HOST_LOG_H
+
+#include "lockfree_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// Level-filtered logging for code that may run on the audio thread or on a
+// plugin's UI callbacks. Call sites format into a fixed-size record on the
+// stack and push it onto a lock-free ring; a background thread started by
+// vst3_host_init drains the ring to stderr. Producers never lock, allocate
+// or make a syscall - when the ring is full the record is dropped and
+// counted.
+//
+// Built in when VST3_HOST_LOGGING is 1 (default: builds without NDEBUG).
+// Otherwise every VST3_LOG_* call compiles to nothing and its arguments are
+// not evaluated.
+#ifndef VST3_HOST_LOGGING
+#ifdef NDEBUG
+#define VST3_HOST_LOGGING 0
+#else
+#define VST3_HOST_LOGGING 1
+#endif
+#endif
+
+namespace host_log {
+
+enum Level : int {
+    kDebug = 0,
+    kInfo = 1,
+    kWarn = 2,
+    kError = 3,
+    kOff = 4,
+};
+
+static constexpr size_t kMessageSize = 240;
+static constexpr size_t kQueueSize = 1024;
+static constexpr auto kDrainInterval = std::chrono::milliseconds(20);
+
+struct Record {
+    int level;
+    uint64_t time_us;           // Since the logger was created
+    char message[kMessageSize];
+};
+
+#if VST3_HOST_LOGGING
+
+struct Logger {
+    LockFreeQueue<Record> queue{kQueueSize};
+    std::atomic<int> min_level{kInfo};
+    std::atomic<uint32_t> dropped{0};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    // Drain thread, only touched by start()/stop()
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread thread;
+    bool stopping = false;
+};
+
+// Created on first use; vst3_host_init calls start() so that happens
+// before any audio thread logs
+inline Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+inline bool enabled(int level) {
+    return level >= logger().min_level.load(std::memory_order_relaxed);
+}
+
+inline void set_level(int level) {
+    logger().min_level.store(level, std::memory_order_relaxed);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((format(printf, 2, 3)))
+#endif
+inline void write(int level, const char* format, ...) {
+    Logger& log = logger();
+
+    Record record;
+    record.level = level;
+    record.time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - log.epoch).count());
+
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(record.message, kMessageSize, format, args);
+    va_end(args);
+
+    if (!log.queue.try_push(record)) {
+        log.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Write out everything queued so far. Drain thread (or stop()) only
+inline void flush() {
+    static const char* const kNames[] = {"debug", "info", "warn", "error"};
+    Logger& log = logger();
+
+    Record record;
+    bool wrote = false;
+    while (log.queue.try_pop(record)) {
+        const int level = record.level < kDebug || record.level > kError ? kInfo : record.level;
+        std::fprintf(stderr, "[vst3 %llu.%03llu %s] %s\n",
+                     static_cast<unsigned long long>(record.time_us / 1000000),
+                     static_cast<unsigned long long>((record.time_us / 1000) % 1000),
+                     kNames[level], record.message);
+        wrote = true;
+    }
+
+    const uint32_t dropped = log.dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::fprintf(stderr, "[vst3] %u log message(s) dropped\n", dropped);
+        wrote = true;
+    }
+    if (wrote) {
+        std::fflush(stderr);
+    }
+}
+
+inline void start() {
+    Logger& log = logger();
+    std::lock_guard<std::mutex> lock(log.mutex);
+    if (log.thread.joinable()) {
+        return;
+    }
+    log.stopping = false;
+    log.thread = std::thread([&log]() {
+        std::unique_lock<std::mutex> lock(log.mutex);
+        while (!log.stopping) {
+            log.cv.wait_for(lock, kDrainInterval);
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    });
+}
+
+inline void stop() {
+    Logger& log = logger();
+    {
+        std::lock_guard<std::mutex> lock(log.mutex);
+        if (!log.thread.joinable()) {
+            return;
+        }
+        log.stopping = true;
+    }
+    log.cv.notify_all();
+    log.thread.join();
+    flush();
+}
+
+#define VST3_LOG(level, ...)                            \
+    do {                                                \
+        if (host_log::enabled(level)) {                 \
+            host_log::write(level, __VA_ARGS__);        \
+        }                                               \
+    } while (0)
+
+#else  // !VST3_HOST_LOGGING
+
+inline void set_level(int) {}
+inline void start() {}
+inline void stop() {}
+
+#define VST3_LOG(level, ...) do {} while (0)
+
+#endif  // VST3_HOST_LOGGING
+
+} // namespace host_log
+
+#define VST3_LOG_DEBUG(...) VST3_LOG(host_log::kDebug, __VA_ARGS__)
+#define VST3_LOG_INFO(...)  VST3_LOG(host_log::kInfo, __VA_ARGS__)
+#define VST3_LOG_WARN(...)  VST3_LOG(host_log::kWarn, __VA_ARGS__)
+#define VST3_LOG_ERROR(...) VST3_LOG(host_log::kError, __VA_ARGS__)
+
+#endif // VST3_HOST_HOST_LOG_H
@@ -0,0 +1,447 @@
+#ifndef VST3_HOST_PLUGIN_CATALOG_H
+#define VST3_HOST_PLUGIN_CATALOG_H
+
+#include "vst3_host.h"
+#include "scan_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary plugin catalog, built from the scan cache after every scan and
+// mapped read-only by the browser side. Nothing is parsed or copied on open;
+// queries are binary searches over prebuilt indices and hand out spans of
+// record ids that point straight into the mapping.
+//
+// Layout (native byte order, every section 4-byte aligned):
+//   Header
+//   Record  records[record_count]   sorted by folded (ASCII lowercase) name
+//   uint32  by_name[record_count]   0..record_count-1, so "all" is a span too
+//   Group   groups[kIndexCount][..] sorted by folded key
+//   uint32  members[..]             the record ids of every group
+//   char    strings[..]             NUL-terminated, deduplicated
+//
+// A group's members are ascending record ids, which is name order, so the
+// result of any two queries can be intersected with a linear merge.
+namespace plugin_catalog {
+
+static constexpr char kMagic[8] = {'V', 'S', 'T', '3', 'C', 'A', 'T', '\0'};
+static constexpr uint32_t kVersion = 1;
+// Written as 1 by the writer; reads back differently on the other byte order
+static constexpr uint32_t kByteOrderMark = 1;
+
+enum Index : uint32_t {
+    kVendor = 0,       // factory vendor
+    kSubcategory = 1,  // each '|'-separated part of the category string
+    kKind = 2,         // "instrument" and/or "effect"
+    kIndexCount = 3,
+};
+
+static constexpr uint32_t kFlagInstrument = 1u << 0;
+static constexpr uint32_t kFlagEffect = 1u << 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t file_size;
+    uint32_t record_count;
+    uint32_t records_offset;
+    uint32_t by_name_offset;
+    uint32_t groups_offset[kIndexCount];
+    uint32_t group_count[kIndexCount];
+    uint32_t members_offset;
+    uint32_t member_count;
+    uint32_t strings_offset;
+    uint32_t strings_size;
+};
+
+// Strings are offsets into the string table
+struct Record {
+    uint32_t name;
+    uint32_t folded_name;
+    uint32_t vendor;
+    uint32_t version;
+    uint32_t category;
+    uint32_t file_path;
+    uint32_t flags;
+};
+
+struct Group {
+    uint32_t key;    // folded, what lookups compare against
+    uint32_t label;  // as the first plugin in the group spells it
+    uint32_t first;  // into members
+    uint32_t count;
+};
+
+static_assert(sizeof(Header) % 4 == 0 && sizeof(Record) % 4 == 0 && sizeof(Group) % 4 == 0,
+              "catalog sections must stay 4-byte aligned");
+
+inline std::string fold(const char* s) {
+    std::string out(s);
+    for (auto& c : out) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return out;
+}
+
+inline std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos) return std::string();
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Subcategories of a "Fx|Delay" style category string, without duplicates
+inline std::vector<std::string> subcategories(const char* category) {
+    std::vector<std::string> parts;
+    std::string s(category);
+    size_t start = 0;
+    for (;;) {
+        size_t bar = s.find('|', start);
+        std::string part = trim(s.substr(start, bar == std::string::npos ? std::string::npos : bar - start));
+        if (!part.empty() && std::find(parts.begin(), parts.end(), part) == parts.end()) {
+            parts.push_back(part);
+        }
+        if (bar == std::string::npos) break;
+        start = bar + 1;
+    }
+    return parts;
+}
+
+//------------------------------------------------------------------------
+// Writing
+//------------------------------------------------------------------------
+
+class StringTable {
+public:
+    StringTable() { add(""); }
+
+    uint32_t add(const std::string& s) {
+        auto it = offsets_.find(s);
+        if (it != offsets_.end()) return it->second;
+        uint32_t offset = static_cast<uint32_t>(data_.size());
+        data_.insert(data_.end(), s.begin(), s.end());
+        data_.push_back('\0');
+        offsets_.emplace(s, offset);
+        return offset;
+    }
+
+    const std::vector<char>& data() const { return data_; }
+
+private:
+    std::vector<char> data_;
+    std::map<std::string, uint32_t> offsets_;
+};
+
+// The catalog of every plugin in the scan cache, as file contents
+inline std::vector<char> build(const scan_cache::Cache& cache) {
+    std::vector<const VST3PluginInfo*> plugins;
+    for (const auto& [bundle, entry] : cache) {
+        for (const auto& info : entry.plugins) {
+            plugins.push_back(&info);
+        }
+    }
+
+    std::vector<std::string> folded_names(plugins.size());
+    std::vector<uint32_t> order(plugins.size());
+    for (size_t i = 0; i < plugins.size(); i++) {
+        folded_names[i] = fold(plugins[i]->name);
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return folded_names[a] < folded_names[b];
+    });
+
+    StringTable strings;
+    std::vector<Record> records(plugins.size());
+    // folded key -> (label, record ids); ids are pushed in name order
+    std::map<std::string, std::pair<std::string, std::vector<uint32_t>>> groups[kIndexCount];
+    auto add_to_group = [&groups](Index index, const std::string& label, uint32_t id) {
+        auto& group = groups[index][fold(label.c_str())];
+        if (group.second.empty()) group.first = label;
+        if (group.second.empty() || group.second.back() != id) group.second.push_back(id);
+    };
+
+    for (uint32_t id = 0; id < order.size(); id++) {
+        const VST3PluginInfo& info = *plugins[order[id]];
+        Record& record = records[id];
+        record.name = strings.add(info.name);
+        record.folded_name = strings.add(folded_names[order[id]]);
+        record.vendor = strings.add(info.vendor);
+        record.version = strings.add(info.version);
+        record.category = strings.add(info.category);
+        record.file_path = strings.add(info.file_path);
+        record.flags = (info.is_instrument ? kFlagInstrument : 0) | (info.is_effect ? kFlagEffect : 0);
+
+        add_to_group(kVendor, info.vendor, id);
+        for (const auto& part : subcategories(info.category)) {
+            add_to_group(kSubcategory, part, id);
+        }
+        if (info.is_instrument) add_to_group(kKind, "instrument", id);
+        if (info.is_effect) add_to_group(kKind, "effect", id);
+    }
+
+    std::vector<Group> group_tables[kIndexCount];
+    std::vector<uint32_t> members;
+    for (uint32_t index = 0; index < kIndexCount; index++) {
+        for (const auto& [key, group] : groups[index]) {
+            Group g;
+            g.key = strings.add(key);
+            g.label = strings.add(group.first);
+            g.first = static_cast<uint32_t>(members.size());
+            g.count = static_cast<uint32_t>(group.second.size());
+            members.insert(members.end(), group.second.begin(), group.second.end());
+            group_tables[index].push_back(g);
+        }
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    header.record_count = static_cast<uint32_t>(records.size());
+
+    uint32_t offset = sizeof(Header);
+    header.records_offset = offset;
+    offset += static_cast<uint32_t>(records.size() * sizeof(Record));
+    header.by_name_offset = offset;
+    offset += static_cast<uint32_t>(records.size() * sizeof(uint32_t));
+    for (uint32_t index = 0; index < kIndexCount; index++) {
+        header.groups_offset[index] = offset;
+        header.group_count[index] = static_cast<uint32_t>(group_tables[index].size());
+        offset += static_cast<uint32_t>(group_tables[index].size() * sizeof(Group));
+    }
+    header.members_offset = offset;
+    header.member_count = static_cast<uint32_t>(members.size());
+    offset += static_cast<uint32_t>(members.size() * sizeof(uint32_t));
+    header.strings_offset = offset;
+    header.strings_size = static_cast<uint32_t>(strings.data().size());
+    offset += header.strings_size;
+    header.file_size = offset;
+
+    std::vector<char> out(offset);
+    auto put = [&out](uint32_t at, const void* data, size_t size) {
+        if (size) std::memcpy(out.data() + at, data, size);
+    };
+    put(0, &header, sizeof(header));
+    put(header.records_offset, records.data(), records.size() * sizeof(Record));
+    for (uint32_t id = 0; id < header.record_count; id++) {
+        put(header.by_name_offset + id * sizeof(uint32_t), &id, sizeof(id));
+    }
+    for (uint32_t index = 0; index < kIndexCount; index++) {
+        put(header.groups_offset[index], group_tables[index].data(), group_tables[index].size() * sizeof(Group));
+    }
+    put(header.members_offset, members.data(), members.size() * sizeof(uint32_t));
+    put(header.strings_offset, strings.data().data(), strings.data().size());
+    return out;
+}
+
+// Written to a temporary file and renamed over the old catalog like the
+// scan cache. Mappings of the old file stay valid on POSIX
+inline bool save(const std::string& path, const scan_cache::Cache& cache) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path target(path);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), ec);
+    }
+
+    const std::vector<char> data = build(cache);
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            return false;
+        }
+    }
+
+    fs::rename(tmp_path, target, ec);
+    return !ec;
+}
+
+//------------------------------------------------------------------------
+// Reading
+//------------------------------------------------------------------------
+
+struct Span {
+    const uint32_t* ids = nullptr;
+    uint32_t count = 0;
+};
+
+// A mapped (or, on Windows, read-in) catalog file. Immutable once open, so
+// any number of threads can query it
+class Catalog {
+public:
+    Catalog() = default;
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    ~Catalog() {
+#ifndef _WIN32
+        if (mapped_) munmap(mapped_, size_);
+#endif
+    }
+
+    // Checks every offset once here, so lookups never have to
+    static std::unique_ptr<Catalog> open(const std::string& path) {
+        std::unique_ptr<Catalog> catalog(new Catalog());
+#ifdef _WIN32
+        // A mapped file can't be replaced while mapped, and the next scan
+        // renames a new catalog over this one, so read it in instead
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return nullptr;
+        std::streamsize size = in.tellg();
+        if (size < static_cast<std::streamsize>(sizeof(Header))) return nullptr;
+        catalog->buffer_.resize(static_cast<size_t>(size) / sizeof(uint32_t) + 1);
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(catalog->buffer_.data()), size)) return nullptr;
+        catalog->base_ = reinterpret_cast<const char*>(catalog->buffer_.data());
+        catalog->size_ = static_cast<size_t>(size);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+            close(fd);
+            return nullptr;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) return nullptr;
+        catalog->mapped_ = mapped;
+        catalog->base_ = static_cast<const char*>(mapped);
+        catalog->size_ = static_cast<size_t>(st.st_size);
+#endif
+        if (!catalog->validate()) return nullptr;
+        return catalog;
+    }
+
+    uint32_t size() const { return header().record_count; }
+
+    const Record& record(uint32_t id) const { return records()[id]; }
+
+    const char* string(uint32_t offset) const { return base_ + header().strings_offset + offset; }
+
+    Span all() const { return {at<uint32_t>(header().by_name_offset), header().record_count}; }
+
+    uint32_t group_count(Index index) const { return header().group_count[index]; }
+
+    const Group& group(Index index, uint32_t i) const { return groups(index)[i]; }
+
+    Span members(const Group& group) const {
+        return {at<uint32_t>(header().members_offset) + group.first, group.count};
+    }
+
+    // The group whose key matches `key` case-insensitively; empty if none
+    Span find(Index index, const char* key) const {
+        const std::string folded = fold(key);
+        const Group* begin = groups(index);
+        const Group* end = begin + group_count(index);
+        const Group* it = std::lower_bound(begin, end, folded, [this](const Group& g, const std::string& k) {
+            return std::strcmp(string(g.key), k.c_str()) < 0;
+        });
+        if (it == end || folded != string(it->key)) return Span();
+        return members(*it);
+    }
+
+    // Every plugin whose name starts with `prefix`, case-insensitively
+    Span name_prefix(const char* prefix) const {
+        const std::string folded = fold(prefix);
+        const Record* begin = records();
+        const Record* end = begin + size();
+        const Record* first = std::lower_bound(begin, end, folded, [this](const Record& r, const std::string& p) {
+            return std::strcmp(string(r.folded_name), p.c_str()) < 0;
+        });
+        const Record* last = std::partition_point(first, end, [this, &folded](const Record& r) {
+            return std::strncmp(string(r.folded_name), folded.c_str(), folded.size()) == 0;
+        });
+        return {at<uint32_t>(header().by_name_offset) + (first - begin), static_cast<uint32_t>(last - first)};
+    }
+
+private:
+    template <typename T>
+    const T* at(uint32_t offset) const {
+        return reinterpret_cast<const T*>(base_ + offset);
+    }
+
+    const Header& header() const { return *at<Header>(0); }
+    const Record* records() const { return at<Record>(header().records_offset); }
+    const Group* groups(Index index) const { return at<Group>(header().groups_offset[index]); }
+
+    bool section_fits(uint32_t offset, uint64_t count, size_t item) const {
+        return offset % 4 == 0 && offset <= size_ && count * item <= size_ - offset;
+    }
+
+    bool validate() const {
+        const Header& h = header();
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion ||
+            h.byte_order != kByteOrderMark || h.file_size != size_) {
+            return false;
+        }
+        if (!section_fits(h.records_offset, h.record_count, sizeof(Record)) ||
+            !section_fits(h.by_name_offset, h.record_count, sizeof(uint32_t)) ||
+            !section_fits(h.members_offset, h.member_count, sizeof(uint32_t)) ||
+            h.strings_offset > size_ || h.strings_size == 0 || h.strings_size > size_ - h.strings_offset ||
+            base_[h.strings_offset + h.strings_size - 1] != '\0') {
+            return false;
+        }
+
+        auto valid_string = [&h](uint32_t offset) { return offset < h.strings_size; };
+        for (uint32_t id = 0; id < h.record_count; id++) {
+            const Record& r = records()[id];
+            if (!valid_string(r.name) || !valid_string(r.folded_name) || !valid_string(r.vendor) ||
+                !valid_string(r.version) || !valid_string(r.category) || !valid_string(r.file_path) ||
+                at<uint32_t>(h.by_name_offset)[id] >= h.record_count) {
+                return false;
+            }
+        }
+        const uint32_t* members = at<uint32_t>(h.members_offset);
+        for (uint32_t i = 0; i < h.member_count; i++) {
+            if (members[i] >= h.record_count) return false;
+        }
+        for (uint32_t index = 0; index < kIndexCount; index++) {
+            if (!section_fits(h.groups_offset[index], h.group_count[index], sizeof(Group))) return false;
+            for (uint32_t i = 0; i < h.group_count[index]; i++) {
+                const Group& g = groups(static_cast<Index>(index))[i];
+                if (!valid_string(g.key) || !valid_string(g.label) || g.first > h.member_count ||
+                    g.count > h.member_count - g.first) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<uint32_t> buffer_;  // uint32_t for alignment
+#else
+    void* mapped_ = nullptr;
+#endif
+};
+
+} // namespace plugin_catalog
+
+#endif // VST3_HOST_PLUGIN_CATALOG_H
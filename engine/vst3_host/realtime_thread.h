@@ -0,0 +1,111 @@
+#ifndef VST3_HOST_REALTIME_THREAD_H
+#define VST3_HOST_REALTIME_THREAD_H
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VST3_HOST_FP_MXCSR 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VST3_HOST_FP_FPCR 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// Floating-point mode of the calling thread. Denormals (values below about
+// 1e-38) are handled in microcode on most CPUs and can make a decaying
+// reverb or filter tail 10-100x slower; flush-to-zero and
+// denormals-are-zero turn them into 0 instead. The mode is per thread, and
+// plugins are free to change it inside process().
+//
+// x86: MXCSR FTZ (bit 15) and DAZ (bit 6). arm64: FPCR FZ (bit 24), which
+// covers both inputs and results. Elsewhere these are no-ops.
+
+namespace realtime {
+
+#if defined(VST3_HOST_FP_MXCSR)
+static constexpr uint64_t kFlushDenormalBits = 0x8040;
+// Bits 0-5 are sticky exception flags, not mode
+static constexpr uint64_t kFpModeMask = 0xffc0;
+
+inline uint64_t read_fp_control() {
+    return _mm_getcsr();
+}
+
+inline void write_fp_control(uint64_t value) {
+    _mm_setcsr(static_cast<unsigned int>(value));
+}
+#elif defined(VST3_HOST_FP_FPCR)
+static constexpr uint64_t kFlushDenormalBits = uint64_t(1) << 24;
+static constexpr uint64_t kFpModeMask = ~uint64_t(0);
+
+inline uint64_t read_fp_control() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _ReadStatusReg(ARM64_FPCR);
+#else
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(value));
+    return value;
+#endif
+}
+
+inline void write_fp_control(uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _WriteStatusReg(ARM64_FPCR, static_cast<__int64>(value));
+#else
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(value));
+#endif
+}
+#else
+static constexpr uint64_t kFlushDenormalBits = 0;
+static constexpr uint64_t kFpModeMask = 0;
+
+inline uint64_t read_fp_control() {
+    return 0;
+}
+
+inline void write_fp_control(uint64_t) {}
+#endif
+
+// True if the calling thread already flushes denormals
+inline bool flushes_denormals() {
+    return (read_fp_control() & kFlushDenormalBits) == kFlushDenormalBits;
+}
+
+// Turn on flush-to-zero / denormals-are-zero for the calling thread
+inline void enable_flush_denormals() {
+    const uint64_t control = read_fp_control();
+    if ((control & kFlushDenormalBits) != kFlushDenormalBits) {
+        write_fp_control(control | kFlushDenormalBits);
+    }
+}
+
+// Runs a plugin call with denormals flushed and puts the caller's mode back
+// afterwards, whatever the plugin did to it. The control register is only
+// written when something actually differs, so on a prepared thread with a
+// well-behaved plugin this is two register reads.
+class ScopedFlushDenormals {
+public:
+    ScopedFlushDenormals() : saved_(read_fp_control()) {
+        if ((saved_ & kFlushDenormalBits) != kFlushDenormalBits) {
+            write_fp_control(saved_ | kFlushDenormalBits);
+        }
+    }
+
+    ~ScopedFlushDenormals() {
+        if (((read_fp_control() ^ saved_) & kFpModeMask) != 0) {
+            write_fp_control(saved_);
+        }
+    }
+
+    ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+
+private:
+    uint64_t saved_;
+};
+
+}  // namespace realtime
+
+#endif  // VST3_HOST_REALTIME_THREAD_H
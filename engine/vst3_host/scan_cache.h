@@ -0,0 +1,195 @@
+#ifndef VST3_HOST_SCAN_CACHE_H
+#define VST3_HOST_SCAN_CACHE_H
+
+#include "vst3_host.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// On-disk cache of plugin scan results, keyed by bundle path.
+// A bundle is only re-probed when its modification time or size changes.
+//
+// Plain text, one tab-separated record per line:
+//   B  <path> <mtime> <size> <ok>
+//   P  <name> <vendor> <version> <category> <is_instrument> <is_effect>
+// P records belong to the B record before them. The same P format is what
+// vst3_scan_helper prints on stdout for out-of-process scans.
+namespace scan_cache {
+
+static constexpr const char* kHeader = "# vst3 scan cache v1";
+
+struct BundleKey {
+    int64_t mtime = 0;
+    uint64_t size = 0;
+
+    bool operator==(const BundleKey& other) const {
+        return mtime == other.mtime && size == other.size;
+    }
+};
+
+struct BundleEntry {
+    BundleKey key;
+    bool ok = false;  // false = probing failed or crashed, don't retry until the bundle changes
+    std::vector<VST3PluginInfo> plugins;
+};
+
+using Cache = std::map<std::string, BundleEntry>;
+
+// Newest mtime and total size of every file in the bundle. A bundle is a
+// directory, so this catches updates that replace the binary in place.
+inline BundleKey bundle_key(const std::filesystem::path& bundle) {
+    namespace fs = std::filesystem;
+    BundleKey key;
+    std::error_code ec;
+
+    // file_time_type's epoch is implementation defined (and can make current
+    // times negative), so only ever compare against stamps from this clock
+    bool stamped = false;
+    auto stamp = [&key, &stamped](fs::file_time_type t) {
+        int64_t count = static_cast<int64_t>(t.time_since_epoch().count());
+        if (!stamped || count > key.mtime) key.mtime = count;
+        stamped = true;
+    };
+
+    stamp(fs::last_write_time(bundle, ec));
+    if (!fs::is_directory(bundle, ec)) {
+        key.size = fs::file_size(bundle, ec);
+        return key;
+    }
+
+    for (fs::recursive_directory_iterator it(bundle, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (it->is_regular_file(entry_ec)) {
+            key.size += it->file_size(entry_ec);
+            stamp(it->last_write_time(entry_ec));
+        }
+    }
+    return key;
+}
+
+inline std::string sanitize(const char* s) {
+    std::string out(s);
+    for (auto& c : out) {
+        if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+    }
+    return out;
+}
+
+inline std::vector<std::string> split_tabs(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+inline std::string format_plugin(const VST3PluginInfo& info) {
+    return "P\t" + sanitize(info.name) + "\t" + sanitize(info.vendor) + "\t" +
+           sanitize(info.version) + "\t" + sanitize(info.category) + "\t" +
+           (info.is_instrument ? "1" : "0") + "\t" + (info.is_effect ? "1" : "0");
+}
+
+// Parses a P record. file_path is filled in from the owning bundle.
+inline bool parse_plugin(const std::string& line, const std::string& bundle_path, VST3PluginInfo& info) {
+    auto fields = split_tabs(line);
+    if (fields.size() != 7 || fields[0] != "P") {
+        return false;
+    }
+
+    std::memset(&info, 0, sizeof(VST3PluginInfo));
+    std::strncpy(info.name, fields[1].c_str(), sizeof(info.name) - 1);
+    std::strncpy(info.vendor, fields[2].c_str(), sizeof(info.vendor) - 1);
+    std::strncpy(info.version, fields[3].c_str(), sizeof(info.version) - 1);
+    std::strncpy(info.category, fields[4].c_str(), sizeof(info.category) - 1);
+    std::strncpy(info.file_path, bundle_path.c_str(), sizeof(info.file_path) - 1);
+    info.is_instrument = fields[5] == "1";
+    info.is_effect = fields[6] == "1";
+    return true;
+}
+
+// Returns false if the file is missing or not a cache file; `cache` is left
+// with whatever records could be read.
+inline bool load(const std::string& path, Cache& cache) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != kHeader) {
+        return false;
+    }
+
+    BundleEntry* current = nullptr;
+    std::string current_path;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+
+        if (line[0] == 'B') {
+            auto fields = split_tabs(line);
+            current = nullptr;
+            if (fields.size() != 5) continue;
+
+            BundleEntry entry;
+            entry.key.mtime = std::strtoll(fields[2].c_str(), nullptr, 10);
+            entry.key.size = std::strtoull(fields[3].c_str(), nullptr, 10);
+            entry.ok = fields[4] == "1";
+            current_path = fields[1];
+            current = &(cache[current_path] = entry);
+        } else if (line[0] == 'P' && current) {
+            VST3PluginInfo info;
+            if (parse_plugin(line, current_path, info)) {
+                current->plugins.push_back(info);
+            }
+        }
+    }
+    return true;
+}
+
+// Written to a temporary file and renamed over the old cache, so a crash
+// mid-write never leaves a truncated cache behind.
+inline bool save(const std::string& path, const Cache& cache) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path target(path);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), ec);
+    }
+
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << kHeader << "\n";
+        for (const auto& [bundle, entry] : cache) {
+            out << "B\t" << sanitize(bundle.c_str()) << "\t" << entry.key.mtime << "\t"
+                << entry.key.size << "\t" << (entry.ok ? 1 : 0) << "\n";
+            for (const auto& info : entry.plugins) {
+                out << format_plugin(info) << "\n";
+            }
+        }
+        if (!out) {
+            return false;
+        }
+    }
+
+    fs::rename(tmp_path, target, ec);
+    return !ec;
+}
+
+} // namespace scan_cache
+
+#endif // VST3_HOST_SCAN_CACHE_H
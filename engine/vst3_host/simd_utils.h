@@ -0,0 +1,244 @@
+#ifndef VST3_HOST_SIMD_UTILS_H
+#define VST3_HOST_SIMD_UTILS_H
+
+#include <cmath>
+#include <cstddef>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VST3_HOST_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VST3_HOST_SIMD_NEON 1
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VST3_HOST_SIMD_AVX 1
+#endif
+
+// Small vectorized helpers for the audio thread. SSE2 on x86-64 (plus AVX
+// where the build enables it), NEON on arm64, scalar everywhere else. No
+// allocation, no alignment requirements.
+
+// Anything at or below this peak (about -160 dBFS) counts as silence,
+// which also catches denormal tails that never quite reach zero
+static constexpr float kSilenceThreshold = 1.0e-8f;
+
+// True if every sample's magnitude is at or below `threshold`.
+// Bails out at the first loud 16-sample chunk, so live signal is cheap too.
+inline bool buffer_is_silent(const float* data, int num_samples, float threshold = kSilenceThreshold) {
+    int i = 0;
+
+#if defined(VST3_HOST_SIMD_SSE2)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 limit = _mm_set1_ps(threshold);
+    for (; i + 16 <= num_samples; i += 16) {
+        __m128 a = _mm_and_ps(_mm_loadu_ps(data + i), abs_mask);
+        __m128 b = _mm_and_ps(_mm_loadu_ps(data + i + 4), abs_mask);
+        __m128 c = _mm_and_ps(_mm_loadu_ps(data + i + 8), abs_mask);
+        __m128 d = _mm_and_ps(_mm_loadu_ps(data + i + 12), abs_mask);
+        __m128 peak = _mm_max_ps(_mm_max_ps(a, b), _mm_max_ps(c, d));
+        if (_mm_movemask_ps(_mm_cmpgt_ps(peak, limit)) != 0) {
+            return false;
+        }
+    }
+#elif defined(VST3_HOST_SIMD_NEON)
+    for (; i + 16 <= num_samples; i += 16) {
+        float32x4_t a = vabsq_f32(vld1q_f32(data + i));
+        float32x4_t b = vabsq_f32(vld1q_f32(data + i + 4));
+        float32x4_t c = vabsq_f32(vld1q_f32(data + i + 8));
+        float32x4_t d = vabsq_f32(vld1q_f32(data + i + 12));
+        float32x4_t peak = vmaxq_f32(vmaxq_f32(a, b), vmaxq_f32(c, d));
+        if (vmaxvq_f32(peak) > threshold) {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < num_samples; i++) {
+        if (std::fabs(data[i]) > threshold) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Double precision variant for 64-bit (kSample64) buffers
+inline bool buffer_is_silent(const double* data, int num_samples, double threshold = kSilenceThreshold) {
+    int i = 0;
+
+#if defined(VST3_HOST_SIMD_SSE2)
+    const __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d limit = _mm_set1_pd(threshold);
+    for (; i + 8 <= num_samples; i += 8) {
+        __m128d a = _mm_and_pd(_mm_loadu_pd(data + i), abs_mask);
+        __m128d b = _mm_and_pd(_mm_loadu_pd(data + i + 2), abs_mask);
+        __m128d c = _mm_and_pd(_mm_loadu_pd(data + i + 4), abs_mask);
+        __m128d d = _mm_and_pd(_mm_loadu_pd(data + i + 6), abs_mask);
+        __m128d peak = _mm_max_pd(_mm_max_pd(a, b), _mm_max_pd(c, d));
+        if (_mm_movemask_pd(_mm_cmpgt_pd(peak, limit)) != 0) {
+            return false;
+        }
+    }
+#elif defined(VST3_HOST_SIMD_NEON)
+    for (; i + 8 <= num_samples; i += 8) {
+        float64x2_t a = vabsq_f64(vld1q_f64(data + i));
+        float64x2_t b = vabsq_f64(vld1q_f64(data + i + 2));
+        float64x2_t c = vabsq_f64(vld1q_f64(data + i + 4));
+        float64x2_t d = vabsq_f64(vld1q_f64(data + i + 6));
+        float64x2_t peak = vmaxq_f64(vmaxq_f64(a, b), vmaxq_f64(c, d));
+        if (vmaxvq_f64(peak) > threshold) {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < num_samples; i++) {
+        if (std::fabs(data[i]) > threshold) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sample size conversion between float and double buffers
+inline void convert_samples(const float* src, double* dst, int num_samples) {
+    int i = 0;
+
+#if defined(VST3_HOST_SIMD_SSE2)
+    for (; i + 4 <= num_samples; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+#elif defined(VST3_HOST_SIMD_NEON)
+    for (; i + 4 <= num_samples; i += 4) {
+        float32x4_t v = vld1q_f32(src + i);
+        vst1q_f64(dst + i, vcvt_f64_f32(vget_low_f32(v)));
+        vst1q_f64(dst + i + 2, vcvt_high_f64_f32(v));
+    }
+#endif
+
+    for (; i < num_samples; i++) {
+        dst[i] = static_cast<double>(src[i]);
+    }
+}
+
+inline void convert_samples(const double* src, float* dst, int num_samples) {
+    int i = 0;
+
+#if defined(VST3_HOST_SIMD_SSE2)
+    for (; i + 4 <= num_samples; i += 4) {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+#elif defined(VST3_HOST_SIMD_NEON)
+    for (; i + 4 <= num_samples; i += 4) {
+        float32x2_t lo = vcvt_f32_f64(vld1q_f64(src + i));
+        vst1q_f32(dst + i, vcvt_high_f32_f64(lo, vld1q_f64(src + i + 2)));
+    }
+#endif
+
+    for (; i < num_samples; i++) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+// Interleaved stereo (L R L R ...) to planar left / right
+inline void deinterleave_stereo(const float* src, float* left, float* right, int num_frames) {
+    int i = 0;
+
+#if defined(VST3_HOST_SIMD_AVX)
+    for (; i + 8 <= num_frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(src + 2 * i);      // L0 R0 L1 R1 | L2 R2 L3 R3
+        __m256 b = _mm256_loadu_ps(src + 2 * i + 8);  // L4 R4 L5 R5 | L6 R6 L7 R7
+        __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+        __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+        _mm256_storeu_ps(left + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(right + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+#if defined(VST3_HOST_SIMD_SSE2)
+    for (; i + 4 <= num_frames; i += 4) {
+        __m128 a = _mm_loadu_ps(src + 2 * i);      // L0 R0 L1 R1
+        __m128 b = _mm_loadu_ps(src + 2 * i + 4);  // L2 R2 L3 R3
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif defined(VST3_HOST_SIMD_NEON)
+    for (; i + 4 <= num_frames; i += 4) {
+        float32x4x2_t v = vld2q_f32(src + 2 * i);
+        vst1q_f32(left + i, v.val[0]);
+        vst1q_f32(right + i, v.val[1]);
+    }
+#endif
+
+    for (; i < num_frames; i++) {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+}
+
+// Planar left / right to interleaved stereo. `dst` may alias neither input
+inline void interleave_stereo(const float* left, const float* right, float* dst, int num_frames) {
+    int i = 0;
+
+#if defined(VST3_HOST_SIMD_AVX)
+    for (; i + 8 <= num_frames; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        __m256 lo = _mm256_unpacklo_ps(l, r);  // L0 R0 L1 R1 | L4 R4 L5 R5
+        __m256 hi = _mm256_unpackhi_ps(l, r);  // L2 R2 L3 R3 | L6 R6 L7 R7
+        _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+#endif
+#if defined(VST3_HOST_SIMD_SSE2)
+    for (; i + 4 <= num_frames; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#elif defined(VST3_HOST_SIMD_NEON)
+    for (; i + 4 <= num_frames; i += 4) {
+        float32x4x2_t v = {{vld1q_f32(left + i), vld1q_f32(right + i)}};
+        vst2q_f32(dst + 2 * i, v);
+    }
+#endif
+
+    for (; i < num_frames; i++) {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+// Cache-line alignment for scratch buffers the kernels above stream through
+static constexpr std::size_t kSimdAlignment = 64;
+
+// std::vector allocator for kSimdAlignment-aligned storage
+template <typename T>
+struct SimdAllocator {
+    using value_type = T;
+
+    SimdAllocator() = default;
+    template <typename U>
+    SimdAllocator(const SimdAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kSimdAlignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(kSimdAlignment));
+    }
+
+    template <typename U>
+    bool operator==(const SimdAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const SimdAllocator<U>&) const { return false; }
+};
+
+#endif // VST3_HOST_SIMD_UTILS_H
@@ -0,0 +1,324 @@
+// vst3_bridge_helper - runs one bridged plugin in its own process
+//
+// Usage: vst3_bridge_helper <region-name>
+//
+// Started by the host for every plugin loaded with bridging on (see
+// vst3_set_plugin_bridged). Maps the shared region the host created
+// (bridge_ipc.h), loads the plugin through the in-process C API and serves
+// control requests on the main thread and audio blocks on a second thread
+// until the host sends kShutdown or goes away. A plugin that crashes only
+// takes this process down; the host outputs silence for it from then on.
+
+#include "vst3_host.h"
+#include "bridge_ipc.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if VST3_HOST_HAS_BRIDGE
+
+static bridge::Endpoint g_ipc;
+static VST3PluginHandle g_plugin = nullptr;
+static std::atomic<bool> g_stopping{false};
+
+// State the host reads without a round trip
+static void publish_status() {
+    bridge::Region* region = g_ipc.region;
+    region->output_silent.store(g_plugin && vst3_is_output_silent(g_plugin) ? 1 : 0,
+                                std::memory_order_relaxed);
+    region->latency_changes.store(g_plugin ? vst3_get_plugin_latency_change_count(g_plugin) : 0,
+                                  std::memory_order_relaxed);
+    region->state_generation.store(g_plugin ? vst3_get_state_generation(g_plugin) : 0,
+                                   std::memory_order_release);
+}
+
+// Process every block the host submits, with the transport, events and parameter
+// changes queued for it. Input and output stay in the shared block
+static void audio_thread_main() {
+    bridge::Region* region = g_ipc.region;
+    bridge::AudioBlock& block = region->block;
+    uint32_t seen = 0;
+    vst3_prepare_realtime_thread();
+    VST3TransportHandle transport = vst3_transport_create();
+    vst3_transport_bind(transport);
+
+    for (;;) {
+        g_ipc.submit.wait(seen, -1);
+        seen = g_ipc.submit.value();
+        if (g_stopping.load(std::memory_order_acquire)) {
+            vst3_transport_destroy(transport);
+            return;
+        }
+
+        bridge::MidiEvent event;
+        while (region->midi.pop(event)) {
+            vst3_queue_midi_event_at(g_plugin, event.type, event.channel, event.data1, event.data2,
+                                     event.sample_time);
+        }
+        bridge::ParamChange change;
+        while (region->params.pop(change)) {
+            vst3_queue_parameter_change(g_plugin, change.id, change.value, change.sample_offset);
+        }
+
+        // The host's transport for this block, recomputed for the plugins
+        // in this process
+        vst3_transport_update(transport, block.has_transport ? &block.transport : nullptr);
+
+        const int frames = std::clamp(block.num_frames, 0, bridge::kMaxBlockFrames);
+        const bool has_input = block.has_input != 0;
+        if (!vst3_process_block(g_plugin, has_input ? block.input[0] : nullptr,
+                                has_input ? block.input[1] : nullptr,
+                                block.output[0], block.output[1], frames)) {
+            std::memset(block.output[0], 0, sizeof(float) * frames);
+            std::memset(block.output[1], 0, sizeof(float) * frames);
+        }
+
+        publish_status();
+        g_ipc.done.notify();
+    }
+}
+
+// The helper isn't worth keeping around once the host is gone
+static void watchdog_main(pid_t parent) {
+    for (;;) {
+        if (getppid() != parent) {
+            _exit(1);
+        }
+        timespec ts = {0, 250000000};
+        nanosleep(&ts, nullptr);
+    }
+}
+
+template <typename T>
+static void reply_with(bridge::ControlBlock& control, const T* items, size_t count) {
+    control.size = static_cast<uint32_t>(sizeof(T) * count);
+    if (count > 0) {
+        std::memcpy(control.payload, items, control.size);
+    }
+}
+
+// Run one control request against the plugin. Arguments come in args[],
+// value and the payload; the call's return value goes back in result, any
+// output in the payload, and the error the call left (if any) alongside
+static void handle_request(bridge::ControlBlock& control) {
+    const uint32_t request_size = control.size;
+    const int32_t* args = control.args;
+    control.size = 0;
+    control.result = 0;
+    vst3_clear_last_error();
+
+    switch (control.command) {
+        case bridge::kLoad: {
+            // Payload: bundle path, NUL, class name (may be empty), NUL
+            std::string request(reinterpret_cast<const char*>(control.payload), request_size);
+            std::string path = request.c_str();
+            std::string class_name = request.size() > path.size() + 1 ? request.c_str() + path.size() + 1 : "";
+            g_plugin = vst3_load_plugin_class(path.c_str(), class_name.c_str());
+            VST3PluginInfo info;
+            if (g_plugin && vst3_get_plugin_info(g_plugin, &info)) {
+                reply_with(control, &info, 1);
+                control.result = 1;
+            }
+            break;
+        }
+        case bridge::kInitialize:  // value = sample rate, args[0] = max block size
+            control.result = vst3_initialize_plugin(g_plugin, control.value, args[0]);
+            break;
+        case bridge::kActivate:
+            control.result = vst3_activate_plugin(g_plugin);
+            break;
+        case bridge::kDeactivate:
+            control.result = vst3_deactivate_plugin(g_plugin);
+            break;
+        case bridge::kReset:
+            control.result = vst3_reset_plugin(g_plugin);
+            break;
+        case bridge::kReconfigure:  // value = sample rate, args[0] = max block size
+            control.result = vst3_reconfigure(g_plugin, control.value, args[0]);
+            break;
+        case bridge::kSetOfflineMode:  // args = offline, max block size
+            control.result = vst3_set_offline_mode(g_plugin, args[0] != 0, args[1]);
+            break;
+        case bridge::kSetAutoSleep:
+            control.result = vst3_set_auto_sleep(g_plugin, args[0] != 0);
+            break;
+        case bridge::kGetLatency:
+            control.result = vst3_get_latency_samples(g_plugin);
+            break;
+        case bridge::kGetBusCount:  // args[0] = input
+            control.result = vst3_get_bus_count(g_plugin, args[0] != 0);
+            break;
+        case bridge::kGetBusInfo: {  // args = input, index
+            VST3BusInfo info;
+            if (vst3_get_bus_info(g_plugin, args[0] != 0, args[1], &info)) {
+                reply_with(control, &info, 1);
+                control.result = 1;
+            }
+            break;
+        }
+        case bridge::kGetStats: {
+            VST3PluginStats stats;
+            if (vst3_get_plugin_stats(g_plugin, &stats)) {
+                reply_with(control, &stats, 1);
+                control.result = 1;
+            }
+            break;
+        }
+        case bridge::kResetStats:
+            vst3_reset_plugin_stats(g_plugin);
+            break;
+        case bridge::kGetParameterCount:
+            control.result = vst3_get_parameter_count(g_plugin);
+            break;
+        case bridge::kGetParameterInfo: {  // args[0] = index
+            VST3ParameterInfo info;
+            if (vst3_get_parameter_info(g_plugin, args[0], &info)) {
+                reply_with(control, &info, 1);
+                control.result = 1;
+            }
+            break;
+        }
+        case bridge::kGetParameterCatalog: {  // args[0] = max params; result = total
+            constexpr int kFits = static_cast<int>(bridge::kPayloadSize / sizeof(VST3ParameterInfo));
+            auto infos = reinterpret_cast<VST3ParameterInfo*>(control.payload);
+            const int max_params = std::clamp(args[0], 0, kFits);
+            const int total = vst3_get_parameter_catalog(g_plugin, max_params > 0 ? infos : nullptr, max_params);
+            control.result = total;
+            control.size = static_cast<uint32_t>(sizeof(VST3ParameterInfo) * std::clamp(total, 0, max_params));
+            break;
+        }
+        case bridge::kGetParameterIndex:  // args[0] = parameter ID
+            control.result = vst3_get_parameter_index(g_plugin, static_cast<uint32_t>(args[0]));
+            break;
+        case bridge::kGetParameterValues: {  // Payload: IDs; reply: values
+            std::vector<uint32_t> ids(request_size / sizeof(uint32_t));
+            std::memcpy(ids.data(), control.payload, sizeof(uint32_t) * ids.size());
+            std::vector<double> values(ids.size());
+            const int count = vst3_get_parameter_values(g_plugin, ids.data(), values.data(),
+                                                        static_cast<int>(ids.size()));
+            control.result = count;
+            reply_with(control, values.data(), count > 0 ? static_cast<size_t>(count) : 0);
+            break;
+        }
+        case bridge::kSetParameterValue:  // args[0] = parameter ID, value
+            control.result = vst3_set_parameter_value(g_plugin, static_cast<uint32_t>(args[0]), control.value);
+            break;
+        case bridge::kSetParameterValues: {  // Payload: args[0] IDs, then as many values
+            const size_t count = static_cast<size_t>(std::max(args[0], 0));
+            std::vector<uint32_t> ids(count);
+            std::vector<double> values(count);
+            if (request_size >= count * (sizeof(uint32_t) + sizeof(double))) {
+                std::memcpy(ids.data(), control.payload, sizeof(uint32_t) * count);
+                std::memcpy(values.data(), control.payload + sizeof(uint32_t) * count, sizeof(double) * count);
+                control.result = vst3_set_parameter_values(g_plugin, ids.data(), values.data(),
+                                                           static_cast<int>(count));
+            }
+            break;
+        }
+        case bridge::kPollParameterChanges: {  // args[0] = max changes
+            constexpr int kFits = static_cast<int>(bridge::kPayloadSize / sizeof(VST3ParameterChange));
+            auto changes = reinterpret_cast<VST3ParameterChange*>(control.payload);
+            const int count = vst3_poll_parameter_changes(g_plugin, changes, std::clamp(args[0], 0, kFits));
+            control.result = count;
+            control.size = static_cast<uint32_t>(sizeof(VST3ParameterChange) * count);
+            break;
+        }
+        case bridge::kPollEditorChanges: {  // args[0] = max changes
+            constexpr int kFits = static_cast<int>(bridge::kPayloadSize / sizeof(VST3EditorChange));
+            auto changes = reinterpret_cast<VST3EditorChange*>(control.payload);
+            const int count = vst3_poll_editor_changes(g_plugin, changes, std::clamp(args[0], 0, kFits));
+            control.result = count;
+            control.size = static_cast<uint32_t>(sizeof(VST3EditorChange) * count);
+            break;
+        }
+        case bridge::kGetState: {  // Reply: the state chunk; result = its size or -1
+            const void* data = nullptr;
+            int size = 0;
+            VST3StateSnapshot snapshot = vst3_snapshot_state(g_plugin, &data, &size);
+            control.result = -1;
+            if (snapshot && static_cast<size_t>(size) <= bridge::kPayloadSize) {
+                reply_with(control, static_cast<const uint8_t*>(data), static_cast<size_t>(size));
+                control.result = size;
+            } else if (snapshot) {
+                control.error_code = VST3_ERROR_NOT_SUPPORTED;
+                std::snprintf(control.error, sizeof(control.error),
+                              "State chunk too large for the plugin bridge (%d bytes)", size);
+                vst3_release_state(snapshot);
+                return;
+            }
+            vst3_release_state(snapshot);
+            break;
+        }
+        case bridge::kSetState:  // Payload: the state chunk
+            control.result = vst3_set_state(g_plugin, control.payload, static_cast<int>(request_size));
+            break;
+        case bridge::kShutdown:
+            control.result = 1;
+            break;
+        default:
+            control.error_code = VST3_ERROR_INVALID_ARGUMENT;
+            std::snprintf(control.error, sizeof(control.error), "Unknown bridge command %u", control.command);
+            return;
+    }
+
+    control.error_code = vst3_get_last_error_code();
+    std::snprintf(control.error, sizeof(control.error), "%s", vst3_get_last_error());
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <region-name>\n", argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    if (!g_ipc.open(argv[1], error)) {
+        std::fprintf(stderr, "❌ [Bridge] %s\n", error.c_str());
+        return 1;
+    }
+    if (!vst3_host_init()) {
+        std::fprintf(stderr, "❌ [Bridge] %s\n", vst3_get_last_error());
+        return 1;
+    }
+
+    std::thread(watchdog_main, getppid()).detach();
+    std::thread audio_thread(audio_thread_main);
+
+    bridge::ControlBlock& control = g_ipc.region->control;
+    uint32_t seen = 0;
+    bool running = true;
+    while (running) {
+        g_ipc.request.wait(seen, -1);
+        seen = g_ipc.request.value();
+
+        running = control.command != bridge::kShutdown;
+        handle_request(control);
+        publish_status();
+        g_ipc.reply.notify();
+    }
+
+    g_stopping.store(true, std::memory_order_release);
+    g_ipc.submit.notify();
+    audio_thread.join();
+
+    if (g_plugin) {
+        vst3_unload_plugin(g_plugin);
+    }
+    vst3_host_shutdown();
+    g_ipc.close();
+    return 0;
+}
+
+#else  // !VST3_HOST_HAS_BRIDGE
+
+int main() {
+    std::fprintf(stderr, "Plugin bridging is not supported on this platform\n");
+    return 1;
+}
+
+#endif  // VST3_HOST_HAS_BRIDGE
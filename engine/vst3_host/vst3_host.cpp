@@ -17,6 +17,16 @@
 
 #include <stdexcept>
 #include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+#include <list>
+#include <set>
+#include <unordered_map>
 
 // VST3 SDK includes
 #include "pluginterfaces/vst/ivstaudioprocessor.h"
@@ -24,6 +34,7 @@
 #include "pluginterfaces/vst/ivstcomponent.h"
 #include "pluginterfaces/vst/ivstpluginterfacesupport.h"  // For IComponentHandler
 #include "pluginterfaces/vst/ivstprocesscontext.h"
+#include "pluginterfaces/vst/ivstmidicontrollers.h"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
 #include "pluginterfaces/vst/ivstevents.h"
 #include "pluginterfaces/gui/iplugview.h"
@@ -34,13 +45,31 @@
 #include "public.sdk/source/vst/hosting/plugprovider.h"
 #include "public.sdk/source/vst/hosting/eventlist.h"  // For MIDI event queue
 
+#include "bridge_ipc.h"
+#include "edit_table.h"
+#include "host_log.h"
+#include "lockfree_queue.h"
+#include "plugin_catalog.h"
+#include "realtime_thread.h"
+#include "scan_cache.h"
+#include "simd_utils.h"
+
 using namespace Steinberg;
 using namespace Steinberg::Vst;
 
 namespace fs = std::filesystem;
 
-// Global error message
-static std::string g_last_error;
+// Last error of the calling thread. Fixed-size and thread-local, so
+// realtime entry points can report failures without allocating or racing
+// with other threads
+static constexpr size_t kErrorMessageSize = 512;
+
+struct LastError {
+    VST3Result code = VST3_OK;
+    char message[kErrorMessageSize] = {};
+};
+
+static thread_local LastError g_last_error;
 
 // Global host application
 static IPtr<HostApplication> g_host_app;
@@ -48,40 +77,33 @@ static IPtr<HostApplication> g_host_app;
 // Forward declaration
 struct VST3PluginInstance;
 
+// Bumped every time any plugin reports kLatencyChanged, so the host can
+// tell cheaply that something moved. Each instance also counts its own
+// (VST3PluginInstance::latency_changes) to find which one
+static std::atomic<uint32_t> g_latency_change_count{0};
+
 //------------------------------------------------------------------------
 // IComponentHandler implementation - required for plugins to communicate back to host
 // Plugins use this to notify about parameter changes, restarts, etc.
 // Many plugins may crash or malfunction without a valid component handler.
+//
+// Each instance gets its own handler so callbacks can be attributed to it.
+// Implementation after VST3PluginInstance is defined.
 //------------------------------------------------------------------------
 class ComponentHandler : public IComponentHandler
 {
 public:
-    ComponentHandler() : refCount_(1) {}
-
-    // IComponentHandler
-    tresult PLUGIN_API beginEdit(ParamID id) override {
-        fprintf(stderr, "📊 [ComponentHandler] beginEdit: param %u\n", id);
-        fflush(stderr);
-        return kResultOk;  // Accept the edit start
-    }
-
-    tresult PLUGIN_API performEdit(ParamID id, ParamValue valueNormalized) override {
-        // Don't log every performEdit as it can be very frequent
-        return kResultOk;
-    }
+    explicit ComponentHandler(VST3PluginInstance* instance)
+        : instance_(instance), refCount_(1) {}
 
-    tresult PLUGIN_API endEdit(ParamID id) override {
-        fprintf(stderr, "📊 [ComponentHandler] endEdit: param %u\n", id);
-        fflush(stderr);
-        return kResultOk;
-    }
+    // Called before the instance goes away; the plugin may still hold us
+    void detach() { instance_.store(nullptr, std::memory_order_release); }
 
-    tresult PLUGIN_API restartComponent(int32 flags) override {
-        fprintf(stderr, "📊 [ComponentHandler] restartComponent: flags=%d\n", flags);
-        fflush(stderr);
-        // TODO: Handle restart flags properly (kReloadComponent, kIoChanged, etc.)
-        return kResultOk;
-    }
+    // IComponentHandler
+    tresult PLUGIN_API beginEdit(ParamID id) override;
+    tresult PLUGIN_API performEdit(ParamID id, ParamValue valueNormalized) override;
+    tresult PLUGIN_API endEdit(ParamID id) override;
+    tresult PLUGIN_API restartComponent(int32 flags) override;
 
     // FUnknown
     tresult PLUGIN_API queryInterface(const TUID _iid, void** obj) override {
@@ -108,12 +130,12 @@ public:
     }
 
 private:
+    void mark_dirty();
+
+    std::atomic<VST3PluginInstance*> instance_;
     std::atomic<uint32> refCount_;
 };
 
-// Global component handler - shared by all plugin instances
-static IPtr<ComponentHandler> g_component_handler;
-
 //------------------------------------------------------------------------
 // IPlugFrame declaration - implementation after VST3PluginInstance is defined
 // Many plugins (especially Serum) crash if setFrame() is not called before attached()
@@ -162,25 +184,367 @@ private:
     bool resizeRecursionGuard_;
 };
 
+//------------------------------------------------------------------------
+// Parameter change queues (IParameterChanges / IParamValueQueue)
+// All storage is preallocated, so filling the queues and handing them to
+// process() never allocates on the audio thread. Both classes are owned by
+// a VST3PluginInstance and only lent to the plugin for the duration of a
+// process() call, so reference counting is a no-op.
+//------------------------------------------------------------------------
+class ParamValueQueue : public IParamValueQueue
+{
+public:
+    static constexpr int32 kMaxPoints = 64;
+
+    ParamValueQueue() : id_(kNoParamId), count_(0) {}
+
+    void reset(ParamID id) {
+        id_ = id;
+        count_ = 0;
+    }
+
+    ParamID PLUGIN_API getParameterId() override { return id_; }
+    int32 PLUGIN_API getPointCount() override { return count_; }
+
+    tresult PLUGIN_API getPoint(int32 index, int32& sampleOffset, ParamValue& value) override {
+        if (index < 0 || index >= count_) {
+            return kInvalidArgument;
+        }
+        sampleOffset = offsets_[index];
+        value = values_[index];
+        return kResultOk;
+    }
+
+    // Points are kept sorted by sample offset; a second point at the same
+    // offset replaces the first one
+    tresult PLUGIN_API addPoint(int32 sampleOffset, ParamValue value, int32& index) override {
+        int32 pos = count_;
+        while (pos > 0 && offsets_[pos - 1] > sampleOffset) {
+            pos--;
+        }
+        if (pos > 0 && offsets_[pos - 1] == sampleOffset) {
+            values_[pos - 1] = value;
+            index = pos - 1;
+            return kResultOk;
+        }
+        if (count_ >= kMaxPoints) {
+            return kResultFalse;
+        }
+        for (int32 i = count_; i > pos; i--) {
+            offsets_[i] = offsets_[i - 1];
+            values_[i] = values_[i - 1];
+        }
+        offsets_[pos] = sampleOffset;
+        values_[pos] = value;
+        count_++;
+        index = pos;
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID _iid, void** obj) override {
+        if (FUnknownPrivate::iidEqual(_iid, IParamValueQueue::iid) ||
+            FUnknownPrivate::iidEqual(_iid, FUnknown::iid)) {
+            *obj = static_cast<IParamValueQueue*>(this);
+            return kResultOk;
+        }
+        *obj = nullptr;
+        return kNoInterface;
+    }
+    uint32 PLUGIN_API addRef() override { return 1; }
+    uint32 PLUGIN_API release() override { return 1; }
+
+private:
+    ParamID id_;
+    int32 count_;
+    int32 offsets_[kMaxPoints];
+    ParamValue values_[kMaxPoints];
+};
+
+class ParameterChanges : public IParameterChanges
+{
+public:
+    explicit ParameterChanges(int32 max_parameters) : queues_(max_parameters), used_(0) {}
+
+    void clear() { used_ = 0; }
+    bool empty() const { return used_ == 0; }
+
+    int32 PLUGIN_API getParameterCount() override { return used_; }
+
+    IParamValueQueue* PLUGIN_API getParameterData(int32 index) override {
+        return (index >= 0 && index < used_) ? &queues_[index] : nullptr;
+    }
+
+    IParamValueQueue* PLUGIN_API addParameterData(const ParamID& id, int32& index) override {
+        for (int32 i = 0; i < used_; i++) {
+            if (queues_[i].getParameterId() == id) {
+                index = i;
+                return &queues_[i];
+            }
+        }
+        if (used_ >= static_cast<int32>(queues_.size())) {
+            return nullptr;
+        }
+        queues_[used_].reset(id);
+        index = used_;
+        return &queues_[used_++];
+    }
+
+    // Convenience for host-side producers
+    bool add_point(ParamID id, int32 sample_offset, ParamValue value) {
+        int32 queue_index = 0;
+        IParamValueQueue* queue = addParameterData(id, queue_index);
+        int32 point_index = 0;
+        return queue && queue->addPoint(sample_offset, value, point_index) == kResultOk;
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID _iid, void** obj) override {
+        if (FUnknownPrivate::iidEqual(_iid, IParameterChanges::iid) ||
+            FUnknownPrivate::iidEqual(_iid, FUnknown::iid)) {
+            *obj = static_cast<IParameterChanges*>(this);
+            return kResultOk;
+        }
+        *obj = nullptr;
+        return kNoInterface;
+    }
+    uint32 PLUGIN_API addRef() override { return 1; }
+    uint32 PLUGIN_API release() override { return 1; }
+
+private:
+    std::vector<ParamValueQueue> queues_;
+    int32 used_;
+};
+
+// A parameter change waiting to be delivered to the processor
+struct ParamPoint {
+    ParamID id;
+    int32 sample_offset;
+    ParamValue value;
+};
+
+static constexpr size_t kParamQueueSize = 1024;      // Pending changes between blocks
+static constexpr size_t kEditTableSize = 4096;       // Distinct parameters edited in the plugin's editor
+static constexpr int32 kMaxChangedParamsPerBlock = 128;
+
+// A MIDI event waiting to be delivered, stamped with the absolute sample
+// time (see VST3PluginInstance::sample_position) it should play at.
+// Controller messages (CC, pitch bend, aftertouch) have no VST3 event type;
+// they carry their ControllerNumbers value in `controller` and are turned
+// into parameter changes through the instance's MIDI mapping on delivery.
+struct TimedEvent {
+    int64 sample_time;
+    Event event;
+    int32 controller;      // -1 for note events
+    int16 channel;
+    ParamValue value;      // Normalized controller value
+};
+
+static constexpr size_t kMidiQueueSize = 4096;       // Events in flight between producers and the audio thread
+static constexpr int32 kMaxEventsPerBlock = 1024;    // Events handed to a single process() call
+
+// MIDI controller -> parameter table: every controller number
+// (0-127 CC, kAfterTouch, kPitchBend) on each of the 16 channels
+static constexpr int kMidiChannels = 16;
+static constexpr int kMidiMapSize = kMidiChannels * kCountCtrlNumber;
+
+// Timing of process() calls for vst3_get_plugin_stats. Written by the
+// audio thread only (relaxed atomics, no read-modify-write needed) and read
+// from any thread. The histogram for the percentile is logarithmic: times
+// under 8us get a bucket per microsecond, above that 8 buckets per octave.
+static constexpr int kStatsSubBuckets = 8;
+static constexpr int kStatsBuckets = 32 * kStatsSubBuckets;  // Up to ~2^34 us
+
+struct ProcessStats {
+    std::atomic<uint64> calls{0};
+    std::atomic<uint64> total_ns{0};
+    std::atomic<uint64> budget_ns{0};  // Duration of the audio those calls produced
+    std::atomic<uint64> max_ns{0};
+    std::atomic<uint64> last_ns{0};
+    std::atomic<uint64> overruns{0};
+    std::atomic<uint32> histogram[kStatsBuckets] = {};
+
+    void reset() {
+        calls.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        budget_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+        last_ns.store(0, std::memory_order_relaxed);
+        overruns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Host end of a bridged plugin (see vst3_set_plugin_bridged). The plugin
+// itself lives in the helper process; the instance only keeps the setup
+// fields, sample clock and parameter queue it keeps for in-process plugins.
+struct BridgeClient {
+    // Declared first so the helper is killed before the region is unmapped
+    bridge::Endpoint ipc;
+    bridge::Process process;
+
+    // One control request at a time; held for the whole round trip
+    std::mutex control_mutex;
+    std::atomic<bool> failed{false};  // Helper crashed or stopped responding
+    VST3PluginInfo info = {};
+
+    // Audio thread only. Blocks handed to the helper; it's done with all of
+    // them once the done signal has counted as many
+    uint32_t submitted = 0;
+    int pending_output_frames = 0;  // Realtime output not yet played
+    uint32_t latency_changes_seen = 0;
+
+    // Latency the pipeline adds: the last realtime block size
+    std::atomic<int> pipeline_frames{0};
+
+    // Producers push here from any thread; the audio thread moves the events
+    // into the region's ring with the block they belong to
+    LockFreeQueue<bridge::MidiEvent> midi_queue{kMidiQueueSize};
+};
+
 // Plugin instance wrapper
+struct LoadedModule;
+
 struct VST3PluginInstance {
+    // Declared first so the module outlives every interface pointer below
+    std::shared_ptr<LoadedModule> module;
+    size_t class_index = 0;  // Into module->audio_classes
+
     IPtr<IComponent> component;
     IPtr<IAudioProcessor> processor;
     IPtr<IEditController> controller;
     std::string file_path;
-    VST3::Hosting::Module::Ptr module;
+
+    // Set when the plugin runs in a helper process; the interfaces above
+    // are then all null and the C API forwards to the bridge
+    std::unique_ptr<BridgeClient> bridge;
 
     // Audio setup
     double sample_rate;
     int max_block_size;
+    int32 process_mode;         // kRealtime, or kOffline while rendering
+    int realtime_block_size;    // max_block_size to restore after offline mode
+    int32 sample_size;          // kSample32, or kSample64 once negotiated
+    bool prefer_double;         // Ask for kSample64 (vst3_set_double_precision)
     bool initialized;
     bool active;
 
-    // Processing buffers
+    // Processing context - built once in vst3_initialize_plugin and reused
+    // for every process() call. The realtime path only swaps the main bus
+    // channel pointers and numSamples. Only the set matching sample_size is
+    // allocated; the other stays empty.
     ProcessData process_data;
-
-    // Event list for MIDI - concrete class for queuing MIDI events
-    EventList midi_events;
+    std::vector<AudioBusBuffers> input_buses;
+    std::vector<AudioBusBuffers> output_buses;
+    std::vector<Sample32*> input_channel_ptrs;   // Flat storage, sliced per bus
+    std::vector<Sample32*> output_channel_ptrs;
+    std::vector<float> silence_buffer;           // Feeds unused input channels
+    std::vector<float> discard_buffer;           // Receives unused output channels
+    std::vector<Sample64*> input_channel_ptrs64;
+    std::vector<Sample64*> output_channel_ptrs64;
+    std::vector<double> silence_buffer64;
+    std::vector<double> discard_buffer64;
+
+    // One max_block_size slice per channel (inputs first, then outputs) in
+    // the plugin's sample size, for callers whose buffers have the other one.
+    // Float callers of a 64-bit plugin convert through convert_scratch64,
+    // double callers of a 32-bit plugin through convert_scratch32.
+    std::vector<float> convert_scratch32;
+    std::vector<double> convert_scratch64;
+
+    // Planar float scratch for vst3_process_interleaved: input left/right,
+    // then output left/right, interleave_stride floats each (max_block_size
+    // rounded up to whole cache lines, so every slice is aligned)
+    std::vector<float, SimdAllocator<float>> interleave_scratch;
+    int interleave_stride;
+    int total_input_channels;
+    int main_input_channels;
+    int main_output_channels;
+
+    // Bus layout requested before vst3_initialize_plugin: channel count per
+    // bus index (absent = plugin default), and which buses are switched on.
+    // Only the main buses are active unless the host asks for more
+    // (sidechain inputs, multi-out instruments).
+    std::map<int32, int> requested_input_channels;
+    std::map<int32, int> requested_output_channels;
+    std::vector<bool> input_bus_active;
+    std::vector<bool> output_bus_active;
+
+    // Silence handling (see process_sub_blocks). Input silence flags are
+    // set from a peak check of every block; with auto_sleep the plugin is
+    // skipped once idle input has outlasted its tail and its output is quiet.
+    bool auto_sleep;
+    bool sleeping;
+    bool output_silent;     // Every bound output channel was silent last block
+    uint32 tail_samples;    // getTailSamples() at activation
+    uint64 idle_samples;    // Consecutive samples of silent input with no events
+
+    // MIDI events bound for the processor. Producers (MIDI input, UI, the
+    // audio callback itself) push timestamped events into midi_queue without
+    // locking; the audio thread moves them into pending_events, kept sorted by
+    // time, and hands each process() call the ones due in its sub-block
+    // through block_events. Events stamped in the future stay pending.
+    LockFreeQueue<TimedEvent> midi_queue;
+    std::vector<TimedEvent> pending_events;
+    EventList block_events;
+
+    // Absolute sample time of the next block to be processed. Advanced by
+    // the audio thread after every block; read by producers to stamp events
+    std::atomic<int64> sample_position;
+
+    // IProcessContextRequirements flags, counted into the host-wide union
+    // the shared transport context fills (see vst3_transport_update).
+    // Sub-blocks after the first get the context advanced into
+    // sub_block_context
+    uint32 context_requirements;
+    bool context_requirements_counted;
+    ProcessContext sub_block_context;
+
+    // IMidiMapping assignments of the main event bus, indexed by
+    // channel * kCountCtrlNumber + controller (kNoParamId = unassigned).
+    // Filled from the controller off the audio thread; entries are atomic
+    // so the audio thread can read them while a rebuild is in progress
+    std::unique_ptr<std::atomic<ParamID>[]> midi_cc_map;
+    std::atomic<bool> midi_mapping_stale;  // Set by kMidiCCAssignmentChanged
+
+    // kLatencyChanged notifications from this instance (see note_latency_change)
+    std::atomic<uint32_t> latency_changes;
+
+    // process() timing (see record_process_time)
+    ProcessStats stats;
+
+    // Parameter changes bound for the processor. Producers (UI thread,
+    // automation) push into param_queue without locking; the audio thread
+    // drains it into pending_params at the start of each block and hands the
+    // points to process() through input_param_changes.
+    LockFreeQueue<ParamPoint> param_queue;
+    std::vector<ParamPoint> pending_params;
+    ParameterChanges input_param_changes;
+
+    // Parameter changes reported by the processor (meters, auto-learned
+    // values). Filled by the plugin in process(), copied into
+    // output_param_queue on the audio thread and drained by the UI thread
+    // through vst3_poll_parameter_changes.
+    ParameterChanges output_param_changes;
+    LockFreeQueue<ParamPoint> output_param_queue;
+
+    // Bumped whenever the plugin's state may have changed (edits reported
+    // through component_handler, set_state, set_parameter_value)
+    std::atomic<uint64> state_generation;
+    IPtr<ComponentHandler> component_handler;
+
+    // Latest value and gesture flags of every parameter edited in the
+    // plugin's editor since the UI last drained it
+    ParamEditTable edit_table;
+
+    // Decoded ParameterInfo for every parameter, in controller index order,
+    // plus ParamID -> index. Built on first use off the audio thread and
+    // rebuilt after restartComponent(kParamTitlesChanged) marks it stale.
+    std::mutex param_catalog_mutex;
+    std::vector<VST3ParameterInfo> param_catalog;
+    std::unordered_map<ParamID, int32> param_index;
+    bool param_catalog_built;
+    std::atomic<bool> param_catalog_stale;
 
     // Editor view (M7 Phase 1: Native GUI support)
     IPtr<IPlugView> editor_view;
@@ -191,15 +555,127 @@ struct VST3PluginInstance {
     VST3PluginInstance()
         : sample_rate(44100.0)
         , max_block_size(512)
+        , process_mode(kRealtime)
+        , realtime_block_size(512)
+        , sample_size(kSample32)
+        , prefer_double(false)
         , initialized(false)
         , active(false)
-        , midi_events(128)  // Up to 128 MIDI events per buffer
+        , interleave_stride(0)
+        , total_input_channels(0)
+        , main_input_channels(0)
+        , main_output_channels(0)
+        , auto_sleep(false)
+        , sleeping(false)
+        , output_silent(false)
+        , tail_samples(kInfiniteTail)
+        , idle_samples(0)
+        , midi_queue(kMidiQueueSize)
+        , block_events(kMaxEventsPerBlock)
+        , sample_position(0)
+        , context_requirements(0)
+        , context_requirements_counted(false)
+        , sub_block_context()
+        , midi_cc_map(new std::atomic<ParamID>[kMidiMapSize])
+        , midi_mapping_stale(false)
+        , latency_changes(0)
+        , param_queue(kParamQueueSize)
+        , input_param_changes(kMaxChangedParamsPerBlock)
+        , output_param_changes(kMaxChangedParamsPerBlock)
+        , output_param_queue(kParamQueueSize)
+        , state_generation(0)
+        , edit_table(kEditTableSize)
+        , param_catalog_built(false)
+        , param_catalog_stale(false)
         , parent_window(nullptr)
         , editor_open(false) {
-        std::memset(&process_data, 0, sizeof(ProcessData));
+        pending_params.reserve(kParamQueueSize);
+        pending_events.reserve(kMidiQueueSize);
+        for (int i = 0; i < kMidiMapSize; i++) {
+            midi_cc_map[i].store(kNoParamId, std::memory_order_relaxed);
+        }
     }
 };
 
+//------------------------------------------------------------------------
+// ComponentHandler implementation (needs VST3PluginInstance to be complete)
+//------------------------------------------------------------------------
+
+// Anything the plugin reports as a change to its state bumps the
+// instance's state_generation, which autosave compares against the
+// generation it last wrote (see vst3_get_state_generation)
+void ComponentHandler::mark_dirty() {
+    if (auto instance = instance_.load(std::memory_order_acquire)) {
+        instance->state_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Editor gestures are recorded in the instance's edit table for the UI and
+// automation recording (vst3_poll_editor_changes). performEdit values are
+// also forwarded to the processor, which only learns about edits made in
+// the plugin's editor through the host.
+tresult PLUGIN_API ComponentHandler::beginEdit(ParamID id) {
+    VST3_LOG_DEBUG("📊 [ComponentHandler] beginEdit: param %u", id);
+    if (auto instance = instance_.load(std::memory_order_acquire)) {
+        instance->edit_table.record(id, ParamEditTable::kEditBegan, 0.0);
+    }
+    return kResultOk;  // Accept the edit start
+}
+
+tresult PLUGIN_API ComponentHandler::performEdit(ParamID id, ParamValue valueNormalized) {
+    // Don't log every performEdit as it can be very frequent
+    if (auto instance = instance_.load(std::memory_order_acquire)) {
+        instance->edit_table.record(id, ParamEditTable::kValueChanged, valueNormalized);
+        instance->param_queue.try_push(ParamPoint{id, 0, valueNormalized});
+    }
+    mark_dirty();
+    return kResultOk;
+}
+
+tresult PLUGIN_API ComponentHandler::endEdit(ParamID id) {
+    VST3_LOG_DEBUG("📊 [ComponentHandler] endEdit: param %u", id);
+    if (auto instance = instance_.load(std::memory_order_acquire)) {
+        instance->edit_table.record(id, ParamEditTable::kEditEnded, 0.0);
+    }
+    mark_dirty();
+    return kResultOk;
+}
+
+// The host re-reads this instance's latency when its count moves
+static void note_latency_change(VST3PluginInstance* instance) {
+    instance->latency_changes.fetch_add(1, std::memory_order_release);
+    g_latency_change_count.fetch_add(1, std::memory_order_release);
+}
+
+tresult PLUGIN_API ComponentHandler::restartComponent(int32 flags) {
+    VST3_LOG_DEBUG("📊 [ComponentHandler] restartComponent: flags=%d", flags);
+    auto instance = instance_.load(std::memory_order_acquire);
+
+    if (flags & kParamValuesChanged) {
+        // Preset loaded from the plugin's own browser, etc.
+        mark_dirty();
+    }
+    if (flags & kParamTitlesChanged) {
+        if (instance) {
+            instance->param_catalog_stale.store(true, std::memory_order_release);
+        }
+    }
+    if (flags & kLatencyChanged) {
+        if (instance) {
+            note_latency_change(instance);
+        }
+    }
+    if (flags & kMidiCCAssignmentChanged) {
+        // Rebuilt off the audio thread by the next control call on this
+        // instance (see refresh_midi_mapping)
+        if (instance) {
+            instance->midi_mapping_stale.store(true, std::memory_order_release);
+        }
+    }
+    // TODO: Handle the remaining restart flags (kReloadComponent, kIoChanged, etc.)
+    return kResultOk;
+}
+
 //------------------------------------------------------------------------
 // PlugFrame implementation (needs VST3PluginInstance to be complete)
 //------------------------------------------------------------------------
@@ -210,21 +686,18 @@ PlugFrame::PlugFrame(VST3PluginInstance* instance)
 
 tresult PLUGIN_API PlugFrame::resizeView(IPlugView* view, ViewRect* newSize) {
     if (!newSize || !view) {
-        fprintf(stderr, "📐 [PlugFrame] resizeView: invalid args\n");
-        fflush(stderr);
+        VST3_LOG_DEBUG("📐 [PlugFrame] resizeView: invalid args");
         return kInvalidArgument;
     }
 
     int width = newSize->right - newSize->left;
     int height = newSize->bottom - newSize->top;
 
-    fprintf(stderr, "📐 [PlugFrame] resizeView: %dx%d\n", width, height);
-    fflush(stderr);
+    VST3_LOG_DEBUG("📐 [PlugFrame] resizeView: %dx%d", width, height);
 
     // Prevent recursion
     if (resizeRecursionGuard_) {
-        fprintf(stderr, "📐 [PlugFrame] resizeView: recursion guard - returning kResultFalse\n");
-        fflush(stderr);
+        VST3_LOG_DEBUG("📐 [PlugFrame] resizeView: recursion guard - returning kResultFalse");
         return kResultFalse;
     }
 
@@ -233,13 +706,11 @@ tresult PLUGIN_API PlugFrame::resizeView(IPlugView* view, ViewRect* newSize) {
 #ifdef __APPLE__
     // Actually resize the parent NSView to match the plugin's requested size
     if (instance_ && instance_->parent_window) {
-        fprintf(stderr, "📐 [PlugFrame] Resizing NSView %p to %dx%d\n",
-                instance_->parent_window, width, height);
-        fflush(stderr);
+        VST3_LOG_DEBUG("📐 [PlugFrame] Resizing NSView %p to %dx%d",
+                       instance_->parent_window, width, height);
         vst3_resize_nsview(instance_->parent_window, width, height);
     } else {
-        fprintf(stderr, "📐 [PlugFrame] No parent window to resize\n");
-        fflush(stderr);
+        VST3_LOG_DEBUG("📐 [PlugFrame] No parent window to resize");
     }
 #endif
 
@@ -247,8 +718,7 @@ tresult PLUGIN_API PlugFrame::resizeView(IPlugView* view, ViewRect* newSize) {
     ViewRect r;
     if (view->getSize(&r) == kResultTrue) {
         if (r.right - r.left != width || r.bottom - r.top != height) {
-            fprintf(stderr, "📐 [PlugFrame] Calling view->onSize\n");
-            fflush(stderr);
+            VST3_LOG_DEBUG("📐 [PlugFrame] Calling view->onSize");
             view->onSize(newSize);
         }
     }
@@ -257,451 +727,3716 @@ tresult PLUGIN_API PlugFrame::resizeView(IPlugView* view, ViewRect* newSize) {
     return kResultTrue;
 }
 
-// Helper function to set error message
-static void set_error(const std::string& error) {
-    g_last_error = error;
-}
-
-// C API Implementation
-
-bool vst3_host_init() {
-    // Initialize host application
-    if (!g_host_app) {
-        g_host_app = owned(new HostApplication());
-    }
-    // Initialize component handler
-    if (!g_component_handler) {
-        g_component_handler = owned(new ComponentHandler());
-        fprintf(stdout, "✅ VST3 Host: Created global ComponentHandler\n");
-        fflush(stdout);
-    }
-    return true;
+// Record the calling thread's last error (code + message). Never allocates
+static void set_error(VST3Result code, const char* message) {
+    g_last_error.code = code;
+    std::snprintf(g_last_error.message, kErrorMessageSize, "%s", message);
 }
 
-void vst3_host_shutdown() {
-    // Cleanup global resources
-    g_component_handler = nullptr;
-    g_host_app = nullptr;
-    g_last_error.clear();
+static void set_error(VST3Result code, const std::string& message) {
+    set_error(code, message.c_str());
 }
 
-int vst3_scan_directory(const char* directory, VST3ScanCallback callback, void* user_data) {
-    if (!directory || !callback) {
-        set_error("Invalid parameters");
-        return 0;
-    }
-
-    int count = 0;
+//------------------------------------------------------------------------
+// String conversion
+//------------------------------------------------------------------------
 
-    try {
-        fs::path dir_path(directory);
-        if (!fs::exists(dir_path) || !fs::is_directory(dir_path)) {
-            set_error("Directory does not exist");
-            return 0;
+// UTF-16 (String128 etc., at most src_len units) to NUL-terminated UTF-8,
+// truncated at a code point boundary to fit `dst_size` bytes
+template <size_t src_len>
+static void utf16_to_utf8(const char16 (&src)[src_len], char* dst, size_t dst_size) {
+    if (dst_size == 0) return;
+
+    size_t out = 0;
+    for (size_t i = 0; i < src_len && src[i]; i++) {
+        uint32_t cp = static_cast<uint16_t>(src[i]);
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint32_t low = i + 1 < src_len ? static_cast<uint16_t>(src[i + 1]) : 0;
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            } else {
+                cp = 0xFFFD;  // Unpaired surrogate
+            }
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            cp = 0xFFFD;
         }
 
-        // Scan for .vst3 bundles/folders
-        fprintf(stdout, "🔍 Scanning directory: %s\n", directory);
-        fflush(stdout);
-
-        for (const auto& entry : fs::recursive_directory_iterator(dir_path)) {
-            if (entry.is_directory() && entry.path().extension() == ".vst3") {
-                std::string plugin_path = entry.path().string();
-                fprintf(stdout, "📦 Found VST3 bundle: %s\n", plugin_path.c_str());
-                fflush(stdout);
-
-                // Try to load the module
-                std::string error;
-                auto module = VST3::Hosting::Module::create(plugin_path, error);
-                if (!module) {
-                    fprintf(stderr, "❌ Failed to load module: %s - Error: %s\n",
-                            plugin_path.c_str(), error.c_str());
-                    fflush(stderr);
-                    continue;
-                }
-                fprintf(stdout, "✅ Module loaded successfully: %s\n", plugin_path.c_str());
-                fflush(stdout);
-
-                auto factory = module->getFactory();
-
-                // Get factory info
-                PFactoryInfo factory_info;
-                factory.get()->getFactoryInfo(&factory_info);
-
-                // Iterate through all class infos
-                for (const auto& class_info : factory.classInfos()) {
-                    // Check if it's an audio module component
-                    if (class_info.category() == kVstAudioEffectClass) {
-                        VST3PluginInfo info;
-                        std::memset(&info, 0, sizeof(VST3PluginInfo));
-
-                        std::strncpy(info.name, class_info.name().c_str(), sizeof(info.name) - 1);
-                        std::strncpy(info.vendor, factory_info.vendor, sizeof(info.vendor) - 1);
-                        std::strncpy(info.file_path, plugin_path.c_str(), sizeof(info.file_path) - 1);
-
-                        // Detect plugin type from subcategories and by checking MIDI input capability
-                        std::string subcat_str = class_info.subCategoriesString();
-                        std::string plugin_name = class_info.name();
-                        std::strncpy(info.category, subcat_str.c_str(), sizeof(info.category) - 1);
-
-                        info.is_instrument = false;
-                        info.is_effect = false;
-
-                        // First, check if it's an instrument by looking at subcategories
-                        if (subcat_str.find("Instrument") != std::string::npos ||
-                            subcat_str.find("Synth") != std::string::npos ||
-                            subcat_str.find("Sampler") != std::string::npos ||
-                            subcat_str.find("Drum") != std::string::npos ||
-                            subcat_str.find("Piano") != std::string::npos ||
-                            subcat_str.find("SoundGenerator") != std::string::npos ||
-                            subcat_str.find("Generator") != std::string::npos) {
-                            info.is_instrument = true;
-                        }
-
-                        // Check if it's an effect by looking at subcategories
-                        if (subcat_str.find("Fx") != std::string::npos ||
-                            subcat_str.find("Effect") != std::string::npos) {
-                            info.is_effect = true;
-                        }
-
-                        // Use plugin name to detect type - most reliable approach
-                        // .vst3 bundles contain multiple classes (e.g., Serum 2 and Serum 2 FX)
-
-                        // If plugin name contains "FX" (case-insensitive), it's explicitly an effect
-                        std::string name_upper = plugin_name;
-                        std::transform(name_upper.begin(), name_upper.end(), name_upper.begin(),
-                                     [](unsigned char c) { return std::toupper(c); });
-                        if (name_upper.find(" FX") != std::string::npos || name_upper.find(" FX ") != std::string::npos) {
-                            info.is_effect = true;
-                            info.is_instrument = false;
-                        }
-
-                        // If still unknown, DEFAULT to INSTRUMENT
-                        // Most synthesizers don't declare proper VST3 subcategories,
-                        // so defaulting to instrument makes more sense than defaulting to effect.
-                        // Serum, Serum 2, etc. will correctly be identified as instruments.
-                        if (!info.is_instrument && !info.is_effect) {
-                            info.is_instrument = true;
-                        }
-
-                        // DEBUG: Log plugin detection
-                        fprintf(stdout, "🔍 VST3 Plugin: '%s' | SubCat: '%s' | Instrument: %d | Effect: %d\n",
-                                plugin_name.c_str(), subcat_str.c_str(), info.is_instrument, info.is_effect);
-                        fflush(stdout);
-
-                        callback(&info, user_data);
-                        count++;
-                    }
-                }
-            }
+        char bytes[4];
+        size_t n;
+        if (cp < 0x80) {
+            bytes[0] = static_cast<char>(cp);
+            n = 1;
+        } else if (cp < 0x800) {
+            bytes[0] = static_cast<char>(0xC0 | (cp >> 6));
+            bytes[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            n = 2;
+        } else if (cp < 0x10000) {
+            bytes[0] = static_cast<char>(0xE0 | (cp >> 12));
+            bytes[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            bytes[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            n = 3;
+        } else {
+            bytes[0] = static_cast<char>(0xF0 | (cp >> 18));
+            bytes[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            bytes[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            bytes[3] = static_cast<char>(0x80 | (cp & 0x3F));
+            n = 4;
         }
-    } catch (const std::exception& e) {
-        set_error(std::string("Scan error: ") + e.what());
-        return count;
-    }
 
-    return count;
+        if (out + n >= dst_size) break;
+        std::memcpy(dst + out, bytes, n);
+        out += n;
+    }
+    dst[out] = '\0';
 }
 
-int vst3_scan_standard_locations(VST3ScanCallback callback, void* user_data) {
-    int total = 0;
-
-    std::vector<std::string> locations;
+//------------------------------------------------------------------------
+// Processing context
+//------------------------------------------------------------------------
 
-#ifdef _WIN32
-    // Standard VST3 locations on Windows
-    locations.push_back("C:\\Program Files\\Common Files\\VST3");
-    locations.push_back("C:\\Program Files (x86)\\Common Files\\VST3");
+// Fallback arrangement for a bus whose arrangement the plugin won't report
+static SpeakerArrangement default_arrangement(IComponent* component, BusDirection dir, int32 index) {
+    BusInfo info = {};
+    if (component->getBusInfo(kAudio, dir, index, info) == kResultOk && info.channelCount == 1) {
+        return SpeakerArr::kMono;
+    }
+    return SpeakerArr::kStereo;
+}
 
-    // User VST3 directory
-    char* appdata = getenv("APPDATA");
-    if (appdata) {
-        locations.push_back(std::string(appdata) + "\\VST3");
+// Speaker arrangement for a requested channel count, kEmpty if unsupported
+static SpeakerArrangement arrangement_for_channels(int channels) {
+    switch (channels) {
+        case 1: return SpeakerArr::kMono;
+        case 2: return SpeakerArr::kStereo;
+        case 3: return SpeakerArr::k30Cine;
+        case 4: return SpeakerArr::k40Music;
+        case 5: return SpeakerArr::k50;
+        case 6: return SpeakerArr::k51;
+        case 8: return SpeakerArr::k71Cine;
+        default: return SpeakerArr::kEmpty;
     }
+}
 
-    // Also check LOCALAPPDATA for some plugins
-    char* localappdata = getenv("LOCALAPPDATA");
-    if (localappdata) {
-        locations.push_back(std::string(localappdata) + "\\Programs\\Common\\VST3");
+// Size the per-bus active flags to the plugin's bus counts (main buses on)
+static void ensure_bus_state(VST3PluginInstance* instance) {
+    const size_t num_inputs = std::max(0, instance->component->getBusCount(kAudio, kInput));
+    const size_t num_outputs = std::max(0, instance->component->getBusCount(kAudio, kOutput));
+    if (instance->input_bus_active.size() != num_inputs) {
+        instance->input_bus_active.assign(num_inputs, false);
+        if (num_inputs > 0) instance->input_bus_active[0] = true;
     }
-#elif __APPLE__
-    // Standard VST3 locations on macOS
-    locations.push_back("/Library/Audio/Plug-Ins/VST3");
-    const char* home = getenv("HOME");
-    if (home) {
-        locations.push_back(std::string(home) + "/Library/Audio/Plug-Ins/VST3");
+    if (instance->output_bus_active.size() != num_outputs) {
+        instance->output_bus_active.assign(num_outputs, false);
+        if (num_outputs > 0) instance->output_bus_active[0] = true;
     }
-#elif __linux__
-    // Standard VST3 locations on Linux
-    const char* home = getenv("HOME");
-    if (home) {
-        locations.push_back(std::string(home) + "/.vst3");
+}
+
+// Per-sample-size views of the instance buffers. Everything that touches
+// channel pointers is written once against these and instantiated for float
+// (kSample32) and double (kSample64).
+template <typename Sample>
+static Sample** bus_channels(AudioBusBuffers& bus) {
+    if constexpr (std::is_same_v<Sample, double>) {
+        return bus.channelBuffers64;
+    } else {
+        return bus.channelBuffers32;
     }
-    locations.push_back("/usr/lib/vst3");
-    locations.push_back("/usr/local/lib/vst3");
-#endif
+}
 
-    for (const auto& location : locations) {
-        total += vst3_scan_directory(location.c_str(), callback, user_data);
+template <typename Sample>
+static Sample* silence_of(VST3PluginInstance* instance) {
+    if constexpr (std::is_same_v<Sample, double>) {
+        return instance->silence_buffer64.data();
+    } else {
+        return instance->silence_buffer.data();
     }
+}
 
-    return total;
+template <typename Sample>
+static Sample* discard_of(VST3PluginInstance* instance) {
+    if constexpr (std::is_same_v<Sample, double>) {
+        return instance->discard_buffer64.data();
+    } else {
+        return instance->discard_buffer.data();
+    }
 }
 
-VST3PluginHandle vst3_load_plugin(const char* file_path) {
-    if (!file_path) {
-        set_error("Invalid file path");
-        return nullptr;
+// Conversion slice for a flat channel index (inputs first, then outputs)
+template <typename Sample>
+static Sample* scratch_of(VST3PluginInstance* instance, int slot) {
+    const size_t offset = static_cast<size_t>(slot) * std::max(1, instance->max_block_size);
+    if constexpr (std::is_same_v<Sample, double>) {
+        return instance->convert_scratch64.data() + offset;
+    } else {
+        return instance->convert_scratch32.data() + offset;
     }
+}
 
-    if (!g_host_app) {
-        set_error("Host not initialized. Call vst3_host_init() first");
-        return nullptr;
+// Point every channel at the shared silence/discard buffers and mark
+// inactive inputs silent. Callers that bind their own buffers for a block
+// restore this afterwards so no pointer outlives the call that set it.
+static void reset_bus_bindings(VST3PluginInstance* instance) {
+    std::fill(instance->input_channel_ptrs.begin(), instance->input_channel_ptrs.end(),
+              instance->silence_buffer.data());
+    std::fill(instance->output_channel_ptrs.begin(), instance->output_channel_ptrs.end(),
+              instance->discard_buffer.data());
+    std::fill(instance->input_channel_ptrs64.begin(), instance->input_channel_ptrs64.end(),
+              instance->silence_buffer64.data());
+    std::fill(instance->output_channel_ptrs64.begin(), instance->output_channel_ptrs64.end(),
+              instance->discard_buffer64.data());
+
+    for (size_t i = 0; i < instance->input_buses.size(); i++) {
+        auto& bus = instance->input_buses[i];
+        // Aux inputs are only fed through vst3_process_buses
+        bus.silenceFlags = (i == 0 || bus.numChannels >= 64) ? 0 : ((1ULL << bus.numChannels) - 1);
+    }
+    for (auto& bus : instance->output_buses) {
+        bus.silenceFlags = 0;
     }
+}
 
-    try {
-        auto instance = std::make_unique<VST3PluginInstance>();
-        instance->file_path = file_path;
+// Size the interleave scratch for the current max_block_size. Runs
+// whenever the block size changes, never on the audio thread
+static void size_interleave_scratch(VST3PluginInstance* instance) {
+    constexpr int kFloatsPerLine = static_cast<int>(kSimdAlignment / sizeof(float));
+    const int block = std::max(1, instance->max_block_size);
+    instance->interleave_stride = (block + kFloatsPerLine - 1) / kFloatsPerLine * kFloatsPerLine;
+    instance->interleave_scratch.assign(static_cast<size_t>(instance->interleave_stride) * 4, 0.0f);
+}
 
-        // Load the module
-        std::string error;
-        auto module = VST3::Hosting::Module::create(file_path, error);
-        if (!module) {
-            set_error("Failed to load module: " + error);
-            return nullptr;
+// Negotiate bus arrangements and build the reusable ProcessData.
+// Main buses (index 0) are requested as stereo and aux buses keep the
+// plugin's own arrangement, unless vst3_set_bus_channels asked for something
+// else. Every bus gets channel pointers - unbound channels are wired to the
+// shared silence/discard buffers so the plugin always sees valid memory.
+// Buffers are allocated in instance->sample_size.
+// Must be called before setupProcessing(), while the plugin is not processing.
+static void build_process_context(VST3PluginInstance* instance) {
+    IComponent* component = instance->component;
+    IAudioProcessor* processor = instance->processor;
+
+    const int32 num_inputs = std::max(0, component->getBusCount(kAudio, kInput));
+    const int32 num_outputs = std::max(0, component->getBusCount(kAudio, kOutput));
+
+    auto requested = [](const std::map<int32, int>& channels, int32 index) {
+        auto it = channels.find(index);
+        return it != channels.end() ? arrangement_for_channels(it->second) : SpeakerArr::kEmpty;
+    };
+
+    std::vector<SpeakerArrangement> input_arr(num_inputs);
+    std::vector<SpeakerArrangement> output_arr(num_outputs);
+    for (int32 i = 0; i < num_inputs; i++) {
+        input_arr[i] = requested(instance->requested_input_channels, i);
+        if (input_arr[i] != SpeakerArr::kEmpty) continue;
+        if (i == 0 || processor->getBusArrangement(kInput, i, input_arr[i]) != kResultOk) {
+            input_arr[i] = (i == 0) ? SpeakerArr::kStereo : default_arrangement(component, kInput, i);
+        }
+    }
+    for (int32 i = 0; i < num_outputs; i++) {
+        output_arr[i] = requested(instance->requested_output_channels, i);
+        if (output_arr[i] != SpeakerArr::kEmpty) continue;
+        if (i == 0 || processor->getBusArrangement(kOutput, i, output_arr[i]) != kResultOk) {
+            output_arr[i] = (i == 0) ? SpeakerArr::kStereo : default_arrangement(component, kOutput, i);
         }
+    }
 
-        instance->module = module;
+    if (processor->setBusArrangements(input_arr.data(), num_inputs,
+                                      output_arr.data(), num_outputs) != kResultTrue) {
+        // Plugin rejected our request - use whatever layout it settled on
+        for (int32 i = 0; i < num_inputs; i++) {
+            processor->getBusArrangement(kInput, i, input_arr[i]);
+        }
+        for (int32 i = 0; i < num_outputs; i++) {
+            processor->getBusArrangement(kOutput, i, output_arr[i]);
+        }
+    }
 
-        auto factory = module->getFactory();
+    int32 total_inputs = 0;
+    int32 total_outputs = 0;
+    for (auto arr : input_arr) total_inputs += SpeakerArr::getChannelCount(arr);
+    for (auto arr : output_arr) total_outputs += SpeakerArr::getChannelCount(arr);
+
+    // Buffers in the negotiated sample size; the other set is released
+    const bool is64 = instance->sample_size == kSample64;
+    const size_t block = static_cast<size_t>(std::max(1, instance->max_block_size));
+    const size_t scratch = block * static_cast<size_t>(total_inputs + total_outputs);
+    instance->silence_buffer.assign(is64 ? 0 : block, 0.0f);
+    instance->discard_buffer.assign(is64 ? 0 : block, 0.0f);
+    instance->convert_scratch32.assign(is64 ? 0 : scratch, 0.0f);
+    instance->input_channel_ptrs.assign(is64 ? 0 : total_inputs, nullptr);
+    instance->output_channel_ptrs.assign(is64 ? 0 : total_outputs, nullptr);
+    instance->silence_buffer64.assign(is64 ? block : 0, 0.0);
+    instance->discard_buffer64.assign(is64 ? block : 0, 0.0);
+    instance->convert_scratch64.assign(is64 ? scratch : 0, 0.0);
+    instance->input_channel_ptrs64.assign(is64 ? total_inputs : 0, nullptr);
+    instance->output_channel_ptrs64.assign(is64 ? total_outputs : 0, nullptr);
+    instance->total_input_channels = total_inputs;
+    size_interleave_scratch(instance);
+
+    instance->input_buses.assign(num_inputs, AudioBusBuffers());
+    instance->output_buses.assign(num_outputs, AudioBusBuffers());
+
+    int32 offset = 0;
+    for (int32 i = 0; i < num_inputs; i++) {
+        auto& bus = instance->input_buses[i];
+        bus.numChannels = SpeakerArr::getChannelCount(input_arr[i]);
+        if (is64) {
+            bus.channelBuffers64 = instance->input_channel_ptrs64.data() + offset;
+        } else {
+            bus.channelBuffers32 = instance->input_channel_ptrs.data() + offset;
+        }
+        offset += bus.numChannels;
+    }
+    offset = 0;
+    for (int32 i = 0; i < num_outputs; i++) {
+        auto& bus = instance->output_buses[i];
+        bus.numChannels = SpeakerArr::getChannelCount(output_arr[i]);
+        if (is64) {
+            bus.channelBuffers64 = instance->output_channel_ptrs64.data() + offset;
+        } else {
+            bus.channelBuffers32 = instance->output_channel_ptrs.data() + offset;
+        }
+        offset += bus.numChannels;
+    }
+    reset_bus_bindings(instance);
+
+    instance->main_input_channels = num_inputs > 0 ? instance->input_buses[0].numChannels : 0;
+    instance->main_output_channels = num_outputs > 0 ? instance->output_buses[0].numChannels : 0;
+
+    ProcessData& data = instance->process_data;
+    data = ProcessData();
+    data.processMode = instance->process_mode;
+    data.symbolicSampleSize = instance->sample_size;
+    data.numSamples = 0;
+    data.numInputs = num_inputs;
+    data.numOutputs = num_outputs;
+    data.inputs = num_inputs > 0 ? instance->input_buses.data() : nullptr;
+    data.outputs = num_outputs > 0 ? instance->output_buses.data() : nullptr;
+    data.inputParameterChanges = nullptr;
+    data.outputParameterChanges = nullptr;
+    data.inputEvents = nullptr;
+    data.outputEvents = nullptr;
+    data.processContext = nullptr;
 
-        // Find the first audio effect class
-        for (const auto& class_info : factory.classInfos()) {
-            if (class_info.category() == kVstAudioEffectClass) {
-                // Create the component using modern API
-                auto component = factory.createInstance<IComponent>(class_info.ID());
-                if (!component) {
-                    set_error("Failed to create component instance");
-                    return nullptr;
-                }
+    fprintf(stdout, "🎛️ [C++] Process context: %d input bus(es) / %d ch main, %d output bus(es) / %d ch main, %d-bit\n",
+            num_inputs, instance->main_input_channels, num_outputs, instance->main_output_channels,
+            is64 ? 64 : 32);
+    fflush(stdout);
+}
 
-                instance->component = component;
+//------------------------------------------------------------------------
+// Transport context
+//------------------------------------------------------------------------
 
-                // Initialize the component
-                if (component->initialize(g_host_app) != kResultOk) {
-                    set_error("Failed to initialize component");
-                    return nullptr;
-                }
+// IProcessContextRequirements defines kNeedSystemTime .. kNeedTransportState;
+// a plugin without the interface is given all of them
+static constexpr int kContextRequirementFlags = 11;
+static constexpr uint32 kAllContextRequirements = (1u << kContextRequirementFlags) - 1;
+static constexpr int32 kMidiClocksPerQuarter = 24;
+
+// How many instances asked for each flag, and the union of the flags still
+// asked for, which vst3_transport_update fills
+static std::mutex g_context_requirements_mutex;
+static uint32 g_context_requirement_counts[kContextRequirementFlags] = {};
+static std::atomic<uint32> g_context_requirements{0};
+
+// One block's ProcessContext, computed in vst3_transport_update and shared
+// by every instance processing on a thread bound to it
+struct TransportContext {
+    VST3Transport transport = {};
+    uint32 requirements = 0;  // g_context_requirements at the update
+    int64 system_time = 0;    // Steady clock (ns) at the update
+    bool valid = false;
+    ProcessContext context = {};
+};
 
-                // Get the audio processor interface
-                auto processor = FUnknownPtr<IAudioProcessor>(component);
-                if (processor) {
-                    instance->processor = processor;
+static thread_local TransportContext* g_bound_transport = nullptr;
+
+// Caller holds g_context_requirements_mutex
+static void count_context_requirements(uint32 flags, int delta) {
+    uint32 mask = 0;
+    for (int bit = 0; bit < kContextRequirementFlags; bit++) {
+        if (flags & (1u << bit)) {
+            g_context_requirement_counts[bit] += delta;
+        }
+        if (g_context_requirement_counts[bit] > 0) {
+            mask |= 1u << bit;
+        }
+    }
+    g_context_requirements.store(mask, std::memory_order_relaxed);
+}
+
+// Ask the processor what it reads from the context. Only valid after
+// setupProcessing(); a re-initialized plugin replaces the flags it had
+static void update_context_requirements(VST3PluginInstance* instance) {
+    FUnknownPtr<IProcessContextRequirements> requirements(instance->processor);
+    const uint32 flags = requirements
+        ? requirements->getProcessContextRequirements() & kAllContextRequirements
+        : kAllContextRequirements;
+
+    std::lock_guard<std::mutex> lock(g_context_requirements_mutex);
+    if (instance->context_requirements_counted) {
+        count_context_requirements(instance->context_requirements, -1);
+    }
+    count_context_requirements(flags, 1);
+    instance->context_requirements = flags;
+    instance->context_requirements_counted = true;
+}
+
+static void release_context_requirements(VST3PluginInstance* instance) {
+    std::lock_guard<std::mutex> lock(g_context_requirements_mutex);
+    if (instance->context_requirements_counted) {
+        count_context_requirements(instance->context_requirements, -1);
+        instance->context_requirements_counted = false;
+    }
+}
+
+// The context `offset` frames into the block `source` was updated for.
+// Position and transport state are always set; everything else only if
+// some instance asked for it
+static void fill_process_context(const TransportContext& source, int64 offset, ProcessContext& context) {
+    using Needs = IProcessContextRequirements;
+    const VST3Transport& transport = source.transport;
+    const uint32 needs = source.requirements;
+    const double sample_rate = transport.sample_rate > 0.0 ? transport.sample_rate : 44100.0;
+    const double tempo = transport.tempo > 0.0 ? transport.tempo : 120.0;
+
+    context = ProcessContext();
+    context.sampleRate = sample_rate;
+    context.projectTimeSamples = transport.project_time_samples + offset;
+    if (transport.playing) context.state |= ProcessContext::kPlaying;
+    if (transport.recording) context.state |= ProcessContext::kRecording;
+    if (transport.cycle_active) context.state |= ProcessContext::kCycleActive;
+
+    if (needs & Needs::kNeedSystemTime) {
+        context.systemTime = source.system_time + static_cast<int64>(offset * 1e9 / sample_rate);
+        context.state |= ProcessContext::kSystemTimeValid;
+    }
+    if (needs & Needs::kNeedContinousTimeSamples) {
+        context.continousTimeSamples = transport.continuous_time_samples + offset;
+        context.state |= ProcessContext::kContTimeValid;
+    }
+
+    const double ppq = static_cast<double>(context.projectTimeSamples) / sample_rate * tempo / 60.0;
+    const int32 numerator = std::max(1, transport.time_sig_numerator);
+    const int32 denominator = std::max(1, transport.time_sig_denominator);
+    if (needs & Needs::kNeedProjectTimeMusic) {
+        context.projectTimeMusic = ppq;
+        context.state |= ProcessContext::kProjectTimeMusicValid;
+    }
+    if (needs & Needs::kNeedBarPositionMusic) {
+        const double bar_length = 4.0 * numerator / denominator;
+        context.barPositionMusic = std::floor(ppq / bar_length) * bar_length;
+        context.state |= ProcessContext::kBarPositionValid;
+    }
+    if ((needs & Needs::kNeedCycleMusic) && transport.cycle_active) {
+        context.cycleStartMusic = transport.cycle_start_ppq;
+        context.cycleEndMusic = transport.cycle_end_ppq;
+        context.state |= ProcessContext::kCycleValid;
+    }
+    if (needs & Needs::kNeedTempo) {
+        context.tempo = tempo;
+        context.state |= ProcessContext::kTempoValid;
+    }
+    if (needs & Needs::kNeedTimeSignature) {
+        context.timeSigNumerator = numerator;
+        context.timeSigDenominator = denominator;
+        context.state |= ProcessContext::kTimeSigValid;
+    }
+    if (needs & Needs::kNeedSamplesToNextClock) {
+        const double clocks = ppq * kMidiClocksPerQuarter;
+        const double samples_per_clock = sample_rate * 60.0 / (tempo * kMidiClocksPerQuarter);
+        context.samplesToNextClock =
+            static_cast<int32>(std::ceil((std::ceil(clocks) - clocks) * samples_per_clock));
+        context.state |= ProcessContext::kClockValid;
+    }
+}
+
+// What process() gets for the sub-block starting `offset` frames into the
+// block: the bound transport's shared context for the first one, a copy
+// advanced by the offset for the rest. Null if the thread isn't bound
+static ProcessContext* process_context_for(VST3PluginInstance* instance, int offset) {
+    const TransportContext* bound = g_bound_transport;
+    if (!bound || !bound->valid) {
+        return nullptr;
+    }
+    if (offset == 0) {
+        return const_cast<ProcessContext*>(&bound->context);
+    }
+    fill_process_context(*bound, offset, instance->sub_block_context);
+    return &instance->sub_block_context;
+}
+
+//------------------------------------------------------------------------
+// MIDI controller mapping
+//------------------------------------------------------------------------
+
+// Ask the controller's IMidiMapping for every controller on every channel
+// and store the result in midi_cc_map. Plugins without IMidiMapping get an
+// empty table. Calls into the controller, so never on the audio thread
+static void build_midi_mapping(VST3PluginInstance* instance) {
+    FUnknownPtr<IMidiMapping> mapping(instance->controller);
+    int assigned = 0;
+    for (int channel = 0; channel < kMidiChannels; channel++) {
+        for (int ctrl = 0; ctrl < kCountCtrlNumber; ctrl++) {
+            ParamID id = kNoParamId;
+            if (!mapping || mapping->getMidiControllerAssignment(0, static_cast<int16>(channel),
+                                                                  static_cast<CtrlNumber>(ctrl), id) != kResultTrue) {
+                id = kNoParamId;
+            }
+            if (id != kNoParamId) assigned++;
+            instance->midi_cc_map[channel * kCountCtrlNumber + ctrl].store(id, std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (mapping) {
+        fprintf(stdout, "🎹 [C++] MIDI mapping: %d controller assignment(s)\n", assigned);
+        fflush(stdout);
+    }
+}
+
+// Rebuild the table if this instance's handler got kMidiCCAssignmentChanged
+// since the last build. Called from the instance's control-thread entry
+// points (polls, parameter queries, state restore)
+static void refresh_midi_mapping(VST3PluginInstance* instance) {
+    if (instance->controller && instance->midi_mapping_stale.exchange(false, std::memory_order_acq_rel)) {
+        build_midi_mapping(instance);
+    }
+}
+
+// Parameter a controller message drives, kNoParamId if none.
+// One table lookup, safe on the audio thread
+static ParamID midi_mapped_param(const VST3PluginInstance* instance, int channel, int controller) {
+    if (channel < 0 || channel >= kMidiChannels || controller < 0 || controller >= kCountCtrlNumber) {
+        return kNoParamId;
+    }
+    return instance->midi_cc_map[channel * kCountCtrlNumber + controller].load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+// Plugin scanning
+//------------------------------------------------------------------------
+
+static constexpr unsigned kMaxScanThreads = 8;
+
+// Held around every in-process Module::create and factory walk (scanning and
+// the module registry). Bundle entry points, static initializers and the
+// dynamic linker aren't safe to run for several bundles at once, so
+// in-process loads go one at a time; only helper-process probes and the
+// per-instance setup after the module is loaded run in parallel
+static std::mutex g_module_load_mutex;
+
+static std::mutex g_scan_mutex;         // Guards everything below; one scan at a time
+static std::string g_scan_cache_path;   // Empty = default_scan_cache_path()
+static std::string g_scan_helper_path;  // Empty = probe in-process
+static scan_cache::Cache g_scan_cache;
+static bool g_scan_cache_loaded = false;
+
+static std::string default_scan_cache_path() {
+#ifdef _WIN32
+    const char* base = getenv("LOCALAPPDATA");
+    return base ? std::string(base) + "\\Boojy Audio\\vst3_scan_cache.txt" : std::string();
+#elif __APPLE__
+    const char* home = getenv("HOME");
+    return home ? std::string(home) + "/Library/Caches/Boojy Audio/vst3_scan_cache.txt" : std::string();
+#else
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        return std::string(xdg) + "/boojy-audio/vst3_scan_cache.txt";
+    }
+    const char* home = getenv("HOME");
+    return home ? std::string(home) + "/.cache/boojy-audio/vst3_scan_cache.txt" : std::string();
+#endif
+}
+
+static std::string scan_cache_path() {
+    return g_scan_cache_path.empty() ? default_scan_cache_path() : g_scan_cache_path;
+}
+
+// The catalog sits next to the scan cache it is built from
+static std::string catalog_path_for(const std::string& cache_path) {
+    return cache_path.empty() ? std::string() : fs::path(cache_path).replace_extension(".catalog").string();
+}
+
+// The published catalog. Its own lock rather than g_scan_mutex, so the
+// browser never waits for a scan
+static std::mutex g_catalog_mutex;
+static std::shared_ptr<const plugin_catalog::Catalog> g_catalog;
+
+static void publish_catalog(std::shared_ptr<const plugin_catalog::Catalog> catalog) {
+    std::lock_guard<std::mutex> lock(g_catalog_mutex);
+    g_catalog.swap(catalog);
+}
+
+static bool has_catalog() {
+    std::lock_guard<std::mutex> lock(g_catalog_mutex);
+    return g_catalog != nullptr;
+}
+
+// Map the catalog at `path`, or publish none if it is missing or invalid
+static void open_catalog(const std::string& path) {
+    publish_catalog(path.empty() ? nullptr : plugin_catalog::Catalog::open(path));
+}
+
+// Fill in a plugin info from a factory class (name, vendor, instrument/effect)
+static void describe_plugin_class(const VST3::Hosting::ClassInfo& class_info,
+                                  const PFactoryInfo& factory_info,
+                                  const std::string& plugin_path,
+                                  VST3PluginInfo& info) {
+    std::memset(&info, 0, sizeof(VST3PluginInfo));
+
+    std::strncpy(info.name, class_info.name().c_str(), sizeof(info.name) - 1);
+    std::strncpy(info.vendor, factory_info.vendor, sizeof(info.vendor) - 1);
+    std::strncpy(info.version, class_info.version().c_str(), sizeof(info.version) - 1);
+    std::strncpy(info.file_path, plugin_path.c_str(), sizeof(info.file_path) - 1);
+
+    // Detect plugin type from subcategories and by checking MIDI input capability
+    std::string subcat_str = class_info.subCategoriesString();
+    std::string plugin_name = class_info.name();
+    std::strncpy(info.category, subcat_str.c_str(), sizeof(info.category) - 1);
+
+    info.is_instrument = false;
+    info.is_effect = false;
+
+    // First, check if it's an instrument by looking at subcategories
+    if (subcat_str.find("Instrument") != std::string::npos ||
+        subcat_str.find("Synth") != std::string::npos ||
+        subcat_str.find("Sampler") != std::string::npos ||
+        subcat_str.find("Drum") != std::string::npos ||
+        subcat_str.find("Piano") != std::string::npos ||
+        subcat_str.find("SoundGenerator") != std::string::npos ||
+        subcat_str.find("Generator") != std::string::npos) {
+        info.is_instrument = true;
+    }
+
+    // Check if it's an effect by looking at subcategories
+    if (subcat_str.find("Fx") != std::string::npos ||
+        subcat_str.find("Effect") != std::string::npos) {
+        info.is_effect = true;
+    }
+
+    // Use plugin name to detect type - most reliable approach
+    // .vst3 bundles contain multiple classes (e.g., Serum 2 and Serum 2 FX)
+
+    // If plugin name contains "FX" (case-insensitive), it's explicitly an effect
+    std::string name_upper = plugin_name;
+    std::transform(name_upper.begin(), name_upper.end(), name_upper.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+    if (name_upper.find(" FX") != std::string::npos || name_upper.find(" FX ") != std::string::npos) {
+        info.is_effect = true;
+        info.is_instrument = false;
+    }
+
+    // If still unknown, DEFAULT to INSTRUMENT
+    // Most synthesizers don't declare proper VST3 subcategories,
+    // so defaulting to instrument makes more sense than defaulting to effect.
+    // Serum, Serum 2, etc. will correctly be identified as instruments.
+    if (!info.is_instrument && !info.is_effect) {
+        info.is_instrument = true;
+    }
+}
+
+// Load a bundle in this process and list its audio module classes
+static bool probe_bundle_in_process(const std::string& plugin_path,
+                                    std::vector<VST3PluginInfo>& plugins,
+                                    std::string& error) {
+    std::lock_guard<std::mutex> lock(g_module_load_mutex);
+    auto module = VST3::Hosting::Module::create(plugin_path, error);
+    if (!module) {
+        return false;
+    }
+
+    auto factory = module->getFactory();
+
+    PFactoryInfo factory_info;
+    factory.get()->getFactoryInfo(&factory_info);
+
+    for (const auto& class_info : factory.classInfos()) {
+        if (class_info.category() == kVstAudioEffectClass) {
+            VST3PluginInfo info;
+            describe_plugin_class(class_info, factory_info, plugin_path, info);
+            plugins.push_back(info);
+        }
+    }
+    return true;
+}
+
+static std::string shell_quote(const std::string& arg) {
+#ifdef _WIN32
+    return "\"" + arg + "\"";
+#else
+    std::string quoted = "'";
+    for (char c : arg) {
+        if (c == '\'') quoted += "'\\''";
+        else quoted += c;
+    }
+    return quoted + "'";
+#endif
+}
+
+// Run vst3_scan_helper on a bundle and read its P records from stdout.
+// A plugin that crashes while loading only takes the child down.
+static bool probe_bundle_out_of_process(const std::string& helper_path,
+                                        const std::string& plugin_path,
+                                        std::vector<VST3PluginInfo>& plugins,
+                                        std::string& error) {
+    std::string command = shell_quote(helper_path) + " " + shell_quote(plugin_path);
+#ifdef _WIN32
+    // cmd /c strips the outer pair of quotes
+    command = "\"" + command + "\"";
+    FILE* pipe = _popen(command.c_str(), "r");
+#else
+    FILE* pipe = popen(command.c_str(), "r");
+#endif
+    if (!pipe) {
+        error = "Failed to start scan helper";
+        return false;
+    }
+
+    std::string line;
+    char chunk[1024];
+    while (std::fgets(chunk, sizeof(chunk), pipe)) {
+        line += chunk;
+        if (line.empty() || line.back() != '\n') {
+            continue;
+        }
+        line.pop_back();
+        VST3PluginInfo info;
+        if (scan_cache::parse_plugin(line, plugin_path, info)) {
+            plugins.push_back(info);
+        }
+        line.clear();
+    }
+
+#ifdef _WIN32
+    int status = _pclose(pipe);
+#else
+    int status = pclose(pipe);
+#endif
+    if (status != 0) {
+        error = "Scan helper failed (exit status " + std::to_string(status) + ")";
+        plugins.clear();
+        return false;
+    }
+    return true;
+}
+
+struct ScanJob {
+    std::string path;
+    scan_cache::BundleKey key;
+    bool ok = false;
+    std::string error;
+    std::vector<VST3PluginInfo> plugins;
+};
+
+// Probe bundles, results in job order. Helper-process probes run on a small
+// worker pool (mostly disk and dynamic linker time, so this scales past the
+// core count); in-process probes run one at a time on the calling thread
+// (see g_module_load_mutex).
+static void probe_bundles(std::vector<ScanJob>& jobs, const std::string& helper_path) {
+    if (jobs.empty()) {
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1)) {
+            ScanJob& job = jobs[i];
+            job.ok = helper_path.empty()
+                ? probe_bundle_in_process(job.path, job.plugins, job.error)
+                : probe_bundle_out_of_process(helper_path, job.path, job.plugins, job.error);
+        }
+    };
+
+    unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min<unsigned>({num_threads, kMaxScanThreads, static_cast<unsigned>(jobs.size())});
+    if (helper_path.empty()) {
+        num_threads = 1;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < num_threads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+//------------------------------------------------------------------------
+// Module registry
+//------------------------------------------------------------------------
+
+// A loaded bundle, shared by every instance created from it. The factory
+// info and audio classes are parsed once when the module is loaded.
+struct LoadedModule {
+    VST3::Hosting::Module::Ptr module;
+    PFactoryInfo factory_info;
+    std::vector<VST3::Hosting::ClassInfo> audio_classes;  // kVstAudioEffectClass, factory order
+    std::vector<VST3PluginInfo> descriptions;            // Parallel to audio_classes
+    std::map<std::string, size_t> class_by_name;         // Class name -> audio_classes index
+    std::map<std::string, size_t> class_by_uid;          // Class UID string -> audio_classes index
+
+    // Index of the class matching a name or UID string, or -1
+    int find_class(const std::string& name_or_uid) const {
+        auto it = class_by_name.find(name_or_uid);
+        if (it != class_by_name.end()) return static_cast<int>(it->second);
+        it = class_by_uid.find(name_or_uid);
+        if (it != class_by_uid.end()) return static_cast<int>(it->second);
+        return -1;
+    }
+};
+
+// Registry slots are keyed by canonical bundle path. A slot only holds a
+// weak reference: the module is unloaded once its last instance is gone.
+// Each slot has its own lock, so waiting for one bundle's module doesn't
+// hold up instances of bundles that are already loaded.
+struct ModuleSlot {
+    std::mutex mutex;
+    std::weak_ptr<LoadedModule> module;
+};
+
+static std::mutex g_module_registry_mutex;
+static std::map<std::string, std::shared_ptr<ModuleSlot>> g_module_registry;
+
+static std::shared_ptr<LoadedModule> acquire_module(const std::string& file_path, std::string& error) {
+    std::error_code ec;
+    std::string key = fs::weakly_canonical(fs::path(file_path), ec).string();
+    if (ec || key.empty()) {
+        key = file_path;
+    }
+
+    std::shared_ptr<ModuleSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(g_module_registry_mutex);
+        auto& entry = g_module_registry[key];
+        if (!entry) {
+            entry = std::make_shared<ModuleSlot>();
+        }
+        slot = entry;
+    }
+
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (auto loaded = slot->module.lock()) {
+        return loaded;
+    }
+
+    std::lock_guard<std::mutex> load_lock(g_module_load_mutex);
+    auto module = VST3::Hosting::Module::create(file_path, error);
+    if (!module) {
+        return nullptr;
+    }
+
+    auto loaded = std::make_shared<LoadedModule>();
+    loaded->module = module;
+
+    const auto& factory = module->getFactory();
+    std::memset(&loaded->factory_info, 0, sizeof(PFactoryInfo));
+    factory.get()->getFactoryInfo(&loaded->factory_info);
+
+    for (const auto& class_info : factory.classInfos()) {
+        if (class_info.category() == kVstAudioEffectClass) {
+            size_t index = loaded->audio_classes.size();
+            loaded->audio_classes.push_back(class_info);
+
+            VST3PluginInfo info;
+            describe_plugin_class(class_info, loaded->factory_info, file_path, info);
+            loaded->descriptions.push_back(info);
+
+            loaded->class_by_name.emplace(class_info.name(), index);
+            loaded->class_by_uid.emplace(class_info.ID().toString(), index);
+        }
+    }
+
+    fprintf(stdout, "📦 Loaded module %s (%zu audio class(es))\n",
+            file_path.c_str(), loaded->audio_classes.size());
+    fflush(stdout);
+
+    slot->module = loaded;
+    return loaded;
+}
+
+//------------------------------------------------------------------------
+// Async loader
+//------------------------------------------------------------------------
+
+static constexpr unsigned kMaxLoaderThreads = 4;
+
+struct LoadJob {
+    std::string file_path;
+    double sample_rate = 0.0;
+    int max_block_size = 0;
+    VST3LoadCallback callback = nullptr;
+    void* user_data = nullptr;
+};
+
+static std::mutex g_loader_mutex;
+static std::condition_variable g_loader_cv;
+static std::deque<LoadJob> g_loader_jobs;
+static std::vector<std::thread> g_loader_threads;
+static bool g_loader_stopping = false;
+
+// Load, initialize and activate one plugin; on failure the half-built
+// instance is released and the error is left in g_last_error
+static VST3PluginHandle load_and_activate(const LoadJob& job) {
+    VST3PluginHandle handle = vst3_load_plugin(job.file_path.c_str());
+    if (!handle) {
+        return nullptr;
+    }
+
+    if (!vst3_initialize_plugin(handle, job.sample_rate, job.max_block_size) ||
+        !vst3_activate_plugin(handle)) {
+        LastError error = g_last_error;
+        vst3_unload_plugin(handle);
+        g_last_error = error;
+        return nullptr;
+    }
+    return handle;
+}
+
+static void loader_thread_main() {
+    for (;;) {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(g_loader_mutex);
+            g_loader_cv.wait(lock, [] { return g_loader_stopping || !g_loader_jobs.empty(); });
+            if (g_loader_stopping) {
+                return;
+            }
+            job = std::move(g_loader_jobs.front());
+            g_loader_jobs.pop_front();
+        }
+
+        VST3PluginHandle handle = load_and_activate(job);
+        job.callback(handle, handle ? nullptr : g_last_error.message, job.user_data);
+    }
+}
+
+// Stops the loader threads; jobs that haven't started get a failure callback
+static void stop_loader_threads() {
+    std::deque<LoadJob> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(g_loader_mutex);
+        g_loader_stopping = true;
+        cancelled.swap(g_loader_jobs);
+    }
+    g_loader_cv.notify_all();
+
+    for (auto& thread : g_loader_threads) {
+        thread.join();
+    }
+    g_loader_threads.clear();
+
+    for (auto& job : cancelled) {
+        job.callback(nullptr, "VST3 host is shutting down", job.user_data);
+    }
+
+    std::lock_guard<std::mutex> lock(g_loader_mutex);
+    g_loader_stopping = false;
+}
+
+//------------------------------------------------------------------------
+// Instance pool
+//------------------------------------------------------------------------
+
+// Warm, activated instances of recently used and pinned bundles, so the
+// browser can hand out an instrument without loading it. One pool thread
+// does all the slow work: warming classes up to g_pool_size instances,
+// recycling returned ones (state put back to a fresh instance's, DSP reset)
+// and unloading whatever the pool lets go of.
+
+struct PoolClass {
+    std::vector<VST3PluginHandle> ready;  // Initialized, active, default state
+    std::vector<uint8_t> default_state;   // A fresh instance's, restored on recycle
+    bool has_default_state = false;
+    bool pinned = false;
+    bool failed = false;  // Last warm load failed; retried once the class is used again
+    int loading = 0;      // Warm loads in flight
+    std::list<std::string>::iterator lru;
+};
+
+struct PoolLease {
+    std::string file_path;
+    uint64_t state_generation = 0;  // At hand-out; unchanged = no state restore needed
+};
+
+static std::mutex g_pool_mutex;  // Guards everything below
+static std::condition_variable g_pool_cv;
+static std::unordered_map<std::string, PoolClass> g_pool_classes;
+static std::list<std::string> g_pool_lru;  // Most recently used first
+static std::unordered_map<VST3PluginHandle, PoolLease> g_pool_leases;
+static std::deque<std::pair<VST3PluginHandle, PoolLease>> g_pool_returned;
+static std::vector<VST3PluginHandle> g_pool_doomed;  // Unloaded on the pool thread
+static std::thread g_pool_thread;
+static bool g_pool_stopping = false;
+static int g_pool_size = 0;         // Warm instances per class; 0 = pool off
+static int g_pool_max_classes = 0;  // Unpinned classes kept warm
+static double g_pool_sample_rate = 44100.0;
+static int g_pool_block_size = 512;
+static uint64_t g_pool_generation = 0;  // Bumped when the setup changes
+
+// Let go of a class and its warm instances. Loads in flight for it are
+// unloaded when they finish
+static void pool_drop_class(std::unordered_map<std::string, PoolClass>::iterator it) {
+    g_pool_doomed.insert(g_pool_doomed.end(), it->second.ready.begin(), it->second.ready.end());
+    g_pool_lru.erase(it->second.lru);
+    g_pool_classes.erase(it);
+}
+
+// Keep at most g_pool_max_classes unpinned classes, dropping the least
+// recently used
+static void pool_evict() {
+    int unpinned = 0;
+    for (const auto& [path, pool_class] : g_pool_classes) {
+        if (!pool_class.pinned) unpinned++;
+    }
+    for (auto it = g_pool_lru.end(); unpinned > g_pool_max_classes && it != g_pool_lru.begin();) {
+        --it;
+        auto found = g_pool_classes.find(*it);
+        if (found->second.pinned) continue;
+        it = std::next(it);
+        pool_drop_class(found);
+        unpinned--;
+    }
+}
+
+// The class for `file_path`, created if needed and marked most recently used
+static PoolClass& pool_touch(const std::string& file_path) {
+    auto it = g_pool_classes.find(file_path);
+    if (it == g_pool_classes.end()) {
+        g_pool_lru.push_front(file_path);
+        it = g_pool_classes.emplace(file_path, PoolClass()).first;
+        it->second.lru = g_pool_lru.begin();
+    } else {
+        g_pool_lru.splice(g_pool_lru.begin(), g_pool_lru, it->second.lru);
+        it->second.failed = false;
+    }
+    return it->second;
+}
+
+static std::string pool_class_to_warm() {
+    for (const auto& path : g_pool_lru) {
+        const PoolClass& pool_class = g_pool_classes.at(path);
+        if (!pool_class.failed &&
+            static_cast<int>(pool_class.ready.size()) + pool_class.loading < g_pool_size) {
+            return path;
+        }
+    }
+    return std::string();
+}
+
+// Remember a fresh instance's state the first time one is seen
+static void pool_capture_default_state(const std::string& file_path, VST3PluginHandle handle) {
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        auto it = g_pool_classes.find(file_path);
+        if (it == g_pool_classes.end() || it->second.has_default_state) return;
+    }
+
+    const void* data = nullptr;
+    int size = 0;
+    VST3StateSnapshot snapshot = vst3_snapshot_state(handle, &data, &size);
+    if (!snapshot) return;  // Can't save state: instances get unloaded instead of recycled
+
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    auto it = g_pool_classes.find(file_path);
+    if (it != g_pool_classes.end() && !it->second.has_default_state) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        it->second.default_state.assign(bytes, bytes + size);
+        it->second.has_default_state = true;
+    }
+    vst3_release_state(snapshot);
+}
+
+// Put a returned instance back the way a fresh one comes out of the pool.
+// False if it can't be (buses or processing mode changed, no saved state)
+static bool pool_recycle(VST3PluginHandle handle, const PoolLease& lease, const LoadJob& setup,
+                         const std::vector<uint8_t>& default_state, bool has_default_state) {
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (vst3_is_offline_mode(handle) || vst3_get_sample_size(handle) != 32) {
+        return false;
+    }
+    if (!instance->bridge) {
+        if (instance->prefer_double || !instance->requested_input_channels.empty() ||
+            !instance->requested_output_channels.empty()) {
+            return false;
+        }
+        // Nothing processes a released instance, so its queues can be emptied here
+        TimedEvent event;
+        while (instance->midi_queue.try_pop(event)) {}
+        instance->pending_events.clear();
+        ParamPoint point;
+        while (instance->param_queue.try_pop(point)) {}
+        instance->pending_params.clear();
+        while (instance->output_param_queue.try_pop(point)) {}
+    }
+
+    vst3_set_auto_sleep(handle, false);
+    if (vst3_get_state_generation(handle) != lease.state_generation) {
+        if (!has_default_state ||
+            !vst3_set_state(handle, default_state.data(), static_cast<int>(default_state.size()))) {
+            return false;
+        }
+    }
+    return vst3_reconfigure(handle, setup.sample_rate, setup.max_block_size) && vst3_reset_plugin(handle);
+}
+
+static void pool_thread_main() {
+    std::unique_lock<std::mutex> lock(g_pool_mutex);
+    for (;;) {
+        g_pool_cv.wait(lock, [] {
+            return g_pool_stopping || !g_pool_doomed.empty() || !g_pool_returned.empty() ||
+                   !pool_class_to_warm().empty();
+        });
+        if (g_pool_stopping) {
+            return;
+        }
+
+        if (!g_pool_doomed.empty()) {
+            std::vector<VST3PluginHandle> doomed;
+            doomed.swap(g_pool_doomed);
+            lock.unlock();
+            for (VST3PluginHandle handle : doomed) {
+                vst3_unload_plugin(handle);
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (!g_pool_returned.empty()) {
+            auto [handle, lease] = std::move(g_pool_returned.front());
+            g_pool_returned.pop_front();
+
+            auto it = g_pool_classes.find(lease.file_path);
+            bool wanted = it != g_pool_classes.end() && static_cast<int>(it->second.ready.size()) < g_pool_size;
+            std::vector<uint8_t> default_state;
+            bool has_default_state = false;
+            if (wanted) {
+                default_state = it->second.default_state;
+                has_default_state = it->second.has_default_state;
+            }
+            LoadJob setup;
+            setup.sample_rate = g_pool_sample_rate;
+            setup.max_block_size = g_pool_block_size;
+            const uint64_t generation = g_pool_generation;
+            lock.unlock();
+
+            bool recycled = wanted && pool_recycle(handle, lease, setup, default_state, has_default_state);
+
+            lock.lock();
+            it = g_pool_classes.find(lease.file_path);
+            if (recycled && generation == g_pool_generation && it != g_pool_classes.end() &&
+                static_cast<int>(it->second.ready.size()) < g_pool_size) {
+                it->second.ready.push_back(handle);
+            } else {
+                g_pool_doomed.push_back(handle);
+            }
+            continue;
+        }
+
+        const std::string path = pool_class_to_warm();
+        g_pool_classes.at(path).loading++;
+        LoadJob job;
+        job.file_path = path;
+        job.sample_rate = g_pool_sample_rate;
+        job.max_block_size = g_pool_block_size;
+        const uint64_t generation = g_pool_generation;
+        lock.unlock();
+
+        VST3PluginHandle handle = load_and_activate(job);
+        if (handle) {
+            pool_capture_default_state(path, handle);
+        } else {
+            fprintf(stderr, "⚠️ Instance pool failed to warm %s: %s\n", path.c_str(), g_last_error.message);
+            fflush(stderr);
+        }
+
+        lock.lock();
+        auto it = g_pool_classes.find(path);
+        if (it != g_pool_classes.end()) {
+            it->second.loading--;
+            it->second.failed = !handle;
+        }
+        if (handle) {
+            if (it != g_pool_classes.end() && generation == g_pool_generation &&
+                static_cast<int>(it->second.ready.size()) < g_pool_size) {
+                it->second.ready.push_back(handle);
+            } else {
+                g_pool_doomed.push_back(handle);
+            }
+        }
+    }
+}
+
+// Stops the pool thread and unloads every instance the pool holds.
+// Instances handed out stay with their owners; releasing them unloads them
+static void stop_pool() {
+    std::thread pool_thread;
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        g_pool_stopping = true;
+        pool_thread.swap(g_pool_thread);
+    }
+    g_pool_cv.notify_all();
+    if (pool_thread.joinable()) {
+        pool_thread.join();
+    }
+
+    std::vector<VST3PluginHandle> unload;
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        for (auto& [path, pool_class] : g_pool_classes) {
+            unload.insert(unload.end(), pool_class.ready.begin(), pool_class.ready.end());
+        }
+        for (auto& [handle, lease] : g_pool_returned) {
+            unload.push_back(handle);
+        }
+        unload.insert(unload.end(), g_pool_doomed.begin(), g_pool_doomed.end());
+        g_pool_classes.clear();
+        g_pool_lru.clear();
+        g_pool_returned.clear();
+        g_pool_doomed.clear();
+        g_pool_leases.clear();
+        g_pool_size = 0;
+        g_pool_max_classes = 0;
+        g_pool_stopping = false;
+    }
+
+    for (VST3PluginHandle handle : unload) {
+        vst3_unload_plugin(handle);
+    }
+}
+
+//------------------------------------------------------------------------
+// Plugin bridge (host side, see bridge_ipc.h and vst3_bridge_helper.cpp)
+//------------------------------------------------------------------------
+
+static constexpr int kBridgeCallTimeoutMs = 5000;
+static constexpr int kBridgeSetupTimeoutMs = 30000;  // Loading, setup and state restores
+static constexpr int kBridgeOfflineTimeoutMs = 5000;  // One offline block
+static constexpr int kBridgeShutdownTimeoutMs = 1000;
+
+static std::mutex g_bridge_mutex;
+static std::string g_bridge_helper_path;     // Empty = bridging disabled
+static std::set<std::string> g_bridged_plugins;  // Bundle paths to load bridged
+static std::atomic<uint32_t> g_bridge_count{0};  // Makes region names unique
+
+static void bridge_failed(BridgeClient* bridge, const char* message) {
+    if (!bridge->failed.exchange(true)) {
+        fprintf(stderr, "❌ [C++] Plugin bridge: %s\n", message);
+        fflush(stderr);
+    }
+    set_error(VST3_ERROR_BRIDGE, message);
+}
+
+// Send one control request and wait for the reply. The caller holds
+// control_mutex and reads the reply (result, payload) from the control
+// block before letting go. Returns false if the helper crashed or timed
+// out; errors the plugin call itself left are passed on to this thread
+static bool bridge_call(BridgeClient* bridge, uint32_t command, int32_t arg0 = 0, int32_t arg1 = 0,
+                        double value = 0.0, const void* data = nullptr, size_t size = 0,
+                        int timeout_ms = kBridgeCallTimeoutMs) {
+    if (bridge->failed.load(std::memory_order_acquire)) {
+        set_error(VST3_ERROR_BRIDGE, "Plugin bridge helper is not running");
+        return false;
+    }
+    if (size > bridge::kPayloadSize) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Request too large for the plugin bridge");
+        return false;
+    }
+
+    bridge::ControlBlock& control = bridge->ipc.region->control;
+    control.command = command;
+    control.args[0] = arg0;
+    control.args[1] = arg1;
+    control.value = value;
+    control.size = static_cast<uint32_t>(size);
+    if (size > 0) {
+        std::memcpy(control.payload, data, size);
+    }
+
+    const uint32_t seen = bridge->ipc.reply.value();
+    bridge->ipc.request.notify();
+
+    // Wake up every so often to notice a helper that crashed
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!bridge->ipc.reply.wait(seen, 50)) {
+        if (!bridge->process.running()) {
+            bridge_failed(bridge, "Plugin bridge helper crashed");
+            return false;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            bridge->process.stop(0);
+            bridge_failed(bridge, "Plugin bridge helper stopped responding");
+            return false;
+        }
+    }
+
+    if (control.error_code != VST3_OK) {
+        control.error[sizeof(control.error) - 1] = '\0';
+        set_error(static_cast<VST3Result>(control.error_code), control.error);
+    }
+    return true;
+}
+
+// Control request whose reply is just the result. Returns `failure` if the
+// helper didn't answer
+static int64 bridge_request(BridgeClient* bridge, int64 failure, uint32_t command, int32_t arg0 = 0,
+                            int32_t arg1 = 0, double value = 0.0, int timeout_ms = kBridgeCallTimeoutMs) {
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    if (!bridge_call(bridge, command, arg0, arg1, value, nullptr, 0, timeout_ms)) {
+        return failure;
+    }
+    return bridge->ipc.region->control.result;
+}
+
+// Control request replying with one struct in the payload
+template <typename T>
+static bool bridge_request_struct(BridgeClient* bridge, uint32_t command, T* out,
+                                  int32_t arg0 = 0, int32_t arg1 = 0) {
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    const bridge::ControlBlock& control = bridge->ipc.region->control;
+    if (!bridge_call(bridge, command, arg0, arg1) || control.result == 0 || control.size != sizeof(T)) {
+        return false;
+    }
+    std::memcpy(out, control.payload, sizeof(T));
+    return true;
+}
+
+// Start a helper for one plugin and load it there
+static VST3PluginHandle load_bridged_plugin(const char* file_path, const char* class_name) {
+    std::string helper_path;
+    {
+        std::lock_guard<std::mutex> lock(g_bridge_mutex);
+        helper_path = g_bridge_helper_path;
+    }
+    if (helper_path.empty()) {
+        set_error(VST3_ERROR_LOAD_FAILED, "Plugin is set to run bridged but no bridge helper is configured");
+        return nullptr;
+    }
+
+    auto bridge = std::make_unique<BridgeClient>();
+    const std::string name = bridge::region_name(g_bridge_count.fetch_add(1));
+
+    std::string error;
+    if (!bridge->ipc.create(name, error) || !bridge->process.spawn(helper_path, {name}, error)) {
+        set_error(VST3_ERROR_LOAD_FAILED, error);
+        return nullptr;
+    }
+
+    // Payload: bundle path, NUL, class name, NUL
+    std::string request = file_path;
+    request += '\0';
+    request += class_name ? class_name : "";
+    request += '\0';
+
+    {
+        std::lock_guard<std::mutex> lock(bridge->control_mutex);
+        const bool answered = bridge_call(bridge.get(), bridge::kLoad, 0, 0, 0.0,
+                                          request.data(), request.size(), kBridgeSetupTimeoutMs);
+
+        // The helper has mapped everything by now (or is gone); nothing
+        // else needs the names
+        bridge->ipc.unlink();
+
+        const bridge::ControlBlock& control = bridge->ipc.region->control;
+        if (!answered || control.result == 0 || control.size != sizeof(VST3PluginInfo)) {
+            if (answered && control.error_code == VST3_OK) {
+                set_error(VST3_ERROR_LOAD_FAILED, "Bridged plugin failed to load");
+            }
+            return nullptr;
+        }
+        std::memcpy(&bridge->info, control.payload, sizeof(VST3PluginInfo));
+    }
+
+    fprintf(stdout, "✅ [C++] Loaded %s in bridge helper %s\n", bridge->info.name, name.c_str());
+    fflush(stdout);
+
+    auto instance = std::make_unique<VST3PluginInstance>();
+    instance->file_path = file_path;
+    instance->bridge = std::move(bridge);
+    return instance.release();
+}
+
+// Ask the helper to unload the plugin and exit; kill it if it won't
+static void shutdown_bridge(BridgeClient* bridge) {
+    {
+        std::lock_guard<std::mutex> lock(bridge->control_mutex);
+        bridge->ipc.region->stopping.store(1, std::memory_order_release);
+        bridge_call(bridge, bridge::kShutdown, 0, 0, 0.0, nullptr, 0, kBridgeShutdownTimeoutMs);
+    }
+    bridge->process.stop(kBridgeShutdownTimeoutMs);
+}
+
+// Hand the helper one block (at most kMaxBlockFrames) and play what it
+// returns. Realtime blocks are pipelined: the output is the previous
+// block's, so the helper has a whole block period to process while the
+// audio thread gets on with the rest of the session, and the plugin sounds
+// exactly one block late. If the helper hasn't finished the previous block
+// by the next callback, that callback plays silence and its input is
+// dropped. Offline blocks wait for their own output. `offset` is the
+// chunk's position in the caller's block, which the bound transport covers
+static void bridge_process_chunk(VST3PluginInstance* instance, const float* input_left,
+                                 const float* input_right, float* output_left, float* output_right,
+                                 int num_frames, int offset) {
+    BridgeClient* bridge = instance->bridge.get();
+    bridge::Region* region = bridge->ipc.region;
+    bridge::AudioBlock& block = region->block;
+    const bool offline = instance->process_mode == kOffline;
+
+    bool idle = bridge->ipc.done.value() == bridge->submitted;
+    if (!idle && offline) {
+        idle = bridge->ipc.done.wait(bridge->submitted - 1, kBridgeOfflineTimeoutMs);
+    }
+    if (!idle) {
+        std::memset(output_left, 0, sizeof(float) * num_frames);
+        std::memset(output_right, 0, sizeof(float) * num_frames);
+        return;
+    }
+
+    // Input first: the caller may process in place
+    block.num_frames = num_frames;
+    block.has_input = input_left || input_right ? 1 : 0;
+    for (int channel = 0; channel < bridge::kChannels; channel++) {
+        const float* input = channel == 0 ? input_left : input_right;
+        if (input) {
+            std::memcpy(block.input[channel], input, sizeof(float) * num_frames);
+        } else {
+            std::memset(block.input[channel], 0, sizeof(float) * num_frames);
+        }
+    }
+    const TransportContext* transport = g_bound_transport;
+    block.has_transport = transport && transport->valid ? 1 : 0;
+    if (block.has_transport) {
+        block.transport = transport->transport;
+        block.transport.project_time_samples += offset;
+        block.transport.continuous_time_samples += offset;
+    }
+
+    // Previous realtime block's output
+    const int played = std::min(bridge->pending_output_frames, num_frames);
+    if (played > 0) {
+        std::memcpy(output_left, block.output[0], sizeof(float) * played);
+        std::memcpy(output_right, block.output[1], sizeof(float) * played);
+    }
+    if (played < num_frames) {
+        std::memset(output_left + played, 0, sizeof(float) * (num_frames - played));
+        std::memset(output_right + played, 0, sizeof(float) * (num_frames - played));
+    }
+
+    // Events and parameter changes travel with the block they're due in
+    bridge::MidiEvent event;
+    while (bridge->midi_queue.try_pop(event)) {
+        if (!region->midi.push(event)) {
+            VST3_LOG_WARN("🎹 [C++] Bridge MIDI ring full, event dropped");
+        }
+    }
+    ParamPoint point;
+    while (instance->param_queue.try_pop(point)) {
+        if (!region->params.push(bridge::ParamChange{point.id, point.sample_offset, point.value})) {
+            VST3_LOG_WARN("🎛️ [C++] Bridge parameter ring full, change to %u dropped", point.id);
+        }
+    }
+
+    bridge->submitted++;
+    bridge->ipc.submit.notify();
+    instance->sample_position.fetch_add(num_frames, std::memory_order_release);
+
+    if (offline) {
+        bridge->pending_output_frames = 0;
+        if (bridge->ipc.done.wait(bridge->submitted - 1, kBridgeOfflineTimeoutMs)) {
+            std::memcpy(output_left, block.output[0], sizeof(float) * num_frames);
+            std::memcpy(output_right, block.output[1], sizeof(float) * num_frames);
+        }
+    } else {
+        bridge->pending_output_frames = num_frames;
+        if (bridge->pipeline_frames.exchange(num_frames, std::memory_order_relaxed) != num_frames) {
+            note_latency_change(instance);
+        }
+    }
+
+    // Latency changes the plugin reported inside the helper
+    const uint32_t latency_changes = region->latency_changes.load(std::memory_order_relaxed);
+    if (latency_changes != bridge->latency_changes_seen) {
+        bridge->latency_changes_seen = latency_changes;
+        note_latency_change(instance);
+    }
+}
+
+static bool bridge_process_block(VST3PluginInstance* instance, const float* input_left,
+                                 const float* input_right, float* output_left, float* output_right,
+                                 int num_frames) {
+    if (instance->bridge->failed.load(std::memory_order_relaxed)) {
+        std::memset(output_left, 0, sizeof(float) * num_frames);
+        std::memset(output_right, 0, sizeof(float) * num_frames);
+        set_error(VST3_ERROR_BRIDGE, "Plugin bridge helper is not running");
+        return false;
+    }
+
+    for (int offset = 0; offset < num_frames; offset += bridge::kMaxBlockFrames) {
+        const int chunk = std::min(bridge::kMaxBlockFrames, num_frames - offset);
+        bridge_process_chunk(instance,
+                             input_left ? input_left + offset : nullptr,
+                             input_right ? input_right + offset : nullptr,
+                             output_left + offset, output_right + offset, chunk, offset);
+    }
+    return true;
+}
+
+static bool bridge_queue_midi_event(VST3PluginInstance* instance, int event_type, int channel,
+                                    int data1, int data2, int64 sample_time) {
+    if (event_type < 0 || event_type > 4) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Unknown MIDI event type");
+        return false;
+    }
+    if (!instance->bridge->midi_queue.try_push(bridge::MidiEvent{event_type, channel, data1, data2, sample_time})) {
+        VST3_LOG_WARN("🎹 [C++] MIDI event queue full, event dropped");
+        set_error(VST3_ERROR_QUEUE_FULL, "MIDI event queue full");
+        return false;
+    }
+    return true;
+}
+
+static int bridge_get_parameter_catalog(BridgeClient* bridge, VST3ParameterInfo* infos, int max_params) {
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    const bridge::ControlBlock& control = bridge->ipc.region->control;
+    const int wanted = infos ? std::max(0, max_params) : 0;
+    if (!bridge_call(bridge, bridge::kGetParameterCatalog, wanted)) {
+        return -1;
+    }
+    if (infos && control.size > 0) {
+        std::memcpy(infos, control.payload,
+                    std::min<size_t>(control.size, sizeof(VST3ParameterInfo) * static_cast<size_t>(wanted)));
+    }
+    return static_cast<int>(control.result);
+}
+
+static int bridge_get_parameter_values(BridgeClient* bridge, const uint32_t* ids, double* values, int count) {
+    if (sizeof(double) * static_cast<size_t>(count) > bridge::kPayloadSize) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Too many parameters for the plugin bridge");
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    const bridge::ControlBlock& control = bridge->ipc.region->control;
+    if (!bridge_call(bridge, bridge::kGetParameterValues, 0, 0, 0.0, ids, sizeof(uint32_t) * count)) {
+        return -1;
+    }
+    const int read = static_cast<int>(std::clamp<int64>(control.result, -1, count));
+    if (read > 0) {
+        std::memcpy(values, control.payload, sizeof(double) * read);
+    }
+    return read;
+}
+
+static int bridge_set_parameter_values(BridgeClient* bridge, const uint32_t* ids, const double* values, int count) {
+    const size_t ids_size = sizeof(uint32_t) * static_cast<size_t>(count);
+    const size_t size = ids_size + sizeof(double) * static_cast<size_t>(count);
+    if (size > bridge::kPayloadSize) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Too many parameters for the plugin bridge");
+        return -1;
+    }
+
+    std::vector<uint8_t> request(size);
+    std::memcpy(request.data(), ids, ids_size);
+    std::memcpy(request.data() + ids_size, values, size - ids_size);
+
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    if (!bridge_call(bridge, bridge::kSetParameterValues, count, 0, 0.0, request.data(), size)) {
+        return -1;
+    }
+    return static_cast<int>(bridge->ipc.region->control.result);
+}
+
+// Drain parameter or editor changes the helper has collected
+template <typename Change>
+static int bridge_poll_changes(BridgeClient* bridge, uint32_t command, Change* changes, int max_changes) {
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    const bridge::ControlBlock& control = bridge->ipc.region->control;
+    if (!bridge_call(bridge, command, max_changes)) {
+        return 0;
+    }
+    const int count = static_cast<int>(std::clamp<int64>(control.result, 0, max_changes));
+    std::memcpy(changes, control.payload, sizeof(Change) * count);
+    return count;
+}
+
+static bool bridge_get_state(BridgeClient* bridge, std::vector<uint8_t>& state) {
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    const bridge::ControlBlock& control = bridge->ipc.region->control;
+    if (!bridge_call(bridge, bridge::kGetState, 0, 0, 0.0, nullptr, 0, kBridgeSetupTimeoutMs) ||
+        control.result < 0) {
+        return false;
+    }
+    state.assign(control.payload, control.payload + control.size);
+    return true;
+}
+
+static bool bridge_set_state(BridgeClient* bridge, const void* data, int size) {
+    std::lock_guard<std::mutex> lock(bridge->control_mutex);
+    return bridge_call(bridge, bridge::kSetState, 0, 0, 0.0, data, static_cast<size_t>(size), kBridgeSetupTimeoutMs) &&
+           bridge->ipc.region->control.result != 0;
+}
+
+// Whether a bundle is set to load bridged
+static bool is_bridged_path(const char* file_path) {
+    std::lock_guard<std::mutex> lock(g_bridge_mutex);
+    return g_bridged_plugins.count(file_path) != 0;
+}
+
+// C API Implementation
+
+bool vst3_host_init() {
+    // Log drain thread, started before anything can log from the audio thread
+    host_log::start();
+
+    // Initialize host application
+    if (!g_host_app) {
+        g_host_app = owned(new HostApplication());
+    }
+
+    // Map the last scan's catalog so the browser has it before any scan
+    {
+        std::lock_guard<std::mutex> lock(g_scan_mutex);
+        open_catalog(catalog_path_for(scan_cache_path()));
+    }
+    return true;
+}
+
+void vst3_host_shutdown() {
+    stop_pool();
+    stop_loader_threads();
+
+    // Cleanup global resources
+    {
+        // Modules still in use stay loaded until their last instance is unloaded
+        std::lock_guard<std::mutex> lock(g_module_registry_mutex);
+        g_module_registry.clear();
+    }
+    g_host_app = nullptr;
+    g_last_error = LastError();
+
+    host_log::stop();
+}
+
+void vst3_set_log_level(int level) {
+    host_log::set_level(std::max<int>(host_log::kDebug, std::min<int>(level, host_log::kOff)));
+}
+
+int vst3_scan_directory(const char* directory, VST3ScanCallback callback, void* user_data) {
+    if (!directory || !callback) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return 0;
+    }
+
+    int count = 0;
+
+    try {
+        fs::path dir_path(directory);
+        if (!fs::exists(dir_path) || !fs::is_directory(dir_path)) {
+            set_error(VST3_ERROR_INVALID_ARGUMENT, "Directory does not exist");
+            return 0;
+        }
+
+        // Scan for .vst3 bundles/folders
+        fprintf(stdout, "🔍 Scanning directory: %s\n", directory);
+        fflush(stdout);
+
+        std::vector<std::string> bundles;
+        for (auto it = fs::recursive_directory_iterator(dir_path); it != fs::recursive_directory_iterator(); ++it) {
+            if (it->is_directory() && it->path().extension() == ".vst3") {
+                bundles.push_back(it->path().string());
+                it.disable_recursion_pending();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(g_scan_mutex);
+
+        const std::string cache_path = scan_cache_path();
+        if (!g_scan_cache_loaded) {
+            g_scan_cache.clear();
+            if (!cache_path.empty()) {
+                scan_cache::load(cache_path, g_scan_cache);
+            }
+            g_scan_cache_loaded = true;
+        }
+
+        // Only bundles that are new or changed since the last scan get probed
+        std::vector<ScanJob> jobs;
+        std::vector<scan_cache::BundleKey> keys(bundles.size());
+        for (size_t i = 0; i < bundles.size(); i++) {
+            keys[i] = scan_cache::bundle_key(bundles[i]);
+            auto cached = g_scan_cache.find(bundles[i]);
+            if (cached == g_scan_cache.end() || !(cached->second.key == keys[i])) {
+                ScanJob job;
+                job.path = bundles[i];
+                job.key = keys[i];
+                jobs.push_back(std::move(job));
+            }
+        }
+
+        fprintf(stdout, "📦 Found %zu VST3 bundle(s), %zu new or changed%s\n",
+                bundles.size(), jobs.size(), g_scan_helper_path.empty() ? "" : " (out-of-process)");
+        fflush(stdout);
+
+        probe_bundles(jobs, g_scan_helper_path);
+
+        bool cache_dirty = !jobs.empty();
+        for (auto& job : jobs) {
+            if (!job.ok) {
+                fprintf(stderr, "❌ Failed to load module: %s - Error: %s\n",
+                        job.path.c_str(), job.error.c_str());
+                fflush(stderr);
+            }
+            scan_cache::BundleEntry& entry = g_scan_cache[job.path];
+            entry.key = job.key;
+            entry.ok = job.ok;
+            entry.plugins = std::move(job.plugins);
+        }
+
+        // Drop bundles that were removed from this directory
+        const std::string prefix = (dir_path / "").string();
+        for (auto it = g_scan_cache.begin(); it != g_scan_cache.end();) {
+            if (it->first.compare(0, prefix.size(), prefix) == 0 &&
+                std::find(bundles.begin(), bundles.end(), it->first) == bundles.end()) {
+                it = g_scan_cache.erase(it);
+                cache_dirty = true;
+            } else {
+                ++it;
+            }
+        }
+
+        if (cache_dirty && !cache_path.empty() && !scan_cache::save(cache_path, g_scan_cache)) {
+            fprintf(stderr, "⚠️ Failed to write VST3 scan cache: %s\n", cache_path.c_str());
+            fflush(stderr);
+        }
+
+        // Also rebuilt when there is none yet, e.g. a cache from before catalogs
+        const std::string catalog_path = catalog_path_for(cache_path);
+        if ((cache_dirty || !has_catalog()) && !catalog_path.empty()) {
+            if (plugin_catalog::save(catalog_path, g_scan_cache)) {
+                open_catalog(catalog_path);
+            } else {
+                fprintf(stderr, "⚠️ Failed to write VST3 plugin catalog: %s\n", catalog_path.c_str());
+                fflush(stderr);
+            }
+        }
+
+        for (const auto& bundle : bundles) {
+            const scan_cache::BundleEntry& entry = g_scan_cache[bundle];
+            for (const auto& info : entry.plugins) {
+                // DEBUG: Log plugin detection
+                fprintf(stdout, "🔍 VST3 Plugin: '%s' | SubCat: '%s' | Instrument: %d | Effect: %d\n",
+                        info.name, info.category, info.is_instrument, info.is_effect);
+                fflush(stdout);
+
+                callback(&info, user_data);
+                count++;
+            }
+        }
+    } catch (const std::exception& e) {
+        set_error(VST3_ERROR_LOAD_FAILED, std::string("Scan error: ") + e.what());
+        return count;
+    }
+
+    return count;
+}
+
+int vst3_scan_bundle(const char* bundle_path, VST3ScanCallback callback, void* user_data) {
+    if (!bundle_path || !callback) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return -1;
+    }
+
+    std::vector<VST3PluginInfo> plugins;
+    std::string error;
+    if (!probe_bundle_in_process(bundle_path, plugins, error)) {
+        set_error(VST3_ERROR_LOAD_FAILED, "Failed to load module: " + error);
+        return -1;
+    }
+
+    for (const auto& info : plugins) {
+        callback(&info, user_data);
+    }
+    return static_cast<int>(plugins.size());
+}
+
+void vst3_set_scan_cache_path(const char* path) {
+    std::lock_guard<std::mutex> lock(g_scan_mutex);
+    g_scan_cache_path = path ? path : "";
+    g_scan_cache.clear();
+    g_scan_cache_loaded = false;
+    open_catalog(catalog_path_for(scan_cache_path()));
+}
+
+void vst3_set_scan_helper_path(const char* path) {
+    std::lock_guard<std::mutex> lock(g_scan_mutex);
+    g_scan_helper_path = path ? path : "";
+}
+
+void vst3_clear_scan_cache() {
+    std::lock_guard<std::mutex> lock(g_scan_mutex);
+    g_scan_cache.clear();
+    g_scan_cache_loaded = true;
+
+    std::error_code ec;
+    const std::string cache_path = scan_cache_path();
+    if (!cache_path.empty()) {
+        fs::remove(cache_path, ec);
+        fs::remove(catalog_path_for(cache_path), ec);
+    }
+    publish_catalog(nullptr);
+}
+
+int vst3_scan_standard_locations(VST3ScanCallback callback, void* user_data) {
+    int total = 0;
+
+    std::vector<std::string> locations;
+
+#ifdef _WIN32
+    // Standard VST3 locations on Windows
+    locations.push_back("C:\\Program Files\\Common Files\\VST3");
+    locations.push_back("C:\\Program Files (x86)\\Common Files\\VST3");
+
+    // User VST3 directory
+    char* appdata = getenv("APPDATA");
+    if (appdata) {
+        locations.push_back(std::string(appdata) + "\\VST3");
+    }
+
+    // Also check LOCALAPPDATA for some plugins
+    char* localappdata = getenv("LOCALAPPDATA");
+    if (localappdata) {
+        locations.push_back(std::string(localappdata) + "\\Programs\\Common\\VST3");
+    }
+#elif __APPLE__
+    // Standard VST3 locations on macOS
+    locations.push_back("/Library/Audio/Plug-Ins/VST3");
+    const char* home = getenv("HOME");
+    if (home) {
+        locations.push_back(std::string(home) + "/Library/Audio/Plug-Ins/VST3");
+    }
+#elif __linux__
+    // Standard VST3 locations on Linux
+    const char* home = getenv("HOME");
+    if (home) {
+        locations.push_back(std::string(home) + "/.vst3");
+    }
+    locations.push_back("/usr/lib/vst3");
+    locations.push_back("/usr/local/lib/vst3");
+#endif
+
+    for (const auto& location : locations) {
+        total += vst3_scan_directory(location.c_str(), callback, user_data);
+    }
+
+    return total;
+}
+
+//------------------------------------------------------------------------
+// Plugin catalog
+//------------------------------------------------------------------------
+
+using CatalogRef = std::shared_ptr<const plugin_catalog::Catalog>;
+
+static const plugin_catalog::Catalog* catalog_from(VST3CatalogHandle handle) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid catalog handle");
+        return nullptr;
+    }
+    return static_cast<CatalogRef*>(handle)->get();
+}
+
+static VST3CatalogSpan to_span(const plugin_catalog::Span& span) {
+    return VST3CatalogSpan{span.ids, static_cast<int>(span.count)};
+}
+
+static bool valid_catalog_index(VST3CatalogIndex index) {
+    if (index < 0 || index >= static_cast<int>(plugin_catalog::kIndexCount)) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid catalog index");
+        return false;
+    }
+    return true;
+}
+
+VST3CatalogHandle vst3_catalog_acquire() {
+    std::lock_guard<std::mutex> lock(g_catalog_mutex);
+    if (!g_catalog) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "No plugin catalog; scan for plugins first");
+        return nullptr;
+    }
+    return new CatalogRef(g_catalog);
+}
+
+void vst3_catalog_release(VST3CatalogHandle catalog) {
+    delete static_cast<CatalogRef*>(catalog);
+}
+
+int vst3_catalog_size(VST3CatalogHandle catalog) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    return c ? static_cast<int>(c->size()) : 0;
+}
+
+bool vst3_catalog_get_entry(VST3CatalogHandle catalog, uint32_t id, VST3CatalogEntry* entry) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    if (!c) return false;
+    if (!entry || id >= c->size()) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid catalog entry");
+        return false;
+    }
+
+    const plugin_catalog::Record& record = c->record(id);
+    entry->name = c->string(record.name);
+    entry->vendor = c->string(record.vendor);
+    entry->version = c->string(record.version);
+    entry->category = c->string(record.category);
+    entry->file_path = c->string(record.file_path);
+    entry->is_instrument = (record.flags & plugin_catalog::kFlagInstrument) != 0;
+    entry->is_effect = (record.flags & plugin_catalog::kFlagEffect) != 0;
+    return true;
+}
+
+VST3CatalogSpan vst3_catalog_all(VST3CatalogHandle catalog) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    return c ? to_span(c->all()) : VST3CatalogSpan{nullptr, 0};
+}
+
+VST3CatalogSpan vst3_catalog_find(VST3CatalogHandle catalog, VST3CatalogIndex index, const char* key) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    if (!c || !valid_catalog_index(index)) return VST3CatalogSpan{nullptr, 0};
+    return to_span(c->find(static_cast<plugin_catalog::Index>(index), key ? key : ""));
+}
+
+VST3CatalogSpan vst3_catalog_name_prefix(VST3CatalogHandle catalog, const char* prefix) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    return c ? to_span(c->name_prefix(prefix ? prefix : "")) : VST3CatalogSpan{nullptr, 0};
+}
+
+int vst3_catalog_group_count(VST3CatalogHandle catalog, VST3CatalogIndex index) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    if (!c || !valid_catalog_index(index)) return 0;
+    return static_cast<int>(c->group_count(static_cast<plugin_catalog::Index>(index)));
+}
+
+bool vst3_catalog_get_group(VST3CatalogHandle catalog, VST3CatalogIndex index, int group,
+                            const char** label, VST3CatalogSpan* members) {
+    const plugin_catalog::Catalog* c = catalog_from(catalog);
+    if (!c || !valid_catalog_index(index)) return false;
+    const auto catalog_index = static_cast<plugin_catalog::Index>(index);
+    if (group < 0 || static_cast<uint32_t>(group) >= c->group_count(catalog_index)) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid catalog group");
+        return false;
+    }
+
+    const plugin_catalog::Group& g = c->group(catalog_index, static_cast<uint32_t>(group));
+    if (label) *label = c->string(g.label);
+    if (members) *members = to_span(c->members(g));
+    return true;
+}
+
+// Create and connect an instance of one audio class from a bundle.
+// class_name may be a class name or UID string; NULL or "" picks the first.
+static VST3PluginHandle load_plugin_class(const char* file_path, const char* class_name) {
+    if (!file_path) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid file path");
+        return nullptr;
+    }
+
+    if (!g_host_app) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Host not initialized. Call vst3_host_init() first");
+        return nullptr;
+    }
+
+    if (is_bridged_path(file_path)) {
+        return load_bridged_plugin(file_path, class_name);
+    }
+
+    try {
+        auto instance = std::make_unique<VST3PluginInstance>();
+        instance->file_path = file_path;
+
+        // Load the module (or share the one already loaded for this bundle)
+        std::string error;
+        auto module = acquire_module(file_path, error);
+        if (!module) {
+            set_error(VST3_ERROR_LOAD_FAILED, "Failed to load module: " + error);
+            return nullptr;
+        }
+
+        if (module->audio_classes.empty()) {
+            set_error(VST3_ERROR_LOAD_FAILED, "No audio effect class found in plugin");
+            return nullptr;
+        }
+
+        int class_index = 0;
+        if (class_name && *class_name) {
+            class_index = module->find_class(class_name);
+            if (class_index < 0) {
+                set_error(VST3_ERROR_LOAD_FAILED, std::string("Plugin class not found: ") + class_name);
+                return nullptr;
+            }
+        }
+
+        instance->module = module;
+        instance->class_index = static_cast<size_t>(class_index);
+
+        const auto& factory = module->module->getFactory();
+        const auto& class_info = module->audio_classes[instance->class_index];
+
+        // Create the component using modern API
+        auto component = factory.createInstance<IComponent>(class_info.ID());
+        if (!component) {
+            set_error(VST3_ERROR_LOAD_FAILED, "Failed to create component instance");
+            return nullptr;
+        }
+
+        instance->component = component;
+
+        // Initialize the component
+        if (component->initialize(g_host_app) != kResultOk) {
+            set_error(VST3_ERROR_LOAD_FAILED, "Failed to initialize component");
+            return nullptr;
+        }
+
+        // Get the audio processor interface
+        auto processor = FUnknownPtr<IAudioProcessor>(component);
+        if (processor) {
+            instance->processor = processor;
+        }
+
+        // Get the edit controller
+        TUID controller_cid;
+        if (component->getControllerClassId(controller_cid) == kResultOk) {
+            auto controller = factory.createInstance<IEditController>(VST3::UID::fromTUID(controller_cid));
+            if (controller) {
+                instance->controller = controller;
+                controller->initialize(g_host_app);
+
+                // CRITICAL: Set the component handler on the controller
+                // This allows the plugin to notify us of parameter changes, restarts, etc.
+                // Many plugins may crash or malfunction without this!
+                instance->component_handler = owned(new ComponentHandler(instance.get()));
+                tresult handlerResult = controller->setComponentHandler(instance->component_handler);
+                fprintf(stdout, "📊 setComponentHandler result: %d\n", handlerResult);
+                fflush(stdout);
+
+                // CRITICAL: Connect component and controller via IConnectionPoint
+                // This allows them to communicate - many plugins crash without this!
+                // This matches what the SDK's PlugProvider::connectComponents() does.
+                FUnknownPtr<IConnectionPoint> componentCP(component);
+                FUnknownPtr<IConnectionPoint> controllerCP(controller);
+
+                if (componentCP && controllerCP) {
+                    componentCP->connect(controllerCP);
+                    controllerCP->connect(componentCP);
+                    fprintf(stdout, "✅ Connected component and controller via IConnectionPoint\n");
+                    fflush(stdout);
+                } else {
+                    fprintf(stdout, "⚠️ Plugin does not support IConnectionPoint (componentCP=%p, controllerCP=%p)\n",
+                            (void*)componentCP.get(), (void*)controllerCP.get());
+                    fflush(stdout);
+                }
+
+                // CC / pitch bend / aftertouch assignments for the audio thread
+                build_midi_mapping(instance.get());
+            }
+        }
+
+        return instance.release();
+
+    } catch (const std::exception& e) {
+        set_error(VST3_ERROR_LOAD_FAILED, std::string("Load error: ") + e.what());
+        return nullptr;
+    }
+}
+
+VST3PluginHandle vst3_load_plugin(const char* file_path) {
+    return load_plugin_class(file_path, nullptr);
+}
+
+VST3PluginHandle vst3_load_plugin_class(const char* file_path, const char* class_name) {
+    return load_plugin_class(file_path, class_name);
+}
+
+bool vst3_load_plugin_async(const char* file_path, double sample_rate, int max_block_size,
+                            VST3LoadCallback callback, void* user_data) {
+    if (!file_path || !callback) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return false;
+    }
+
+    if (!g_host_app) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Host not initialized. Call vst3_host_init() first");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_loader_mutex);
+
+        // Loader threads are started on first use and live until shutdown
+        if (g_loader_threads.empty()) {
+            unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+            num_threads = std::min(num_threads, kMaxLoaderThreads);
+            for (unsigned i = 0; i < num_threads; i++) {
+                g_loader_threads.emplace_back(loader_thread_main);
+            }
+        }
+
+        LoadJob job;
+        job.file_path = file_path;
+        job.sample_rate = sample_rate;
+        job.max_block_size = max_block_size;
+        job.callback = callback;
+        job.user_data = user_data;
+        g_loader_jobs.push_back(std::move(job));
+    }
+    g_loader_cv.notify_one();
+
+    return true;
+}
+
+bool vst3_pool_configure(int instances_per_class, int max_classes, double sample_rate, int max_block_size) {
+    if (instances_per_class < 0 || max_classes < 0 || sample_rate <= 0.0 || max_block_size <= 0) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return false;
+    }
+    if (!g_host_app) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Host not initialized. Call vst3_host_init() first");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        if (g_pool_stopping) {
+            set_error(VST3_ERROR_NOT_INITIALIZED, "VST3 host is shutting down");
+            return false;
+        }
+        if (sample_rate != g_pool_sample_rate || max_block_size != g_pool_block_size) {
+            // Warm instances are set up for the old rate / block size
+            for (auto& [path, pool_class] : g_pool_classes) {
+                g_pool_doomed.insert(g_pool_doomed.end(), pool_class.ready.begin(), pool_class.ready.end());
+                pool_class.ready.clear();
+            }
+            g_pool_generation++;
+        }
+        g_pool_size = instances_per_class;
+        g_pool_max_classes = max_classes;
+        g_pool_sample_rate = sample_rate;
+        g_pool_block_size = max_block_size;
+
+        for (auto& [path, pool_class] : g_pool_classes) {
+            while (static_cast<int>(pool_class.ready.size()) > g_pool_size) {
+                g_pool_doomed.push_back(pool_class.ready.back());
+                pool_class.ready.pop_back();
+            }
+        }
+        if (g_pool_size == 0) {
+            while (!g_pool_classes.empty()) {
+                pool_drop_class(g_pool_classes.begin());
+            }
+        } else {
+            pool_evict();
+        }
+
+        // Started on first use and lives until shutdown
+        if (!g_pool_thread.joinable()) {
+            g_pool_thread = std::thread(pool_thread_main);
+        }
+    }
+    g_pool_cv.notify_one();
+    return true;
+}
+
+bool vst3_pool_pin(const char* file_path, bool pinned) {
+    if (!file_path) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        if (g_pool_size == 0) {
+            set_error(VST3_ERROR_WRONG_STATE, "Instance pool is off. Call vst3_pool_configure() first");
+            return false;
+        }
+        if (pinned) {
+            pool_touch(file_path).pinned = true;
+        } else {
+            auto it = g_pool_classes.find(file_path);
+            if (it != g_pool_classes.end()) {
+                it->second.pinned = false;
+                pool_evict();
+            }
+        }
+    }
+    g_pool_cv.notify_one();
+    return true;
+}
+
+VST3PluginHandle vst3_pool_acquire(const char* file_path, double sample_rate, int max_block_size) {
+    if (!file_path) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return nullptr;
+    }
+
+    VST3PluginHandle handle = nullptr;
+    bool pooled = false;
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        if (g_pool_size > 0) {
+            pooled = true;
+            PoolClass& pool_class = pool_touch(file_path);
+            if (!pool_class.ready.empty()) {
+                handle = pool_class.ready.back();
+                pool_class.ready.pop_back();
+            }
+            pool_evict();
+        }
+    }
+    if (pooled) {
+        g_pool_cv.notify_one();  // Refill, or warm a class just used for the first time
+    }
+
+    // A warm instance only needs moving if the caller runs at another setup
+    if (handle && !vst3_reconfigure(handle, sample_rate, max_block_size)) {
+        vst3_unload_plugin(handle);
+        handle = nullptr;
+    }
+    if (!handle) {
+        LoadJob job;
+        job.file_path = file_path;
+        job.sample_rate = sample_rate;
+        job.max_block_size = max_block_size;
+        handle = load_and_activate(job);
+        if (!handle) {
+            // Don't let the pool thread try the same broken bundle again
+            std::lock_guard<std::mutex> lock(g_pool_mutex);
+            auto it = g_pool_classes.find(file_path);
+            if (it != g_pool_classes.end()) {
+                it->second.failed = true;
+            }
+            return nullptr;
+        }
+        if (pooled) {
+            pool_capture_default_state(file_path, handle);
+        }
+    }
+
+    if (pooled) {
+        PoolLease lease;
+        lease.file_path = file_path;
+        lease.state_generation = vst3_get_state_generation(handle);
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        g_pool_leases[handle] = std::move(lease);
+    }
+    return handle;
+}
+
+void vst3_pool_release(VST3PluginHandle handle) {
+    if (!handle) return;
+
+    // The editor belongs to the caller's (UI) thread
+    vst3_close_editor(handle);
+
+    bool unload_here = false;
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        auto it = g_pool_leases.find(handle);
+        if (it != g_pool_leases.end() && g_pool_size > 0) {
+            g_pool_returned.emplace_back(handle, std::move(it->second));
+        } else if (g_pool_thread.joinable()) {
+            g_pool_doomed.push_back(handle);
+        } else {
+            unload_here = true;
+        }
+        if (it != g_pool_leases.end()) {
+            g_pool_leases.erase(it);
+        }
+    }
+
+    if (unload_here) {
+        vst3_unload_plugin(handle);
+    } else {
+        g_pool_cv.notify_one();
+    }
+}
+
+int vst3_pool_ready_count(const char* file_path) {
+    if (!file_path) return 0;
+
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    auto it = g_pool_classes.find(file_path);
+    return it == g_pool_classes.end() ? 0 : static_cast<int>(it->second.ready.size());
+}
+
+// An active instance has both IComponent::setActive and
+// IAudioProcessor::setProcessing switched on. setProcessing may answer
+// kNotImplemented, which is fine. Bus switching and setupProcessing() happen
+// with both off
+static tresult start_processing(VST3PluginInstance* instance) {
+    tresult result = instance->component->setActive(true);
+    if (result != kResultOk) {
+        set_error(VST3_ERROR_PLUGIN_REFUSED, "Plugin refused to activate");
+        return result;
+    }
+    result = instance->processor->setProcessing(true);
+    if (result != kResultOk && result != kNotImplemented) {
+        instance->component->setActive(false);
+        set_error(VST3_ERROR_PLUGIN_REFUSED, "Failed to start processing");
+        return result;
+    }
+
+    instance->active = true;
+    instance->sleeping = false;
+    instance->output_silent = false;
+    instance->idle_samples = 0;
+    instance->tail_samples = instance->processor->getTailSamples();
+    return kResultOk;
+}
+
+static void stop_processing(VST3PluginInstance* instance) {
+    instance->processor->setProcessing(false);
+    instance->component->setActive(false);
+    instance->active = false;
+}
+
+void vst3_unload_plugin(VST3PluginHandle handle) {
+    if (!handle) return;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+
+    if (instance->bridge) {
+        shutdown_bridge(instance->bridge.get());
+        delete instance;
+        return;
+    }
+
+    // Deactivate if active
+    if (instance->active && instance->processor) {
+        stop_processing(instance);
+    }
+
+    // Disconnect component and controller via IConnectionPoint before terminating
+    if (instance->component && instance->controller) {
+        FUnknownPtr<IConnectionPoint> componentCP(instance->component);
+        FUnknownPtr<IConnectionPoint> controllerCP(instance->controller);
+
+        if (componentCP && controllerCP) {
+            componentCP->disconnect(controllerCP);
+            controllerCP->disconnect(componentCP);
+            fprintf(stdout, "✅ Disconnected component and controller via IConnectionPoint\n");
+            fflush(stdout);
+        }
+    }
+
+    // Cleanup
+    if (instance->controller) {
+        instance->controller->setComponentHandler(nullptr);
+        instance->controller->terminate();
+    }
+    if (instance->component_handler) {
+        instance->component_handler->detach();
+    }
+
+    if (instance->component) {
+        instance->component->terminate();
+    }
+
+    release_context_requirements(instance);
+    delete instance;
+}
+
+void vst3_set_bridge_helper_path(const char* path) {
+    std::lock_guard<std::mutex> lock(g_bridge_mutex);
+    g_bridge_helper_path = path ? path : "";
+}
+
+bool vst3_set_plugin_bridged(const char* file_path, bool bridged) {
+    if (!file_path || !*file_path) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid file path");
+        return false;
+    }
+    if (bridged && !VST3_HOST_HAS_BRIDGE) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Plugin bridging is not supported on this platform");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_bridge_mutex);
+    if (bridged) {
+        g_bridged_plugins.insert(file_path);
+    } else {
+        g_bridged_plugins.erase(file_path);
+    }
+    return true;
+}
+
+bool vst3_is_plugin_bridged(VST3PluginHandle handle) {
+    return handle && static_cast<VST3PluginInstance*>(handle)->bridge != nullptr;
+}
+
+bool vst3_get_plugin_info(VST3PluginHandle handle, VST3PluginInfo* info) {
+    if (!handle || !info) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        *info = instance->bridge->info;
+        return true;
+    }
+    std::memset(info, 0, sizeof(VST3PluginInfo));
+
+    // Parsed once per module when it was loaded
+    if (instance->module && instance->class_index < instance->module->descriptions.size()) {
+        *info = instance->module->descriptions[instance->class_index];
+    } else {
+        info->is_effect = true;
+    }
+    std::strncpy(info->file_path, instance->file_path.c_str(), sizeof(info->file_path) - 1);
+
+    return true;
+}
+
+// Activate the main buses and the aux buses the host asked for (sidechain,
+// multi-out). The plugin must not be active
+static bool activate_buses(VST3PluginInstance* instance) {
+    tresult inputBusResult = instance->component->activateBus(kAudio, kInput, 0, true);
+    fprintf(stdout, "🎛️ [C++] activateBus(input) result: %d\n", inputBusResult);
+    fflush(stdout);
+    // Some plugins don't have input (instruments) - that's OK
+
+    tresult outputBusResult = instance->component->activateBus(kAudio, kOutput, 0, true);
+    fprintf(stdout, "🎛️ [C++] activateBus(output) result: %d\n", outputBusResult);
+    fflush(stdout);
+
+    if (outputBusResult != kResultOk) {
+        set_error(VST3_ERROR_PLUGIN_REFUSED, "Failed to activate output bus");
+        return false;
+    }
+
+    ensure_bus_state(instance);
+    for (size_t i = 1; i < instance->input_bus_active.size(); i++) {
+        if (instance->input_bus_active[i]) {
+            instance->component->activateBus(kAudio, kInput, static_cast<int32>(i), true);
+        }
+    }
+    for (size_t i = 1; i < instance->output_bus_active.size(); i++) {
+        if (instance->output_bus_active[i]) {
+            instance->component->activateBus(kAudio, kOutput, static_cast<int32>(i), true);
+        }
+    }
+    return true;
+}
+
+// Settle bus arrangements and (re)run setupProcessing() with the instance's
+// current mode, sample size, sample rate and block size. kSample64 is only
+// used if the host asked for it and the plugin supports it; a plugin that
+// then rejects the 64-bit setup is set up again in 32-bit.
+// A new setup can change what the plugin reads from the context and which
+// buses it has active, so both are redone after every successful one.
+// The plugin must not be processing
+static bool setup_processing(VST3PluginInstance* instance) {
+    IAudioProcessor* processor = instance->processor;
+    instance->sample_size =
+        instance->prefer_double && processor->canProcessSampleSize(kSample64) == kResultTrue
+            ? kSample64 : kSample32;
+
+    for (;;) {
+        // Bus arrangements have to be settled before setupProcessing()
+        build_process_context(instance);
+
+        ProcessSetup setup;
+        setup.processMode = instance->process_mode;
+        setup.symbolicSampleSize = instance->sample_size;
+        setup.maxSamplesPerBlock = instance->max_block_size;
+        setup.sampleRate = instance->sample_rate;
+
+        tresult setupResult = processor->setupProcessing(setup);
+        fprintf(stdout, "🎛️ [C++] setupProcessing(%s, %d, %d-bit) result: %d\n",
+                instance->process_mode == kOffline ? "offline" : "realtime",
+                instance->max_block_size, instance->sample_size == kSample64 ? 64 : 32, setupResult);
+        fflush(stdout);
+
+        if (setupResult == kResultOk) {
+            update_context_requirements(instance);
+            return activate_buses(instance);
+        }
+        if (instance->sample_size != kSample64) {
+            set_error(VST3_ERROR_PLUGIN_REFUSED, "Failed to setup processing");
+            return false;
+        }
+        instance->sample_size = kSample32;
+    }
+}
+
+// Stop the plugin if it's processing, run `reconfigure` and restart it.
+// setupProcessing() is only allowed while the plugin isn't active
+template <typename Reconfigure>
+static bool reconfigure_stopped(VST3PluginInstance* instance, Reconfigure reconfigure) {
+    const bool was_active = instance->active;
+    if (was_active) {
+        stop_processing(instance);
+    }
+
+    bool ok = reconfigure();
+
+    if (was_active && !vst3_activate_plugin(instance)) {
+        return false;
+    }
+    return ok;
+}
+
+bool vst3_initialize_plugin(VST3PluginHandle handle, double sample_rate, int max_block_size) {
+    fprintf(stdout, "🎛️ [C++] vst3_initialize_plugin called: handle=%p, sample_rate=%f, block_size=%d\n",
+            handle, sample_rate, max_block_size);
+    fflush(stdout);
+
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        if (max_block_size > bridge::kMaxBlockFrames) {
+            set_error(VST3_ERROR_INVALID_ARGUMENT, "Block size too large for the plugin bridge");
+            return false;
+        }
+        if (!bridge_request(instance->bridge.get(), 0, bridge::kInitialize, max_block_size, 0,
+                            sample_rate, kBridgeSetupTimeoutMs)) {
+            return false;
+        }
+        instance->sample_rate = sample_rate;
+        instance->max_block_size = max_block_size;
+        instance->realtime_block_size = max_block_size;
+        instance->bridge->pipeline_frames.store(max_block_size, std::memory_order_relaxed);
+        size_interleave_scratch(instance);
+        instance->initialized = true;
+        return true;
+    }
+    if (!instance->processor) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No audio processor interface");
+        fprintf(stderr, "❌ [C++] vst3_initialize_plugin: No audio processor interface\n");
+        fflush(stderr);
+        return false;
+    }
+
+    instance->sample_rate = sample_rate;
+    instance->max_block_size = max_block_size;
+    if (instance->process_mode == kRealtime) {
+        instance->realtime_block_size = max_block_size;
+    }
+
+    if (!setup_processing(instance)) {
+        return false;
+    }
+
+    instance->initialized = true;
+    fprintf(stdout, "✅ [C++] vst3_initialize_plugin: success\n");
+    fflush(stdout);
+    return true;
+}
+
+bool vst3_activate_plugin(VST3PluginHandle handle) {
+    fprintf(stdout, "🎛️ [C++] vst3_activate_plugin called: handle=%p\n", handle);
+    fflush(stdout);
+
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        instance->active = bridge_request(instance->bridge.get(), 0, bridge::kActivate, 0, 0, 0.0,
+                                          kBridgeSetupTimeoutMs) != 0;
+        return instance->active;
+    }
+    if (!instance->initialized || !instance->processor) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Plugin not initialized");
+        fprintf(stderr, "❌ [C++] vst3_activate_plugin: Plugin not initialized\n");
+        fflush(stderr);
+        return false;
+    }
+
+    tresult result = start_processing(instance);
+    fprintf(stdout, "🎛️ [C++] setActive/setProcessing(true) result: %d\n", result);
+    fflush(stdout);
+    return result == kResultOk;
+}
+
+bool vst3_deactivate_plugin(VST3PluginHandle handle) {
+    if (!handle) return false;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        instance->active = false;
+        return bridge_request(instance->bridge.get(), 0, bridge::kDeactivate) != 0;
+    }
+    if (instance->active && instance->processor) {
+        stop_processing(instance);
+    }
+
+    return true;
+}
+
+bool vst3_reset_plugin(VST3PluginHandle handle) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_request(instance->bridge.get(), 0, bridge::kReset) != 0;
+    }
+    if (!instance->active || !instance->processor) {
+        return true;
+    }
+
+    // The processing setup, buses and parameters stay as they are
+    stop_processing(instance);
+    return start_processing(instance) == kResultOk;
+}
+
+bool vst3_reconfigure(VST3PluginHandle handle, double sample_rate, int max_block_size) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+    if (sample_rate <= 0.0 || max_block_size <= 0) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid sample rate or block size");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (!instance->initialized) {
+        return vst3_initialize_plugin(handle, sample_rate, max_block_size);
+    }
+
+    // While offline, the block size applies when the plugin goes back to
+    // realtime; only a sample rate change needs a new setup now
+    const bool offline = instance->process_mode == kOffline;
+    const int realtime_block_size = offline ? instance->realtime_block_size : instance->max_block_size;
+    if (sample_rate == instance->sample_rate && max_block_size == realtime_block_size) {
+        return true;
+    }
+
+    if (instance->bridge) {
+        if (max_block_size > bridge::kMaxBlockFrames) {
+            set_error(VST3_ERROR_INVALID_ARGUMENT, "Block size too large for the plugin bridge");
+            return false;
+        }
+        if (!bridge_request(instance->bridge.get(), 0, bridge::kReconfigure, max_block_size, 0,
+                            sample_rate, kBridgeSetupTimeoutMs)) {
+            return false;
+        }
+        instance->sample_rate = sample_rate;
+        instance->realtime_block_size = max_block_size;
+        if (!offline) {
+            instance->max_block_size = max_block_size;
+            size_interleave_scratch(instance);
+        }
+        return true;
+    }
+    if (!instance->processor) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No audio processor interface");
+        return false;
+    }
+
+    const double old_sample_rate = instance->sample_rate;
+    const int old_block_size = instance->max_block_size;
+    const int old_realtime_block_size = instance->realtime_block_size;
+    if (sample_rate == old_sample_rate && offline) {
+        instance->realtime_block_size = max_block_size;
+        return true;
+    }
+
+    return reconfigure_stopped(instance, [&]() {
+        instance->sample_rate = sample_rate;
+        instance->realtime_block_size = max_block_size;
+        if (!offline) {
+            instance->max_block_size = max_block_size;
+        }
+
+        bool ok = setup_processing(instance);
+        if (!ok) {
+            // Fall back to the last working setup so the instance stays usable
+            LastError error = g_last_error;
+            instance->sample_rate = old_sample_rate;
+            instance->max_block_size = old_block_size;
+            instance->realtime_block_size = old_realtime_block_size;
+            setup_processing(instance);
+            g_last_error = error;
+        }
+        return ok;
+    });
+}
+
+int vst3_get_latency_samples(VST3PluginHandle handle) {
+    if (!handle) return 0;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        // Plus the block the pipeline holds back in realtime mode
+        const int pipeline = instance->process_mode == kRealtime
+            ? instance->bridge->pipeline_frames.load(std::memory_order_relaxed) : 0;
+        return static_cast<int>(bridge_request(instance->bridge.get(), 0, bridge::kGetLatency)) + pipeline;
+    }
+    if (!instance->processor) return 0;
+
+    return static_cast<int>(instance->processor->getLatencySamples());
+}
+
+uint32_t vst3_get_latency_change_count() {
+    return g_latency_change_count.load(std::memory_order_acquire);
+}
+
+uint32_t vst3_get_plugin_latency_change_count(VST3PluginHandle handle) {
+    if (!handle) return 0;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    return instance->latency_changes.load(std::memory_order_acquire);
+}
+
+bool vst3_set_offline_mode(VST3PluginHandle handle, bool offline, int max_block_size) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        const int block_size = max_block_size > 0
+            ? max_block_size : offline ? instance->max_block_size : instance->realtime_block_size;
+        if (block_size > bridge::kMaxBlockFrames) {
+            set_error(VST3_ERROR_INVALID_ARGUMENT, "Block size too large for the plugin bridge");
+            return false;
+        }
+        if (!bridge_request(instance->bridge.get(), 0, bridge::kSetOfflineMode, offline ? 1 : 0,
+                            block_size, 0.0, kBridgeSetupTimeoutMs)) {
+            return false;
+        }
+        if (instance->process_mode == kRealtime) {
+            instance->realtime_block_size = instance->max_block_size;
+        }
+        instance->process_mode = offline ? kOffline : kRealtime;
+        instance->max_block_size = block_size;
+        size_interleave_scratch(instance);
+        return true;
+    }
+    if (!instance->initialized || !instance->processor) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Plugin not initialized");
+        return false;
+    }
+
+    int block_size = max_block_size;
+    if (block_size <= 0) {
+        block_size = offline ? instance->max_block_size : instance->realtime_block_size;
+    }
+
+    const int32 mode = offline ? kOffline : kRealtime;
+    if (mode == instance->process_mode && block_size == instance->max_block_size) {
+        return true;
+    }
+
+    return reconfigure_stopped(instance, [&]() {
+        if (instance->process_mode == kRealtime) {
+            instance->realtime_block_size = instance->max_block_size;
+        }
+        instance->process_mode = mode;
+        instance->max_block_size = block_size;
+
+        bool ok = setup_processing(instance);
+        if (!ok) {
+            // Fall back to the last working setup so the instance stays usable
+            LastError error = g_last_error;
+            instance->process_mode = kRealtime;
+            instance->max_block_size = instance->realtime_block_size;
+            setup_processing(instance);
+            g_last_error = error;
+        }
+        return ok;
+    });
+}
+
+bool vst3_is_offline_mode(VST3PluginHandle handle) {
+    if (!handle) return false;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    return instance->process_mode == kOffline;
+}
+
+bool vst3_set_double_precision(VST3PluginHandle handle, bool enabled) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge && enabled) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Bridged plugins process 32-bit float only");
+        return false;
+    }
+    if (instance->prefer_double == enabled) {
+        return true;
+    }
+    instance->prefer_double = enabled;
+
+    // Applied by vst3_initialize_plugin if it hasn't run yet
+    if (!instance->initialized || !instance->processor) {
+        return true;
+    }
+
+    return reconfigure_stopped(instance, [&]() { return setup_processing(instance); });
+}
+
+int vst3_get_sample_size(VST3PluginHandle handle) {
+    if (!handle) return 32;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    return instance->sample_size == kSample64 ? 64 : 32;
+}
+
+bool vst3_set_auto_sleep(VST3PluginHandle handle, bool enabled) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_request(instance->bridge.get(), 0, bridge::kSetAutoSleep, enabled ? 1 : 0) != 0;
+    }
+    instance->auto_sleep = enabled;
+    return true;
+}
+
+bool vst3_is_output_silent(VST3PluginHandle handle) {
+    if (!handle) return false;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return instance->bridge->ipc.region->output_silent.load(std::memory_order_relaxed) != 0;
+    }
+    return instance->output_silent || instance->sleeping;
+}
+
+int vst3_get_bus_count(VST3PluginHandle handle, bool input) {
+    if (!handle) return 0;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return static_cast<int>(bridge_request(instance->bridge.get(), 0, bridge::kGetBusCount, input ? 1 : 0));
+    }
+    if (!instance->component) return 0;
+
+    return std::max(0, instance->component->getBusCount(kAudio, input ? kInput : kOutput));
+}
+
+bool vst3_get_bus_info(VST3PluginHandle handle, bool input, int index, VST3BusInfo* info) {
+    if (!handle || !info) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_request_struct(instance->bridge.get(), bridge::kGetBusInfo, info, input ? 1 : 0, index);
+    }
+    if (!instance->component) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No component");
+        return false;
+    }
+
+    const BusDirection dir = input ? kInput : kOutput;
+    BusInfo bus_info = {};
+    if (instance->component->getBusInfo(kAudio, dir, index, bus_info) != kResultOk) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid bus index");
+        return false;
+    }
+
+    std::memset(info, 0, sizeof(VST3BusInfo));
+    utf16_to_utf8(bus_info.name, info->name, sizeof(info->name));
+
+    // Channel count as negotiated once the process context exists
+    const auto& buses = input ? instance->input_buses : instance->output_buses;
+    info->channel_count = index < static_cast<int>(buses.size())
+        ? buses[index].numChannels : bus_info.channelCount;
+    info->is_aux = bus_info.busType == kAux;
+
+    ensure_bus_state(instance);
+    const auto& active = input ? instance->input_bus_active : instance->output_bus_active;
+    info->is_active = index < static_cast<int>(active.size()) && active[index];
+
+    return true;
+}
+
+bool vst3_set_bus_channels(VST3PluginHandle handle, bool input, int index, int channels) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Bridged plugins only use the main stereo buses");
+        return false;
+    }
+    if (instance->initialized) {
+        set_error(VST3_ERROR_WRONG_STATE, "Bus layout must be set before vst3_initialize_plugin");
+        return false;
+    }
+
+    auto& requested = input ? instance->requested_input_channels : instance->requested_output_channels;
+    if (channels == 0) {
+        requested.erase(index);
+        return true;
+    }
+
+    if (arrangement_for_channels(channels) == SpeakerArr::kEmpty) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Unsupported channel count");
+        return false;
+    }
+
+    requested[index] = channels;
+    return true;
+}
+
+bool vst3_set_bus_active(VST3PluginHandle handle, bool input, int index, bool active) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Bridged plugins only use the main stereo buses");
+        return false;
+    }
+    if (!instance->component) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No component");
+        return false;
+    }
+
+    if (instance->active) {
+        set_error(VST3_ERROR_WRONG_STATE, "Buses can only be switched while the plugin is deactivated");
+        return false;
+    }
+
+    ensure_bus_state(instance);
+    auto& flags = input ? instance->input_bus_active : instance->output_bus_active;
+    if (index < 0 || index >= static_cast<int>(flags.size())) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid bus index");
+        return false;
+    }
+
+    // Before initialization this is applied in vst3_initialize_plugin
+    if (instance->initialized &&
+        instance->component->activateBus(kAudio, input ? kInput : kOutput, index, active) != kResultOk) {
+        set_error(VST3_ERROR_PLUGIN_REFUSED, "Plugin refused to switch the bus");
+        return false;
+    }
+
+    flags[index] = active;
+    return true;
+}
+
+// Map a block-relative sample offset onto the sub-block [offset, offset + chunk).
+// Anything past the end of the block lands in the last sub-block.
+static bool route_to_sub_block(int32 sample_offset, int offset, int chunk, bool last_chunk, int32& rebased) {
+    if (sample_offset < offset && offset > 0) {
+        return false;  // Already delivered with an earlier sub-block
+    }
+    if (sample_offset >= offset + chunk && !last_chunk) {
+        return false;  // Belongs to a later sub-block
+    }
+    rebased = std::max(0, std::min(sample_offset - offset, chunk - 1));
+    return true;
+}
+
+// Set input silence flags from the bound buffers. Channels wired to the
+// shared silence buffer are silent by definition; the rest get a peak check.
+// Returns true if every input channel is silent.
+template <typename Sample>
+static bool update_input_silence(VST3PluginInstance* instance, int num_samples) {
+    const Sample* silence = silence_of<Sample>(instance);
+    bool all_silent = true;
+    for (auto& bus : instance->input_buses) {
+        uint64 flags = 0;
+        for (int32 c = 0; c < bus.numChannels; c++) {
+            const Sample* buffer = bus_channels<Sample>(bus)[c];
+            if (buffer == silence || buffer_is_silent(buffer, num_samples)) {
+                if (c < 64) flags |= 1ULL << c;
+            } else {
+                all_silent = false;
+            }
+        }
+        bus.silenceFlags = flags;
+    }
+    return all_silent;
+}
+
+// Honor the output silence flags the plugin returned: flagged channels are
+// zeroed (their contents are not guaranteed), the rest get a peak check.
+// Returns true if every bound output channel is silent.
+template <typename Sample>
+static bool apply_output_silence(VST3PluginInstance* instance, int num_samples) {
+    const Sample* discard = discard_of<Sample>(instance);
+    bool all_silent = true;
+    for (auto& bus : instance->output_buses) {
+        for (int32 c = 0; c < bus.numChannels; c++) {
+            Sample* buffer = bus_channels<Sample>(bus)[c];
+            if (buffer == discard) {
+                continue;
+            }
+            if (c < 64 && (bus.silenceFlags & (1ULL << c))) {
+                std::memset(buffer, 0, num_samples * sizeof(Sample));
+            } else if (all_silent && !buffer_is_silent(buffer, num_samples)) {
+                all_silent = false;
+            }
+        }
+    }
+    return all_silent;
+}
+
+// What the plugin would have produced while asleep
+template <typename Sample>
+static void silence_outputs(VST3PluginInstance* instance, int num_samples) {
+    const Sample* discard = discard_of<Sample>(instance);
+    for (auto& bus : instance->output_buses) {
+        Sample** channels = bus_channels<Sample>(bus);
+        for (int32 c = 0; c < bus.numChannels; c++) {
+            if (channels[c] != discard) {
+                std::memset(channels[c], 0, num_samples * sizeof(Sample));
+            }
+        }
+        bus.silenceFlags = bus.numChannels >= 64 ? ~0ULL : ((1ULL << bus.numChannels) - 1);
+    }
+}
+
+// Histogram bucket for a process() time in microseconds
+static int stats_bucket(uint64 us) {
+    if (us < kStatsSubBuckets) {
+        return static_cast<int>(us);
+    }
+    int octave = 3;
+    while ((us >> (octave + 1)) != 0) {
+        octave++;
+    }
+    const int sub = static_cast<int>((us >> (octave - 3)) & (kStatsSubBuckets - 1));
+    return std::min(kStatsBuckets - 1, (octave - 2) * kStatsSubBuckets + sub);
+}
+
+// Upper edge of a histogram bucket in microseconds
+static double stats_bucket_limit(int bucket) {
+    if (bucket < kStatsSubBuckets) {
+        return bucket + 1.0;
+    }
+    const int octave = bucket / kStatsSubBuckets + 2;
+    const int sub = bucket % kStatsSubBuckets;
+    return std::ldexp(static_cast<double>(kStatsSubBuckets + sub + 1), octave - 3);
+}
+
+// Account one process() call of `num_samples`. Audio thread only
+static void record_process_time(VST3PluginInstance* instance, int num_samples, std::chrono::nanoseconds elapsed) {
+    ProcessStats& stats = instance->stats;
+    const uint64 ns = static_cast<uint64>(std::max<int64>(0, elapsed.count()));
+    const uint64 budget = instance->sample_rate > 0.0
+        ? static_cast<uint64>(num_samples * 1.0e9 / instance->sample_rate) : 0;
+
+    auto add = [](std::atomic<uint64>& counter, uint64 amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    };
+    add(stats.calls, 1);
+    add(stats.total_ns, ns);
+    add(stats.budget_ns, budget);
+    stats.last_ns.store(ns, std::memory_order_relaxed);
+    if (ns > stats.max_ns.load(std::memory_order_relaxed)) {
+        stats.max_ns.store(ns, std::memory_order_relaxed);
+    }
+    // Offline renders are allowed to run slower than realtime
+    if (instance->process_mode == kRealtime && ns > budget) {
+        add(stats.overruns, 1);
+    }
+
+    auto& bucket = stats.histogram[stats_bucket(ns / 1000)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// Move events queued by producers into pending_events, keeping it sorted by
+// sample time. Producers mostly push in time order, so the insertion step
+// rarely moves anything. Events that don't fit are left in the queue for the
+// next block. Audio thread only
+static void collect_midi_events(VST3PluginInstance* instance) {
+    auto& pending = instance->pending_events;
+    TimedEvent timed;
+    while (pending.size() < kMidiQueueSize && instance->midi_queue.try_pop(timed)) {
+        pending.push_back(timed);
+        // Stable: events with the same time keep their queue order
+        for (size_t i = pending.size() - 1; i > 0 && pending[i - 1].sample_time > pending[i].sample_time; i--) {
+            std::swap(pending[i - 1], pending[i]);
+        }
+    }
+}
+
+// Drop the events delivered during the block and advance the sample clock
+static void finish_block(VST3PluginInstance* instance, int num_frames, size_t delivered_events) {
+    auto& pending = instance->pending_events;
+    pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(delivered_events));
+    instance->sample_position.fetch_add(num_frames, std::memory_order_release);
+}
+
+// Caller channel -> plugin channel binding. Matching sample sizes pass the
+// caller's pointer straight through; otherwise inputs are converted into the
+// channel's scratch slice and outputs land there until finish_output()
+// converts them back. NULL reads silence / writes to the discard buffer.
+template <typename Sample, typename CallerSample>
+static Sample* bind_input(VST3PluginInstance* instance, const CallerSample* src, int slot, int num_samples) {
+    if (!src) {
+        return silence_of<Sample>(instance);
+    }
+    if constexpr (std::is_same_v<Sample, CallerSample>) {
+        return const_cast<Sample*>(src);
+    } else {
+        Sample* dst = scratch_of<Sample>(instance, slot);
+        convert_samples(src, dst, num_samples);
+        return dst;
+    }
+}
+
+template <typename Sample, typename CallerSample>
+static Sample* bind_output(VST3PluginInstance* instance, CallerSample* dst, int slot) {
+    if (!dst) {
+        return discard_of<Sample>(instance);
+    }
+    if constexpr (std::is_same_v<Sample, CallerSample>) {
+        return dst;
+    } else {
+        return scratch_of<Sample>(instance, instance->total_input_channels + slot);
+    }
+}
+
+template <typename Sample, typename CallerSample>
+static void finish_output(const Sample* bound, CallerSample* dst, int num_samples) {
+    if constexpr (!std::is_same_v<Sample, CallerSample>) {
+        if (dst) {
+            convert_samples(bound, dst, num_samples);
+        }
+    }
+}
+
+// Shared process() loop, instantiated for the plugin's sample size. Splits
+// the block into sub-blocks of at most max_block_size, routes queued MIDI
+// and parameter changes into each one and publishes output parameter
+// changes. bind_buffers(offset, chunk) points the bus channels at the
+// caller's memory for the sub-block starting at `offset`; after_chunk(offset,
+// chunk) runs once the plugin has processed it.
+template <typename Sample, typename BindBuffers, typename AfterChunk>
+static bool process_sub_blocks(VST3PluginInstance* instance, int num_frames,
+                               BindBuffers bind_buffers, AfterChunk after_chunk) {
+    // Never hand the plugin more than it was set up for in setupProcessing()
+    const int block_size = instance->max_block_size > 0 ? instance->max_block_size : num_frames;
+    const int64 block_start = instance->sample_position.load(std::memory_order_relaxed);
+
+    // Collect parameter changes queued since the last block
+    instance->pending_params.clear();
+    ParamPoint point;
+    while (instance->pending_params.size() < kParamQueueSize && instance->param_queue.try_pop(point)) {
+        instance->pending_params.push_back(point);
+    }
+
+    // Collect MIDI events queued since the last block
+    collect_midi_events(instance);
+    size_t next_event = 0;
+
+    for (int offset = 0; offset < num_frames; offset += block_size) {
+        const int chunk = std::min(block_size, num_frames - offset);
+        const bool last_chunk = offset + chunk >= num_frames;
+
+        // Point the buses at the caller's buffers for this sub-block
+        bind_buffers(offset, chunk);
+
+        // Distribute parameter changes
+        instance->input_param_changes.clear();
+        for (const auto& change : instance->pending_params) {
+            int32 rebased = 0;
+            if (route_to_sub_block(change.sample_offset, offset, chunk, last_chunk, rebased)) {
+                instance->input_param_changes.add_point(change.id, rebased, change.value);
+            }
+        }
+
+        // Hand over the MIDI events due in this sub-block, in time order.
+        // Late events play at the start of the sub-block; anything beyond
+        // what one process() call takes slips into the next one. Mapped
+        // controller messages become parameter changes
+        IEventList* events = nullptr;
+        instance->block_events.clear();
+        const int64 chunk_start = block_start + offset;
+        const int64 chunk_end = chunk_start + chunk;
+        int32 delivered = 0;
+        while (next_event < instance->pending_events.size() && delivered < kMaxEventsPerBlock &&
+               instance->pending_events[next_event].sample_time < chunk_end) {
+            const TimedEvent& timed = instance->pending_events[next_event];
+            const int32 event_offset = static_cast<int32>(std::max<int64>(0, timed.sample_time - chunk_start));
+            if (timed.controller >= 0) {
+                ParamID id = midi_mapped_param(instance, timed.channel, timed.controller);
+                if (id != kNoParamId) {
+                    instance->input_param_changes.add_point(id, event_offset, timed.value);
+                }
+            } else {
+                Event event = timed.event;
+                event.sampleOffset = event_offset;
+                instance->block_events.addEvent(event);
+                delivered++;
+            }
+            next_event++;
+        }
+        if (delivered > 0) {
+            events = &instance->block_events;
+        }
+
+        // Does this sub-block give the plugin anything to do?
+        const bool input_silent = update_input_silence<Sample>(instance, chunk);
+        const bool idle = input_silent && !events && instance->input_param_changes.empty();
+        const uint64 idle_before = instance->idle_samples;
+        instance->idle_samples = idle ? idle_before + chunk : 0;
+
+        // Tail-aware sleep: the plugin has already processed more silent input
+        // than its tail and its output has gone quiet, so process() would only
+        // produce more silence
+        instance->sleeping = idle && instance->auto_sleep && instance->output_silent &&
+                             instance->tail_samples != kInfiniteTail &&
+                             idle_before >= instance->tail_samples;
+        if (instance->sleeping) {
+            silence_outputs<Sample>(instance, chunk);
+            after_chunk(offset, chunk);
+            continue;
+        }
+
+        for (auto& bus : instance->output_buses) {
+            bus.silenceFlags = 0;
+        }
+
+        ProcessData& data = instance->process_data;
+        data.numSamples = chunk;
+        data.processContext = process_context_for(instance, offset);
+
+        // For instruments, this is critical - they need MIDI to generate audio
+        data.inputEvents = events;
+        data.inputParameterChanges = instance->input_param_changes.empty()
+            ? nullptr : &instance->input_param_changes;
+        instance->output_param_changes.clear();
+        data.outputParameterChanges = &instance->output_param_changes;
+
+        // Process the audio
+        const auto process_start = std::chrono::steady_clock::now();
+        tresult result;
+        {
+            realtime::ScopedFlushDenormals fp_guard;
+            result = instance->processor->process(data);
+        }
+        record_process_time(instance, chunk, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - process_start));
+
+        if (result != kResultOk && result != kResultTrue) {
+            VST3_LOG_WARN("🎛️ [C++] process() failed: result=%d, %d samples", result, chunk);
+            finish_block(instance, num_frames, next_event);
+            set_error(VST3_ERROR_PROCESS_FAILED, "Audio processing failed");
+            return false;
+        }
+
+        instance->output_silent = apply_output_silence<Sample>(instance, chunk);
+
+        // Publish the final value of every parameter the plugin moved.
+        // Offsets are rebased to the whole block.
+        if (!instance->output_param_changes.empty()) {
+            const int32 count = instance->output_param_changes.getParameterCount();
+            for (int32 i = 0; i < count; i++) {
+                IParamValueQueue* queue = instance->output_param_changes.getParameterData(i);
+                const int32 points = queue ? queue->getPointCount() : 0;
+                int32 sample_offset = 0;
+                ParamValue value = 0.0;
+                if (points > 0 && queue->getPoint(points - 1, sample_offset, value) == kResultOk) {
+                    // Dropped if the UI thread has fallen behind - the next block
+                    // will report a newer value anyway
+                    instance->output_param_queue.try_push(
+                        ParamPoint{queue->getParameterId(), sample_offset + offset, value});
                 }
+            }
+        }
+
+        after_chunk(offset, chunk);
+    }
+
+    finish_block(instance, num_frames, next_event);
+    return true;
+}
+
+// Main-bus stereo processing for callers with `CallerSample` buffers,
+// converting if the plugin runs in the other sample size
+template <typename Sample, typename CallerSample>
+static bool process_main_buses(
+    VST3PluginInstance* instance,
+    const CallerSample* input_left,
+    const CallerSample* input_right,
+    CallerSample* output_left,
+    CallerSample* output_right,
+    int num_frames
+) {
+    auto bind_main_buses = [&](int offset, int chunk) {
+        if (instance->main_input_channels > 0) {
+            Sample** in = bus_channels<Sample>(instance->input_buses[0]);
+            in[0] = bind_input<Sample>(instance, input_left ? input_left + offset : nullptr, 0, chunk);
+            if (instance->main_input_channels > 1) {
+                in[1] = bind_input<Sample>(instance, input_right ? input_right + offset : nullptr, 1, chunk);
+            }
+        }
+        if (instance->main_output_channels > 0) {
+            Sample** out = bus_channels<Sample>(instance->output_buses[0]);
+            out[0] = bind_output<Sample>(instance, output_left + offset, 0);
+            if (instance->main_output_channels > 1) {
+                out[1] = bind_output<Sample>(instance, output_right + offset, 1);
+            }
+        }
+    };
+
+    auto finish_main_outputs = [&](int offset, int chunk) {
+        if (instance->main_output_channels > 0) {
+            Sample** out = bus_channels<Sample>(instance->output_buses[0]);
+            finish_output(out[0], output_left + offset, chunk);
+            if (instance->main_output_channels > 1) {
+                finish_output(out[1], output_right + offset, chunk);
+            }
+        }
+        // Mono (or no) main output - mirror / silence the missing channels
+        if (instance->main_output_channels == 0) {
+            std::memset(output_left + offset, 0, chunk * sizeof(CallerSample));
+        }
+        if (instance->main_output_channels < 2) {
+            std::memcpy(output_right + offset, output_left + offset, chunk * sizeof(CallerSample));
+        }
+    };
+
+    return process_sub_blocks<Sample>(instance, num_frames, bind_main_buses, finish_main_outputs);
+}
+
+template <typename CallerSample>
+static bool process_block_impl(
+    VST3PluginHandle handle,
+    const CallerSample* input_left,
+    const CallerSample* input_right,
+    CallerSample* output_left,
+    CallerSample* output_right,
+    int num_frames
+) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (!instance->active || (!instance->processor && !instance->bridge)) {
+        set_error(VST3_ERROR_NOT_ACTIVE, "Plugin not active");
+        return false;
+    }
+
+    if (!output_left || !output_right) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid output buffers");
+        return false;
+    }
+
+    if (num_frames <= 0) {
+        return true;
+    }
+
+    if (instance->bridge) {
+        if constexpr (std::is_same_v<CallerSample, float>) {
+            return bridge_process_block(instance, input_left, input_right, output_left, output_right, num_frames);
+        } else {
+            set_error(VST3_ERROR_NOT_SUPPORTED, "Bridged plugins process 32-bit float only");
+            return false;
+        }
+    }
+
+    bool ok = instance->sample_size == kSample64
+        ? process_main_buses<double>(instance, input_left, input_right, output_left, output_right, num_frames)
+        : process_main_buses<float>(instance, input_left, input_right, output_left, output_right, num_frames);
+
+    return ok;
+}
+
+bool vst3_process_block(
+    VST3PluginHandle handle,
+    const float* input_left,
+    const float* input_right,
+    float* output_left,
+    float* output_right,
+    int num_frames
+) {
+    return process_block_impl(handle, input_left, input_right, output_left, output_right, num_frames);
+}
 
-                // Get the edit controller
-                TUID controller_cid;
-                if (component->getControllerClassId(controller_cid) == kResultOk) {
-                    auto controller = factory.createInstance<IEditController>(VST3::UID::fromTUID(controller_cid));
-                    if (controller) {
-                        instance->controller = controller;
-                        controller->initialize(g_host_app);
-
-                        // CRITICAL: Set the component handler on the controller
-                        // This allows the plugin to notify us of parameter changes, restarts, etc.
-                        // Many plugins may crash or malfunction without this!
-                        if (g_component_handler) {
-                            tresult handlerResult = controller->setComponentHandler(g_component_handler);
-                            fprintf(stdout, "📊 setComponentHandler result: %d\n", handlerResult);
-                            fflush(stdout);
-                        }
-
-                        // CRITICAL: Connect component and controller via IConnectionPoint
-                        // This allows them to communicate - many plugins crash without this!
-                        // This matches what the SDK's PlugProvider::connectComponents() does.
-                        FUnknownPtr<IConnectionPoint> componentCP(component);
-                        FUnknownPtr<IConnectionPoint> controllerCP(controller);
-
-                        if (componentCP && controllerCP) {
-                            componentCP->connect(controllerCP);
-                            controllerCP->connect(componentCP);
-                            fprintf(stdout, "✅ Connected component and controller via IConnectionPoint\n");
-                            fflush(stdout);
-                        } else {
-                            fprintf(stdout, "⚠️ Plugin does not support IConnectionPoint (componentCP=%p, controllerCP=%p)\n",
-                                    (void*)componentCP.get(), (void*)controllerCP.get());
-                            fflush(stdout);
-                        }
-                    }
-                }
+bool vst3_process_block_double(
+    VST3PluginHandle handle,
+    const double* input_left,
+    const double* input_right,
+    double* output_left,
+    double* output_right,
+    int num_frames
+) {
+    return process_block_impl(handle, input_left, input_right, output_left, output_right, num_frames);
+}
 
-                return instance.release();
+// Main-bus stereo processing for interleaved callers. Each sub-block is
+// split into the instance's planar scratch right before the plugin runs and
+// merged back right after, so `input` may be `output`: a sub-block's input
+// is read before any of its output is written
+template <typename Sample>
+static bool process_interleaved_main_buses(VST3PluginInstance* instance, const float* input,
+                                           float* output, int num_frames) {
+    const size_t stride = static_cast<size_t>(instance->interleave_stride);
+    float* in_left = instance->interleave_scratch.data();
+    float* in_right = in_left + stride;
+    float* out_left = in_right + stride;
+    float* out_right = out_left + stride;
+
+    auto bind_main_buses = [&](int offset, int chunk) {
+        if (input) {
+            deinterleave_stereo(input + 2 * static_cast<size_t>(offset), in_left, in_right, chunk);
+        }
+        if (instance->main_input_channels > 0) {
+            Sample** in = bus_channels<Sample>(instance->input_buses[0]);
+            in[0] = bind_input<Sample>(instance, input ? in_left : nullptr, 0, chunk);
+            if (instance->main_input_channels > 1) {
+                in[1] = bind_input<Sample>(instance, input ? in_right : nullptr, 1, chunk);
+            }
+        }
+        if (instance->main_output_channels > 0) {
+            Sample** out = bus_channels<Sample>(instance->output_buses[0]);
+            out[0] = bind_output<Sample>(instance, out_left, 0);
+            if (instance->main_output_channels > 1) {
+                out[1] = bind_output<Sample>(instance, out_right, 1);
             }
         }
+    };
 
-        set_error("No audio effect class found in plugin");
-        return nullptr;
+    auto finish_main_outputs = [&](int offset, int chunk) {
+        if (instance->main_output_channels > 0) {
+            Sample** out = bus_channels<Sample>(instance->output_buses[0]);
+            finish_output(out[0], out_left, chunk);
+            if (instance->main_output_channels > 1) {
+                finish_output(out[1], out_right, chunk);
+            }
+        }
+        // Mono (or no) main output - mirror / silence the missing channels
+        if (instance->main_output_channels == 0) {
+            std::memset(out_left, 0, chunk * sizeof(float));
+        }
+        if (instance->main_output_channels < 2) {
+            std::memcpy(out_right, out_left, chunk * sizeof(float));
+        }
+        interleave_stereo(out_left, out_right, output + 2 * static_cast<size_t>(offset), chunk);
+    };
 
-    } catch (const std::exception& e) {
-        set_error(std::string("Load error: ") + e.what());
-        return nullptr;
-    }
+    return process_sub_blocks<Sample>(instance, num_frames, bind_main_buses, finish_main_outputs);
 }
 
-void vst3_unload_plugin(VST3PluginHandle handle) {
-    if (!handle) return;
+bool vst3_process_interleaved(VST3PluginHandle handle, const float* input, float* output, int num_frames) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
-
-    // Deactivate if active
-    if (instance->active && instance->processor) {
-        instance->processor->setProcessing(false);
-        instance->active = false;
+    if (!instance->active || (!instance->processor && !instance->bridge)) {
+        set_error(VST3_ERROR_NOT_ACTIVE, "Plugin not active");
+        return false;
     }
 
-    // Disconnect component and controller via IConnectionPoint before terminating
-    if (instance->component && instance->controller) {
-        FUnknownPtr<IConnectionPoint> componentCP(instance->component);
-        FUnknownPtr<IConnectionPoint> controllerCP(instance->controller);
-
-        if (componentCP && controllerCP) {
-            componentCP->disconnect(controllerCP);
-            controllerCP->disconnect(componentCP);
-            fprintf(stdout, "✅ Disconnected component and controller via IConnectionPoint\n");
-            fflush(stdout);
-        }
+    if (!output) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid output buffer");
+        return false;
     }
 
-    // Cleanup
-    if (instance->controller) {
-        instance->controller->terminate();
+    if (num_frames <= 0) {
+        return true;
     }
 
-    if (instance->component) {
-        instance->component->terminate();
+    if (instance->bridge) {
+        // The bridge copies into shared memory anyway; go through the
+        // scratch one scratch-sized piece at a time
+        const size_t stride = static_cast<size_t>(instance->interleave_stride);
+        float* scratch = instance->interleave_scratch.data();
+        bool ok = true;
+        for (int offset = 0; offset < num_frames && ok; offset += instance->interleave_stride) {
+            const int chunk = std::min(instance->interleave_stride, num_frames - offset);
+            const size_t at = 2 * static_cast<size_t>(offset);
+            if (input) {
+                deinterleave_stereo(input + at, scratch, scratch + stride, chunk);
+            }
+            ok = bridge_process_block(instance, input ? scratch : nullptr, input ? scratch + stride : nullptr,
+                                      scratch + 2 * stride, scratch + 3 * stride, chunk);
+            interleave_stereo(scratch + 2 * stride, scratch + 3 * stride, output + at, chunk);
+        }
+        return ok;
     }
 
-    delete instance;
+    return instance->sample_size == kSample64
+        ? process_interleaved_main_buses<double>(instance, input, output, num_frames)
+        : process_interleaved_main_buses<float>(instance, input, output, num_frames);
 }
 
-bool vst3_get_plugin_info(VST3PluginHandle handle, VST3PluginInfo* info) {
-    if (!handle || !info) {
-        set_error("Invalid parameters");
-        return false;
-    }
+// Every bus of a 32- or 64-bit plugin against the caller's float buses.
+// Anything the caller doesn't provide reads silence / writes to the discard
+// buffer
+template <typename Sample>
+static bool process_all_buses(
+    VST3PluginInstance* instance,
+    const VST3AudioBus* inputs,
+    int num_inputs,
+    const VST3AudioBus* outputs,
+    int num_outputs,
+    int num_frames
+) {
+    auto channel_of = [](const VST3AudioBus* buses, int count, size_t b, int32 c) -> float* {
+        if (static_cast<int>(b) >= count) return nullptr;
+        const VST3AudioBus& bus = buses[b];
+        return bus.channels && c < bus.num_channels ? bus.channels[c] : nullptr;
+    };
 
-    auto instance = static_cast<VST3PluginInstance*>(handle);
-    std::memset(info, 0, sizeof(VST3PluginInfo));
+    auto bind_all_buses = [&](int offset, int chunk) {
+        int slot = 0;
+        for (size_t b = 0; b < instance->input_buses.size(); b++) {
+            auto& bus = instance->input_buses[b];
+            Sample** channels = bus_channels<Sample>(bus);
+            for (int32 c = 0; c < bus.numChannels; c++, slot++) {
+                const float* src = channel_of(inputs, num_inputs, b, c);
+                channels[c] = bind_input<Sample>(instance, src ? src + offset : nullptr, slot, chunk);
+            }
+        }
 
-    // Get info from component
-    PFactoryInfo factory_info;
-    std::strncpy(info->file_path, instance->file_path.c_str(), sizeof(info->file_path) - 1);
+        slot = 0;
+        for (size_t b = 0; b < instance->output_buses.size(); b++) {
+            auto& bus = instance->output_buses[b];
+            Sample** channels = bus_channels<Sample>(bus);
+            for (int32 c = 0; c < bus.numChannels; c++, slot++) {
+                float* dst = channel_of(outputs, num_outputs, b, c);
+                channels[c] = bind_output<Sample>(instance, dst ? dst + offset : nullptr, slot);
+            }
+        }
+    };
 
-    // TODO: Extract more detailed info from component
-    info->is_effect = true;
-    info->is_instrument = false;
+    auto finish_all_outputs = [&](int offset, int chunk) {
+        if constexpr (!std::is_same_v<Sample, float>) {
+            for (size_t b = 0; b < instance->output_buses.size(); b++) {
+                auto& bus = instance->output_buses[b];
+                Sample** channels = bus_channels<Sample>(bus);
+                for (int32 c = 0; c < bus.numChannels; c++) {
+                    float* dst = channel_of(outputs, num_outputs, b, c);
+                    finish_output(channels[c], dst ? dst + offset : nullptr, chunk);
+                }
+            }
+        }
+    };
 
-    return true;
+    return process_sub_blocks<Sample>(instance, num_frames, bind_all_buses, finish_all_outputs);
 }
 
-bool vst3_initialize_plugin(VST3PluginHandle handle, double sample_rate, int max_block_size) {
-    fprintf(stdout, "🎛️ [C++] vst3_initialize_plugin called: handle=%p, sample_rate=%f, block_size=%d\n",
-            handle, sample_rate, max_block_size);
-    fflush(stdout);
-
+bool vst3_process_buses(
+    VST3PluginHandle handle,
+    const VST3AudioBus* inputs,
+    int num_inputs,
+    const VST3AudioBus* outputs,
+    int num_outputs,
+    int num_frames
+) {
     if (!handle) {
-        set_error("Invalid handle");
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
         return false;
     }
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (!instance->processor) {
-        set_error("No audio processor interface");
-        fprintf(stderr, "❌ [C++] vst3_initialize_plugin: No audio processor interface\n");
-        fflush(stderr);
+    if (instance->bridge) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Bridged plugins only use the main stereo buses");
+        return false;
+    }
+    if (!instance->active || !instance->processor) {
+        set_error(VST3_ERROR_NOT_ACTIVE, "Plugin not active");
         return false;
     }
 
-    instance->sample_rate = sample_rate;
-    instance->max_block_size = max_block_size;
+    if ((num_inputs > 0 && !inputs) || (num_outputs > 0 && !outputs)) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid bus buffers");
+        return false;
+    }
+
+    if (num_frames <= 0) {
+        return true;
+    }
 
-    // Setup processing
-    ProcessSetup setup;
-    setup.processMode = kRealtime;
-    setup.symbolicSampleSize = kSample32;
-    setup.maxSamplesPerBlock = max_block_size;
-    setup.sampleRate = sample_rate;
+    // Caller buffers are handed to a 32-bit plugin directly
+    bool ok = instance->sample_size == kSample64
+        ? process_all_buses<double>(instance, inputs, num_inputs, outputs, num_outputs, num_frames)
+        : process_all_buses<float>(instance, inputs, num_inputs, outputs, num_outputs, num_frames);
 
-    tresult setupResult = instance->processor->setupProcessing(setup);
-    fprintf(stdout, "🎛️ [C++] setupProcessing result: %d\n", setupResult);
-    fflush(stdout);
+    reset_bus_bindings(instance);
+
+    return ok;
+}
 
-    if (setupResult != kResultOk) {
-        set_error("Failed to setup processing");
+bool vst3_get_plugin_stats(VST3PluginHandle handle, VST3PluginStats* out) {
+    if (!handle || !out) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
         return false;
     }
 
-    // Activate busses
-    tresult inputBusResult = instance->component->activateBus(kAudio, kInput, 0, true);
-    fprintf(stdout, "🎛️ [C++] activateBus(input) result: %d\n", inputBusResult);
-    fflush(stdout);
-    // Some plugins don't have input (instruments) - that's OK
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_request_struct(instance->bridge.get(), bridge::kGetStats, out);
+    }
+    const ProcessStats& stats = instance->stats;
+
+    std::memset(out, 0, sizeof(VST3PluginStats));
+    out->process_calls = stats.calls.load(std::memory_order_relaxed);
+    out->overruns = stats.overruns.load(std::memory_order_relaxed);
+    out->max_us = stats.max_ns.load(std::memory_order_relaxed) / 1000.0;
+    out->last_us = stats.last_ns.load(std::memory_order_relaxed) / 1000.0;
+
+    const uint64 total_ns = stats.total_ns.load(std::memory_order_relaxed);
+    const uint64 budget_ns = stats.budget_ns.load(std::memory_order_relaxed);
+    if (out->process_calls > 0) {
+        out->mean_us = total_ns / 1000.0 / static_cast<double>(out->process_calls);
+    }
+    if (budget_ns > 0) {
+        out->load = static_cast<double>(total_ns) / static_cast<double>(budget_ns);
+    }
 
-    tresult outputBusResult = instance->component->activateBus(kAudio, kOutput, 0, true);
-    fprintf(stdout, "🎛️ [C++] activateBus(output) result: %d\n", outputBusResult);
-    fflush(stdout);
+    // p99 from the histogram; the counts can be a block apart from `calls`
+    uint64 counts[kStatsBuckets];
+    uint64 counted = 0;
+    for (int i = 0; i < kStatsBuckets; i++) {
+        counts[i] = stats.histogram[i].load(std::memory_order_relaxed);
+        counted += counts[i];
+    }
+    if (counted > 0) {
+        const uint64 target = counted - counted / 100;
+        uint64 seen = 0;
+        for (int i = 0; i < kStatsBuckets; i++) {
+            seen += counts[i];
+            if (seen >= target) {
+                out->p99_us = std::min(stats_bucket_limit(i), out->max_us);
+                break;
+            }
+        }
+    }
 
-    if (outputBusResult != kResultOk) {
-        set_error("Failed to activate output bus");
-        return false;
+    return true;
+}
+
+void vst3_reset_plugin_stats(VST3PluginHandle handle) {
+    if (!handle) return;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        bridge_request(instance->bridge.get(), 0, bridge::kResetStats);
+        return;
     }
+    instance->stats.reset();
+}
 
-    instance->initialized = true;
-    fprintf(stdout, "✅ [C++] vst3_initialize_plugin: success\n");
-    fflush(stdout);
+// Platform part of vst3_prepare_realtime_thread (vst3_host_win.cpp,
+// vst3_host_mac.mm). Sets *token to what release needs to undo, or NULL
+#if defined(__APPLE__) || defined(_WIN32)
+extern "C" bool vst3_platform_prepare_realtime_thread(void** token);
+extern "C" void vst3_platform_release_realtime_thread(void* token);
+#else
+static bool vst3_platform_prepare_realtime_thread(void** token) {
+    *token = nullptr;
     return true;
 }
 
-bool vst3_activate_plugin(VST3PluginHandle handle) {
-    fprintf(stdout, "🎛️ [C++] vst3_activate_plugin called: handle=%p\n", handle);
-    fflush(stdout);
+static void vst3_platform_release_realtime_thread(void*) {}
+#endif
 
-    if (!handle) {
-        set_error("Invalid handle");
-        return false;
+// Per-thread result of vst3_prepare_realtime_thread; the destructor leaves
+// the workgroup / MMCSS task on thread exit
+struct RealtimeThreadState {
+    bool prepared = false;
+    void* platform_token = nullptr;
+
+    void release() {
+        if (platform_token) {
+            vst3_platform_release_realtime_thread(platform_token);
+            platform_token = nullptr;
+        }
+        prepared = false;
     }
 
-    auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (!instance->initialized || !instance->processor) {
-        set_error("Plugin not initialized");
-        fprintf(stderr, "❌ [C++] vst3_activate_plugin: Plugin not initialized\n");
-        fflush(stderr);
-        return false;
+    ~RealtimeThreadState() {
+        release();
     }
+};
 
-    tresult result = instance->processor->setProcessing(true);
-    fprintf(stdout, "🎛️ [C++] setProcessing(true) result: %d\n", result);
-    fflush(stdout);
+static thread_local RealtimeThreadState g_realtime_thread;
 
-    if (result != kResultOk) {
-        set_error("Failed to start processing");
-        return false;
+bool vst3_prepare_realtime_thread() {
+    realtime::enable_flush_denormals();
+    if (g_realtime_thread.prepared) {
+        return true;
     }
 
-    instance->active = true;
+    g_realtime_thread.prepared = true;
+    if (!vst3_platform_prepare_realtime_thread(&g_realtime_thread.platform_token)) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Could not set up realtime scheduling for this thread");
+        return false;
+    }
     return true;
 }
 
-bool vst3_deactivate_plugin(VST3PluginHandle handle) {
-    if (!handle) return false;
+void vst3_release_realtime_thread() {
+    g_realtime_thread.release();
+}
 
-    auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (instance->active && instance->processor) {
-        instance->processor->setProcessing(false);
-        instance->active = false;
+VST3TransportHandle vst3_transport_create() {
+    return new TransportContext();
+}
+
+void vst3_transport_destroy(VST3TransportHandle transport) {
+    auto context = static_cast<TransportContext*>(transport);
+    if (g_bound_transport == context) {
+        g_bound_transport = nullptr;
     }
+    delete context;
+}
 
-    return true;
+void vst3_transport_update(VST3TransportHandle transport, const VST3Transport* state) {
+    auto context = static_cast<TransportContext*>(transport);
+    if (!context) {
+        return;
+    }
+    if (!state) {
+        context->valid = false;
+        return;
+    }
+    context->transport = *state;
+    context->requirements = g_context_requirements.load(std::memory_order_relaxed);
+    if (context->requirements & IProcessContextRequirements::kNeedSystemTime) {
+        context->system_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    fill_process_context(*context, 0, context->context);
+    context->valid = true;
+}
+
+VST3TransportHandle vst3_transport_bind(VST3TransportHandle transport) {
+    TransportContext* previous = g_bound_transport;
+    g_bound_transport = static_cast<TransportContext*>(transport);
+    return previous;
 }
 
 bool vst3_process_audio(
@@ -712,66 +4447,82 @@ bool vst3_process_audio(
     float* output_right,
     int num_frames
 ) {
-    if (!handle) {
-        set_error("Invalid handle");
-        return false;
-    }
+    return vst3_process_block(handle, input_left, input_right, output_left, output_right, num_frames);
+}
 
-    auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (!instance->active || !instance->processor) {
-        set_error("Plugin not active");
-        return false;
-    }
+// Build a MIDI event and push it onto the instance's event queue.
+// Lock-free; safe from any thread
+static bool queue_midi_event(VST3PluginInstance* instance, int event_type, int channel,
+                             int data1, int data2, int64 sample_time) {
+    // Create an event
+    TimedEvent timed;
+    std::memset(&timed, 0, sizeof(TimedEvent));
+    timed.sample_time = sample_time;
+    timed.controller = -1;
+    timed.channel = static_cast<int16>(channel);
+    Event& event = timed.event;
+    event.busIndex = 0;
+    event.sampleOffset = 0;  // Set from sample_time when the event is delivered
+    event.ppqPosition = 0;
+    event.flags = Event::kIsLive;
 
-    // Set up input buffers (stereo)
-    float* inputs[2] = {
-        const_cast<float*>(input_left),
-        const_cast<float*>(input_right)
-    };
+    // Event types: 0 = note on, 1 = note off, 2 = CC, 3 = pitch bend,
+    // 4 = channel aftertouch
+    switch (event_type) {
+        case 0: // Note On
+            event.type = Event::kNoteOnEvent;
+            event.noteOn.channel = static_cast<int16>(channel);
+            event.noteOn.pitch = static_cast<int16>(data1);
+            event.noteOn.velocity = static_cast<float>(data2) / 127.0f;
+            event.noteOn.length = 0;
+            event.noteOn.tuning = 0.0f;
+            event.noteOn.noteId = -1;
+            break;
 
-    // Set up output buffers (stereo)
-    float* outputs[2] = {
-        output_left,
-        output_right
-    };
+        case 1: // Note Off
+            event.type = Event::kNoteOffEvent;
+            event.noteOff.channel = static_cast<int16>(channel);
+            event.noteOff.pitch = static_cast<int16>(data1);
+            event.noteOff.velocity = static_cast<float>(data2) / 127.0f;
+            event.noteOff.tuning = 0.0f;
+            event.noteOff.noteId = -1;
+            break;
 
-    // Set up audio bus buffers
-    AudioBusBuffers input_bus;
-    input_bus.numChannels = 2;
-    input_bus.silenceFlags = 0;
-    input_bus.channelBuffers32 = inputs;
-
-    AudioBusBuffers output_bus;
-    output_bus.numChannels = 2;
-    output_bus.silenceFlags = 0;
-    output_bus.channelBuffers32 = outputs;
-
-    // Set up process data
-    ProcessData data;
-    data.processMode = kRealtime;
-    data.symbolicSampleSize = kSample32;
-    data.numSamples = num_frames;
-    data.numInputs = 1;
-    data.numOutputs = 1;
-    data.inputs = &input_bus;
-    data.outputs = &output_bus;
-    data.inputParameterChanges = nullptr;
-    data.outputParameterChanges = nullptr;
+        case 2: // Control Change (CC)
+            // VST3 has no CC events - the plugin maps controllers to
+            // parameters through IMidiMapping. Unassigned CCs are dropped
+            if (data1 < 0 || data1 > 127 || midi_mapped_param(instance, channel, data1) == kNoParamId) {
+                return true;
+            }
+            timed.controller = data1;
+            timed.value = std::clamp(data2, 0, 127) / 127.0;
+            break;
 
-    // Pass queued MIDI events to the plugin
-    // For instruments, this is critical - they need MIDI to generate audio
-    data.inputEvents = (instance->midi_events.getEventCount() > 0) ? &instance->midi_events : nullptr;
-    data.outputEvents = nullptr;
-    data.processContext = nullptr;
+        case 3: // Pitch bend (data1 = LSB, data2 = MSB)
+            if (midi_mapped_param(instance, channel, kPitchBend) == kNoParamId) {
+                return true;
+            }
+            timed.controller = kPitchBend;
+            timed.value = ((std::clamp(data2, 0, 127) << 7) | std::clamp(data1, 0, 127)) / 16383.0;
+            break;
 
-    // Process the audio
-    tresult result = instance->processor->process(data);
+        case 4: // Channel aftertouch (data1 = pressure)
+            if (midi_mapped_param(instance, channel, kAfterTouch) == kNoParamId) {
+                return true;
+            }
+            timed.controller = kAfterTouch;
+            timed.value = std::clamp(data1, 0, 127) / 127.0;
+            break;
 
-    // Clear MIDI events after processing (they've been consumed)
-    instance->midi_events.clear();
+        default:
+            set_error(VST3_ERROR_INVALID_ARGUMENT, "Unknown MIDI event type");
+            return false;
+    }
 
-    if (result != kResultOk && result != kResultTrue) {
-        set_error("Audio processing failed");
+    // Sent during the process() call covering sample_time
+    if (!instance->midi_queue.try_push(timed)) {
+        VST3_LOG_WARN("🎹 [C++] MIDI event queue full, event dropped");
+        set_error(VST3_ERROR_QUEUE_FULL, "MIDI event queue full");
         return false;
     }
 
@@ -787,79 +4538,166 @@ bool vst3_process_midi_event(
     int sample_offset
 ) {
     if (!handle) {
-        set_error("Invalid handle");
-        return false;
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (!instance->processor && !instance->bridge) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No processor available");
+        return false;
+    }
+
+    // Offsets are relative to the next block to be processed
+    const int64 sample_time = instance->sample_position.load(std::memory_order_acquire) +
+                              std::max(0, sample_offset);
+    if (instance->bridge) {
+        return bridge_queue_midi_event(instance, event_type, channel, data1, data2, sample_time);
+    }
+    return queue_midi_event(instance, event_type, channel, data1, data2, sample_time);
+}
+
+bool vst3_queue_midi_event_at(
+    VST3PluginHandle handle,
+    int event_type,
+    int channel,
+    int data1,
+    int data2,
+    int64_t sample_time
+) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_queue_midi_event(instance, event_type, channel, data1, data2, sample_time);
+    }
+    if (!instance->processor) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No processor available");
+        return false;
+    }
+
+    return queue_midi_event(instance, event_type, channel, data1, data2, sample_time);
+}
+
+int64_t vst3_get_sample_position(VST3PluginHandle handle) {
+    if (!handle) return 0;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    return instance->sample_position.load(std::memory_order_acquire);
+}
+
+// Build (or rebuild, once marked stale) the parameter catalog.
+// Caller holds param_catalog_mutex.
+static void refresh_param_catalog(VST3PluginInstance* instance) {
+    bool stale = instance->param_catalog_stale.exchange(false, std::memory_order_acq_rel);
+    if (instance->param_catalog_built && !stale) {
+        return;
+    }
+
+    instance->param_catalog.clear();
+    instance->param_index.clear();
+    instance->param_catalog_built = true;
+    if (!instance->controller) {
+        return;
+    }
+
+    const int32 count = instance->controller->getParameterCount();
+    instance->param_catalog.reserve(count > 0 ? count : 0);
+    instance->param_index.reserve(count > 0 ? count : 0);
+
+    for (int32 index = 0; index < count; index++) {
+        ParameterInfo param_info{};
+        if (instance->controller->getParameterInfo(index, param_info) != kResultOk) {
+            // Keep indices aligned with the controller's
+            param_info.id = kNoParamId;
+        }
+
+        VST3ParameterInfo info;
+        std::memset(&info, 0, sizeof(info));
+        info.id = param_info.id;
+        utf16_to_utf8(param_info.title, info.title, sizeof(info.title));
+        utf16_to_utf8(param_info.shortTitle, info.short_title, sizeof(info.short_title));
+        utf16_to_utf8(param_info.units, info.units, sizeof(info.units));
+        info.default_value = param_info.defaultNormalizedValue;
+        info.step_count = param_info.stepCount;
+        if (param_info.id != kNoParamId) {
+            // Plain range; values themselves stay normalized
+            info.min_value = instance->controller->normalizedParamToPlain(param_info.id, 0.0);
+            info.max_value = instance->controller->normalizedParamToPlain(param_info.id, 1.0);
+            instance->param_index.emplace(param_info.id, index);
+        }
+
+        instance->param_catalog.push_back(info);
+    }
+
+    VST3_LOG_DEBUG("🎛️ [C++] Parameter catalog built: %d parameters", count);
+}
+
+int vst3_get_parameter_catalog(VST3PluginHandle handle, VST3ParameterInfo* infos, int max_params) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return -1;
     }
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (!instance->processor) {
-        set_error("No processor available");
-        return false;
+    if (instance->bridge) {
+        return bridge_get_parameter_catalog(instance->bridge.get(), infos, max_params);
+    }
+    if (!instance->controller) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Plugin has no edit controller");
+        return -1;
     }
 
-    // Create an event
-    Event event;
-    std::memset(&event, 0, sizeof(Event));
-    event.busIndex = 0;
-    event.sampleOffset = sample_offset;
-    event.ppqPosition = 0;
-    event.flags = Event::kIsLive;
-
-    // Event types: 0 = note on, 1 = note off, 2 = CC
-    switch (event_type) {
-        case 0: // Note On
-            event.type = Event::kNoteOnEvent;
-            event.noteOn.channel = static_cast<int16>(channel);
-            event.noteOn.pitch = static_cast<int16>(data1);
-            event.noteOn.velocity = static_cast<float>(data2) / 127.0f;
-            event.noteOn.length = 0;
-            event.noteOn.tuning = 0.0f;
-            event.noteOn.noteId = -1;
-            break;
+    refresh_midi_mapping(instance);
+    std::lock_guard<std::mutex> lock(instance->param_catalog_mutex);
+    refresh_param_catalog(instance);
 
-        case 1: // Note Off
-            event.type = Event::kNoteOffEvent;
-            event.noteOff.channel = static_cast<int16>(channel);
-            event.noteOff.pitch = static_cast<int16>(data1);
-            event.noteOff.velocity = static_cast<float>(data2) / 127.0f;
-            event.noteOff.tuning = 0.0f;
-            event.noteOff.noteId = -1;
-            break;
+    const int count = static_cast<int>(instance->param_catalog.size());
+    if (infos && max_params > 0) {
+        std::memcpy(infos, instance->param_catalog.data(),
+                    sizeof(VST3ParameterInfo) * static_cast<size_t>(std::min(count, max_params)));
+    }
+    return count;
+}
 
-        case 2: // Control Change (CC)
-            // VST3 doesn't have direct CC events - they're typically handled via parameter changes
-            // For now, we'll skip CC events as they require IParameterChanges
-            return true;
+int vst3_get_parameter_index(VST3PluginHandle handle, uint32_t param_id) {
+    if (!handle) return -1;
 
-        default:
-            set_error("Unknown MIDI event type");
-            return false;
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return static_cast<int>(bridge_request(instance->bridge.get(), -1, bridge::kGetParameterIndex,
+                                               static_cast<int32_t>(param_id)));
     }
+    if (!instance->controller) return -1;
 
-    // Add the event to the queue - will be sent during next process() call
-    tresult result = instance->midi_events.addEvent(event);
-    if (result != kResultOk) {
-        set_error("Failed to queue MIDI event");
-        return false;
-    }
+    refresh_midi_mapping(instance);
+    std::lock_guard<std::mutex> lock(instance->param_catalog_mutex);
+    refresh_param_catalog(instance);
 
-    return true;
+    auto it = instance->param_index.find(param_id);
+    return it != instance->param_index.end() ? it->second : -1;
 }
 
 int vst3_get_parameter_count(VST3PluginHandle handle) {
     if (!handle) {
-        printf("🎛️ [C++] vst3_get_parameter_count: handle is null\n");
+        VST3_LOG_DEBUG("🎛️ [C++] vst3_get_parameter_count: handle is null");
         return 0;
     }
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return static_cast<int>(bridge_request(instance->bridge.get(), 0, bridge::kGetParameterCount));
+    }
     if (!instance->controller) {
-        printf("🎛️ [C++] vst3_get_parameter_count: controller is null\n");
+        VST3_LOG_DEBUG("🎛️ [C++] vst3_get_parameter_count: controller is null");
         return 0;
     }
 
     int count = instance->controller->getParameterCount();
-    printf("🎛️ [C++] vst3_get_parameter_count: handle=%p, count=%d\n", handle, count);
+    VST3_LOG_DEBUG("🎛️ [C++] vst3_get_parameter_count: handle=%p, count=%d", handle, count);
     return count;
 }
 
@@ -867,24 +4705,25 @@ bool vst3_get_parameter_info(VST3PluginHandle handle, int index, VST3ParameterIn
     if (!handle || !info) return false;
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_request_struct(instance->bridge.get(), bridge::kGetParameterInfo, info, index);
+    }
     if (!instance->controller) return false;
 
-    ParameterInfo param_info;
-    if (instance->controller->getParameterInfo(index, param_info) != kResultOk) {
-        return false;
-    }
+    refresh_midi_mapping(instance);
 
-    std::memset(info, 0, sizeof(VST3ParameterInfo));
-    info->id = param_info.id;
+    // Served from the catalog, so listing parameters one index at a time
+    // only asks the controller once
+    std::lock_guard<std::mutex> lock(instance->param_catalog_mutex);
+    refresh_param_catalog(instance);
 
-    // Convert from UTF16 to UTF8 (simplified - real implementation needs proper conversion)
-    for (int i = 0; i < 255 && param_info.title[i]; i++) {
-        info->title[i] = static_cast<char>(param_info.title[i]);
+    if (index < 0 || index >= static_cast<int>(instance->param_catalog.size()) ||
+        instance->param_catalog[index].id == kNoParamId) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Parameter index out of range");
+        return false;
     }
 
-    info->default_value = param_info.defaultNormalizedValue;
-    info->step_count = param_info.stepCount;
-
+    *info = instance->param_catalog[index];
     return true;
 }
 
@@ -892,6 +4731,11 @@ double vst3_get_parameter_value(VST3PluginHandle handle, uint32_t param_id) {
     if (!handle) return 0.0;
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        double value = 0.0;
+        bridge_get_parameter_values(instance->bridge.get(), &param_id, &value, 1);
+        return value;
+    }
     if (!instance->controller) return 0.0;
 
     return instance->controller->getParamNormalized(param_id);
@@ -901,23 +4745,173 @@ bool vst3_set_parameter_value(VST3PluginHandle handle, uint32_t param_id, double
     if (!handle) return false;
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_request(instance->bridge.get(), 0, bridge::kSetParameterValue,
+                              static_cast<int32_t>(param_id), 0, value) != 0;
+    }
     if (!instance->controller) return false;
 
+    // The controller only updates the UI side - the processor learns about the
+    // change through the parameter queue on its next block
+    instance->param_queue.try_push(ParamPoint{param_id, 0, value});
+    instance->state_generation.fetch_add(1, std::memory_order_relaxed);
+
     return instance->controller->setParamNormalized(param_id, value) == kResultOk;
 }
 
+int vst3_get_parameter_values(VST3PluginHandle handle, const uint32_t* ids, double* values, int count) {
+    if (!handle || count < 0 || (count > 0 && (!ids || !values))) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid handle or parameter arrays");
+        return -1;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_get_parameter_values(instance->bridge.get(), ids, values, count);
+    }
+    if (!instance->controller) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Plugin has no edit controller");
+        return -1;
+    }
+
+    IEditController* controller = instance->controller;
+    for (int i = 0; i < count; i++) {
+        values[i] = controller->getParamNormalized(ids[i]);
+    }
+    return count;
+}
+
+int vst3_set_parameter_values(VST3PluginHandle handle, const uint32_t* ids, const double* values, int count) {
+    if (!handle || count < 0 || (count > 0 && (!ids || !values))) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid handle or parameter arrays");
+        return -1;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_set_parameter_values(instance->bridge.get(), ids, values, count);
+    }
+    if (!instance->controller) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Plugin has no edit controller");
+        return -1;
+    }
+
+    IEditController* controller = instance->controller;
+    int queued = 0;
+    for (int i = 0; i < count; i++) {
+        if (instance->param_queue.try_push(ParamPoint{ids[i], 0, values[i]})) {
+            queued++;
+        }
+        controller->setParamNormalized(ids[i], values[i]);
+    }
+    if (count > 0) {
+        instance->state_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (queued < count) {
+        VST3_LOG_WARN("🎛️ [C++] Parameter queue full, %d of %d changes dropped", count - queued, count);
+        set_error(VST3_ERROR_QUEUE_FULL, "Parameter queue full");
+    }
+    return queued;
+}
+
+uint64_t vst3_get_state_generation(VST3PluginHandle handle) {
+    if (!handle) return 0;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return instance->bridge->ipc.region->state_generation.load(std::memory_order_acquire);
+    }
+    return instance->state_generation.load(std::memory_order_relaxed);
+}
+
+int vst3_poll_parameter_changes(VST3PluginHandle handle, VST3ParameterChange* changes, int max_changes) {
+    if (!handle || !changes || max_changes <= 0) {
+        return 0;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_poll_changes(instance->bridge.get(), bridge::kPollParameterChanges, changes, max_changes);
+    }
+
+    refresh_midi_mapping(instance);
+
+    int count = 0;
+    ParamPoint point;
+    while (count < max_changes && instance->output_param_queue.try_pop(point)) {
+        changes[count].id = point.id;
+        changes[count].sample_offset = point.sample_offset;
+        changes[count].value = point.value;
+        count++;
+
+        // Keep the controller (and with it the editor) in sync with the processor
+        if (instance->controller) {
+            instance->controller->setParamNormalized(point.id, point.value);
+        }
+    }
+
+    return count;
+}
+
+int vst3_poll_editor_changes(VST3PluginHandle handle, VST3EditorChange* changes, int max_changes) {
+    if (!handle || !changes || max_changes <= 0) {
+        return 0;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_poll_changes(instance->bridge.get(), bridge::kPollEditorChanges, changes, max_changes);
+    }
+    refresh_midi_mapping(instance);
+
+    static_assert(ParamEditTable::kValueChanged == VST3_EDIT_VALUE_CHANGED &&
+                  ParamEditTable::kEditBegan == VST3_EDIT_BEGAN &&
+                  ParamEditTable::kEditEnded == VST3_EDIT_ENDED,
+                  "edit flags must match the C API");
+
+    const size_t count = instance->edit_table.drain(
+        static_cast<size_t>(max_changes), [&](uint32_t id, double value, uint32_t flags) {
+            VST3EditorChange& change = *changes++;
+            change.id = id;
+            change.flags = static_cast<int32_t>(flags);
+            change.value = value;
+        });
+
+    if (uint32_t dropped = instance->edit_table.take_dropped()) {
+        VST3_LOG_WARN("🎛️ [C++] Editor change table full, %u edits dropped", dropped);
+    }
+    return static_cast<int>(count);
+}
+
+bool vst3_queue_parameter_change(VST3PluginHandle handle, uint32_t param_id, double value, int sample_offset) {
+    if (!handle) {
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
+        return false;
+    }
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (!instance->param_queue.try_push(ParamPoint{param_id, static_cast<int32>(sample_offset), value})) {
+        VST3_LOG_WARN("🎛️ [C++] Parameter queue full, change to %u dropped", param_id);
+        set_error(VST3_ERROR_QUEUE_FULL, "Parameter queue full");
+        return false;
+    }
+
+    return true;
+}
+
 // ============================================================================
-// Memory Stream for State Save/Load
+// Memory Streams for State Save/Load
 // ============================================================================
 
+// Growable write stream. Capacity doubles, so serializing an N byte state
+// costs O(log N) reallocations however small the plugin's write() calls are.
+// begin_segment() makes seek/tell relative to the current end, so the
+// processor and controller can serialize back to back into one buffer and
+// each still sees a stream that starts at 0.
 class MemoryStream : public IBStream {
 public:
-    MemoryStream() : position_(0), refCount_(1) {}
-
-    MemoryStream(const void* data, int size) : position_(0), refCount_(1) {
-        buffer_.resize(size);
-        std::memcpy(buffer_.data(), data, size);
-    }
+    MemoryStream() : size_(0), position_(0), base_(0), refCount_(1) {}
 
     virtual ~MemoryStream() = default;
 
@@ -925,11 +4919,11 @@ public:
     tresult PLUGIN_API read(void* buffer, int32 numBytes, int32* numBytesRead) override {
         if (!buffer || numBytes < 0) return kInvalidArgument;
 
-        int32 available = static_cast<int32>(buffer_.size()) - position_;
-        int32 toRead = std::min(numBytes, available);
+        int64 available = size_ - (base_ + position_);
+        int32 toRead = static_cast<int32>(std::max<int64>(0, std::min<int64>(numBytes, available)));
 
         if (toRead > 0) {
-            std::memcpy(buffer, buffer_.data() + position_, toRead);
+            std::memcpy(buffer, buffer_.data() + base_ + position_, toRead);
             position_ += toRead;
         }
 
@@ -940,14 +4934,16 @@ public:
     tresult PLUGIN_API write(void* buffer, int32 numBytes, int32* numBytesWritten) override {
         if (!buffer || numBytes < 0) return kInvalidArgument;
 
-        // Expand buffer if needed
-        int32 endPos = position_ + numBytes;
-        if (endPos > static_cast<int32>(buffer_.size())) {
-            buffer_.resize(endPos);
+        int64 endPos = base_ + position_ + numBytes;
+        if (endPos > kMaxSize) return kOutOfMemory;
+        if (endPos > static_cast<int64>(buffer_.size())) {
+            size_t capacity = std::max<size_t>(buffer_.size() * 2, kInitialCapacity);
+            buffer_.resize(std::max<size_t>(capacity, static_cast<size_t>(endPos)));
         }
 
-        std::memcpy(buffer_.data() + position_, buffer, numBytes);
+        std::memcpy(buffer_.data() + base_ + position_, buffer, numBytes);
         position_ += numBytes;
+        size_ = std::max(size_, endPos);
 
         if (numBytesWritten) *numBytesWritten = numBytes;
         return kResultOk;
@@ -958,12 +4954,12 @@ public:
         switch (mode) {
             case IBStream::kIBSeekSet: newPos = pos; break;
             case IBStream::kIBSeekCur: newPos = position_ + pos; break;
-            case IBStream::kIBSeekEnd: newPos = static_cast<int64>(buffer_.size()) + pos; break;
+            case IBStream::kIBSeekEnd: newPos = segment_size() + pos; break;
             default: return kInvalidArgument;
         }
 
         if (newPos < 0) newPos = 0;
-        position_ = static_cast<int32>(newPos);
+        position_ = newPos;
 
         if (result) *result = position_;
         return kResultOk;
@@ -993,13 +4989,116 @@ public:
         return count;
     }
 
-    // Accessors
-    const std::vector<uint8_t>& getData() const { return buffer_; }
-    int32 getSize() const { return static_cast<int32>(buffer_.size()); }
+    // Start a new stream at the current end
+    void begin_segment() {
+        base_ = size_;
+        position_ = 0;
+    }
+
+    // Bytes written since the last begin_segment()
+    int64 segment_size() const { return size_ - base_; }
+
+    // Drop everything written since the last begin_segment()
+    void discard_segment() {
+        size_ = base_;
+        position_ = 0;
+    }
+
+    int64 size() const { return size_; }
+    uint8_t* data() { return buffer_.data(); }
+
+    // Hand the buffer over, trimmed to the bytes written
+    std::vector<uint8_t> take() {
+        buffer_.resize(static_cast<size_t>(size_));
+        size_ = position_ = base_ = 0;
+        return std::move(buffer_);
+    }
 
 private:
+    static constexpr size_t kInitialCapacity = 4096;
+    // State chunk sizes are stored as int32
+    static constexpr int64 kMaxSize = 0x7fffffff;
+
     std::vector<uint8_t> buffer_;
-    int32 position_;
+    int64 size_;
+    int64 position_;
+    int64 base_;
+    std::atomic<uint32> refCount_;
+};
+
+// Read-only stream over memory owned by the caller (state restore), so a
+// saved chunk is handed to the plugin without being copied
+class MemoryReadStream : public IBStream {
+public:
+    MemoryReadStream(const void* data, int64 size)
+        : data_(static_cast<const uint8_t*>(data)), size_(size), position_(0), refCount_(1) {}
+
+    virtual ~MemoryReadStream() = default;
+
+    // IBStream
+    tresult PLUGIN_API read(void* buffer, int32 numBytes, int32* numBytesRead) override {
+        if (!buffer || numBytes < 0) return kInvalidArgument;
+
+        int64 available = size_ - position_;
+        int32 toRead = static_cast<int32>(std::max<int64>(0, std::min<int64>(numBytes, available)));
+
+        if (toRead > 0) {
+            std::memcpy(buffer, data_ + position_, toRead);
+            position_ += toRead;
+        }
+
+        if (numBytesRead) *numBytesRead = toRead;
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API write(void*, int32, int32* numBytesWritten) override {
+        if (numBytesWritten) *numBytesWritten = 0;
+        return kNotImplemented;
+    }
+
+    tresult PLUGIN_API seek(int64 pos, int32 mode, int64* result) override {
+        int64 newPos = 0;
+        switch (mode) {
+            case IBStream::kIBSeekSet: newPos = pos; break;
+            case IBStream::kIBSeekCur: newPos = position_ + pos; break;
+            case IBStream::kIBSeekEnd: newPos = size_ + pos; break;
+            default: return kInvalidArgument;
+        }
+
+        position_ = std::max<int64>(0, std::min(newPos, size_));
+
+        if (result) *result = position_;
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API tell(int64* pos) override {
+        if (pos) *pos = position_;
+        return kResultOk;
+    }
+
+    // FUnknown
+    tresult PLUGIN_API queryInterface(const TUID _iid, void** obj) override {
+        if (FUnknownPrivate::iidEqual(_iid, IBStream::iid) ||
+            FUnknownPrivate::iidEqual(_iid, FUnknown::iid)) {
+            *obj = this;
+            addRef();
+            return kResultTrue;
+        }
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override { return ++refCount_; }
+    uint32 PLUGIN_API release() override {
+        uint32 count = --refCount_;
+        if (count == 0) delete this;
+        return count;
+    }
+
+private:
+    const uint8_t* data_;
+    int64 size_;
+    int64 position_;
     std::atomic<uint32> refCount_;
 };
 
@@ -1007,96 +5106,145 @@ private:
 // State Save/Load Functions
 // ============================================================================
 
-int vst3_get_state_size(VST3PluginHandle handle) {
-    if (!handle) return 0;
+// Chunk layout: [4 bytes processor size][4 bytes controller size]
+//               [processor state][controller state]
+static constexpr int32 kStateHeaderSize = 8;
 
-    auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (!instance->component) return 0;
+struct VST3StateSnapshotData {
+    std::vector<uint8_t> data;
+};
 
-    // Create a temporary stream to get the state size
-    MemoryStream stream;
+// Serialize processor and controller state once, straight into `stream`
+static bool capture_state(VST3PluginInstance* instance, MemoryStream& stream) {
+    // Header is filled in once both sizes are known
+    int32 sizes[2] = {0, 0};
+    stream.write(sizes, kStateHeaderSize, nullptr);
 
-    // Get processor state
+    stream.begin_segment();
     if (instance->component->getState(&stream) != kResultOk) {
-        fprintf(stderr, "❌ [C++] vst3_get_state_size: component->getState failed\n");
-        return 0;
+        VST3_LOG_ERROR("❌ [C++] capture_state: component->getState failed");
+        set_error(VST3_ERROR_PLUGIN_REFUSED, "component->getState failed");
+        return false;
     }
+    int64 processorSize = stream.segment_size();
 
-    int32 processorSize = stream.getSize();
-
-    // Get controller state if available
-    int32 controllerSize = 0;
+    int64 controllerSize = 0;
     if (instance->controller) {
-        MemoryStream controllerStream;
-        if (instance->controller->getState(&controllerStream) == kResultOk) {
-            controllerSize = controllerStream.getSize();
+        stream.begin_segment();
+        if (instance->controller->getState(&stream) == kResultOk) {
+            controllerSize = stream.segment_size();
+        } else {
+            // Controller state is optional
+            stream.discard_segment();
         }
     }
 
-    // Total size = 8 bytes header + processor state + controller state
-    // Header format: [4 bytes processor size][4 bytes controller size]
-    int totalSize = 8 + processorSize + controllerSize;
+    sizes[0] = static_cast<int32>(processorSize);
+    sizes[1] = static_cast<int32>(controllerSize);
+    std::memcpy(stream.data(), sizes, kStateHeaderSize);
 
-    fprintf(stderr, "📦 [C++] vst3_get_state_size: processor=%d, controller=%d, total=%d\n",
-            processorSize, controllerSize, totalSize);
-
-    return totalSize;
+    VST3_LOG_DEBUG("📦 [C++] capture_state: processor=%lld, controller=%lld",
+                   static_cast<long long>(processorSize), static_cast<long long>(controllerSize));
+    return true;
 }
 
-int vst3_get_state(VST3PluginHandle handle, void* data, int max_size) {
-    if (!handle || !data || max_size < 8) return -1;
+VST3StateSnapshot vst3_snapshot_state(VST3PluginHandle handle, const void** data, int* size) {
+    if (!handle || !data || !size) {
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid handle or output pointer");
+        return nullptr;
+    }
+    *data = nullptr;
+    *size = 0;
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
-    if (!instance->component) return -1;
-
-    // Get processor state
-    MemoryStream processorStream;
-    if (instance->component->getState(&processorStream) != kResultOk) {
-        fprintf(stderr, "❌ [C++] vst3_get_state: component->getState failed\n");
-        return -1;
+    if (instance->bridge) {
+        auto snapshot = new VST3StateSnapshotData;
+        if (!bridge_get_state(instance->bridge.get(), snapshot->data)) {
+            delete snapshot;
+            return nullptr;
+        }
+        *data = snapshot->data.data();
+        *size = static_cast<int>(snapshot->data.size());
+        return snapshot;
+    }
+    if (!instance->component) {
+        set_error(VST3_ERROR_NOT_INITIALIZED, "Plugin not initialized");
+        return nullptr;
     }
 
-    // Get controller state
-    MemoryStream controllerStream;
-    bool hasControllerState = false;
-    if (instance->controller) {
-        hasControllerState = (instance->controller->getState(&controllerStream) == kResultOk);
+    MemoryStream stream;
+    if (!capture_state(instance, stream)) {
+        return nullptr;
     }
 
-    int32 processorSize = processorStream.getSize();
-    int32 controllerSize = hasControllerState ? controllerStream.getSize() : 0;
-    int32 totalSize = 8 + processorSize + controllerSize;
+    auto snapshot = new VST3StateSnapshotData{stream.take()};
+    *data = snapshot->data.data();
+    *size = static_cast<int>(snapshot->data.size());
+    return snapshot;
+}
 
-    if (totalSize > max_size) {
-        fprintf(stderr, "❌ [C++] vst3_get_state: buffer too small (%d < %d)\n", max_size, totalSize);
-        return -1;
+void vst3_release_state(VST3StateSnapshot snapshot) {
+    delete static_cast<VST3StateSnapshotData*>(snapshot);
+}
+
+int vst3_get_state_size(VST3PluginHandle handle) {
+    if (!handle) return 0;
+
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        std::vector<uint8_t> state;
+        return bridge_get_state(instance->bridge.get(), state) ? static_cast<int>(state.size()) : 0;
+    }
+    if (!instance->component) return 0;
+
+    MemoryStream stream;
+    if (!capture_state(instance, stream)) {
+        return 0;
     }
+    return static_cast<int>(stream.size());
+}
 
-    // Write header
-    uint8_t* ptr = static_cast<uint8_t*>(data);
-    std::memcpy(ptr, &processorSize, 4);
-    std::memcpy(ptr + 4, &controllerSize, 4);
-    ptr += 8;
+int vst3_get_state(VST3PluginHandle handle, void* data, int max_size) {
+    if (!handle || !data || max_size < kStateHeaderSize) return -1;
 
-    // Write processor state
-    std::memcpy(ptr, processorStream.getData().data(), processorSize);
-    ptr += processorSize;
+    auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        std::vector<uint8_t> state;
+        if (!bridge_get_state(instance->bridge.get(), state)) {
+            return -1;
+        }
+        if (state.size() > static_cast<size_t>(max_size)) {
+            set_error(VST3_ERROR_INVALID_ARGUMENT, "State buffer too small");
+            return -1;
+        }
+        std::memcpy(data, state.data(), state.size());
+        return static_cast<int>(state.size());
+    }
+    if (!instance->component) return -1;
 
-    // Write controller state
-    if (controllerSize > 0) {
-        std::memcpy(ptr, controllerStream.getData().data(), controllerSize);
+    MemoryStream stream;
+    if (!capture_state(instance, stream)) {
+        return -1;
     }
 
-    fprintf(stderr, "✅ [C++] vst3_get_state: saved %d bytes (processor=%d, controller=%d)\n",
-            totalSize, processorSize, controllerSize);
+    int totalSize = static_cast<int>(stream.size());
+    if (totalSize > max_size) {
+        VST3_LOG_ERROR("❌ [C++] vst3_get_state: buffer too small (%d < %d)", max_size, totalSize);
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "State buffer too small");
+        return -1;
+    }
 
+    std::memcpy(data, stream.data(), totalSize);
     return totalSize;
 }
 
 bool vst3_set_state(VST3PluginHandle handle, const void* data, int size) {
-    if (!handle || !data || size < 8) return false;
+    if (!handle || !data || size < kStateHeaderSize) return false;
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
+    if (instance->bridge) {
+        return bridge_set_state(instance->bridge.get(), data, size);
+    }
     if (!instance->component) return false;
 
     // Read header
@@ -1104,44 +5252,50 @@ bool vst3_set_state(VST3PluginHandle handle, const void* data, int size) {
     int32 processorSize, controllerSize;
     std::memcpy(&processorSize, ptr, 4);
     std::memcpy(&controllerSize, ptr + 4, 4);
-    ptr += 8;
+    ptr += kStateHeaderSize;
 
     // Validate sizes
-    if (8 + processorSize + controllerSize > size) {
-        fprintf(stderr, "❌ [C++] vst3_set_state: invalid sizes (header says %d, got %d)\n",
-                8 + processorSize + controllerSize, size);
+    if (processorSize < 0 || controllerSize < 0 ||
+        static_cast<int64>(kStateHeaderSize) + processorSize + controllerSize > size) {
+        VST3_LOG_ERROR("❌ [C++] vst3_set_state: invalid sizes (header says %lld, got %d)",
+                       static_cast<long long>(kStateHeaderSize) + processorSize + controllerSize, size);
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Corrupt state chunk");
         return false;
     }
 
-    fprintf(stderr, "📦 [C++] vst3_set_state: loading %d bytes (processor=%d, controller=%d)\n",
-            size, processorSize, controllerSize);
+    VST3_LOG_INFO("📦 [C++] vst3_set_state: loading %d bytes (processor=%d, controller=%d)",
+                  size, processorSize, controllerSize);
 
     // Set processor state
     if (processorSize > 0) {
-        MemoryStream processorStream(ptr, processorSize);
+        MemoryReadStream processorStream(ptr, processorSize);
         if (instance->component->setState(&processorStream) != kResultOk) {
-            fprintf(stderr, "❌ [C++] vst3_set_state: component->setState failed\n");
+            VST3_LOG_ERROR("❌ [C++] vst3_set_state: component->setState failed");
+            set_error(VST3_ERROR_PLUGIN_REFUSED, "component->setState failed");
             return false;
         }
-        ptr += processorSize;
 
         // Also sync to controller (important for parameter display)
         if (instance->controller) {
-            MemoryStream processorStream2(ptr - processorSize, processorSize);
-            instance->controller->setComponentState(&processorStream2);
+            MemoryReadStream componentStream(ptr, processorSize);
+            instance->controller->setComponentState(&componentStream);
         }
+        ptr += processorSize;
     }
 
     // Set controller state
     if (controllerSize > 0 && instance->controller) {
-        MemoryStream controllerStream(ptr, controllerSize);
+        MemoryReadStream controllerStream(ptr, controllerSize);
         if (instance->controller->setState(&controllerStream) != kResultOk) {
-            fprintf(stderr, "⚠️ [C++] vst3_set_state: controller->setState failed (non-fatal)\n");
+            VST3_LOG_WARN("⚠️ [C++] vst3_set_state: controller->setState failed (non-fatal)");
             // Controller state is optional, don't fail
         }
     }
 
-    fprintf(stderr, "✅ [C++] vst3_set_state: state restored successfully\n");
+    instance->state_generation.fetch_add(1, std::memory_order_relaxed);
+    refresh_midi_mapping(instance);
+
+    VST3_LOG_INFO("✅ [C++] vst3_set_state: state restored successfully");
     return true;
 }
 
@@ -1169,15 +5323,20 @@ bool vst3_open_editor(VST3PluginHandle handle) {
     fprintf(stderr, "🎨 [C++] vst3_open_editor called: handle=%p\n", handle);
 
     if (!handle) {
-        set_error("Invalid handle");
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle");
         fprintf(stderr, "❌ [C++] vst3_open_editor: handle is null\n");
         return false;
     }
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
 
+    if (instance->bridge) {
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Bridged plugins have no editor");
+        return false;
+    }
+
     if (!instance->controller) {
-        set_error("No edit controller available");
+        set_error(VST3_ERROR_NOT_SUPPORTED, "No edit controller available");
         fprintf(stderr, "❌ [C++] vst3_open_editor: no edit controller\n");
         return false;
     }
@@ -1192,7 +5351,7 @@ bool vst3_open_editor(VST3PluginHandle handle) {
     fprintf(stderr, "📝 [C++] Creating editor view via controller->createView\n");
     auto view = instance->controller->createView(ViewType::kEditor);
     if (!view) {
-        set_error("Failed to create editor view");
+        set_error(VST3_ERROR_EDITOR, "Failed to create editor view");
         fprintf(stderr, "❌ [C++] vst3_open_editor: createView returned null\n");
         return false;
     }
@@ -1232,19 +5391,19 @@ void vst3_close_editor(VST3PluginHandle handle) {
 
 bool vst3_get_editor_size(VST3PluginHandle handle, int* width, int* height) {
     if (!handle || !width || !height) {
-        set_error("Invalid parameters");
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parameters");
         return false;
     }
 
     auto instance = static_cast<VST3PluginInstance*>(handle);
     if (!instance->editor_view) {
-        set_error("No editor view available");
+        set_error(VST3_ERROR_EDITOR, "No editor view available");
         return false;
     }
 
     ViewRect rect;
     if (instance->editor_view->getSize(&rect) != kResultOk) {
-        set_error("Failed to get editor size");
+        set_error(VST3_ERROR_EDITOR, "Failed to get editor size");
         return false;
     }
 
@@ -1263,14 +5422,14 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
     fflush(stderr);
 
     if (!handle) {
-        set_error("Invalid handle (null)");
+        set_error(VST3_ERROR_INVALID_HANDLE, "Invalid handle (null)");
         fprintf(stderr, "❌ [C++] vst3_attach_editor: handle is null\n");
         fflush(stderr);
         return false;
     }
 
     if (!parent) {
-        set_error("Invalid parent (null)");
+        set_error(VST3_ERROR_INVALID_ARGUMENT, "Invalid parent (null)");
         fprintf(stderr, "❌ [C++] vst3_attach_editor: parent is null\n");
         fflush(stderr);
         return false;
@@ -1289,7 +5448,7 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
 
     // Check if editor was opened first
     if (!instance->editor_open) {
-        set_error("Editor not opened - call vst3_open_editor first");
+        set_error(VST3_ERROR_WRONG_STATE, "Editor not opened - call vst3_open_editor first");
         fprintf(stderr, "❌ [C++] vst3_attach_editor: editor not opened first\n");
         fflush(stderr);
         return false;
@@ -1299,7 +5458,7 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
     fflush(stderr);
 
     if (!instance->editor_view) {
-        set_error("No editor view available (editor_view is null)");
+        set_error(VST3_ERROR_EDITOR, "No editor view available (editor_view is null)");
         fprintf(stderr, "❌ [C++] vst3_attach_editor: editor_view is null\n");
         fflush(stderr);
         return false;
@@ -1335,7 +5494,7 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
     // Try to get the IPlugView pointer and check it's valid before calling attached()
     IPlugView* view = instance->editor_view.get();
     if (!view) {
-        set_error("IPlugView pointer is null");
+        set_error(VST3_ERROR_EDITOR, "IPlugView pointer is null");
         fprintf(stderr, "❌ [C++] IPlugView pointer is null\n");
         fflush(stderr);
         return false;
@@ -1348,7 +5507,7 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
     if (view->isPlatformTypeSupported(kPlatformTypeNSView) != kResultTrue) {
         fprintf(stderr, "❌ [C++] NSView platform type NOT supported by this plugin\n");
         fflush(stderr);
-        set_error("Plugin does not support NSView platform type");
+        set_error(VST3_ERROR_NOT_SUPPORTED, "Plugin does not support NSView platform type");
         return false;
     }
     fprintf(stderr, "✅ [C++] NSView platform type is supported\n");
@@ -1403,12 +5562,12 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
     } catch (const std::exception& e) {
         fprintf(stderr, "❌ [C++] C++ exception in attached(): %s\n", e.what());
         fflush(stderr);
-        set_error("C++ exception in IPlugView->attached()");
+        set_error(VST3_ERROR_EDITOR, "C++ exception in IPlugView->attached()");
         return false;
     } catch (...) {
         fprintf(stderr, "❌ [C++] Unknown exception in attached()\n");
         fflush(stderr);
-        set_error("Unknown exception in IPlugView->attached()");
+        set_error(VST3_ERROR_EDITOR, "Unknown exception in IPlugView->attached()");
         return false;
     }
 
@@ -1419,7 +5578,7 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
     fflush(stderr);
 
     if (result != kResultOk) {
-        set_error("Failed to attach editor to parent window");
+        set_error(VST3_ERROR_EDITOR, "Failed to attach editor to parent window");
         fprintf(stderr, "❌ [C++] IPlugView->attached failed with result: %d\n", result);
         fflush(stderr);
         return false;
@@ -1433,5 +5592,33 @@ bool vst3_attach_editor(VST3PluginHandle handle, void* parent) {
 }
 
 const char* vst3_get_last_error() {
-    return g_last_error.c_str();
+    return g_last_error.message;
+}
+
+VST3Result vst3_get_last_error_code() {
+    return g_last_error.code;
+}
+
+void vst3_clear_last_error() {
+    g_last_error.code = VST3_OK;
+    g_last_error.message[0] = '\0';
+}
+
+const char* vst3_result_string(VST3Result result) {
+    switch (result) {
+        case VST3_OK: return "ok";
+        case VST3_ERROR_INVALID_HANDLE: return "invalid handle";
+        case VST3_ERROR_INVALID_ARGUMENT: return "invalid argument";
+        case VST3_ERROR_NOT_INITIALIZED: return "not initialized";
+        case VST3_ERROR_NOT_ACTIVE: return "not active";
+        case VST3_ERROR_WRONG_STATE: return "not allowed in the current state";
+        case VST3_ERROR_NOT_SUPPORTED: return "not supported";
+        case VST3_ERROR_LOAD_FAILED: return "load failed";
+        case VST3_ERROR_PLUGIN_REFUSED: return "refused by plugin";
+        case VST3_ERROR_PROCESS_FAILED: return "processing failed";
+        case VST3_ERROR_QUEUE_FULL: return "queue full";
+        case VST3_ERROR_EDITOR: return "editor error";
+        case VST3_ERROR_BRIDGE: return "plugin bridge failed";
+    }
+    return "unknown error";
 }
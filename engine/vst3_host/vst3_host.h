@@ -11,6 +11,25 @@ extern "C" {
 // Opaque plugin handle
 typedef void* VST3PluginHandle;
 
+// Error codes. Functions that fail set the calling thread's last error
+// (vst3_get_last_error_code / vst3_get_last_error); it is left untouched on
+// success
+typedef enum {
+    VST3_OK = 0,
+    VST3_ERROR_INVALID_HANDLE = 1,
+    VST3_ERROR_INVALID_ARGUMENT = 2,
+    VST3_ERROR_NOT_INITIALIZED = 3,   // Host or plugin not initialized
+    VST3_ERROR_NOT_ACTIVE = 4,        // Plugin not activated
+    VST3_ERROR_WRONG_STATE = 5,       // Not allowed while (de)activated / editor closed
+    VST3_ERROR_NOT_SUPPORTED = 6,     // Plugin lacks the interface or feature
+    VST3_ERROR_LOAD_FAILED = 7,
+    VST3_ERROR_PLUGIN_REFUSED = 8,    // The plugin returned an error
+    VST3_ERROR_PROCESS_FAILED = 9,
+    VST3_ERROR_QUEUE_FULL = 10,
+    VST3_ERROR_EDITOR = 11,
+    VST3_ERROR_BRIDGE = 12,           // Bridged plugin's helper process crashed or hung
+} VST3Result;
+
 // Plugin info structure
 typedef struct {
     char name[256];
@@ -38,30 +57,299 @@ int vst3_scan_directory(const char* directory, VST3ScanCallback callback, void*
 // Scan standard VST3 plugin locations
 int vst3_scan_standard_locations(VST3ScanCallback callback, void* user_data);
 
+// Scans probe bundles on a worker pool and remember the results in an
+// on-disk cache keyed by bundle path, mtime and size, so only new or changed
+// bundles are loaded again. Bundles that failed to load stay skipped until
+// they change.
+
+// Set the scan cache file. NULL or "" restores the default per-user location
+void vst3_set_scan_cache_path(const char* path);
+
+// Probe bundles in child processes running the vst3_scan_helper executable
+// at this path, so a plugin that crashes while loading can't take the host
+// down. NULL or "" probes in-process (default)
+void vst3_set_scan_helper_path(const char* path);
+
+// Forget all cached scan results; the next scan re-probes every bundle
+void vst3_clear_scan_cache();
+
+// Probe a single bundle in this process, bypassing the cache
+// Returns the number of plugins found, or -1 if the module failed to load
+int vst3_scan_bundle(const char* bundle_path, VST3ScanCallback callback, void* user_data);
+
+// Plugin catalog
+//
+// Every scan that changes the cache also writes a compact binary catalog of
+// all cached plugins next to it (same name, ".catalog" extension), with a
+// string table and prebuilt indices by vendor, subcategory and kind, sorted
+// by name. vst3_host_init maps it, so a browser can list a large library
+// without scanning or copying VST3PluginInfo structs.
+//
+// Queries return spans of record ids pointing into the catalog; they stay
+// valid until the handle they came from is released, even if a later scan
+// publishes a new catalog. Every span is ascending, which is name order, so
+// two spans can be intersected with a merge. Lookups ignore ASCII case.
+
+typedef void* VST3CatalogHandle;
+
+typedef struct {
+    const uint32_t* ids;
+    int count;
+} VST3CatalogSpan;
+
+// Strings point into the catalog, valid as long as the handle
+typedef struct {
+    const char* name;
+    const char* vendor;
+    const char* version;
+    const char* category;  // "Fx|Delay" style subcategory string
+    const char* file_path;
+    bool is_instrument;
+    bool is_effect;
+} VST3CatalogEntry;
+
+typedef enum {
+    VST3_CATALOG_VENDOR = 0,
+    VST3_CATALOG_SUBCATEGORY = 1,
+    VST3_CATALOG_KIND = 2,  // keys "instrument" and "effect"
+} VST3CatalogIndex;
+
+// The newest catalog, or NULL if no scan has written one yet. Does not block
+// on a running scan for longer than it takes to swap the catalog
+VST3CatalogHandle vst3_catalog_acquire();
+void vst3_catalog_release(VST3CatalogHandle catalog);
+
+int vst3_catalog_size(VST3CatalogHandle catalog);
+bool vst3_catalog_get_entry(VST3CatalogHandle catalog, uint32_t id, VST3CatalogEntry* entry);
+
+// Every plugin, by name
+VST3CatalogSpan vst3_catalog_all(VST3CatalogHandle catalog);
+// Plugins with this vendor / subcategory / kind (an empty span if none)
+VST3CatalogSpan vst3_catalog_find(VST3CatalogHandle catalog, VST3CatalogIndex index, const char* key);
+// Plugins whose name starts with `prefix`
+VST3CatalogSpan vst3_catalog_name_prefix(VST3CatalogHandle catalog, const char* prefix);
+
+// The distinct keys of an index, for building browser filters. `label` is
+// the key as spelled by the first plugin (by name) that has it
+int vst3_catalog_group_count(VST3CatalogHandle catalog, VST3CatalogIndex index);
+bool vst3_catalog_get_group(VST3CatalogHandle catalog, VST3CatalogIndex index, int group,
+                            const char** label, VST3CatalogSpan* members);
+
 // Load a plugin from file path
 // Returns handle to plugin or NULL on failure
+// Instances from the same bundle share one loaded module, which is unloaded
+// with its last instance
 VST3PluginHandle vst3_load_plugin(const char* file_path);
 
+// Load a specific audio class from a bundle that contains several
+// (e.g. "Serum 2" and "Serum 2 FX"), by class name or UID string.
+// NULL or "" behaves like vst3_load_plugin (first audio class)
+VST3PluginHandle vst3_load_plugin_class(const char* file_path, const char* class_name);
+
 // Unload a plugin
 void vst3_unload_plugin(VST3PluginHandle handle);
 
+// Bridged (sandboxed) plugins run in a vst3_bridge_helper process, so a
+// plugin that crashes or corrupts memory can't take the host down with it.
+// The handle works with the rest of this API as usual: audio blocks, MIDI
+// events and parameter changes go through shared memory, everything else
+// is a round trip to the helper. Differences from in-process plugins:
+// - realtime blocks come back one block late (the helper processes block N
+//   while the host plays block N-1), which vst3_get_latency_samples
+//   includes; offline blocks are processed synchronously with no delay
+// - only the main stereo buses in 32-bit float, no editor
+// - blocks the helper hasn't finished in time play silence, and once the
+//   helper is gone every call fails with VST3_ERROR_BRIDGE
+// Linux and macOS only.
+
+// Location of the vst3_bridge_helper executable. NULL or "" disables bridging
+void vst3_set_bridge_helper_path(const char* path);
+
+// Per-plugin setting: load the bundle at file_path bridged (true) or
+// in-process (false, default) from now on. Instances already loaded keep
+// running where they are. Returns false if bridging isn't available on
+// this platform
+bool vst3_set_plugin_bridged(const char* file_path, bool bridged);
+
+// True if the instance runs in a helper process
+bool vst3_is_plugin_bridged(VST3PluginHandle handle);
+
+// Async load completion callback. Called on a loader thread with a loaded,
+// initialized and activated plugin, or with handle NULL and an error message
+// (only valid during the call)
+typedef void (*VST3LoadCallback)(VST3PluginHandle handle, const char* error, void* user_data);
+
+// Load, initialize and activate a plugin on the host's loader thread pool.
+// Several loads run in parallel, except loading the bundle's module itself
+// (one at a time process-wide); the callback fires once per request.
+// Returns false (callback never called) if the request couldn't be queued.
+// Plugins that must be initialized on the main thread need vst3_load_plugin
+bool vst3_load_plugin_async(const char* file_path, double sample_rate, int max_block_size,
+                            VST3LoadCallback callback, void* user_data);
+
+// Instance pool (off until configured)
+//
+// Keeps `instances_per_class` loaded, initialized and activated instances of
+// each pinned bundle and of the `max_classes` most recently acquired ones,
+// so auditioning or adding an instrument doesn't wait for a load. A
+// background thread warms classes, recycles returned instances and unloads
+// the ones the pool drops. Instances are warmed at `sample_rate` /
+// `max_block_size`. Calling it again changes the limits; a new rate or
+// block size drops the warm instances. 0 instances turns the pool off
+bool vst3_pool_configure(int instances_per_class, int max_classes, double sample_rate, int max_block_size);
+
+// Keep a bundle warm regardless of how recently it was used (or stop)
+bool vst3_pool_pin(const char* file_path, bool pinned);
+
+// An initialized, active instance: a warm one in constant time if there is
+// one (reconfigured if the setup differs), otherwise loaded right here like
+// vst3_load_plugin_async does. Acquiring a bundle marks it recently used.
+// With the pool off this is a plain load. The instance is the caller's until
+// vst3_pool_release
+VST3PluginHandle vst3_pool_acquire(const char* file_path, double sample_rate, int max_block_size);
+
+// Give back an instance from vst3_pool_acquire. Closes its editor, then the
+// pool thread restores a fresh instance's state (only if it changed), resets
+// it and keeps it warm, or unloads it if the pool is full, the class was
+// dropped, or the buses or processing mode were changed. Other handles are
+// unloaded in the background. Not while the instance is being processed
+void vst3_pool_release(VST3PluginHandle handle);
+
+// Warm instances of a bundle waiting in the pool
+int vst3_pool_ready_count(const char* file_path);
+
 // Get plugin info
 bool vst3_get_plugin_info(VST3PluginHandle handle, VST3PluginInfo* info);
 
 // Initialize plugin with sample rate and max block size
 bool vst3_initialize_plugin(VST3PluginHandle handle, double sample_rate, int max_block_size);
 
-// Activate plugin (start processing)
+// Activate plugin (IComponent::setActive, then start processing)
 bool vst3_activate_plugin(VST3PluginHandle handle);
 
-// Deactivate plugin (stop processing)
+// Deactivate plugin (stop processing, then IComponent::setActive(false))
 bool vst3_deactivate_plugin(VST3PluginHandle handle);
 
-// Process audio (stereo in/out for now)
+// Flush the plugin's internal state (delay lines, reverb tails, voices) for
+// a transport stop or loop jump: switches processing and the component off
+// and on again. The processing setup, buses and parameters are kept, so this
+// is much cheaper than deactivate + initialize + activate. No-op while the
+// plugin is deactivated. Not concurrently with processing the same instance
+bool vst3_reset_plugin(VST3PluginHandle handle);
+
+// Change the sample rate and/or max block size of an initialized plugin
+// (or initialize it). Returns straight away if neither changed; otherwise
+// redoes only the processing setup, keeping buses and the active state.
+// In offline mode the block size applies when it returns to realtime
+bool vst3_reconfigure(VST3PluginHandle handle, double sample_rate, int max_block_size);
+
+// Processing latency the plugin reports, in samples (0 if unknown).
+// Read it again after activation and whenever the latency change count moves
+int vst3_get_latency_samples(VST3PluginHandle handle);
+
+// Number of kLatencyChanged notifications received from any plugin so far.
+// Cheap to poll; when it changes, check vst3_get_plugin_latency_change_count
+// to find the plugins whose latency needs re-reading
+uint32_t vst3_get_latency_change_count();
+
+// Number of kLatencyChanged notifications from this plugin so far (for a
+// bridged plugin, including changes of the pipeline's block)
+uint32_t vst3_get_plugin_latency_change_count(VST3PluginHandle handle);
+
+// Switch an initialized plugin between realtime and offline processing
+// (kOffline) for faster-than-realtime rendering. The plugin is stopped,
+// set up again with the new mode and max_block_size (e.g. 4096-16384) and
+// restarted if it was active. max_block_size <= 0 keeps the current size
+// when going offline and restores the realtime size when switching back.
+// Don't process the plugin from another thread while switching
+bool vst3_set_offline_mode(VST3PluginHandle handle, bool offline, int max_block_size);
+
+// True while the plugin is in offline mode
+bool vst3_is_offline_mode(VST3PluginHandle handle);
+
+// Ask for 64-bit (kSample64) processing. Used only if the plugin reports
+// canProcessSampleSize(kSample64); otherwise it keeps running in 32-bit.
+// Best called before vst3_initialize_plugin; on an initialized plugin it is
+// stopped, set up again and restarted like vst3_set_offline_mode
+bool vst3_set_double_precision(VST3PluginHandle handle, bool enabled);
+
+// Sample size the plugin processes in: 32 or 64
+int vst3_get_sample_size(VST3PluginHandle handle);
+
+// Audio bus info
+typedef struct {
+    char name[128];
+    int channel_count;  // Negotiated count once initialized, plugin default before
+    bool is_aux;        // Sidechain input / additional output
+    bool is_active;
+} VST3BusInfo;
+
+// Number of audio buses in one direction (input = true for inputs)
+int vst3_get_bus_count(VST3PluginHandle handle, bool input);
+
+// Get info about an audio bus
+bool vst3_get_bus_info(VST3PluginHandle handle, bool input, int index, VST3BusInfo* info);
+
+// Request a channel count for a bus (1, 2, 3, 4, 5, 6 = 5.1, 8 = 7.1;
+// 0 = plugin default). Must be called before vst3_initialize_plugin; the
+// plugin may settle on another layout, read it back with vst3_get_bus_info
+bool vst3_set_bus_channels(VST3PluginHandle handle, bool input, int index, int channels);
+
+// Switch an audio bus on or off (e.g. a sidechain input or the extra outputs
+// of a multi-out instrument). Only main buses are active by default.
+// Not allowed while the plugin is activated
+bool vst3_set_bus_active(VST3PluginHandle handle, bool input, int index, bool active);
+
+// Channel pointers for one bus
+typedef struct {
+    float** channels;
+    int num_channels;
+} VST3AudioBus;
+
+// Process a block with per-bus channel pointers (bus 0 = main, then aux).
+// Buffers are passed to the plugin without copying. Missing buses, channels
+// or NULL channel pointers read silence on input and are discarded on
+// output. Splitting and MIDI routing work as in vst3_process_block
+bool vst3_process_buses(
+    VST3PluginHandle handle,
+    const VST3AudioBus* inputs,
+    int num_inputs,
+    const VST3AudioBus* outputs,
+    int num_outputs,
+    int num_frames
+);
+
+// Process a block of audio (stereo in/out on the main buses)
 // input_left, input_right: input audio buffers
 // output_left, output_right: output audio buffers
 // num_frames: number of frames to process
 // For instruments, input buffers can be NULL
+// Blocks up to max_block_size are processed in a single process() call;
+// larger blocks are split and queued MIDI events are routed to the
+// sub-block their sample_offset falls into.
+// Inputs and outputs may be the same buffers (in-place processing).
+bool vst3_process_block(
+    VST3PluginHandle handle,
+    const float* input_left,
+    const float* input_right,
+    float* output_left,
+    float* output_right,
+    int num_frames
+);
+
+// Same as vst3_process_block with double-precision buffers. A 64-bit plugin
+// reads and writes them directly; a 32-bit one goes through a conversion.
+// The float entry points likewise convert for 64-bit plugins
+bool vst3_process_block_double(
+    VST3PluginHandle handle,
+    const double* input_left,
+    const double* input_right,
+    double* output_left,
+    double* output_right,
+    int num_frames
+);
+
+// Process audio (legacy entry point, same as vst3_process_block)
 bool vst3_process_audio(
     VST3PluginHandle handle,
     const float* input_left,
@@ -71,12 +359,121 @@ bool vst3_process_audio(
     int num_frames
 );
 
+// Process a block of interleaved stereo (L R L R ...), as audio devices
+// and the engine's mix buffers deliver it. Each sub-block is split into
+// aligned planar scratch owned by the instance (SSE/AVX/NEON), processed
+// and merged back into `output`. input may be NULL (instruments) or equal
+// to output (in place). Otherwise behaves like vst3_process_block.
+// A chain of plugins doesn't need this between instances: run them with
+// vst3_process_block on the same planar buffers for input and output
+// (in-place processing), and interleave only at the ends
+bool vst3_process_interleaved(
+    VST3PluginHandle handle,
+    const float* input,
+    float* output,
+    int num_frames
+);
+
+// Input silence flags are set from a peak check of every block, and output
+// channels the plugin flags as silent are cleared.
+
+// Let the host skip process() while the plugin has nothing to do: its input
+// has been silent (with no MIDI or parameter changes) for longer than the
+// tail it reports and its output is silent. Off by default; plugins with an
+// infinite tail never sleep
+bool vst3_set_auto_sleep(VST3PluginHandle handle, bool enabled);
+
+// True if every output channel was silent in the last processed block
+bool vst3_is_output_silent(VST3PluginHandle handle);
+
+// Timing of the plugin's process() calls since load or the last reset
+typedef struct {
+    uint64_t process_calls;
+    uint64_t overruns;  // Realtime calls that took longer than the audio they produced
+    double mean_us;
+    double p99_us;      // From a log-scale histogram (about 12% resolution)
+    double max_us;
+    double last_us;
+    double load;        // Time in process() / duration of the audio processed (1.0 = 100%)
+} VST3PluginStats;
+
+// Per-plugin DSP load. Every process() call is timed with a monotonic clock
+// and accumulated without locking; safe to call from any thread while the
+// plugin is processing (the fields may be one block apart)
+bool vst3_get_plugin_stats(VST3PluginHandle handle, VST3PluginStats* stats);
+
+// Start the statistics over (e.g. after a transport start)
+void vst3_reset_plugin_stats(VST3PluginHandle handle);
+
+// Set up the calling thread for realtime processing. Call once on every
+// thread that processes plugins in realtime (the audio callback and any
+// worker threads it hands plugins to) before its first block:
+// - turns on flush-to-zero / denormals-are-zero, so decaying tails don't
+//   fall into the CPU's slow denormal path
+// - Windows: registers the thread with MMCSS as "Pro Audio"
+// - macOS: joins the default output device's audio workgroup, so the
+//   scheduler treats it as part of the device's IO deadline
+// Repeated calls are cheap no-ops. Returns false if the platform part
+// failed (the FP mode is set regardless). Every process() call also runs
+// with denormals flushed and the caller's FP mode restored afterwards, so
+// a plugin that changes the mode can't leak it into the host
+bool vst3_prepare_realtime_thread();
+
+// Undo the platform part of vst3_prepare_realtime_thread (leave the
+// workgroup / MMCSS task). Done automatically when the thread exits
+void vst3_release_realtime_thread();
+
+// Musical position of the block being processed, as the host's transport
+// sees it at the block's first sample
+typedef struct {
+    double sample_rate;
+    int64_t project_time_samples;     // Playhead
+    int64_t continuous_time_samples;  // Keeps running while stopped and across loops
+    double tempo;                     // BPM
+    int time_sig_numerator;
+    int time_sig_denominator;
+    double cycle_start_ppq;           // Loop range in quarter notes
+    double cycle_end_ppq;
+    bool playing;
+    bool recording;
+    bool cycle_active;
+} VST3Transport;
+
+typedef void* VST3TransportHandle;
+
+// Shared ProcessContext for every plugin processing a given stream of
+// blocks (the audio callback, an offline render). Update it once per
+// block; every process() on a thread bound to it gets the same context,
+// with the musical fields filled only if some loaded plugin asks for them
+// (IProcessContextRequirements; plugins without it get everything).
+// Until the first update plugins see no context at all
+VST3TransportHandle vst3_transport_create();
+void vst3_transport_destroy(VST3TransportHandle transport);
+
+// Recompute the context for the next block. Must not race with processing
+// on threads bound to it: update, then hand the block to the workers
+void vst3_transport_update(VST3TransportHandle transport, const VST3Transport* state);
+
+// Make the calling thread's process() calls use `transport` (NULL: no
+// context) and return the one it was bound to before. Cheap enough to call
+// at the start of every worker task. Bridged plugins get the bound
+// transport forwarded with each block
+VST3TransportHandle vst3_transport_bind(VST3TransportHandle transport);
+
 // Process MIDI event (for instruments)
-// event_type: 0 = note on, 1 = note off, 2 = CC
+// event_type: 0 = note on, 1 = note off, 2 = CC, 3 = pitch bend,
+//             4 = channel aftertouch
 // channel: MIDI channel (0-15)
-// data1: note number or CC number
-// data2: velocity or CC value
-// sample_offset: offset in current audio buffer
+// data1: note number, CC number, pitch bend LSB or aftertouch pressure
+// data2: velocity, CC value or pitch bend MSB
+// Controller messages become parameter changes through the plugin's
+// IMidiMapping (read at load, re-read by the instance's next poll, parameter
+// query or state restore after kMidiCCAssignmentChanged); unassigned ones
+// are dropped.
+// sample_offset: offset in the next processed block
+// Events go through a lock-free queue (up to 4096 in flight) and may be
+// sent from any thread. Events due in the same block are delivered in time
+// order; returns false if the queue is full.
 bool vst3_process_midi_event(
     VST3PluginHandle handle,
     int event_type,
@@ -86,6 +483,22 @@ bool vst3_process_midi_event(
     int sample_offset
 );
 
+// Queue a MIDI event at an absolute sample time on the plugin's own clock
+// (see vst3_get_sample_position). Events in the past play at the start of
+// the next block; events in the future wait for the block that covers them
+bool vst3_queue_midi_event_at(
+    VST3PluginHandle handle,
+    int event_type,
+    int channel,
+    int data1,
+    int data2,
+    int64_t sample_time
+);
+
+// Sample time of the next block the plugin will process: the number of
+// frames processed since it was loaded
+int64_t vst3_get_sample_position(VST3PluginHandle handle);
+
 // Parameter management
 int vst3_get_parameter_count(VST3PluginHandle handle);
 
@@ -100,13 +513,88 @@ typedef struct {
     int step_count;  // 0 for continuous, >0 for discrete
 } VST3ParameterInfo;
 
+// Titles and units are UTF-8. min/max_value are the plain range
+// (the value functions below work on normalized 0..1 values).
 bool vst3_get_parameter_info(VST3PluginHandle handle, int index, VST3ParameterInfo* info);
 
+// Copy the metadata of every parameter, in index order, into `infos`
+// (up to max_params entries). The catalog is cached per instance and
+// rebuilt when the plugin reports kParamTitlesChanged.
+// Pass infos = nullptr to just get the count.
+// Returns the total number of parameters, or -1 on error.
+int vst3_get_parameter_catalog(VST3PluginHandle handle, VST3ParameterInfo* infos, int max_params);
+
+// Index of a parameter ID in the catalog, or -1 if the plugin has no such parameter
+int vst3_get_parameter_index(VST3PluginHandle handle, uint32_t param_id);
+
 double vst3_get_parameter_value(VST3PluginHandle handle, uint32_t param_id);
+
+// Set a parameter from the UI side: updates the controller and queues the
+// value for the processor (applied at the start of the next block)
 bool vst3_set_parameter_value(VST3PluginHandle handle, uint32_t param_id, double value);
 
+// Batched forms of the two calls above, for UI refreshes and preset morphs:
+// ids[i] is read into / written from values[i] for i < count.
+// Get returns the number of values read, or -1 on error.
+// Set returns the number of values queued for the processor (less than
+// count if the parameter queue filled up), or -1 on error.
+int vst3_get_parameter_values(VST3PluginHandle handle, const uint32_t* ids, double* values, int count);
+int vst3_set_parameter_values(VST3PluginHandle handle, const uint32_t* ids, const double* values, int count);
+
+// Parameter change reported by the plugin's processor
+typedef struct {
+    uint32_t id;
+    int sample_offset;  // Offset inside the block that produced the change
+    double value;       // Normalized 0.0-1.0
+} VST3ParameterChange;
+
+// Drain parameter changes reported by the processor (output parameter
+// changes: meters, auto-learned values) since the last poll.
+// Call from the UI thread; also syncs the edit controller.
+// Returns the number of changes written to `changes` (at most max_changes)
+int vst3_poll_parameter_changes(VST3PluginHandle handle, VST3ParameterChange* changes, int max_changes);
+
+// Parameter edited in the plugin's own editor
+#define VST3_EDIT_VALUE_CHANGED 1  // `value` holds the latest value
+#define VST3_EDIT_BEGAN 2          // Gesture started (touch)
+#define VST3_EDIT_ENDED 4          // Gesture finished (release)
+
+typedef struct {
+    uint32_t id;
+    int32_t flags;   // VST3_EDIT_* bits; a whole gesture can arrive as one change
+    double value;    // Normalized 0.0-1.0
+} VST3EditorChange;
+
+// Drain the parameters edited in the plugin's editor since the last poll.
+// Edits are coalesced per parameter (latest value wins), so polling once
+// per UI frame is enough however fast the user moves a control; the values
+// have already been forwarded to the processor.
+// Returns the number of changes written (at most max_changes; the rest stay
+// pending for the next call)
+int vst3_poll_editor_changes(VST3PluginHandle handle, VST3EditorChange* changes, int max_changes);
+
+// Queue a sample-accurate parameter change for the processor (automation)
+// sample_offset: position inside the next processed block
+// Lock-free and allocation-free; safe to call from the audio thread.
+// Returns false if the queue is full.
+bool vst3_queue_parameter_change(VST3PluginHandle handle, uint32_t param_id, double value, int sample_offset);
+
 // State management (binary chunks)
-// Returns the size of the state data
+
+// Host-owned copy of a plugin's state, see vst3_snapshot_state
+typedef void* VST3StateSnapshot;
+
+// Serialize the plugin's state once into a host-owned buffer.
+// On success *data / *size describe the chunk (same format as
+// vst3_get_state), valid until vst3_release_state.
+// Returns nullptr on error (see vst3_get_last_error).
+VST3StateSnapshot vst3_snapshot_state(VST3PluginHandle handle, const void** data, int* size);
+
+// Free a snapshot returned by vst3_snapshot_state (nullptr is ignored)
+void vst3_release_state(VST3StateSnapshot snapshot);
+
+// Returns the size of the state data.
+// Serializes the whole state to measure it; prefer vst3_snapshot_state.
 int vst3_get_state_size(VST3PluginHandle handle);
 
 // Get plugin state
@@ -115,10 +603,16 @@ int vst3_get_state_size(VST3PluginHandle handle);
 int vst3_get_state(VST3PluginHandle handle, void* data, int max_size);
 
 // Set plugin state
-// data: state data to load
+// data: state data to load (read in place, not copied)
 // size: size of state data
 bool vst3_set_state(VST3PluginHandle handle, const void* data, int size);
 
+// Counter bumped whenever the plugin's state may have changed: edits and
+// kParamValuesChanged reported by the plugin, vst3_set_state and
+// vst3_set_parameter_value. Read it before taking a snapshot; if it hasn't
+// moved since, the saved state is still current.
+uint64_t vst3_get_state_generation(VST3PluginHandle handle);
+
 // Open plugin editor window (native GUI)
 // Returns true if editor opened successfully
 bool vst3_open_editor(VST3PluginHandle handle);
@@ -139,8 +633,29 @@ bool vst3_get_editor_size(VST3PluginHandle handle, int* width, int* height);
 bool vst3_attach_editor(VST3PluginHandle handle, void* parent);
 
 // Error handling
+// The last error is per thread: read it on the thread that made the failing
+// call. Storage is fixed-size, so failing realtime calls (processing,
+// queueing) never allocate or contend with other threads.
+// Message of the calling thread's last error ("" if none). Valid until the
+// thread's next failing call
 const char* vst3_get_last_error();
 
+// Code of the calling thread's last error (VST3_OK if none)
+VST3Result vst3_get_last_error_code();
+
+// Reset the calling thread's last error to VST3_OK
+void vst3_clear_last_error();
+
+// Static description of an error code
+const char* vst3_result_string(VST3Result result);
+
+// Minimum level for the host's diagnostic log: 0 = debug, 1 = info
+// (default), 2 = warnings, 3 = errors, 4 = off. Messages are queued without
+// locking and written to stderr by a background thread started in
+// vst3_host_init. No-op when the library is built without
+// VST3_HOST_LOGGING (release builds by default)
+void vst3_set_log_level(int level);
+
 #ifdef __cplusplus
 }
 #endif
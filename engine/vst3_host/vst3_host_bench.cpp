@@ -0,0 +1,565 @@
+// vst3_host_bench - benchmarks the host against the SDK's sample plugins
+//
+// Usage: vst3_host_bench [--plugins <dir>] [--output <file.json>] [--quick]
+//
+// Loads the again, adelay and again_sampleaccurate samples (built alongside
+// this target, see VST3_HOST_BUILD_BENCH) and measures, per plugin:
+// - load / initialize / activate / unload times
+// - process() cost per block at several block sizes
+// - MIDI throughput with event-heavy blocks
+// - parameter queue throughput (sample-accurate changes per block)
+// - state snapshot / restore sizes and times
+// plus cold and cached directory scan times. Results go to stdout (or
+// --output) as JSON; progress, errors and anything the host or plugins
+// print go to stderr. Times are wall-clock nanoseconds from a steady clock,
+// single-threaded.
+
+#include "vst3_host.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define fdopen _fdopen
+#else
+#include <unistd.h>
+#endif
+
+#ifndef VST3_HOST_BENCH_PLUGIN_DIR
+#define VST3_HOST_BENCH_PLUGIN_DIR ""
+#endif
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr int kMaxBlockSize = 4096;
+constexpr int kBlockSizes[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+constexpr const char* kSamplePlugins[] = {"again", "adelay", "again_sampleaccurate"};
+
+// Audio processed per measurement, so small blocks get as many calls as
+// they need to average out
+constexpr double kSecondsPerMeasurement = 2.0;
+constexpr double kQuickSecondsPerMeasurement = 0.25;
+
+// Queue depths for the throughput runs (the host's queues hold 4096)
+constexpr int kMidiEventsPerBlock = 256;
+constexpr int kParamChangesPerBlock = 256;
+constexpr int kThroughputBlockSize = 512;
+
+using Clock = std::chrono::steady_clock;
+
+int64_t elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Summary of a set of per-call timings
+struct Timings {
+    double mean_ns = 0.0;
+    double median_ns = 0.0;
+    double p99_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+    size_t samples = 0;
+};
+
+Timings summarize(std::vector<int64_t> ns) {
+    Timings t;
+    if (ns.empty()) {
+        return t;
+    }
+    std::sort(ns.begin(), ns.end());
+    double sum = 0.0;
+    for (int64_t v : ns) {
+        sum += static_cast<double>(v);
+    }
+    t.samples = ns.size();
+    t.mean_ns = sum / static_cast<double>(ns.size());
+    t.median_ns = static_cast<double>(ns[ns.size() / 2]);
+    t.p99_ns = static_cast<double>(ns[std::min(ns.size() - 1, ns.size() * 99 / 100)]);
+    t.min_ns = static_cast<double>(ns.front());
+    t.max_ns = static_cast<double>(ns.back());
+    return t;
+}
+
+// Minimal JSON writer: objects and arrays with automatic commas.
+// Names passed in are plain identifiers; string values are escaped.
+class JsonWriter {
+public:
+    void begin_object(const char* name = nullptr) { open(name, '{'); }
+    void end_object() { close('}'); }
+    void begin_array(const char* name = nullptr) { open(name, '['); }
+    void end_array() { close(']'); }
+
+    void value(const char* name, const std::string& v) {
+        key(name);
+        out_ += '"';
+        for (char c : v) {
+            switch (c) {
+                case '"': out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\n': out_ += "\\n"; break;
+                case '\t': out_ += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out_ += buf;
+                    } else {
+                        out_ += c;
+                    }
+            }
+        }
+        out_ += '"';
+    }
+    void value(const char* name, const char* v) { value(name, std::string(v ? v : "")); }
+    void value(const char* name, bool v) {
+        key(name);
+        out_ += v ? "true" : "false";
+    }
+    void value(const char* name, int64_t v) {
+        key(name);
+        out_ += std::to_string(v);
+    }
+    void value(const char* name, int v) { value(name, static_cast<int64_t>(v)); }
+    void value(const char* name, size_t v) { value(name, static_cast<int64_t>(v)); }
+    void value(const char* name, double v) {
+        key(name);
+        if (!std::isfinite(v)) {
+            out_ += "null";
+            return;
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", v);
+        out_ += buf;
+    }
+
+    void timings(const char* name, const Timings& t) {
+        begin_object(name);
+        value("mean_ns", t.mean_ns);
+        value("median_ns", t.median_ns);
+        value("p99_ns", t.p99_ns);
+        value("min_ns", t.min_ns);
+        value("max_ns", t.max_ns);
+        value("samples", t.samples);
+        end_object();
+    }
+
+    const std::string& str() const { return out_; }
+
+private:
+    void key(const char* name) {
+        if (need_comma_) {
+            out_ += ',';
+        }
+        newline();
+        if (name) {
+            out_ += '"';
+            out_ += name;
+            out_ += "\": ";
+        }
+        need_comma_ = true;
+    }
+
+    void open(const char* name, char bracket) {
+        key(name);
+        out_ += bracket;
+        depth_++;
+        need_comma_ = false;
+    }
+
+    void close(char bracket) {
+        depth_--;
+        newline();
+        out_ += bracket;
+        need_comma_ = true;
+    }
+
+    void newline() {
+        if (out_.empty()) {
+            return;
+        }
+        out_ += '\n';
+        out_.append(static_cast<size_t>(depth_) * 2, ' ');
+    }
+
+    std::string out_;
+    int depth_ = 0;
+    bool need_comma_ = false;
+};
+
+struct Options {
+    std::string plugin_dir = VST3_HOST_BENCH_PLUGIN_DIR;
+    std::string output;
+    bool quick = false;
+};
+
+// Stereo noise input and output buffers for the largest block
+struct Buffers {
+    std::vector<float> in_l, in_r, out_l, out_r;
+
+    Buffers() : in_l(kMaxBlockSize), in_r(kMaxBlockSize), out_l(kMaxBlockSize), out_r(kMaxBlockSize) {
+        uint32_t seed = 0x12345678;
+        for (int i = 0; i < kMaxBlockSize; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            in_l[i] = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+            in_r[i] = -in_l[i];
+        }
+    }
+
+    bool process(VST3PluginHandle plugin, int frames) {
+        return vst3_process_block(plugin, in_l.data(), in_r.data(), out_l.data(), out_r.data(), frames);
+    }
+};
+
+int blocks_for(int block_size, const Options& options) {
+    const double seconds = options.quick ? kQuickSecondsPerMeasurement : kSecondsPerMeasurement;
+    return std::max(16, static_cast<int>(seconds * kSampleRate / block_size));
+}
+
+void count_plugin(const VST3PluginInfo*, void*) {}
+
+// Scan the plugin directory with an empty cache, then again with the cache
+// the first scan wrote
+void bench_scan(JsonWriter& json, const Options& options) {
+    const std::string cache_path = options.plugin_dir + "/.vst3_host_bench_scan_cache.txt";
+    vst3_set_scan_cache_path(cache_path.c_str());
+    vst3_clear_scan_cache();
+
+    Clock::time_point start = Clock::now();
+    const int cold_count = vst3_scan_directory(options.plugin_dir.c_str(), count_plugin, nullptr);
+    const int64_t cold_ns = elapsed_ns(start);
+
+    std::vector<int64_t> cached;
+    int cached_count = 0;
+    for (int i = 0; i < (options.quick ? 3 : 10); i++) {
+        start = Clock::now();
+        cached_count = vst3_scan_directory(options.plugin_dir.c_str(), count_plugin, nullptr);
+        cached.push_back(elapsed_ns(start));
+    }
+
+    json.begin_object("scan");
+    json.value("directory", options.plugin_dir);
+    json.value("cold_ns", cold_ns);
+    json.value("cold_plugins", cold_count);
+    json.timings("cached", summarize(cached));
+    json.value("cached_plugins", cached_count);
+    json.end_object();
+
+    vst3_clear_scan_cache();
+    std::remove(cache_path.c_str());
+    vst3_set_scan_cache_path(nullptr);
+}
+
+void bench_block_sizes(JsonWriter& json, VST3PluginHandle plugin, Buffers& buffers, const Options& options) {
+    json.begin_array("process");
+    for (int block_size : kBlockSizes) {
+        const int blocks = blocks_for(block_size, options);
+        for (int i = 0; i < 8; i++) {
+            buffers.process(plugin, block_size);  // Warm up caches and branch predictors
+        }
+
+        std::vector<int64_t> ns;
+        ns.reserve(static_cast<size_t>(blocks));
+        bool ok = true;
+        for (int i = 0; i < blocks && ok; i++) {
+            const Clock::time_point start = Clock::now();
+            ok = buffers.process(plugin, block_size);
+            ns.push_back(elapsed_ns(start));
+        }
+
+        const Timings t = summarize(std::move(ns));
+        json.begin_object();
+        json.value("block_size", block_size);
+        json.value("ok", ok);
+        json.timings("block", t);
+        json.value("ns_per_frame", t.mean_ns / block_size);
+        // Share of the block's realtime budget spent in process()
+        json.value("realtime_load", t.mean_ns / (block_size / kSampleRate * 1e9));
+        json.end_object();
+    }
+    json.end_array();
+}
+
+// Blocks carrying kMidiEventsPerBlock note on/off events spread across the
+// block. Effects without an event input still pay for queueing and routing
+void bench_midi(JsonWriter& json, VST3PluginHandle plugin, Buffers& buffers, const Options& options) {
+    const int blocks = blocks_for(kThroughputBlockSize, options);
+    std::vector<int64_t> ns;
+    ns.reserve(static_cast<size_t>(blocks));
+    int64_t queued = 0;
+    int64_t dropped = 0;
+
+    for (int b = 0; b < blocks; b++) {
+        const Clock::time_point start = Clock::now();
+        for (int e = 0; e < kMidiEventsPerBlock; e++) {
+            const int note = 36 + (e / 2) % 48;
+            const int offset = e * kThroughputBlockSize / kMidiEventsPerBlock;
+            if (vst3_process_midi_event(plugin, e % 2, 0, note, 100, offset)) {
+                queued++;
+            } else {
+                dropped++;
+            }
+        }
+        buffers.process(plugin, kThroughputBlockSize);
+        ns.push_back(elapsed_ns(start));
+    }
+
+    const Timings t = summarize(std::move(ns));
+    json.begin_object("midi");
+    json.value("block_size", kThroughputBlockSize);
+    json.value("events_per_block", kMidiEventsPerBlock);
+    json.timings("block", t);
+    json.value("events_queued", queued);
+    json.value("events_dropped", dropped);
+    json.value("events_per_second", kMidiEventsPerBlock / (t.mean_ns * 1e-9));
+    json.end_object();
+}
+
+// Blocks carrying kParamChangesPerBlock sample-accurate changes, spread over
+// every parameter the plugin has
+void bench_parameters(JsonWriter& json, VST3PluginHandle plugin, Buffers& buffers, const Options& options) {
+    std::vector<VST3ParameterInfo> params(static_cast<size_t>(std::max(vst3_get_parameter_count(plugin), 0)));
+    const int count = params.empty() ? 0 : vst3_get_parameter_catalog(plugin, params.data(), static_cast<int>(params.size()));
+    json.begin_object("parameters");
+    json.value("count", count);
+    if (count <= 0) {
+        json.end_object();
+        return;
+    }
+    params.resize(static_cast<size_t>(std::min<int>(count, static_cast<int>(params.size()))));
+
+    const int blocks = blocks_for(kThroughputBlockSize, options);
+    std::vector<int64_t> ns;
+    ns.reserve(static_cast<size_t>(blocks));
+    int64_t queued = 0;
+    int64_t dropped = 0;
+
+    for (int b = 0; b < blocks; b++) {
+        const Clock::time_point start = Clock::now();
+        for (int c = 0; c < kParamChangesPerBlock; c++) {
+            const VST3ParameterInfo& param = params[static_cast<size_t>(c) % params.size()];
+            const double value = 0.5 + 0.5 * std::sin((b * kParamChangesPerBlock + c) * 0.01);
+            const int offset = c * kThroughputBlockSize / kParamChangesPerBlock;
+            if (vst3_queue_parameter_change(plugin, param.id, value, offset)) {
+                queued++;
+            } else {
+                dropped++;
+            }
+        }
+        buffers.process(plugin, kThroughputBlockSize);
+        ns.push_back(elapsed_ns(start));
+    }
+
+    const Timings t = summarize(std::move(ns));
+    json.value("block_size", kThroughputBlockSize);
+    json.value("changes_per_block", kParamChangesPerBlock);
+    json.timings("block", t);
+    json.value("changes_queued", queued);
+    json.value("changes_dropped", dropped);
+    json.value("changes_per_second", kParamChangesPerBlock / (t.mean_ns * 1e-9));
+    json.end_object();
+}
+
+void bench_state(JsonWriter& json, VST3PluginHandle plugin, const Options& options) {
+    const int iterations = options.quick ? 20 : 200;
+    std::vector<int64_t> save_ns, restore_ns;
+    std::vector<uint8_t> chunk;
+    bool ok = true;
+
+    for (int i = 0; i < iterations && ok; i++) {
+        const void* data = nullptr;
+        int size = 0;
+        Clock::time_point start = Clock::now();
+        VST3StateSnapshot snapshot = vst3_snapshot_state(plugin, &data, &size);
+        save_ns.push_back(elapsed_ns(start));
+        if (!snapshot) {
+            ok = false;
+            break;
+        }
+        chunk.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        vst3_release_state(snapshot);
+
+        start = Clock::now();
+        ok = vst3_set_state(plugin, chunk.data(), static_cast<int>(chunk.size()));
+        restore_ns.push_back(elapsed_ns(start));
+    }
+
+    json.begin_object("state");
+    json.value("ok", ok);
+    json.value("size_bytes", chunk.size());
+    json.timings("snapshot", summarize(std::move(save_ns)));
+    json.timings("restore", summarize(std::move(restore_ns)));
+    json.end_object();
+}
+
+// Instance pool: a miss loads like vst3_load_plugin_async does, a hit hands
+// out a warm instance. Every release is recycled before the next acquire
+void bench_pool(JsonWriter& json, const std::string& path, const Options& options) {
+    constexpr auto kWarmTimeout = std::chrono::seconds(10);
+    const int iterations = options.quick ? 5 : 20;
+
+    vst3_pool_configure(1, 1, kSampleRate, kMaxBlockSize);
+    auto wait_warm = [&path, kWarmTimeout]() {
+        const Clock::time_point deadline = Clock::now() + kWarmTimeout;
+        while (vst3_pool_ready_count(path.c_str()) == 0 && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return vst3_pool_ready_count(path.c_str()) > 0;
+    };
+
+    Clock::time_point start = Clock::now();
+    VST3PluginHandle plugin = vst3_pool_acquire(path.c_str(), kSampleRate, kMaxBlockSize);
+    const int64_t miss_ns = elapsed_ns(start);
+    bool ok = plugin != nullptr;
+    vst3_pool_release(plugin);
+
+    std::vector<int64_t> hit_ns;
+    for (int i = 0; i < iterations && ok; i++) {
+        ok = wait_warm();
+        if (!ok) break;
+        start = Clock::now();
+        plugin = vst3_pool_acquire(path.c_str(), kSampleRate, kMaxBlockSize);
+        hit_ns.push_back(elapsed_ns(start));
+        ok = plugin != nullptr;
+        vst3_pool_release(plugin);
+    }
+    vst3_pool_configure(0, 0, kSampleRate, kMaxBlockSize);
+
+    json.begin_object("pool");
+    json.value("ok", ok);
+    json.value("miss_ns", miss_ns);
+    json.timings("hit", summarize(std::move(hit_ns)));
+    json.end_object();
+}
+
+void bench_plugin(JsonWriter& json, const std::string& name, Buffers& buffers, const Options& options) {
+    const std::string path = options.plugin_dir + "/" + name + ".vst3";
+    std::fprintf(stderr, "🎛️  [Bench] %s\n", path.c_str());
+
+    json.begin_object();
+    json.value("name", name);
+
+    Clock::time_point start = Clock::now();
+    VST3PluginHandle plugin = vst3_load_plugin(path.c_str());
+    const int64_t load_ns = elapsed_ns(start);
+    if (!plugin) {
+        json.value("error", vst3_get_last_error());
+        json.end_object();
+        std::fprintf(stderr, "❌ [Bench] %s: %s\n", name.c_str(), vst3_get_last_error());
+        return;
+    }
+
+    start = Clock::now();
+    const bool initialized = vst3_initialize_plugin(plugin, kSampleRate, kMaxBlockSize);
+    const int64_t initialize_ns = elapsed_ns(start);
+
+    start = Clock::now();
+    const bool activated = initialized && vst3_activate_plugin(plugin);
+    const int64_t activate_ns = elapsed_ns(start);
+
+    json.begin_object("lifecycle");
+    json.value("load_ns", load_ns);
+    json.value("initialize_ns", initialize_ns);
+    json.value("activate_ns", activate_ns);
+    json.end_object();
+
+    if (activated) {
+        json.value("latency_samples", vst3_get_latency_samples(plugin));
+        bench_block_sizes(json, plugin, buffers, options);
+        bench_midi(json, plugin, buffers, options);
+        bench_parameters(json, plugin, buffers, options);
+        bench_state(json, plugin, options);
+    } else {
+        json.value("error", vst3_get_last_error());
+        std::fprintf(stderr, "❌ [Bench] %s: %s\n", name.c_str(), vst3_get_last_error());
+    }
+
+    start = Clock::now();
+    if (activated) {
+        vst3_deactivate_plugin(plugin);
+    }
+    vst3_unload_plugin(plugin);
+    json.value("unload_ns", elapsed_ns(start));
+
+    bench_pool(json, path, options);
+    json.end_object();
+}
+
+bool parse_args(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--plugins") == 0 && i + 1 < argc) {
+            options.plugin_dir = argv[++i];
+        } else if (std::strcmp(arg, "--output") == 0 && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (std::strcmp(arg, "--quick") == 0) {
+            options.quick = true;
+        } else {
+            return false;
+        }
+    }
+    return !options.plugin_dir.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s [--plugins <dir>] [--output <file.json>] [--quick]\n", argv[0]);
+        return 2;
+    }
+
+    // Keep stdout for the results; the host logs there too
+    std::fflush(stdout);
+    const int results_fd = dup(1);
+    dup2(2, 1);
+
+    if (!vst3_host_init()) {
+        std::fprintf(stderr, "❌ [Bench] %s\n", vst3_get_last_error());
+        return 1;
+    }
+    // Measure the way the audio thread runs: denormals flushed, realtime class
+    vst3_prepare_realtime_thread();
+
+    JsonWriter json;
+    json.begin_object();
+    json.value("sample_rate", kSampleRate);
+    json.value("max_block_size", kMaxBlockSize);
+    json.value("quick", options.quick);
+
+    bench_scan(json, options);
+
+    Buffers buffers;
+    json.begin_array("plugins");
+    for (const char* name : kSamplePlugins) {
+        bench_plugin(json, name, buffers, options);
+    }
+    json.end_array();
+    json.end_object();
+
+    vst3_release_realtime_thread();
+    vst3_host_shutdown();
+
+    const std::string& result = json.str();
+    std::fflush(stdout);
+    FILE* file = options.output.empty() ? fdopen(results_fd, "w") : std::fopen(options.output.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "❌ [Bench] Can't write %s\n", options.output.c_str());
+        return 1;
+    }
+    std::fwrite(result.data(), 1, result.size(), file);
+    std::fputc('\n', file);
+    std::fclose(file);
+    return 0;
+}
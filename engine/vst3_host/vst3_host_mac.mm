@@ -1,9 +1,19 @@
 //-----------------------------------------------------------------------------
 // VST3 Host macOS-specific helper functions
 // This file provides Objective-C implementations for NSView manipulation
+// and realtime thread scheduling
 //-----------------------------------------------------------------------------
 
 #import <Cocoa/Cocoa.h>
+#import <CoreAudio/CoreAudio.h>
+#include <os/workgroup.h>
+#include <errno.h>
+
+/// A workgroup the calling thread joined, with the token needed to leave it
+struct JoinedWorkgroup {
+    os_workgroup_t workgroup;
+    os_workgroup_join_token_s token;
+};
 
 extern "C" {
 
@@ -75,4 +85,58 @@ void vst3_resize_nsview(void* nsview, int width, int height) {
     fflush(stderr);
 }
 
+/// Join the default output device's audio workgroup, so the scheduler
+/// treats the calling thread as part of the device's IO deadline (the IO
+/// thread itself is already a member). Needs macOS 11; earlier versions
+/// have no workgroups and succeed without doing anything
+/// @param token - Receives the membership for the release call
+bool vst3_platform_prepare_realtime_thread(void** token) {
+    *token = nullptr;
+    if (@available(macOS 11.0, *)) {
+        AudioObjectPropertyAddress address = {
+            kAudioHardwarePropertyDefaultOutputDevice,
+            kAudioObjectPropertyScopeGlobal,
+            0  // Main element
+        };
+        AudioObjectID device = kAudioObjectUnknown;
+        UInt32 size = sizeof(device);
+        if (AudioObjectGetPropertyData(kAudioObjectSystemObject, &address, 0, nullptr, &size, &device) != noErr ||
+            device == kAudioObjectUnknown) {
+            return false;
+        }
+
+        // The property hands back a retained reference, which ARC releases
+        // with `workgroup`
+        os_workgroup_t workgroup = nil;
+        address.mSelector = kAudioDevicePropertyIOThreadOSWorkgroup;
+        size = sizeof(workgroup);
+        if (AudioObjectGetPropertyData(device, &address, 0, nullptr, &size, (void*)&workgroup) != noErr ||
+            !workgroup) {
+            return false;
+        }
+
+        JoinedWorkgroup* joined = new JoinedWorkgroup{workgroup, {}};
+        const int result = os_workgroup_join(workgroup, &joined->token);
+        if (result != 0) {
+            delete joined;
+            // Already in a workgroup (e.g. this is the device's IO thread)
+            return result == EALREADY;
+        }
+        *token = joined;
+    }
+    return true;
+}
+
+/// Leave the workgroup joined by vst3_platform_prepare_realtime_thread.
+/// Must run on the thread that joined it
+void vst3_platform_release_realtime_thread(void* token) {
+    if (@available(macOS 11.0, *)) {
+        JoinedWorkgroup* joined = static_cast<JoinedWorkgroup*>(token);
+        if (joined) {
+            os_workgroup_leave(joined->workgroup, &joined->token);
+            delete joined;
+        }
+    }
+}
+
 } // extern "C"
@@ -0,0 +1,730 @@
+// vst3_host_render - renders audio files through a fixed plugin chain, headless
+//
+// Usage: vst3_host_render --chain <chain.txt> --output-dir <dir> [--jobs <n>]
+//                         [--block <frames>] [--tail <seconds>] <input.wav>...
+//
+// The chain file lists one plugin per line, in processing order:
+//     <bundle path>[<TAB><state file>]
+// '#' starts a comment line. A state file holds a chunk exactly as
+// vst3_get_state returned it. Relative paths are taken from the chain
+// file's directory.
+//
+// Every worker thread loads its own instance of the chain, sets it up for
+// offline processing with large blocks and renders the next file from a
+// shared list until none are left, so throughput scales with cores. Inputs
+// (8/16/24/32-bit PCM or 32/64-bit float WAV, mono or stereo) are
+// memory-mapped and converted a block at a time; outputs are 32-bit float
+// stereo WAVs of the same name in --output-dir, streamed through a large
+// stdio buffer and renamed into place once complete. The chain's latency is
+// compensated, so outputs line up with their inputs, and --tail seconds of
+// the chain's tail follow the input's end.
+//
+// One line per file goes to stdout; progress, errors and anything the host
+// or plugins print go to stderr. Exit status: 0 if every file rendered, 1 if
+// any failed, 2 on usage errors.
+
+#include "vst3_host.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#define dup _dup
+#define dup2 _dup2
+#define fdopen _fdopen
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int kDefaultBlockSize = 8192;
+constexpr int kMinBlockSize = 64;
+constexpr int kMaxBlockSize = 65536;
+constexpr size_t kOutputBufferSize = 1u << 20;
+
+using Clock = std::chrono::steady_clock;
+
+//------------------------------------------------------------------------
+// Chain description
+//------------------------------------------------------------------------
+
+struct ChainEntry {
+    std::string plugin_path;
+    std::vector<char> state;  // Empty: the plugin's defaults
+};
+
+bool read_file(const fs::path& path, std::vector<char>& data) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const std::streamsize size = in.tellg();
+    data.resize(static_cast<size_t>(std::max<std::streamsize>(0, size)));
+    in.seekg(0);
+    return static_cast<bool>(in.read(data.data(), size));
+}
+
+bool read_chain(const std::string& chain_path, std::vector<ChainEntry>& chain, std::string& error) {
+    std::ifstream in(chain_path);
+    if (!in) {
+        error = "can't read " + chain_path;
+        return false;
+    }
+    const fs::path base = fs::path(chain_path).parent_path();
+    auto resolve = [&](const std::string& path) {
+        const fs::path p(path);
+        return p.is_absolute() ? p : base / p;
+    };
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        ChainEntry entry;
+        const size_t tab = line.find('\t');
+        entry.plugin_path = resolve(line.substr(0, tab)).string();
+        if (tab != std::string::npos) {
+            const fs::path state_path = resolve(line.substr(tab + 1));
+            if (!read_file(state_path, entry.state)) {
+                error = "line " + std::to_string(line_number) + ": can't read state " + state_path.string();
+                return false;
+            }
+        }
+        chain.push_back(std::move(entry));
+    }
+    if (chain.empty()) {
+        error = chain_path + " lists no plugins";
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------
+// Input: memory-mapped WAV
+//------------------------------------------------------------------------
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    }
+
+    bool open(const std::string& path) {
+#ifdef _WIN32
+        file_ = CreateFileW(fs::path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) return false;
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) return false;
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        size_ = static_cast<size_t>(size.QuadPart);
+        return data_ != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) return false;
+        // Read front to back, once
+        madvise(mapped, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+        data_ = static_cast<const uint8_t*>(mapped);
+        size_ = static_cast<size_t>(st.st_size);
+        return true;
+#endif
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+// WAV fields are little-endian, as is every platform the host builds for
+uint16_t read_u16(const uint8_t* p) {
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xfffe;
+
+// The sample data of a parsed WAV, pointing into the mapping
+struct WavInput {
+    uint16_t format = 0;  // kFormatPcm or kFormatFloat
+    int channels = 0;
+    int bits = 0;
+    double sample_rate = 0.0;
+    const uint8_t* samples = nullptr;
+    size_t frames = 0;
+};
+
+bool parse_wav(const uint8_t* data, size_t size, WavInput& wav, std::string& error) {
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    bool have_format = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = data + pos;
+        const size_t available = size - pos - 8;
+        const size_t chunk_size = std::min<size_t>(read_u32(chunk + 4), available);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+            wav.format = read_u16(chunk + 8);
+            wav.channels = read_u16(chunk + 10);
+            wav.sample_rate = read_u32(chunk + 12);
+            wav.bits = read_u16(chunk + 22);
+            if (wav.format == kFormatExtensible && chunk_size >= 40) {
+                wav.format = read_u16(chunk + 32);  // First two bytes of the subformat GUID
+            }
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) {
+                error = "data chunk before fmt chunk";
+                return false;
+            }
+            // A streaming writer may have left the size at 0 or 0xffffffff:
+            // the data then runs to the end of the file
+            const uint32_t declared = read_u32(chunk + 4);
+            const size_t data_size = declared == 0 || declared == 0xffffffffu ? available : chunk_size;
+            wav.samples = chunk + 8;
+            const size_t frame_bytes = static_cast<size_t>(wav.channels) * (wav.bits / 8);
+            wav.frames = frame_bytes > 0 ? data_size / frame_bytes : 0;
+            break;
+        }
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    if (!have_format || !wav.samples) {
+        error = "no audio data";
+        return false;
+    }
+    const bool pcm = wav.format == kFormatPcm &&
+                     (wav.bits == 8 || wav.bits == 16 || wav.bits == 24 || wav.bits == 32);
+    const bool fp = wav.format == kFormatFloat && (wav.bits == 32 || wav.bits == 64);
+    if (!pcm && !fp) {
+        error = "unsupported sample format (format " + std::to_string(wav.format) + ", " +
+                std::to_string(wav.bits) + " bits)";
+        return false;
+    }
+    if (wav.channels < 1 || wav.channels > 2) {
+        error = "only mono and stereo files are supported";
+        return false;
+    }
+    if (wav.sample_rate <= 0.0) {
+        error = "invalid sample rate";
+        return false;
+    }
+    return true;
+}
+
+float decode_sample(const WavInput& wav, const uint8_t* p) {
+    if (wav.format == kFormatFloat) {
+        if (wav.bits == 32) {
+            float v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        double v;
+        std::memcpy(&v, p, sizeof(v));
+        return static_cast<float>(v);
+    }
+    switch (wav.bits) {
+        case 8:
+            return (static_cast<int>(p[0]) - 128) * (1.0f / 128.0f);
+        case 16:
+            return static_cast<int16_t>(read_u16(p)) * (1.0f / 32768.0f);
+        case 24: {
+            const int32_t v = static_cast<int32_t>((uint32_t(p[0]) << 8) | (uint32_t(p[1]) << 16) |
+                                                   (uint32_t(p[2]) << 24)) >> 8;
+            return v * (1.0f / 8388608.0f);
+        }
+        default:
+            return static_cast<int32_t>(read_u32(p)) * (1.0f / 2147483648.0f);
+    }
+}
+
+// Frames [first, first + count) as planar stereo; silence past the end
+void read_frames(const WavInput& wav, size_t first, int count, float* left, float* right) {
+    const size_t sample_bytes = static_cast<size_t>(wav.bits / 8);
+    const size_t frame_bytes = sample_bytes * wav.channels;
+    const int available = first < wav.frames ? static_cast<int>(std::min<size_t>(count, wav.frames - first)) : 0;
+
+    const uint8_t* p = wav.samples + first * frame_bytes;
+    for (int i = 0; i < available; i++, p += frame_bytes) {
+        left[i] = decode_sample(wav, p);
+        right[i] = wav.channels == 2 ? decode_sample(wav, p + sample_bytes) : left[i];
+    }
+    std::fill(left + available, left + count, 0.0f);
+    std::fill(right + available, right + count, 0.0f);
+}
+
+//------------------------------------------------------------------------
+// Output: streamed 32-bit float WAV
+//------------------------------------------------------------------------
+
+// Writes to "<path>.part" and renames it over `path` once finished, so a
+// failed or interrupted render never leaves a truncated file behind
+class WavWriter {
+public:
+    WavWriter() = default;
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    ~WavWriter() {
+        if (file_) {
+            std::fclose(file_);
+            std::error_code ec;
+            fs::remove(part_path_, ec);
+        }
+    }
+
+    bool open(const fs::path& path, double sample_rate) {
+        path_ = path;
+        part_path_ = path;
+        part_path_ += ".part";
+        file_ = std::fopen(part_path_.string().c_str(), "wb");
+        if (!file_) return false;
+        std::setvbuf(file_, nullptr, _IOFBF, kOutputBufferSize);
+        sample_rate_ = static_cast<uint32_t>(sample_rate);
+        return write_header();  // Sizes are filled in by finish()
+    }
+
+    bool write(const float* left, const float* right, int frames) {
+        interleaved_.resize(static_cast<size_t>(frames) * 2);
+        for (int i = 0; i < frames; i++) {
+            interleaved_[2 * i] = left[i];
+            interleaved_[2 * i + 1] = right[i];
+        }
+        frames_ += static_cast<uint64_t>(frames);
+        return std::fwrite(interleaved_.data(), sizeof(float), interleaved_.size(), file_) == interleaved_.size();
+    }
+
+    bool finish(std::string& error) {
+        if (data_bytes() > 0xffffffffull - kHeaderSize) {
+            error = "output larger than 4 GB";
+            return false;
+        }
+        if (std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0 || !write_header() ||
+            std::fclose(file_) != 0) {
+            file_ = nullptr;
+            error = "write failed";
+            return false;
+        }
+        file_ = nullptr;
+
+        std::error_code ec;
+        fs::rename(part_path_, path_, ec);
+        if (ec) {
+            fs::remove(part_path_, ec);
+            error = "can't rename the finished file into place";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint32_t kHeaderSize = 12 + 24 + 12 + 8;  // RIFF, fmt, fact, data header
+
+    uint64_t data_bytes() const { return frames_ * 2 * sizeof(float); }
+
+    bool write_header() {
+        uint8_t header[kHeaderSize];
+        uint8_t* p = header;
+        auto put = [&p](const void* v, size_t n) {
+            std::memcpy(p, v, n);
+            p += n;
+        };
+        auto put16 = [&put](uint16_t v) { put(&v, 2); };
+        auto put32 = [&put](uint32_t v) { put(&v, 4); };
+
+        const uint32_t data_size = static_cast<uint32_t>(data_bytes());
+        put("RIFF", 4);
+        put32(kHeaderSize - 8 + data_size);
+        put("WAVE", 4);
+        put("fmt ", 4);
+        put32(16);
+        put16(kFormatFloat);
+        put16(2);
+        put32(sample_rate_);
+        put32(sample_rate_ * 2 * sizeof(float));
+        put16(2 * sizeof(float));
+        put16(32);
+        put("fact", 4);  // Required for non-PCM formats
+        put32(4);
+        put32(static_cast<uint32_t>(frames_));
+        put("data", 4);
+        put32(data_size);
+        return std::fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+    }
+
+    fs::path path_;
+    fs::path part_path_;
+    FILE* file_ = nullptr;
+    uint32_t sample_rate_ = 0;
+    uint64_t frames_ = 0;
+    std::vector<float> interleaved_;
+};
+
+//------------------------------------------------------------------------
+// Plugin chain
+//------------------------------------------------------------------------
+
+// One worker's instances of the chain, set up for offline processing at the
+// sample rate of the file it's rendering
+class Chain {
+public:
+    explicit Chain(int block_size) : block_size_(block_size) {}
+    Chain(const Chain&) = delete;
+    Chain& operator=(const Chain&) = delete;
+
+    ~Chain() { unload(); }
+
+    // All or nothing: a chain that fails to load is left empty
+    bool load(const std::vector<ChainEntry>& entries, double sample_rate, std::string& error) {
+        for (const ChainEntry& entry : entries) {
+            VST3PluginHandle plugin = vst3_load_plugin(entry.plugin_path.c_str());
+            if (!plugin) {
+                error = entry.plugin_path + ": " + vst3_get_last_error();
+                unload();
+                return false;
+            }
+            plugins_.push_back(plugin);
+
+            const bool ok = vst3_initialize_plugin(plugin, sample_rate, block_size_) &&
+                            vst3_set_offline_mode(plugin, true, block_size_) &&
+                            (entry.state.empty() ||
+                             vst3_set_state(plugin, entry.state.data(), static_cast<int>(entry.state.size()))) &&
+                            vst3_activate_plugin(plugin);
+            if (!ok) {
+                error = entry.plugin_path + ": " + vst3_get_last_error();
+                unload();
+                return false;
+            }
+        }
+        sample_rate_ = sample_rate;
+        return true;
+    }
+
+    // Ready for a new file: the right sample rate and no tail of the last one
+    bool prepare(double sample_rate, std::string& error) {
+        for (VST3PluginHandle plugin : plugins_) {
+            const bool ok = (sample_rate == sample_rate_ || vst3_reconfigure(plugin, sample_rate, block_size_)) &&
+                            vst3_reset_plugin(plugin);
+            if (!ok) {
+                error = vst3_get_last_error();
+                return false;
+            }
+        }
+        sample_rate_ = sample_rate;
+        return true;
+    }
+
+    int latency_samples() const {
+        int latency = 0;
+        for (VST3PluginHandle plugin : plugins_) {
+            latency += vst3_get_latency_samples(plugin);
+        }
+        return latency;
+    }
+
+    // In place, plugin after plugin
+    bool process(float* left, float* right, int frames) {
+        for (VST3PluginHandle plugin : plugins_) {
+            if (!vst3_process_block(plugin, left, right, left, right, frames)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool empty() const { return plugins_.empty(); }
+
+private:
+    void unload() {
+        for (VST3PluginHandle plugin : plugins_) {
+            vst3_deactivate_plugin(plugin);
+            vst3_unload_plugin(plugin);
+        }
+        plugins_.clear();
+    }
+
+    int block_size_;
+    double sample_rate_ = 0.0;
+    std::vector<VST3PluginHandle> plugins_;
+};
+
+//------------------------------------------------------------------------
+// Rendering
+//------------------------------------------------------------------------
+
+struct Options {
+    std::string chain_path;
+    std::string output_dir;
+    std::vector<std::string> inputs;
+    int jobs = 0;  // 0: one per core
+    int block_size = kDefaultBlockSize;
+    double tail_seconds = 0.0;
+};
+
+struct Job {
+    const Options& options;
+    const std::vector<ChainEntry>& chain;
+    std::atomic<size_t> next_input{0};
+    std::atomic<int> failures{0};
+    std::mutex output_mutex;
+    FILE* results;
+
+    Job(const Options& o, const std::vector<ChainEntry>& c, FILE* r) : options(o), chain(c), results(r) {}
+
+    void report(const std::string& line) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::fprintf(results, "%s\n", line.c_str());
+        std::fflush(results);
+    }
+};
+
+fs::path output_path_for(const Options& options, const std::string& input) {
+    fs::path name = fs::path(input).filename();
+    name.replace_extension(".wav");
+    return fs::path(options.output_dir) / name;
+}
+
+bool render_file(Job& job, Chain& chain, const std::string& input, const fs::path& output,
+                 std::vector<float>& left, std::vector<float>& right, double& seconds, std::string& error) {
+    MappedFile file;
+    if (!file.open(input)) {
+        error = "can't map the file";
+        return false;
+    }
+    WavInput wav;
+    if (!parse_wav(file.data(), file.size(), wav, error)) {
+        return false;
+    }
+
+    // Instances are loaded on the first file, at its sample rate
+    if (chain.empty()) {
+        if (!chain.load(job.chain, wav.sample_rate, error)) {
+            return false;
+        }
+    } else if (!chain.prepare(wav.sample_rate, error)) {
+        return false;
+    }
+
+    // Render latency + input + tail frames and drop the first `latency`,
+    // so the output starts where the input does
+    const int block_size = job.options.block_size;
+    const size_t latency = static_cast<size_t>(std::max(0, chain.latency_samples()));
+    const size_t output_frames = wav.frames + static_cast<size_t>(job.options.tail_seconds * wav.sample_rate);
+    const size_t total_frames = output_frames + latency;
+
+    WavWriter writer;
+    if (!writer.open(output, wav.sample_rate)) {
+        error = "can't create " + output.string();
+        return false;
+    }
+
+    for (size_t position = 0; position < total_frames; position += block_size) {
+        const int frames = static_cast<int>(std::min<size_t>(block_size, total_frames - position));
+        read_frames(wav, position, frames, left.data(), right.data());
+        if (!chain.process(left.data(), right.data(), frames)) {
+            error = std::string("processing failed: ") + vst3_get_last_error();
+            return false;
+        }
+
+        const size_t skip = position < latency ? std::min<size_t>(frames, latency - position) : 0;
+        const int keep = frames - static_cast<int>(skip);
+        if (keep > 0 && !writer.write(left.data() + skip, right.data() + skip, keep)) {
+            error = "write failed";
+            return false;
+        }
+    }
+    seconds = static_cast<double>(output_frames) / wav.sample_rate;
+    return writer.finish(error);
+}
+
+void worker_main(Job& job) {
+    Chain chain(job.options.block_size);
+    std::vector<float> left(job.options.block_size);
+    std::vector<float> right(job.options.block_size);
+
+    for (;;) {
+        const size_t index = job.next_input.fetch_add(1, std::memory_order_relaxed);
+        if (index >= job.options.inputs.size()) {
+            return;
+        }
+        const std::string& input = job.options.inputs[index];
+        const fs::path output = output_path_for(job.options, input);
+
+        const Clock::time_point start = Clock::now();
+        double seconds = 0.0;
+        std::string error;
+        std::fprintf(stderr, "🎛️  [Render] %s\n", input.c_str());
+        if (render_file(job, chain, input, output, left, right, seconds, error)) {
+            const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            char speed[32];
+            std::snprintf(speed, sizeof(speed), "%.1fx", elapsed > 0.0 ? seconds / elapsed : 0.0);
+            job.report("ok " + input + " -> " + output.string() + " (" + speed + " realtime)");
+        } else {
+            job.failures.fetch_add(1, std::memory_order_relaxed);
+            std::fprintf(stderr, "❌ [Render] %s: %s\n", input.c_str(), error.c_str());
+            job.report("failed " + input + ": " + error);
+        }
+    }
+}
+
+bool parse_args(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--chain") == 0 && i + 1 < argc) {
+            options.chain_path = argv[++i];
+        } else if (std::strcmp(arg, "--output-dir") == 0 && i + 1 < argc) {
+            options.output_dir = argv[++i];
+        } else if (std::strcmp(arg, "--jobs") == 0 && i + 1 < argc) {
+            options.jobs = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--block") == 0 && i + 1 < argc) {
+            options.block_size = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--tail") == 0 && i + 1 < argc) {
+            options.tail_seconds = std::atof(argv[++i]);
+        } else if (arg[0] == '-' && arg[1] == '-') {
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return !options.chain_path.empty() && !options.output_dir.empty() && !options.inputs.empty() &&
+           options.jobs >= 0 && options.block_size >= kMinBlockSize && options.block_size <= kMaxBlockSize &&
+           options.tail_seconds >= 0.0;
+}
+
+// Outputs are named after their inputs; two inputs with the same name, or
+// an output that would overwrite its own input, can't be rendered
+bool check_outputs(const Options& options) {
+    std::vector<fs::path> outputs;
+    for (const std::string& input : options.inputs) {
+        const fs::path output = output_path_for(options, input);
+        std::error_code ec;
+        if (fs::equivalent(input, output, ec)) {
+            std::fprintf(stderr, "❌ [Render] %s would overwrite its input\n", output.string().c_str());
+            return false;
+        }
+        if (std::find(outputs.begin(), outputs.end(), output) != outputs.end()) {
+            std::fprintf(stderr, "❌ [Render] Two inputs render to %s\n", output.string().c_str());
+            return false;
+        }
+        outputs.push_back(output);
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "Usage: %s --chain <chain.txt> --output-dir <dir> [--jobs <n>] [--block <frames>] "
+                     "[--tail <seconds>] <input.wav>...\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<ChainEntry> chain;
+    std::string error;
+    if (!read_chain(options.chain_path, chain, error)) {
+        std::fprintf(stderr, "❌ [Render] %s\n", error.c_str());
+        return 2;
+    }
+    std::error_code ec;
+    fs::create_directories(options.output_dir, ec);
+    if (!fs::is_directory(options.output_dir)) {
+        std::fprintf(stderr, "❌ [Render] Can't create %s\n", options.output_dir.c_str());
+        return 2;
+    }
+    if (!check_outputs(options)) {
+        return 2;
+    }
+
+    // Keep stdout for the results; the host logs there too
+    std::fflush(stdout);
+    FILE* results = fdopen(dup(1), "w");
+    dup2(2, 1);
+
+    if (!vst3_host_init()) {
+        std::fprintf(stderr, "❌ [Render] %s\n", vst3_get_last_error());
+        return 1;
+    }
+
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t workers = std::min<size_t>(options.inputs.size(), options.jobs > 0 ? options.jobs : cores);
+    std::fprintf(stderr, "🎛️  [Render] %zu file(s), %zu plugin(s), %zu worker(s), %d-frame blocks\n",
+                 options.inputs.size(), chain.size(), workers, options.block_size);
+
+    Job job(options, chain, results ? results : stdout);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers; i++) {
+        threads.emplace_back(worker_main, std::ref(job));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    vst3_host_shutdown();
+    if (results) {
+        std::fclose(results);
+    }
+    return job.failures.load() == 0 ? 0 : 1;
+}
@@ -1,8 +1,10 @@
-// vst3_host_win.cpp - Windows-specific VST3 GUI helpers
-// Windows equivalent of vst3_host_mac.mm for plugin editor window management
+// vst3_host_win.cpp - Windows-specific VST3 helpers
+// Windows equivalent of vst3_host_mac.mm: plugin editor window management
+// and realtime thread scheduling
 
 #include "vst3_host.h"
 #include <windows.h>
+#include <avrt.h>
 
 extern "C" {
 
@@ -49,4 +51,28 @@ void vst3_resize_hwnd(void* hwnd, int width, int height) {
                  SWP_NOZORDER | SWP_NOACTIVATE);
 }
 
+/// Register the calling thread with MMCSS as "Pro Audio", so the
+/// scheduler runs it ahead of ordinary threads
+/// @param token - Receives the MMCSS task handle for the release call
+bool vst3_platform_prepare_realtime_thread(void** token) {
+    *token = nullptr;
+
+    DWORD task_index = 0;
+    HANDLE task = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task_index);
+    if (!task) {
+        return false;
+    }
+    AvSetMmThreadPriority(task, AVRT_PRIORITY_HIGH);
+
+    *token = task;
+    return true;
+}
+
+/// Leave the MMCSS task joined by vst3_platform_prepare_realtime_thread
+void vst3_platform_release_realtime_thread(void* token) {
+    if (token) {
+        AvRevertMmThreadCharacteristics(static_cast<HANDLE>(token));
+    }
+}
+
 } // extern "C"
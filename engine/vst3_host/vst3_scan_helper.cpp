@@ -0,0 +1,47 @@
+// vst3_scan_helper - probes one VST3 bundle in its own process
+//
+// Usage: vst3_scan_helper <bundle.vst3>
+//
+// Prints one scan cache P record per plugin class on stdout and exits 0, or
+// exits non-zero if the module can't be loaded. If the plugin crashes the
+// helper, the host marks the bundle as failed instead of going down with it.
+// Any other output (host or plugin logging) is ignored by the host.
+
+#include "vst3_host.h"
+#include "scan_cache.h"
+
+#include <cstdio>
+#include <string>
+
+static void collect_plugin(const VST3PluginInfo* info, void* user_data) {
+    auto records = static_cast<std::string*>(user_data);
+    *records += scan_cache::format_plugin(*info);
+    *records += "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <bundle.vst3>\n", argv[0]);
+        return 2;
+    }
+
+    if (!vst3_host_init()) {
+        std::fprintf(stderr, "%s\n", vst3_get_last_error());
+        return 1;
+    }
+
+    std::string records;
+    int count = vst3_scan_bundle(argv[1], collect_plugin, &records);
+    if (count < 0) {
+        std::fprintf(stderr, "%s\n", vst3_get_last_error());
+        vst3_host_shutdown();
+        return 1;
+    }
+
+    // Printed in one go after loading, so plugin chatter can't split a record
+    std::fputs(records.c_str(), stdout);
+    std::fflush(stdout);
+
+    vst3_host_shutdown();
+    return 0;
+}